@@ -6,6 +6,7 @@
 #include "../src/application.h"
 #include "../src/application_event.h"
 #include "../src/launch_at_login.h"
+#include "../src/main_thread.h"
 #include "../src/dialog.h"
 #include "../src/display.h"
 #include "../src/display_event.h"
@@ -19,6 +20,7 @@
 #include "../src/keyboard_event.h"
 #include "../src/keyboard_monitor.h"
 #include "../src/menu.h"
+#include "../src/menu_model.h"
 #include "../src/message_dialog.h"
 #include "../src/preferences.h"
 #include "../src/secure_storage.h"
@@ -44,6 +46,7 @@
 #include "../src/capi/geometry_c.h"
 #include "../src/capi/image_c.h"
 #include "../src/capi/keyboard_monitor_c.h"
+#include "../src/capi/main_thread_c.h"
 #include "../src/capi/menu_c.h"
 #include "../src/capi/message_dialog_c.h"
 #include "../src/capi/preferences_c.h"
@@ -0,0 +1,149 @@
+/**
+ * @file callback_registry.h
+ * @brief Sharded registry of the listener data of C API bindings.
+ *
+ * A C binding that forwards events of a handle to a C callback registers a
+ * C++ listener (or callback) on the object. The registry maps
+ * `(handle, id)` to the binding's data so that `*_remove_listener` and
+ * `*_destroy` can find it.
+ *
+ * Used by the menu, menu item and tray icon bindings, which attach listeners
+ * to individual handles. It is not meant for process-wide event callbacks
+ * (window manager, shortcut manager events), which are not tied to a handle
+ * and are walked on every event, nor for bindings that never look their data
+ * up again: the keyboard monitor keeps its callbacks in its handle, and a
+ * shortcut's callback owns its callback data.
+ *
+ * Ownership:
+ * - The C++ listener or callback that forwards the events holds the only
+ *   strong reference to its `Entry`; the registry keeps weak references. Entries
+ *   therefore go away with the object's listeners, even when the object is
+ *   destroyed without a `*_destroy` call (e.g. a submenu owned by its item),
+ *   and a new object at a reused address never sees them.
+ * - Expired entries are swept when a shard has seen as many additions as it
+ *   has entries, which keeps the sweeps O(1) amortized.
+ *
+ * Thread-safety:
+ * - Entries are spread over `kShardCount` shards by handle, each with its
+ *   own mutex, so bindings used from different threads (e.g. a Dart isolate
+ *   and the GTK main thread) rarely contend.
+ * - Event delivery does not touch the registry; only registering and
+ *   unregistering take a shard lock, for O(1) average-case work.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace nativeapi {
+
+template <typename Entry>
+class CallbackRegistry {
+ public:
+  /**
+   * @brief Record the data of listener |id| of |handle|.
+   *
+   * Replaces an entry with the same handle and id.
+   *
+   * @param handle The C API handle the listener was added to.
+   * @param id The listener id returned to C.
+   * @param entry The binding's data, kept alive by the C++ listener.
+   */
+  void Add(const void* handle, size_t id, const std::shared_ptr<Entry>& entry) {
+    Shard& shard = ShardFor(handle);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& entries = shard.handles[handle];
+    if (entries.emplace(id, entry).second) {
+      ++shard.size;
+    } else {
+      entries[id] = entry;
+    }
+    if (++shard.additions >= shard.size) {
+      Sweep(shard);
+    }
+  }
+
+  /**
+   * @brief Remove the data of listener |id| of |handle|.
+   *
+   * This operation is O(1) average-case.
+   *
+   * @return The entry if it was registered and its listener still exists,
+   *         otherwise `nullptr`. Only one of several concurrent callers gets
+   *         the entry, so only that one removes the C++ listener.
+   */
+  std::shared_ptr<Entry> Remove(const void* handle, size_t id) {
+    Shard& shard = ShardFor(handle);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto handle_it = shard.handles.find(handle);
+    if (handle_it == shard.handles.end()) {
+      return nullptr;
+    }
+    auto entry_it = handle_it->second.find(id);
+    if (entry_it == handle_it->second.end()) {
+      return nullptr;
+    }
+    std::shared_ptr<Entry> entry = entry_it->second.lock();
+    handle_it->second.erase(entry_it);
+    --shard.size;
+    if (handle_it->second.empty()) {
+      shard.handles.erase(handle_it);
+    }
+    return entry;
+  }
+
+  /**
+   * @brief Forget every entry of |handle|.
+   *
+   * Called when the C API destroys the handle. This operation is O(n) in
+   * the number of listeners of the handle.
+   */
+  void RemoveAll(const void* handle) {
+    Shard& shard = ShardFor(handle);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto handle_it = shard.handles.find(handle);
+    if (handle_it != shard.handles.end()) {
+      shard.size -= handle_it->second.size();
+      shard.handles.erase(handle_it);
+    }
+  }
+
+ private:
+  static constexpr size_t kShardCount = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<const void*, std::unordered_map<size_t, std::weak_ptr<Entry>>> handles;
+    size_t size = 0;       // Entries over all handles, expired ones included
+    size_t additions = 0;  // Since the last sweep
+  };
+
+  // Handles are heap pointers, whose low bits carry little entropy
+  Shard& ShardFor(const void* handle) {
+    return shards_[(std::hash<const void*>()(handle) >> 4) % kShardCount];
+  }
+
+  static void Sweep(Shard& shard) {
+    for (auto handle_it = shard.handles.begin(); handle_it != shard.handles.end();) {
+      auto& entries = handle_it->second;
+      for (auto entry_it = entries.begin(); entry_it != entries.end();) {
+        if (entry_it->second.expired()) {
+          entry_it = entries.erase(entry_it);
+          --shard.size;
+        } else {
+          ++entry_it;
+        }
+      }
+      handle_it = entries.empty() ? shard.handles.erase(handle_it) : std::next(handle_it);
+    }
+    shard.additions = 0;
+  }
+
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace nativeapi
@@ -1,11 +1,38 @@
 #include "image_c.h"
 
 #include <cstring>
+#include <type_traits>
 #include "../image.h"
 #include "string_utils_c.h"
 
 using namespace nativeapi;
 
+namespace {
+
+// Fails for a format or PNG mode outside its enum, which FFI callers can pass
+bool ToEncodeOptions(const native_image_encode_options_t* options, ImageEncodeOptions& result) {
+  if (!options) {
+    return true;
+  }
+  // Read as integers: loading an out-of-range value as the enum type is
+  // undefined behavior in C++
+  std::underlying_type_t<native_image_encode_format_t> format;
+  std::underlying_type_t<native_png_encode_mode_t> png_mode;
+  std::memcpy(&format, &options->format, sizeof(format));
+  std::memcpy(&png_mode, &options->png_mode, sizeof(png_mode));
+  if (format < NATIVE_IMAGE_ENCODE_FORMAT_PNG || format > NATIVE_IMAGE_ENCODE_FORMAT_ICO ||
+      png_mode < NATIVE_PNG_ENCODE_MODE_DEFAULT || png_mode > NATIVE_PNG_ENCODE_MODE_STORE) {
+    return false;
+  }
+  result.format = static_cast<ImageEncodeFormat>(format);
+  result.compression_level = options->compression_level;
+  result.quality = options->quality;
+  result.png_mode = static_cast<PngEncodeMode>(png_mode);
+  return true;
+}
+
+}  // namespace
+
 // Create an image from a file path
 native_image_t native_image_from_file(const char* file_path) {
   if (!file_path) {
@@ -34,7 +61,7 @@ native_image_t native_image_from_base64(const char* base64_data) {
   }
 
   try {
-    auto image = Image::FromBase64(base64_data);
+    auto image = Image::FromBase64(std::string_view(base64_data));
     if (image) {
       auto size = image->GetSize();
       if (size.width > 0 && size.height > 0) {
@@ -48,6 +75,95 @@ native_image_t native_image_from_base64(const char* base64_data) {
   return nullptr;
 }
 
+// Create an image from encoded image bytes in memory
+native_image_t native_image_from_bytes(const uint8_t* data, size_t size) {
+  if (!data || size == 0) {
+    return nullptr;
+  }
+
+  try {
+    auto image = Image::FromBytes(data, size);
+    if (image) {
+      return new std::shared_ptr<Image>(image);
+    }
+  } catch (...) {
+    // Handle exceptions
+  }
+
+  return nullptr;
+}
+
+static ImageCallbackContext ConvertCallbackContext(native_image_callback_context_t context) {
+  return context == NATIVE_IMAGE_CALLBACK_CONTEXT_WORKER_THREAD
+             ? ImageCallbackContext::WorkerThread
+             : ImageCallbackContext::MainThread;
+}
+
+static ImageDecodeCallback MakeDecodeCallback(native_image_decode_callback_t callback,
+                                              void* user_data) {
+  return [callback, user_data](std::shared_ptr<Image> image) {
+    callback(image ? new std::shared_ptr<Image>(std::move(image)) : nullptr, user_data);
+  };
+}
+
+// Load and decode an image file on a worker thread
+native_image_decode_task_t native_image_from_file_async(const char* file_path,
+                                                        native_image_callback_context_t context,
+                                                        native_image_decode_callback_t callback,
+                                                        void* user_data) {
+  if (!file_path || !callback) {
+    return nullptr;
+  }
+
+  try {
+    auto task = Image::FromFileAsync(file_path, MakeDecodeCallback(callback, user_data),
+                                     ConvertCallbackContext(context));
+    return new std::shared_ptr<ImageDecodeTask>(task);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+// Decode encoded image bytes on a worker thread
+native_image_decode_task_t native_image_from_bytes_async(const uint8_t* data,
+                                                         size_t size,
+                                                         native_image_callback_context_t context,
+                                                         native_image_decode_callback_t callback,
+                                                         void* user_data) {
+  if (!data || size == 0 || !callback) {
+    return nullptr;
+  }
+
+  try {
+    auto task = Image::FromBytesAsync(std::vector<uint8_t>(data, data + size),
+                                      MakeDecodeCallback(callback, user_data),
+                                      ConvertCallbackContext(context));
+    return new std::shared_ptr<ImageDecodeTask>(task);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+// Cancel an asynchronous decode
+bool native_image_decode_task_cancel(native_image_decode_task_t task) {
+  if (!task) {
+    return false;
+  }
+
+  try {
+    return (*static_cast<std::shared_ptr<ImageDecodeTask>*>(task))->Cancel();
+  } catch (...) {
+    return false;
+  }
+}
+
+// Release a decode task handle
+void native_image_decode_task_destroy(native_image_decode_task_t task) {
+  if (task) {
+    delete static_cast<std::shared_ptr<ImageDecodeTask>*>(task);
+  }
+}
+
 // Destroy an image and release its resources
 void native_image_destroy(native_image_t image) {
   if (image) {
@@ -124,3 +240,79 @@ bool native_image_save_to_file(native_image_t image, const char* file_path) {
     return false;
   }
 }
+
+// Fill encoding options with the defaults
+void native_image_encode_options_init(native_image_encode_options_t* options) {
+  if (!options) {
+    return;
+  }
+  const ImageEncodeOptions defaults;
+  options->format = static_cast<native_image_encode_format_t>(defaults.format);
+  options->compression_level = defaults.compression_level;
+  options->quality = defaults.quality;
+  options->png_mode = static_cast<native_png_encode_mode_t>(defaults.png_mode);
+}
+
+// Encode an image into a sink
+bool native_image_encode_to(native_image_t image,
+                            const native_image_encode_options_t* options,
+                            native_image_encode_sink_t sink,
+                            void* user_data) {
+  if (!image || !sink) {
+    return false;
+  }
+
+  ImageEncodeOptions encode_options;
+  if (!ToEncodeOptions(options, encode_options)) {
+    return false;
+  }
+
+  try {
+    auto img = static_cast<std::shared_ptr<Image>*>(image);
+    return (*img)->EncodeTo(
+        [sink, user_data](const uint8_t* data, size_t size) {
+          return sink(data, size, user_data);
+        },
+        encode_options);
+  } catch (...) {
+    return false;
+  }
+}
+
+// Convert an image to a base64 data URI using the given options
+char* native_image_to_base64_with_options(native_image_t image,
+                                          const native_image_encode_options_t* options) {
+  ImageEncodeOptions encode_options;
+  if (!image || !ToEncodeOptions(options, encode_options)) {
+    return nullptr;
+  }
+
+  try {
+    auto img = static_cast<std::shared_ptr<Image>*>(image);
+    std::string base64 = (*img)->ToBase64(encode_options);
+    if (!base64.empty()) {
+      return to_c_str(base64);
+    }
+  } catch (...) {
+    // Handle exceptions
+  }
+
+  return nullptr;
+}
+
+// Save an image to a file using the given options
+bool native_image_save_to_file_with_options(native_image_t image,
+                                            const char* file_path,
+                                            const native_image_encode_options_t* options) {
+  ImageEncodeOptions encode_options;
+  if (!image || !file_path || !ToEncodeOptions(options, encode_options)) {
+    return false;
+  }
+
+  try {
+    auto img = static_cast<std::shared_ptr<Image>*>(image);
+    return (*img)->SaveToFile(file_path, encode_options);
+  } catch (...) {
+    return false;
+  }
+}
@@ -21,6 +21,73 @@ extern "C" {
  */
 typedef void* native_image_t;
 
+/**
+ * Opaque handle for an asynchronous image decode
+ */
+typedef void* native_image_decode_task_t;
+
+/**
+ * Thread on which an asynchronous decode reports its result
+ *
+ * On Windows and Android, MAIN_THREAD results are held until
+ * native_prepare_main_thread_dispatcher() (main_thread_c.h) has been called
+ * from the main thread. On OpenHarmony, MAIN_THREAD decodes report a NULL
+ * image from a worker thread, as the main thread cannot be reached from
+ * native code there.
+ */
+typedef enum {
+  NATIVE_IMAGE_CALLBACK_CONTEXT_WORKER_THREAD = 0,
+  NATIVE_IMAGE_CALLBACK_CONTEXT_MAIN_THREAD = 1
+} native_image_callback_context_t;
+
+/**
+ * Output format for image encoding
+ */
+typedef enum {
+  NATIVE_IMAGE_ENCODE_FORMAT_PNG = 0,
+  NATIVE_IMAGE_ENCODE_FORMAT_JPEG = 1,
+  NATIVE_IMAGE_ENCODE_FORMAT_BMP = 2,
+  NATIVE_IMAGE_ENCODE_FORMAT_GIF = 3,
+  NATIVE_IMAGE_ENCODE_FORMAT_TIFF = 4,
+  NATIVE_IMAGE_ENCODE_FORMAT_ICO = 5
+} native_image_encode_format_t;
+
+/**
+ * PNG compression strategy
+ */
+typedef enum {
+  NATIVE_PNG_ENCODE_MODE_DEFAULT = 0,  // Platform encoder
+  NATIVE_PNG_ENCODE_MODE_FAST = 1,     // Built-in single-pass encoder
+  NATIVE_PNG_ENCODE_MODE_STORE = 2     // Built-in encoder, no compression
+} native_png_encode_mode_t;
+
+/**
+ * Image encoding options
+ */
+typedef struct {
+  native_image_encode_format_t format;
+  int compression_level;  // PNG zlib level 0-9, or -1 for the encoder default
+  int quality;            // JPEG quality 1-100
+  native_png_encode_mode_t png_mode;
+} native_image_encode_options_t;
+
+/**
+ * Receives encoded image bytes in order
+ * @param data Encoded bytes (only valid during the call)
+ * @param size Number of bytes in data
+ * @param user_data User data passed to native_image_encode_to
+ * @return true to continue, false to abort encoding
+ */
+typedef bool (*native_image_encode_sink_t)(const uint8_t* data, size_t size, void* user_data);
+
+/**
+ * Completion callback for asynchronous decodes
+ * @param image The decoded image (caller takes ownership and must destroy it
+ * with native_image_destroy), or NULL if loading or decoding failed
+ * @param user_data User data passed when the decode was started
+ */
+typedef void (*native_image_decode_callback_t)(native_image_t image, void* user_data);
+
 /**
  * Image operations
  */
@@ -41,6 +108,73 @@ native_image_t native_image_from_file(const char* file_path);
 FFI_PLUGIN_EXPORT
 native_image_t native_image_from_base64(const char* base64_data);
 
+/**
+ * Create an image from encoded image bytes in memory
+ * @param data Encoded image data (PNG, JPEG, ...)
+ * @param size Number of bytes in data
+ * @return Image handle, or NULL if decoding failed
+ */
+FFI_PLUGIN_EXPORT
+native_image_t native_image_from_bytes(const uint8_t* data, size_t size);
+
+/**
+ * Load and decode an image file on a worker thread
+ *
+ * The callback is invoked exactly once unless the task is cancelled
+ * successfully.
+ *
+ * @param file_path Path to the image file
+ * @param context Thread on which the callback runs
+ * @param callback Completion callback
+ * @param user_data User data passed to the callback
+ * @return Task handle (must be released with native_image_decode_task_destroy),
+ * or NULL if the decode could not be started
+ */
+FFI_PLUGIN_EXPORT
+native_image_decode_task_t native_image_from_file_async(const char* file_path,
+                                                        native_image_callback_context_t context,
+                                                        native_image_decode_callback_t callback,
+                                                        void* user_data);
+
+/**
+ * Decode encoded image bytes on a worker thread
+ *
+ * The bytes are copied before this function returns. The callback is invoked
+ * exactly once unless the task is cancelled successfully.
+ *
+ * @param data Encoded image data (PNG, JPEG, ...)
+ * @param size Number of bytes in data
+ * @param context Thread on which the callback runs
+ * @param callback Completion callback
+ * @param user_data User data passed to the callback
+ * @return Task handle (must be released with native_image_decode_task_destroy),
+ * or NULL if the decode could not be started
+ */
+FFI_PLUGIN_EXPORT
+native_image_decode_task_t native_image_from_bytes_async(const uint8_t* data,
+                                                         size_t size,
+                                                         native_image_callback_context_t context,
+                                                         native_image_decode_callback_t callback,
+                                                         void* user_data);
+
+/**
+ * Cancel an asynchronous decode
+ * @param task The decode task
+ * @return true if the callback is guaranteed not to be invoked (user_data may
+ * be released), false if it has already run or is about to run
+ */
+FFI_PLUGIN_EXPORT
+bool native_image_decode_task_cancel(native_image_decode_task_t task);
+
+/**
+ * Release a decode task handle
+ *
+ * Releasing the handle does not cancel the decode.
+ * @param task The decode task
+ */
+FFI_PLUGIN_EXPORT
+void native_image_decode_task_destroy(native_image_decode_task_t task);
+
 /**
  * Destroy an image and release its resources
  * @param image The image to destroy
@@ -83,6 +217,54 @@ char* native_image_to_base64(native_image_t image);
 FFI_PLUGIN_EXPORT
 bool native_image_save_to_file(native_image_t image, const char* file_path);
 
+/**
+ * Fill encoding options with the defaults (PNG, platform encoder, default
+ * compression, JPEG quality 90)
+ * @param options Options to initialize
+ */
+FFI_PLUGIN_EXPORT
+void native_image_encode_options_init(native_image_encode_options_t* options);
+
+/**
+ * Encode an image and stream the result into a sink
+ *
+ * The sink may be called several times with consecutive pieces of the file.
+ * @param image The image
+ * @param options Encoding options, or NULL for the defaults
+ * @param sink Receives the encoded bytes
+ * @param user_data User data passed to the sink
+ * @return true if the whole image was encoded and accepted by the sink
+ */
+FFI_PLUGIN_EXPORT
+bool native_image_encode_to(native_image_t image,
+                            const native_image_encode_options_t* options,
+                            native_image_encode_sink_t sink,
+                            void* user_data);
+
+/**
+ * Convert an image to a base64 data URI using the given options
+ * @param image The image
+ * @param options Encoding options, or NULL for the defaults
+ * @return Base64 data URI (caller must free), or NULL on error
+ */
+FFI_PLUGIN_EXPORT
+char* native_image_to_base64_with_options(native_image_t image,
+                                          const native_image_encode_options_t* options);
+
+/**
+ * Save an image to a file using the given options
+ *
+ * The format comes from the options, not from the file extension.
+ * @param image The image
+ * @param file_path Path where the image should be saved
+ * @param options Encoding options, or NULL for the defaults
+ * @return true if saved successfully, false otherwise
+ */
+FFI_PLUGIN_EXPORT
+bool native_image_save_to_file_with_options(native_image_t image,
+                                            const char* file_path,
+                                            const native_image_encode_options_t* options);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,13 @@
+#include "main_thread_c.h"
+
+#include "../main_thread.h"
+
+using namespace nativeapi;
+
+void native_prepare_main_thread_dispatcher(void) {
+  PrepareMainThreadDispatcher();
+}
+
+bool native_is_main_thread_dispatch_supported(void) {
+  return IsMainThreadDispatchSupported();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+
+#if _WIN32
+#define FFI_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define FFI_PLUGIN_EXPORT
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set up delivery of main-thread callbacks.
+ *
+ * Call once from the main thread before starting work that reports back on
+ * the main thread, such as a MAIN_THREAD native_image_from_bytes_async().
+ * Only Windows and Android need it; elsewhere it does nothing. On Windows
+ * the first calling thread is taken to be the main thread and must run a
+ * message loop. Creating a menu or calling native_application_run() also
+ * does this, so clients that do either first can skip it.
+ */
+FFI_PLUGIN_EXPORT
+void native_prepare_main_thread_dispatcher(void);
+
+/**
+ * @brief Whether main-thread callbacks can be delivered on this platform.
+ *
+ * False on OpenHarmony, whose main event loop belongs to the ArkTS runtime.
+ */
+FFI_PLUGIN_EXPORT
+bool native_is_main_thread_dispatch_supported(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,13 +1,15 @@
 #include "menu_c.h"
 #include <cstdlib>
 #include <cstring>
-#include <map>
 #include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 #include "../image.h"
 #include "../menu.h"
 #include "../placement.h"
 #include "../positioning_strategy.h"
+#include "callback_registry.h"
 #include "string_utils_c.h"
 
 using namespace nativeapi;
@@ -25,12 +27,9 @@ struct MenuEventListenerData {
   void* user_data;
 };
 
-// Global maps to store event listeners
-// Key is the C++ listener ID returned by AddListener
-static std::map<native_menu_item_t, std::map<size_t, std::shared_ptr<EventListenerData>>>
-    g_menu_item_listeners;
-static std::map<native_menu_t, std::map<size_t, std::shared_ptr<MenuEventListenerData>>>
-    g_menu_listeners;
+// Listener data by handle and C++ listener ID, which is the ID returned to C
+static CallbackRegistry<EventListenerData> g_menu_item_listeners;
+static CallbackRegistry<MenuEventListenerData> g_menu_listeners;
 
 // Helper functions
 static MenuItemType convert_menu_item_type(native_menu_item_type_t type) {
@@ -67,22 +66,27 @@ static native_menu_item_type_t convert_menu_item_type(MenuItemType type) {
   }
 }
 
-static KeyboardAccelerator convert_keyboard_accelerator(
-    const native_keyboard_accelerator_t* accelerator) {
+static ModifierKey convert_accelerator_modifiers(int c_modifiers) {
   ModifierKey modifiers = ModifierKey::None;
-  if (accelerator->modifiers & NATIVE_ACCELERATOR_MODIFIER_CTRL) {
+  if (c_modifiers & NATIVE_ACCELERATOR_MODIFIER_CTRL) {
     modifiers |= ModifierKey::Ctrl;
   }
-  if (accelerator->modifiers & NATIVE_ACCELERATOR_MODIFIER_ALT) {
+  if (c_modifiers & NATIVE_ACCELERATOR_MODIFIER_ALT) {
     modifiers |= ModifierKey::Alt;
   }
-  if (accelerator->modifiers & NATIVE_ACCELERATOR_MODIFIER_SHIFT) {
+  if (c_modifiers & NATIVE_ACCELERATOR_MODIFIER_SHIFT) {
     modifiers |= ModifierKey::Shift;
   }
-  if (accelerator->modifiers & NATIVE_ACCELERATOR_MODIFIER_META) {
+  if (c_modifiers & NATIVE_ACCELERATOR_MODIFIER_META) {
     modifiers |= ModifierKey::Meta;
   }
-  return KeyboardAccelerator(accelerator->key, modifiers);
+  return modifiers;
+}
+
+static KeyboardAccelerator convert_keyboard_accelerator(
+    const native_keyboard_accelerator_t* accelerator) {
+  return KeyboardAccelerator(accelerator->key,
+                             convert_accelerator_modifiers(accelerator->modifiers));
 }
 
 static native_keyboard_accelerator_t convert_keyboard_accelerator(
@@ -134,6 +138,37 @@ static native_menu_item_state_t convert_menu_item_state(MenuItemState state) {
   }
 }
 
+static Placement convert_placement(native_placement_t placement) {
+  switch (placement) {
+    case NATIVE_PLACEMENT_TOP:
+      return Placement::Top;
+    case NATIVE_PLACEMENT_TOP_START:
+      return Placement::TopStart;
+    case NATIVE_PLACEMENT_TOP_END:
+      return Placement::TopEnd;
+    case NATIVE_PLACEMENT_RIGHT:
+      return Placement::Right;
+    case NATIVE_PLACEMENT_RIGHT_START:
+      return Placement::RightStart;
+    case NATIVE_PLACEMENT_RIGHT_END:
+      return Placement::RightEnd;
+    case NATIVE_PLACEMENT_BOTTOM:
+      return Placement::Bottom;
+    case NATIVE_PLACEMENT_BOTTOM_START:
+      return Placement::BottomStart;
+    case NATIVE_PLACEMENT_BOTTOM_END:
+      return Placement::BottomEnd;
+    case NATIVE_PLACEMENT_LEFT:
+      return Placement::Left;
+    case NATIVE_PLACEMENT_LEFT_START:
+      return Placement::LeftStart;
+    case NATIVE_PLACEMENT_LEFT_END:
+      return Placement::LeftEnd;
+    default:
+      return Placement::BottomStart;
+  }
+}
+
 // MenuItem C API Implementation
 
 native_menu_item_t native_menu_item_create(const char* label, native_menu_item_type_t type) {
@@ -162,10 +197,7 @@ void native_menu_item_destroy(native_menu_item_t menu_item) {
     return;
 
   // Remove event listeners first
-  auto listeners_it = g_menu_item_listeners.find(menu_item);
-  if (listeners_it != g_menu_item_listeners.end()) {
-    g_menu_item_listeners.erase(listeners_it);
-  }
+  g_menu_item_listeners.RemoveAll(menu_item);
 
   // Delete MenuItem instance
   auto menu_item_ptr = static_cast<MenuItem*>(menu_item);
@@ -503,7 +535,7 @@ int native_menu_item_add_listener(native_menu_item_t menu_item,
     }
 
     // Store the listener data using C++ listener ID as key
-    g_menu_item_listeners[menu_item][cpp_listener_id] = listener_data;
+    g_menu_item_listeners.Add(menu_item, cpp_listener_id, listener_data);
 
     return static_cast<int>(cpp_listener_id);
   } catch (...) {
@@ -523,25 +555,11 @@ bool native_menu_item_remove_listener(native_menu_item_t menu_item, int listener
     // Convert C API listener_id (int) to C++ listener_id (size_t)
     size_t cpp_listener_id = static_cast<size_t>(listener_id);
 
-    auto menu_item_it = g_menu_item_listeners.find(menu_item);
-    if (menu_item_it != g_menu_item_listeners.end()) {
-      auto listener_it = menu_item_it->second.find(cpp_listener_id);
-      if (listener_it != menu_item_it->second.end()) {
-        // Remove the C++ listener first
-        menu_item_ptr->RemoveListener(cpp_listener_id);
-
-        // Remove the listener data
-        menu_item_it->second.erase(listener_it);
-
-        // If no more listeners for this menu_item, remove the menu_item entry
-        if (menu_item_it->second.empty()) {
-          g_menu_item_listeners.erase(menu_item_it);
-        }
-
-        return true;
-      }
+    // Only listeners added through the C API can be removed through it
+    if (!g_menu_item_listeners.Remove(menu_item, cpp_listener_id)) {
+      return false;
     }
-    return false;
+    return menu_item_ptr->RemoveListener(cpp_listener_id);
   } catch (...) {
     return false;
   }
@@ -563,10 +581,7 @@ void native_menu_destroy(native_menu_t menu) {
     return;
 
   // Remove event listeners first
-  auto listeners_it = g_menu_listeners.find(menu);
-  if (listeners_it != g_menu_listeners.end()) {
-    g_menu_listeners.erase(listeners_it);
-  }
+  g_menu_listeners.RemoveAll(menu);
 
   // Delete Menu instance
   auto menu_ptr = static_cast<Menu*>(menu);
@@ -790,54 +805,42 @@ bool native_menu_open(native_menu_t menu,
   try {
     auto menu_ptr = static_cast<Menu*>(menu);
     auto strategy_ptr = static_cast<PositioningStrategy*>(strategy);
+    return menu_ptr->Open(*strategy_ptr, convert_placement(placement));
+  } catch (...) {
+    return false;
+  }
+}
 
-    // Convert C placement enum to C++ placement enum
-    Placement cpp_placement;
-    switch (placement) {
-      case NATIVE_PLACEMENT_TOP:
-        cpp_placement = Placement::Top;
-        break;
-      case NATIVE_PLACEMENT_TOP_START:
-        cpp_placement = Placement::TopStart;
-        break;
-      case NATIVE_PLACEMENT_TOP_END:
-        cpp_placement = Placement::TopEnd;
-        break;
-      case NATIVE_PLACEMENT_RIGHT:
-        cpp_placement = Placement::Right;
-        break;
-      case NATIVE_PLACEMENT_RIGHT_START:
-        cpp_placement = Placement::RightStart;
-        break;
-      case NATIVE_PLACEMENT_RIGHT_END:
-        cpp_placement = Placement::RightEnd;
-        break;
-      case NATIVE_PLACEMENT_BOTTOM:
-        cpp_placement = Placement::Bottom;
-        break;
-      case NATIVE_PLACEMENT_BOTTOM_START:
-        cpp_placement = Placement::BottomStart;
-        break;
-      case NATIVE_PLACEMENT_BOTTOM_END:
-        cpp_placement = Placement::BottomEnd;
-        break;
-      case NATIVE_PLACEMENT_LEFT:
-        cpp_placement = Placement::Left;
-        break;
-      case NATIVE_PLACEMENT_LEFT_START:
-        cpp_placement = Placement::LeftStart;
-        break;
-      case NATIVE_PLACEMENT_LEFT_END:
-        cpp_placement = Placement::LeftEnd;
-        break;
-      default:
-        cpp_placement = Placement::BottomStart;
-        break;
-    }
+void native_menu_open_async(native_menu_t menu,
+                            native_positioning_strategy_t strategy,
+                            native_placement_t placement,
+                            native_menu_open_callback_t callback,
+                            void* user_data) {
+  if (!menu || !strategy)
+    return;
 
-    return menu_ptr->Open(*strategy_ptr, cpp_placement);
+  try {
+    auto menu_ptr = static_cast<Menu*>(menu);
+    auto strategy_ptr = static_cast<PositioningStrategy*>(strategy);
+    Menu::OpenCallback cpp_callback;
+    if (callback) {
+      cpp_callback = [callback, user_data](MenuOpenStatus status) {
+        switch (status) {
+          case MenuOpenStatus::Opened:
+            callback(NATIVE_MENU_OPEN_STATUS_OPENED, user_data);
+            break;
+          case MenuOpenStatus::Failed:
+            callback(NATIVE_MENU_OPEN_STATUS_FAILED, user_data);
+            break;
+          case MenuOpenStatus::Closed:
+            callback(NATIVE_MENU_OPEN_STATUS_CLOSED, user_data);
+            break;
+        }
+      };
+    }
+    menu_ptr->OpenAsync(*strategy_ptr, convert_placement(placement), std::move(cpp_callback));
   } catch (...) {
-    return false;
+    // Ignore exceptions
   }
 }
 
@@ -853,6 +856,19 @@ bool native_menu_close(native_menu_t menu) {
   }
 }
 
+bool native_menu_dispatch_accelerator(native_menu_t menu,
+                                      const native_keyboard_accelerator_t* accelerator) {
+  if (!menu || !accelerator)
+    return false;
+
+  try {
+    auto menu_ptr = static_cast<Menu*>(menu);
+    return menu_ptr->DispatchAccelerator(convert_keyboard_accelerator(accelerator));
+  } catch (...) {
+    return false;
+  }
+}
+
 // New menu event listener API implementation
 int native_menu_add_listener(native_menu_t menu,
                              native_menu_event_type_t event_type,
@@ -894,7 +910,7 @@ int native_menu_add_listener(native_menu_t menu,
     }
 
     // Store the listener data using C++ listener ID as key
-    g_menu_listeners[menu][cpp_listener_id] = listener_data;
+    g_menu_listeners.Add(menu, cpp_listener_id, listener_data);
 
     return static_cast<int>(cpp_listener_id);
   } catch (...) {
@@ -914,30 +930,170 @@ bool native_menu_remove_listener(native_menu_t menu, int listener_id) {
     // Convert C API listener_id (int) to C++ listener_id (size_t)
     size_t cpp_listener_id = static_cast<size_t>(listener_id);
 
-    auto menu_it = g_menu_listeners.find(menu);
-    if (menu_it != g_menu_listeners.end()) {
-      auto listener_it = menu_it->second.find(cpp_listener_id);
-      if (listener_it != menu_it->second.end()) {
-        // Remove the C++ listener first
-        menu_ptr->RemoveListener(cpp_listener_id);
+    // Only listeners added through the C API can be removed through it
+    if (!g_menu_listeners.Remove(menu, cpp_listener_id)) {
+      return false;
+    }
+    return menu_ptr->RemoveListener(cpp_listener_id);
+  } catch (...) {
+    return false;
+  }
+}
 
-        // Remove the listener data
-        menu_it->second.erase(listener_it);
+// Bulk construction
 
-        // If no more listeners for this menu, remove the menu entry
-        if (menu_it->second.empty()) {
-          g_menu_listeners.erase(menu_it);
-        }
+// Returns the string at |offset|, or nullptr for NATIVE_MENU_NO_STRING.
+// Sets |valid| to false if the string does not end inside the buffer.
+static const char* string_at(const char* strings,
+                             size_t strings_size,
+                             uint32_t offset,
+                             bool& valid) {
+  if (offset == NATIVE_MENU_NO_STRING) {
+    return nullptr;
+  }
+  if (!strings || offset >= strings_size ||
+      !memchr(strings + offset, '\0', strings_size - offset)) {
+    valid = false;
+    return nullptr;
+  }
+  return strings + offset;
+}
+
+native_menu_t native_menu_build(const native_menu_item_desc_t* items,
+                                size_t count,
+                                const char* strings,
+                                size_t strings_size,
+                                native_menu_item_t* out_items) {
+  if ((count > 0 && (!items || !out_items)) || count > static_cast<size_t>(INT32_MAX))
+    return nullptr;
+
+  // Validate everything first, so a bad descriptor creates nothing
+  for (size_t i = 0; i < count; ++i) {
+    const native_menu_item_desc_t& desc = items[i];
+    bool valid = desc.parent >= -1 && desc.parent < static_cast<int32_t>(i);
+    string_at(strings, strings_size, desc.label, valid);
+    string_at(strings, strings_size, desc.tooltip, valid);
+    string_at(strings, strings_size, desc.accelerator_key, valid);
+    if (!valid)
+      return nullptr;
+  }
+
+  Menu* root = nullptr;
+  // Items in out_items so far, including one whose setup threw
+  size_t created = 0;
+  try {
+    root = new Menu();
+    // Submenu of each item, created when the item or its first child needs it
+    std::vector<std::shared_ptr<Menu>> submenus(count);
+
+    for (size_t i = 0; i < count; ++i) {
+      const native_menu_item_desc_t& desc = items[i];
+      bool valid = true;
+      const char* label = string_at(strings, strings_size, desc.label, valid);
+      const char* tooltip = string_at(strings, strings_size, desc.tooltip, valid);
+      const char* key = string_at(strings, strings_size, desc.accelerator_key, valid);
+      const MenuItemType type = convert_menu_item_type(desc.type);
+
+      auto item = new MenuItem(label ? label : "", type);
+      out_items[i] = static_cast<native_menu_item_t>(item);
+      ++created;
+
+      // Only non-default properties are set, each with one call
+      if (tooltip) {
+        item->SetTooltip(std::string(tooltip));
+      }
+      if (key) {
+        item->SetAccelerator(
+            KeyboardAccelerator(key, convert_accelerator_modifiers(desc.accelerator_modifiers)));
+      }
+      if (desc.icon) {
+        item->SetIcon(*static_cast<std::shared_ptr<Image>*>(desc.icon));
+      }
+      if (!desc.enabled) {
+        item->SetEnabled(false);
+      }
+      if (type == MenuItemType::Radio && desc.radio_group >= 0) {
+        item->SetRadioGroup(desc.radio_group);
+      }
+      if ((type == MenuItemType::Checkbox || type == MenuItemType::Radio) &&
+          desc.state != NATIVE_MENU_ITEM_STATE_UNCHECKED) {
+        item->SetState(convert_menu_item_state(desc.state));
+      }
+      if (type == MenuItemType::Submenu) {
+        submenus[i] = std::make_shared<Menu>();
+        item->SetSubmenu(submenus[i]);
+      }
 
-        return true;
+      // Items are owned by the caller, so menus hold non-owning pointers
+      Menu* parent = root;
+      if (desc.parent >= 0) {
+        std::shared_ptr<Menu>& submenu = submenus[desc.parent];
+        if (!submenu) {
+          submenu = std::make_shared<Menu>();
+          static_cast<MenuItem*>(out_items[desc.parent])->SetSubmenu(submenu);
+        }
+        parent = submenu.get();
       }
+      parent->AddItem(std::shared_ptr<MenuItem>(item, [](MenuItem*) {}));
     }
+    return static_cast<native_menu_t>(root);
+  } catch (...) {
+    native_menu_item_destroy_many(out_items, created);
+    delete root;
+    return nullptr;
+  }
+}
+
+void native_menu_item_destroy_many(const native_menu_item_t* items, size_t count) {
+  if (!items)
+    return;
+
+  for (size_t i = 0; i < count; ++i) {
+    native_menu_item_destroy(items[i]);
+  }
+}
+
+// Snapshots
+
+bool native_menu_serialize(native_menu_t menu, uint8_t** out_data, size_t* out_size) {
+  if (!menu || !out_data || !out_size)
     return false;
+
+  try {
+    std::vector<uint8_t> snapshot = static_cast<Menu*>(menu)->Serialize();
+    // Trees too deep for a snapshot, or with a submenu cycle, are not saved
+    if (snapshot.empty())
+      return false;
+    auto data = static_cast<uint8_t*>(malloc(snapshot.size()));
+    if (!data)
+      return false;
+    memcpy(data, snapshot.data(), snapshot.size());
+    *out_data = data;
+    *out_size = snapshot.size();
+    return true;
   } catch (...) {
     return false;
   }
 }
 
+native_menu_t native_menu_deserialize(const uint8_t* data, size_t size) {
+  if (!data)
+    return nullptr;
+
+  try {
+    auto menu = std::make_unique<Menu>();
+    if (!menu->Deserialize(data, size))
+      return nullptr;
+    return static_cast<native_menu_t>(menu.release());
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void native_menu_snapshot_free(uint8_t* data) {
+  free(data);
+}
+
 // Utility functions
 
 void native_menu_item_list_free(native_menu_item_list_t list) {
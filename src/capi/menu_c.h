@@ -91,6 +91,36 @@ typedef struct {
   native_menu_item_id_t item_id;
 } native_menu_item_submenu_closed_event_t;
 
+/**
+ * Marks an absent string in native_menu_item_desc_t
+ */
+#define NATIVE_MENU_NO_STRING UINT32_MAX
+
+/**
+ * Flat description of one menu item for native_menu_build().
+ *
+ * Strings are byte offsets of NUL-terminated UTF-8 strings in the string
+ * buffer passed to native_menu_build(), or NATIVE_MENU_NO_STRING.
+ */
+typedef struct {
+  /** Index of the parent item in the descriptor array, which must come
+   *  earlier in the array, or -1 for the root menu */
+  int32_t parent;
+  native_menu_item_type_t type;
+  uint32_t label;
+  uint32_t tooltip;
+  /** Accelerator key, or NATIVE_MENU_NO_STRING for no accelerator */
+  uint32_t accelerator_key;
+  /** Combination of native_accelerator_modifier_t flags */
+  int32_t accelerator_modifiers;
+  native_menu_item_state_t state;
+  /** Radio group of radio items, or -1 */
+  int32_t radio_group;
+  bool enabled;
+  /** Icon, or NULL; the caller keeps its own reference */
+  native_image_t icon;
+} native_menu_item_desc_t;
+
 /**
  * Menu item list structure
  */
@@ -113,6 +143,17 @@ typedef struct {
   native_menu_id_t menu_id;
 } native_menu_closed_event_t;
 
+/**
+ * Outcomes of native_menu_open_async(), reported in this order
+ */
+typedef enum {
+  NATIVE_MENU_OPEN_STATUS_OPENED = 0, /**< Showing; CLOSED follows */
+  NATIVE_MENU_OPEN_STATUS_FAILED = 1, /**< Could not be shown; final */
+  NATIVE_MENU_OPEN_STATUS_CLOSED = 2  /**< Dismissed or item selected; final */
+} native_menu_open_status_t;
+
+typedef void (*native_menu_open_callback_t)(native_menu_open_status_t status, void* user_data);
+
 /**
  * Event listener registration function types
  */
@@ -473,6 +514,31 @@ bool native_menu_open(native_menu_t menu,
                       native_positioning_strategy_t strategy,
                       native_placement_t placement);
 
+/**
+ * Open the menu as a context menu without blocking the calling thread
+ *
+ * Returns immediately; may be called from any thread. The callback runs on
+ * the main thread, with OPENED and then CLOSED, or with FAILED alone. Does
+ * nothing if menu or strategy is NULL.
+ *
+ * The menu must have been created on the main thread, which sets up
+ * main-thread delivery on Windows and Android. On OpenHarmony FAILED is
+ * reported from a worker thread.
+ *
+ * @param menu The menu
+ * @param strategy The positioning strategy determining where to display the menu;
+ *                 copied, so it may be destroyed right after the call
+ * @param placement The placement option determining how the menu is positioned
+ * @param callback Receives the outcome, or NULL
+ * @param user_data User data passed to callback
+ */
+FFI_PLUGIN_EXPORT
+void native_menu_open_async(native_menu_t menu,
+                            native_positioning_strategy_t strategy,
+                            native_placement_t placement,
+                            native_menu_open_callback_t callback,
+                            void* user_data);
+
 /**
  * Close the menu if it's currently showing
  * @param menu The menu
@@ -481,6 +547,17 @@ bool native_menu_open(native_menu_t menu,
 FFI_PLUGIN_EXPORT
 bool native_menu_close(native_menu_t menu);
 
+/**
+ * Activate the item of the menu's tree that has the given accelerator, as
+ * if it was clicked (see Menu::DispatchAccelerator())
+ * @param menu The menu
+ * @param accelerator The pressed key and modifiers
+ * @return true if an item has the accelerator, false otherwise
+ */
+FFI_PLUGIN_EXPORT
+bool native_menu_dispatch_accelerator(native_menu_t menu,
+                                      const native_keyboard_accelerator_t* accelerator);
+
 /**
  * Add event listener for a menu
  * @param menu The menu
@@ -504,6 +581,86 @@ int native_menu_add_listener(native_menu_t menu,
 FFI_PLUGIN_EXPORT
 bool native_menu_remove_listener(native_menu_t menu, int listener_id);
 
+/**
+ * Bulk construction
+ */
+
+/**
+ * Build a whole menu tree in one call
+ *
+ * Creates one menu item per descriptor, in array order, and adds it to the
+ * root menu or to the submenu of its parent item. A submenu is created for
+ * every item of type NATIVE_MENU_ITEM_TYPE_SUBMENU or with children; it is
+ * owned by its item (see native_menu_item_get_submenu()) and must not be
+ * destroyed separately.
+ *
+ * @param items Descriptors of the items, parents before their children
+ * @param count Number of descriptors
+ * @param strings Buffer holding every string the descriptors refer to
+ * @param strings_size Size of the string buffer in bytes
+ * @param out_items Caller-allocated array of count entries that receives
+ *                  the item handles, in descriptor order. The caller owns
+ *                  the items, as if created with native_menu_item_create(),
+ *                  and can release them with native_menu_item_destroy_many().
+ * @return The root menu, or NULL if a descriptor is invalid (a parent
+ *         index that is not earlier in the array, or a string offset
+ *         outside the buffer); nothing is created in that case
+ */
+FFI_PLUGIN_EXPORT
+native_menu_t native_menu_build(const native_menu_item_desc_t* items,
+                                size_t count,
+                                const char* strings,
+                                size_t strings_size,
+                                native_menu_item_t* out_items);
+
+/**
+ * Destroy several menu items, e.g. those returned by native_menu_build()
+ * @param items The menu items to destroy; NULL entries are skipped
+ * @param count Number of entries in items
+ */
+FFI_PLUGIN_EXPORT
+void native_menu_item_destroy_many(const native_menu_item_t* items, size_t count);
+
+/**
+ * Snapshots
+ */
+
+/**
+ * Save a menu's items, submenus included, as a compact binary snapshot
+ *
+ * See Menu::Serialize() for what the snapshot contains.
+ *
+ * @param menu The menu
+ * @param out_data Receives the snapshot; free it with
+ *                 native_menu_snapshot_free()
+ * @param out_size Receives the size of the snapshot in bytes
+ * @return true on success, false otherwise, e.g. when submenus nest more
+ *         than 64 levels deep or form a cycle
+ */
+FFI_PLUGIN_EXPORT
+bool native_menu_serialize(native_menu_t menu, uint8_t** out_data, size_t* out_size);
+
+/**
+ * Create a menu from a snapshot made by native_menu_serialize()
+ *
+ * The items and submenus are owned by the menu and go away with
+ * native_menu_destroy(); they must not be destroyed separately.
+ *
+ * @param data The snapshot
+ * @param size Size of the snapshot in bytes
+ * @return The new menu, or NULL if the snapshot is malformed or of an
+ *         unknown version
+ */
+FFI_PLUGIN_EXPORT
+native_menu_t native_menu_deserialize(const uint8_t* data, size_t size);
+
+/**
+ * Free a snapshot returned by native_menu_serialize()
+ * @param data The snapshot, or NULL
+ */
+FFI_PLUGIN_EXPORT
+void native_menu_snapshot_free(uint8_t* data);
+
 /**
  * Utility functions
  */
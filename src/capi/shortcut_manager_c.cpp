@@ -14,9 +14,6 @@ struct ShortcutCallbackInfo {
   void* user_data;
 };
 
-static std::mutex g_shortcut_callback_mutex;
-static std::unordered_map<native_shortcut_id_t, ShortcutCallbackInfo> g_shortcut_callbacks;
-
 // Global state for event callbacks
 struct ShortcutEventCallbackInfo {
   native_shortcut_event_callback_t callback;
@@ -36,6 +33,23 @@ static native_shortcut_t CreateNativeShortcutHandle(std::shared_ptr<Shortcut> sh
   return static_cast<void*>(shortcut.get());
 }
 
+// Helper function to route a shortcut's activations to a C callback; the
+// shortcut's callback owns the callback data, so it goes with the shortcut
+static void BindShortcutCallback(const std::shared_ptr<Shortcut>& shortcut,
+                                 native_shortcut_callback_t callback,
+                                 void* user_data) {
+  auto callback_info =
+      std::make_shared<ShortcutCallbackInfo>(ShortcutCallbackInfo{callback, user_data});
+
+  shortcut->SetCallback([callback_info, id = shortcut->GetId()]() {
+    try {
+      callback_info->callback(id, callback_info->user_data);
+    } catch (...) {
+      // Ignore exceptions from callbacks
+    }
+  });
+}
+
 // Helper function to dispatch events to registered callbacks
 static void DispatchEvent(const native_shortcut_event_t& event) {
   std::lock_guard<std::mutex> lock(g_shortcut_event_callback_mutex);
@@ -131,18 +145,8 @@ native_shortcut_t native_shortcut_manager_register(const char* accelerator,
   });
 
   if (shortcut) {
-    // Store callback info
-    std::lock_guard<std::mutex> lock(g_shortcut_callback_mutex);
-    g_shortcut_callbacks[shortcut->GetId()] = {callback, user_data};
-
     // Update the shortcut's callback to call our C callback
-    shortcut->SetCallback([callback, user_data, id = shortcut->GetId()]() {
-      try {
-        callback(id, user_data);
-      } catch (...) {
-        // Ignore exceptions from callbacks
-      }
-    });
+    BindShortcutCallback(shortcut, callback, user_data);
   }
 
   return CreateNativeShortcutHandle(shortcut);
@@ -171,18 +175,8 @@ native_shortcut_t native_shortcut_manager_register_with_options(
   auto shortcut = manager.Register(cpp_options);
 
   if (shortcut) {
-    // Store callback info
-    std::lock_guard<std::mutex> lock(g_shortcut_callback_mutex);
-    g_shortcut_callbacks[shortcut->GetId()] = {callback, user_data};
-
     // Update the shortcut's callback to call our C callback
-    shortcut->SetCallback([callback, user_data, id = shortcut->GetId()]() {
-      try {
-        callback(id, user_data);
-      } catch (...) {
-        // Ignore exceptions from callbacks
-      }
-    });
+    BindShortcutCallback(shortcut, callback, user_data);
   }
 
   return CreateNativeShortcutHandle(shortcut);
@@ -190,13 +184,6 @@ native_shortcut_t native_shortcut_manager_register_with_options(
 
 bool native_shortcut_manager_unregister_by_id(native_shortcut_id_t shortcut_id) {
   auto& manager = ShortcutManager::GetInstance();
-
-  // Remove callback info
-  {
-    std::lock_guard<std::mutex> lock(g_shortcut_callback_mutex);
-    g_shortcut_callbacks.erase(shortcut_id);
-  }
-
   return manager.Unregister(shortcut_id);
 }
 
@@ -205,27 +192,11 @@ bool native_shortcut_manager_unregister_by_accelerator(const char* accelerator)
     return false;
 
   auto& manager = ShortcutManager::GetInstance();
-
-  // Get the shortcut to find its ID
-  auto shortcut = manager.Get(accelerator);
-  if (shortcut) {
-    // Remove callback info
-    std::lock_guard<std::mutex> lock(g_shortcut_callback_mutex);
-    g_shortcut_callbacks.erase(shortcut->GetId());
-  }
-
   return manager.Unregister(accelerator);
 }
 
 int native_shortcut_manager_unregister_all(void) {
   auto& manager = ShortcutManager::GetInstance();
-
-  // Clear all callback info
-  {
-    std::lock_guard<std::mutex> lock(g_shortcut_callback_mutex);
-    g_shortcut_callbacks.clear();
-  }
-
   return manager.UnregisterAll();
 }
 
@@ -1,11 +1,12 @@
 #include "tray_icon_c.h"
 #include <cstring>
-#include <map>
 #include <memory>
 #include <optional>
+#include <vector>
 #include "../image.h"
 #include "../tray_icon.h"
 #include "../tray_icon_event.h"
+#include "callback_registry.h"
 #include "string_utils_c.h"
 
 using namespace nativeapi;
@@ -15,13 +16,10 @@ struct TrayIconListenerData {
   native_tray_icon_event_type_t event_type;
   native_tray_icon_event_callback_t callback;
   void* user_data;
-  size_t listener_id;
 };
 
-// Global maps to store listener data
-static std::map<native_tray_icon_t, std::vector<std::shared_ptr<TrayIconListenerData>>>
-    g_tray_icon_listeners;
-static std::atomic<int> g_tray_icon_next_listener_id{1};
+// Listener data by handle and C++ listener ID, which is the ID returned to C
+static CallbackRegistry<TrayIconListenerData> g_tray_icon_listeners;
 
 // TrayIcon C API Implementation
 
@@ -51,10 +49,7 @@ void native_tray_icon_destroy(native_tray_icon_t tray_icon) {
     return;
 
   // Remove event listeners first
-  auto listeners_it = g_tray_icon_listeners.find(tray_icon);
-  if (listeners_it != g_tray_icon_listeners.end()) {
-    g_tray_icon_listeners.erase(listeners_it);
-  }
+  g_tray_icon_listeners.RemoveAll(tray_icon);
 
   // Delete TrayIcon instance
   auto tray_icon_ptr = static_cast<TrayIcon*>(tray_icon);
@@ -116,6 +111,50 @@ native_image_t native_tray_icon_get_icon(native_tray_icon_t tray_icon) {
   }
 }
 
+bool native_tray_icon_set_icon_animation(native_tray_icon_t tray_icon,
+                                         const native_image_t* frames,
+                                         size_t frame_count,
+                                         int frame_interval_ms) {
+  if (!tray_icon || (!frames && frame_count > 0))
+    return false;
+
+  try {
+    auto tray_icon_ptr = static_cast<TrayIcon*>(tray_icon);
+    std::vector<std::shared_ptr<Image>> images;
+    images.reserve(frame_count);
+    for (size_t i = 0; i < frame_count; ++i) {
+      if (frames[i]) {
+        images.push_back(*static_cast<std::shared_ptr<Image>*>(frames[i]));
+      }
+    }
+    return tray_icon_ptr->SetIconAnimation(images, std::chrono::milliseconds(frame_interval_ms));
+  } catch (...) {
+    return false;
+  }
+}
+
+void native_tray_icon_stop_icon_animation(native_tray_icon_t tray_icon) {
+  if (!tray_icon)
+    return;
+
+  try {
+    static_cast<TrayIcon*>(tray_icon)->StopIconAnimation();
+  } catch (...) {
+    // Ignore exceptions
+  }
+}
+
+bool native_tray_icon_is_icon_animating(native_tray_icon_t tray_icon) {
+  if (!tray_icon)
+    return false;
+
+  try {
+    return static_cast<TrayIcon*>(tray_icon)->IsIconAnimating();
+  } catch (...) {
+    return false;
+  }
+}
+
 void native_tray_icon_set_title(native_tray_icon_t tray_icon, const char* title) {
   if (!tray_icon)
     return;
@@ -361,10 +400,6 @@ int native_tray_icon_add_listener(native_tray_icon_t tray_icon,
     listener_data->event_type = event_type;
     listener_data->callback = callback;
     listener_data->user_data = user_data;
-    listener_data->listener_id = g_tray_icon_next_listener_id++;
-
-    // Get or create listener list for this tray icon
-    auto& listeners = g_tray_icon_listeners[tray_icon];
 
     // Add event listener based on type
     size_t cpp_listener_id = 0;
@@ -375,6 +410,7 @@ int native_tray_icon_add_listener(native_tray_icon_t tray_icon,
               if (listener_data && listener_data->callback) {
                 native_tray_icon_clicked_event_t c_event;
                 c_event.tray_icon_id = event.GetTrayIconId();
+                c_event.position = {event.GetPosition().x, event.GetPosition().y};
                 listener_data->callback(&c_event, listener_data->user_data);
               }
             });
@@ -386,6 +422,7 @@ int native_tray_icon_add_listener(native_tray_icon_t tray_icon,
               if (listener_data && listener_data->callback) {
                 native_tray_icon_right_clicked_event_t c_event;
                 c_event.tray_icon_id = event.GetTrayIconId();
+                c_event.position = {event.GetPosition().x, event.GetPosition().y};
                 listener_data->callback(&c_event, listener_data->user_data);
               }
             });
@@ -397,6 +434,46 @@ int native_tray_icon_add_listener(native_tray_icon_t tray_icon,
               if (listener_data && listener_data->callback) {
                 native_tray_icon_double_clicked_event_t c_event;
                 c_event.tray_icon_id = event.GetTrayIconId();
+                c_event.position = {event.GetPosition().x, event.GetPosition().y};
+                listener_data->callback(&c_event, listener_data->user_data);
+              }
+            });
+        break;
+
+      case NATIVE_TRAY_ICON_EVENT_READY:
+        cpp_listener_id = tray_icon_ptr->AddListener<TrayIconReadyEvent>(
+            [listener_data](const TrayIconReadyEvent& event) {
+              if (listener_data && listener_data->callback) {
+                native_tray_icon_ready_event_t c_event;
+                c_event.tray_icon_id = event.GetTrayIconId();
+                listener_data->callback(&c_event, listener_data->user_data);
+              }
+            });
+        break;
+
+      case NATIVE_TRAY_ICON_EVENT_FAILED:
+        cpp_listener_id = tray_icon_ptr->AddListener<TrayIconFailedEvent>(
+            [listener_data](const TrayIconFailedEvent& event) {
+              if (listener_data && listener_data->callback) {
+                native_tray_icon_failed_event_t c_event;
+                c_event.tray_icon_id = event.GetTrayIconId();
+                c_event.error_message = event.GetErrorMessage().c_str();
+                listener_data->callback(&c_event, listener_data->user_data);
+              }
+            });
+        break;
+
+      case NATIVE_TRAY_ICON_EVENT_SCROLLED:
+        cpp_listener_id = tray_icon_ptr->AddListener<TrayIconScrolledEvent>(
+            [listener_data](const TrayIconScrolledEvent& event) {
+              if (listener_data && listener_data->callback) {
+                native_tray_icon_scrolled_event_t c_event;
+                c_event.tray_icon_id = event.GetTrayIconId();
+                c_event.delta = event.GetDelta();
+                c_event.orientation =
+                    event.GetOrientation() == TrayIconScrollOrientation::Horizontal
+                        ? NATIVE_TRAY_ICON_SCROLL_HORIZONTAL
+                        : NATIVE_TRAY_ICON_SCROLL_VERTICAL;
                 listener_data->callback(&c_event, listener_data->user_data);
               }
             });
@@ -406,9 +483,7 @@ int native_tray_icon_add_listener(native_tray_icon_t tray_icon,
         return -1;
     }
 
-    // Store the C++ listener ID in our data structure
-    listener_data->listener_id = cpp_listener_id;
-    listeners.push_back(listener_data);
+    g_tray_icon_listeners.Add(tray_icon, cpp_listener_id, listener_data);
 
     return static_cast<int>(cpp_listener_id);
   } catch (...) {
@@ -425,19 +500,12 @@ bool native_tray_icon_remove_listener(native_tray_icon_t tray_icon, int listener
     if (!tray_icon_ptr)
       return false;
 
-    // Find and remove the listener
-    auto it = g_tray_icon_listeners.find(tray_icon);
-    if (it != g_tray_icon_listeners.end()) {
-      auto& listeners = it->second;
-      for (auto lit = listeners.begin(); lit != listeners.end(); ++lit) {
-        if (static_cast<int>((*lit)->listener_id) == listener_id) {
-          tray_icon_ptr->RemoveListener((*lit)->listener_id);
-          listeners.erase(lit);
-          return true;
-        }
-      }
+    // Only listeners added through the C API can be removed through it
+    const size_t cpp_listener_id = static_cast<size_t>(listener_id);
+    if (!g_tray_icon_listeners.Remove(tray_icon, cpp_listener_id)) {
+      return false;
     }
-    return false;
+    return tray_icon_ptr->RemoveListener(cpp_listener_id);
   } catch (...) {
     return false;
   }
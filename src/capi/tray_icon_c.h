@@ -33,6 +33,7 @@ typedef long native_tray_icon_id_t;
  */
 typedef struct {
   native_tray_icon_id_t tray_icon_id;
+  native_point_t position;  // Screen position, or (0, 0) if not reported
 } native_tray_icon_clicked_event_t;
 
 /**
@@ -40,6 +41,7 @@ typedef struct {
  */
 typedef struct {
   native_tray_icon_id_t tray_icon_id;
+  native_point_t position;  // Screen position, or (0, 0) if not reported
 } native_tray_icon_right_clicked_event_t;
 
 /**
@@ -47,15 +49,52 @@ typedef struct {
  */
 typedef struct {
   native_tray_icon_id_t tray_icon_id;
+  native_point_t position;  // Screen position, or (0, 0) if not reported
 } native_tray_icon_double_clicked_event_t;
 
+/**
+ * Scroll direction of a tray icon scrolled event
+ */
+typedef enum {
+  NATIVE_TRAY_ICON_SCROLL_VERTICAL = 0,
+  NATIVE_TRAY_ICON_SCROLL_HORIZONTAL = 1
+} native_tray_icon_scroll_orientation_t;
+
+/**
+ * Tray icon scrolled event
+ */
+typedef struct {
+  native_tray_icon_id_t tray_icon_id;
+  int delta;  // Sign gives the direction
+  native_tray_icon_scroll_orientation_t orientation;
+} native_tray_icon_scrolled_event_t;
+
+/**
+ * Tray icon ready event (emitted asynchronously on Linux once a
+ * StatusNotifierWatcher accepted the icon)
+ */
+typedef struct {
+  native_tray_icon_id_t tray_icon_id;
+} native_tray_icon_ready_event_t;
+
+/**
+ * Tray icon failed event
+ */
+typedef struct {
+  native_tray_icon_id_t tray_icon_id;
+  const char* error_message;  // Only valid during the callback
+} native_tray_icon_failed_event_t;
+
 /**
  * Event types for tray icon events
  */
 typedef enum {
   NATIVE_TRAY_ICON_EVENT_CLICKED = 0,
   NATIVE_TRAY_ICON_EVENT_RIGHT_CLICKED = 1,
-  NATIVE_TRAY_ICON_EVENT_DOUBLE_CLICKED = 2
+  NATIVE_TRAY_ICON_EVENT_DOUBLE_CLICKED = 2,
+  NATIVE_TRAY_ICON_EVENT_READY = 3,
+  NATIVE_TRAY_ICON_EVENT_FAILED = 4,
+  NATIVE_TRAY_ICON_EVENT_SCROLLED = 5
 } native_tray_icon_event_type_t;
 
 /**
@@ -125,6 +164,39 @@ void native_tray_icon_set_icon(native_tray_icon_t tray_icon, native_image_t imag
 FFI_PLUGIN_EXPORT
 native_image_t native_tray_icon_get_icon(native_tray_icon_t tray_icon);
 
+/**
+ * Animate the tray icon through a sequence of frames. The frames are
+ * converted once and the animation loops until native_tray_icon_set_icon()
+ * or native_tray_icon_stop_icon_animation() is called. It pauses while the
+ * icon is hidden or no system tray is available.
+ * @param tray_icon The tray icon
+ * @param frames Array of Image objects shown in order; NULL entries are skipped
+ * @param frame_count Number of entries in frames
+ * @param frame_interval_ms Time each frame stays on screen, in milliseconds
+ * @return true if the animation started; platforms without animation support
+ *         show the first frame and return false
+ */
+FFI_PLUGIN_EXPORT
+bool native_tray_icon_set_icon_animation(native_tray_icon_t tray_icon,
+                                         const native_image_t* frames,
+                                         size_t frame_count,
+                                         int frame_interval_ms);
+
+/**
+ * Stop the icon animation, keeping the current frame as the icon
+ * @param tray_icon The tray icon
+ */
+FFI_PLUGIN_EXPORT
+void native_tray_icon_stop_icon_animation(native_tray_icon_t tray_icon);
+
+/**
+ * Check whether an icon animation is set, including a paused one
+ * @param tray_icon The tray icon
+ * @return true if an animation is set, false otherwise
+ */
+FFI_PLUGIN_EXPORT
+bool native_tray_icon_is_icon_animating(native_tray_icon_t tray_icon);
+
 /**
  * Set the title text for the tray icon
  * @param tray_icon The tray icon
@@ -0,0 +1,300 @@
+#include "base64.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NATIVEAPI_BASE64_X86 1
+#include <tmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define NATIVEAPI_TARGET_SSSE3
+#else
+#define NATIVEAPI_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+namespace nativeapi {
+
+namespace {
+
+constexpr char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Decode table values: 0-63 sextet, kInvalid, kSpace (skipped), kPad ('=')
+constexpr uint8_t kInvalid = 0xFF;
+constexpr uint8_t kSpace = 0xFE;
+constexpr uint8_t kPad = 0xFD;
+
+struct DecodeTable {
+  uint8_t values[256];
+
+  constexpr DecodeTable() : values() {
+    for (int i = 0; i < 256; ++i) {
+      values[i] = kInvalid;
+    }
+    for (int i = 0; i < 64; ++i) {
+      values[static_cast<uint8_t>(kEncodeTable[i])] = static_cast<uint8_t>(i);
+    }
+    values[static_cast<uint8_t>(' ')] = kSpace;
+    values[static_cast<uint8_t>('\t')] = kSpace;
+    values[static_cast<uint8_t>('\r')] = kSpace;
+    values[static_cast<uint8_t>('\n')] = kSpace;
+    values[static_cast<uint8_t>('=')] = kPad;
+  }
+};
+
+constexpr DecodeTable kDecodeTable;
+
+// Encodes whole 3-byte groups; returns the number of input bytes consumed.
+size_t EncodeBlocksScalar(const uint8_t* in, size_t length, char* out) {
+  size_t i = 0;
+  for (; i + 3 <= length; i += 3) {
+    const uint32_t v = (static_cast<uint32_t>(in[i]) << 16) |
+                       (static_cast<uint32_t>(in[i + 1]) << 8) | in[i + 2];
+    *out++ = kEncodeTable[(v >> 18) & 0x3F];
+    *out++ = kEncodeTable[(v >> 12) & 0x3F];
+    *out++ = kEncodeTable[(v >> 6) & 0x3F];
+    *out++ = kEncodeTable[v & 0x3F];
+  }
+  return i;
+}
+
+#if defined(NATIVEAPI_BASE64_X86)
+
+bool CpuHasSsse3() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4] = {0, 0, 0, 0};
+  __cpuid(info, 1);
+  return (info[2] & (1 << 9)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+const bool kHasSsse3 = CpuHasSsse3();
+
+// Encodes 12 input bytes per iteration (reading 16). Returns the number of
+// input bytes consumed; the caller finishes the tail with the scalar path.
+NATIVEAPI_TARGET_SSSE3
+size_t EncodeBlocksSsse3(const uint8_t* in, size_t length, char* out) {
+  const __m128i shuffle =
+      _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i mask_ac = _mm_set1_epi32(0x0fc0fc00);
+  const __m128i mask_bd = _mm_set1_epi32(0x003f03f0);
+  const __m128i mul_ac = _mm_set1_epi32(0x04000040);
+  const __m128i mul_bd = _mm_set1_epi32(0x01000010);
+  const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                        '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 12) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    v = _mm_shuffle_epi8(v, shuffle);
+    const __m128i ac = _mm_mulhi_epu16(_mm_and_si128(v, mask_ac), mul_ac);
+    const __m128i bd = _mm_mullo_epi16(_mm_and_si128(v, mask_bd), mul_bd);
+    const __m128i sextets = _mm_or_si128(ac, bd);
+
+    // Map each sextet to the offset that turns it into its ASCII character.
+    __m128i index = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+    const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+    index = _mm_or_si128(index, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+    const __m128i chars = _mm_add_epi8(sextets, _mm_shuffle_epi8(offsets, index));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+    out += 16;
+  }
+  return i;
+}
+
+// Decodes 16 characters into 12 bytes per iteration (writing 16). Stops at
+// the first block containing anything other than the 64 alphabet characters
+// (whitespace, padding, garbage) and leaves it to the scalar path.
+NATIVEAPI_TARGET_SSSE3
+size_t DecodeBlocksSsse3(const char* in,
+                         size_t length,
+                         uint8_t* out,
+                         size_t capacity,
+                         size_t* written) {
+  const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B,
+                                       0x1B, 0x1A);
+  const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04,
+                                       0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                       0x10, 0x10);
+  const __m128i lut_roll =
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i mask_2f = _mm_set1_epi8(0x2F);
+  const __m128i pack_shuffle =
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  size_t i = 0;
+  size_t o = 0;
+  while (i + 16 <= length && o + 16 <= capacity) {
+    const __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+    const __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0) {
+      break;
+    }
+    const __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    __m128i v = _mm_add_epi8(str, roll);
+    v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+    v = _mm_shuffle_epi8(v, pack_shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), v);
+    i += 16;
+    o += 12;
+  }
+  *written = o;
+  return i;
+}
+
+#endif  // NATIVEAPI_BASE64_X86
+
+}  // namespace
+
+size_t Base64::Encode(const uint8_t* data, size_t length, char* out) {
+  size_t consumed = 0;
+  char* cursor = out;
+#if defined(NATIVEAPI_BASE64_X86)
+  if (kHasSsse3) {
+    consumed = EncodeBlocksSsse3(data, length, cursor);
+    cursor += consumed / 3 * 4;
+  }
+#endif
+  const size_t tail = EncodeBlocksScalar(data + consumed, length - consumed, cursor);
+  consumed += tail;
+  cursor += tail / 3 * 4;
+
+  const size_t remaining = length - consumed;
+  if (remaining > 0) {
+    const uint32_t b0 = data[consumed];
+    const uint32_t b1 = remaining > 1 ? data[consumed + 1] : 0;
+    const uint32_t v = (b0 << 16) | (b1 << 8);
+    *cursor++ = kEncodeTable[(v >> 18) & 0x3F];
+    *cursor++ = kEncodeTable[(v >> 12) & 0x3F];
+    *cursor++ = remaining > 1 ? kEncodeTable[(v >> 6) & 0x3F] : '=';
+    *cursor++ = '=';
+  }
+  return static_cast<size_t>(cursor - out);
+}
+
+void Base64::EncodeAppend(const uint8_t* data, size_t length, std::string& out) {
+  const size_t offset = out.size();
+  out.resize(offset + EncodedLength(length));
+  Encode(data, length, &out[offset]);
+}
+
+bool Base64::Decode(std::string_view input,
+                    uint8_t* out,
+                    size_t capacity,
+                    size_t* written) {
+  const char* in = input.data();
+  const size_t length = input.size();
+  size_t i = 0;
+  size_t o = 0;
+
+  while (i < length) {
+#if defined(NATIVEAPI_BASE64_X86)
+    if (kHasSsse3) {
+      size_t block_written = 0;
+      i += DecodeBlocksSsse3(in + i, length - i, out + o, capacity - o, &block_written);
+      o += block_written;
+      if (i >= length) {
+        break;
+      }
+    }
+#endif
+    // Decode a single quantum, skipping whitespace and handling padding.
+    uint32_t quantum = 0;
+    int count = 0;
+    bool padded = false;
+    for (; i < length && count < 4; ++i) {
+      const uint8_t value = kDecodeTable.values[static_cast<uint8_t>(in[i])];
+      if (value < 64) {
+        quantum = (quantum << 6) | value;
+        ++count;
+      } else if (value == kSpace) {
+        continue;
+      } else if (value == kPad) {
+        padded = true;
+        break;
+      } else {
+        return false;
+      }
+    }
+
+    if (count == 0) {
+      if (padded) {
+        return false;
+      }
+      continue;
+    }
+    if (count == 1) {
+      return false;
+    }
+
+    const size_t bytes = static_cast<size_t>(count - 1);
+    if (o + bytes > capacity) {
+      return false;
+    }
+    quantum <<= 6 * (4 - count);
+    out[o++] = static_cast<uint8_t>(quantum >> 16);
+    if (bytes > 1) {
+      out[o++] = static_cast<uint8_t>(quantum >> 8);
+    }
+    if (bytes > 2) {
+      out[o++] = static_cast<uint8_t>(quantum);
+    }
+
+    if (count < 4) {
+      // A short quantum ends the data; only padding and whitespace may follow.
+      for (; i < length; ++i) {
+        const uint8_t value = kDecodeTable.values[static_cast<uint8_t>(in[i])];
+        if (value != kPad && value != kSpace) {
+          return false;
+        }
+      }
+      break;
+    }
+  }
+
+  if (written) {
+    *written = o;
+  }
+  return true;
+}
+
+bool Base64::Decode(std::string_view input, std::vector<uint8_t>& out) {
+  out.resize(MaxDecodedLength(input.size()));
+  size_t written = 0;
+  if (!Decode(input, out.data(), out.size(), &written)) {
+    out.clear();
+    return false;
+  }
+  out.resize(written);
+  return true;
+}
+
+std::string_view Base64::StripDataUriPrefix(std::string_view input,
+                                            std::string_view* mime_type) {
+  constexpr std::string_view kScheme = "data:";
+  if (input.substr(0, kScheme.size()) != kScheme) {
+    return input;
+  }
+  const size_t comma = input.find(',');
+  if (comma == std::string_view::npos) {
+    return input;
+  }
+  if (mime_type) {
+    std::string_view header = input.substr(kScheme.size(), comma - kScheme.size());
+    *mime_type = header.substr(0, header.find(';'));
+  }
+  return input.substr(comma + 1);
+}
+
+}  // namespace nativeapi
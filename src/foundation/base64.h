@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nativeapi {
+
+/**
+ * @brief Base64 codec used by the image backends and the C API.
+ *
+ * The codec works on caller-provided buffers so that decoding a large
+ * payload does not allocate intermediate strings: the input is read through
+ * a std::string_view and written straight into the destination buffer.
+ * On x86 CPUs with SSSE3 the bulk of the input is processed 12/16 bytes at a
+ * time; the remaining tail (and every other CPU) uses a table-driven scalar
+ * path. The selection happens once at runtime.
+ *
+ * @example
+ * ```cpp
+ * std::string_view payload = Base64::StripDataUriPrefix(data_uri);
+ * std::vector<uint8_t> bytes(Base64::MaxDecodedLength(payload.size()));
+ * size_t written = 0;
+ * if (Base64::Decode(payload, bytes.data(), bytes.size(), &written)) {
+ *   bytes.resize(written);
+ * }
+ * ```
+ */
+class Base64 {
+ public:
+  /**
+   * @brief Number of characters produced when encoding @p length bytes
+   * (including padding).
+   */
+  static constexpr size_t EncodedLength(size_t length) {
+    return ((length + 2) / 3) * 4;
+  }
+
+  /**
+   * @brief Upper bound of the number of bytes produced when decoding
+   * @p length characters.
+   */
+  static constexpr size_t MaxDecodedLength(size_t length) {
+    return ((length + 3) / 4) * 3;
+  }
+
+  /**
+   * @brief Encode @p length bytes into @p out.
+   *
+   * @param out Destination buffer of at least EncodedLength(length) chars.
+   * @return Number of characters written.
+   */
+  static size_t Encode(const uint8_t* data, size_t length, char* out);
+
+  /**
+   * @brief Encode @p length bytes and append the result to @p out.
+   *
+   * The string is grown exactly once, so a prefix such as a data URI header
+   * can be placed in @p out beforehand without an extra copy.
+   */
+  static void EncodeAppend(const uint8_t* data, size_t length, std::string& out);
+
+  /**
+   * @brief Decode base64 text into @p out.
+   *
+   * ASCII whitespace (line breaks from MIME-style wrapping) is skipped and
+   * trailing '=' padding is optional.
+   *
+   * @param input Base64 text without a data URI prefix.
+   * @param out Destination buffer.
+   * @param capacity Size of @p out; MaxDecodedLength(input.size()) is always
+   *                 sufficient.
+   * @param written Receives the number of bytes written on success.
+   * @return false if the input is malformed or does not fit into @p out.
+   */
+  static bool Decode(std::string_view input,
+                     uint8_t* out,
+                     size_t capacity,
+                     size_t* written);
+
+  /**
+   * @brief Decode base64 text into a byte vector.
+   *
+   * @return false if the input is malformed; @p out is left empty.
+   */
+  static bool Decode(std::string_view input, std::vector<uint8_t>& out);
+
+  /**
+   * @brief Return the payload part of a "data:<mime>;base64,<payload>" URI.
+   *
+   * Input that does not start with "data:" is returned unchanged. No data is
+   * copied; the returned view refers into @p input.
+   *
+   * @param input Data URI or plain base64 text.
+   * @param mime_type Optional; receives the mime type ("image/png") when a
+   *                  data URI prefix was present.
+   */
+  static std::string_view StripDataUriPrefix(std::string_view input,
+                                             std::string_view* mime_type = nullptr);
+};
+
+}  // namespace nativeapi
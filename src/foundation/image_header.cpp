@@ -0,0 +1,255 @@
+#include "image_header.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace nativeapi {
+
+namespace {
+
+uint16_t ReadU16BE(const uint8_t* p) {
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint16_t ReadU16LE(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32BE(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint32_t ReadU32LE(const uint8_t* p) {
+  return p[0] | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool StartsWith(const uint8_t* data, size_t size, const char* magic, size_t length) {
+  return size >= length && std::memcmp(data, magic, length) == 0;
+}
+
+int ClampDimension(int64_t value) {
+  return value > 0 && value <= 0x7FFFFFFF ? static_cast<int>(value) : 0;
+}
+
+void ProbePng(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "PNG";
+  // 8-byte signature, then the IHDR chunk: length(4) type(4) width(4) height(4)
+  if (size >= 24 && std::memcmp(data + 12, "IHDR", 4) == 0) {
+    info.width = ClampDimension(ReadU32BE(data + 16));
+    info.height = ClampDimension(ReadU32BE(data + 20));
+  }
+}
+
+void ProbeJpeg(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "JPEG";
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (data[pos] != 0xFF) {
+      return;
+    }
+    // Skip fill bytes
+    while (pos < size && data[pos] == 0xFF) {
+      ++pos;
+    }
+    if (pos >= size) {
+      return;
+    }
+    const uint8_t marker = data[pos++];
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      continue;  // Standalone markers without a length
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      return;  // End of image / start of scan before any frame header
+    }
+    if (pos + 2 > size) {
+      return;
+    }
+    const uint16_t length = ReadU16BE(data + pos);
+    const bool is_sof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+                        marker != 0xCC;
+    if (is_sof) {
+      // length(2) precision(1) height(2) width(2)
+      if (pos + 7 <= size) {
+        info.height = ReadU16BE(data + pos + 3);
+        info.width = ReadU16BE(data + pos + 5);
+      }
+      return;
+    }
+    if (length < 2) {
+      return;
+    }
+    pos += length;
+  }
+}
+
+void ProbeGif(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "GIF";
+  if (size >= 10) {
+    info.width = ReadU16LE(data + 6);
+    info.height = ReadU16LE(data + 8);
+  }
+}
+
+void ProbeBmp(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "BMP";
+  if (size < 26) {
+    return;
+  }
+  const uint32_t dib_size = ReadU32LE(data + 14);
+  if (dib_size == 12) {
+    // BITMAPCOREHEADER with 16-bit dimensions
+    info.width = ReadU16LE(data + 18);
+    info.height = ReadU16LE(data + 20);
+  } else {
+    // Negative height marks a top-down bitmap
+    const int32_t width = static_cast<int32_t>(ReadU32LE(data + 18));
+    const int32_t height = static_cast<int32_t>(ReadU32LE(data + 22));
+    info.width = ClampDimension(width);
+    info.height = ClampDimension(height < 0 ? -static_cast<int64_t>(height) : height);
+  }
+}
+
+void ProbeIco(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "ICO";
+  const uint16_t count = ReadU16LE(data + 4);
+  int64_t best_area = 0;
+  for (uint16_t i = 0; i < count; ++i) {
+    const size_t entry = 6 + static_cast<size_t>(i) * 16;
+    if (entry + 16 > size) {
+      break;
+    }
+    // A stored dimension of 0 means 256 pixels
+    const int width = data[entry] == 0 ? 256 : data[entry];
+    const int height = data[entry + 1] == 0 ? 256 : data[entry + 1];
+    const int64_t area = static_cast<int64_t>(width) * height;
+    if (area > best_area) {
+      best_area = area;
+      info.width = width;
+      info.height = height;
+    }
+  }
+}
+
+void ProbeWebp(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "WEBP";
+  if (size < 30) {
+    return;
+  }
+  const uint8_t* chunk = data + 12;
+  if (std::memcmp(chunk, "VP8 ", 4) == 0) {
+    // Lossy: frame tag(3) start code(3) then 14-bit width and height
+    if (data[23] == 0x9D && data[24] == 0x01 && data[25] == 0x2A) {
+      info.width = ReadU16LE(data + 26) & 0x3FFF;
+      info.height = ReadU16LE(data + 28) & 0x3FFF;
+    }
+  } else if (std::memcmp(chunk, "VP8L", 4) == 0) {
+    // Lossless: signature byte then 14-bit (width - 1) and (height - 1)
+    if (data[20] == 0x2F) {
+      const uint32_t bits = ReadU32LE(data + 21);
+      info.width = static_cast<int>((bits & 0x3FFF) + 1);
+      info.height = static_cast<int>(((bits >> 14) & 0x3FFF) + 1);
+    }
+  } else if (std::memcmp(chunk, "VP8X", 4) == 0) {
+    // Extended: 24-bit (canvas width - 1) and (canvas height - 1)
+    info.width = static_cast<int>((data[24] | (data[25] << 8) | (data[26] << 16)) + 1);
+    info.height = static_cast<int>((data[27] | (data[28] << 8) | (data[29] << 16)) + 1);
+  }
+}
+
+void ProbeTiff(const uint8_t* data, size_t size, ImageHeaderInfo& info) {
+  info.format = "TIFF";
+  const bool little_endian = data[0] == 'I';
+  auto u16 = [&](const uint8_t* p) { return little_endian ? ReadU16LE(p) : ReadU16BE(p); };
+  auto u32 = [&](const uint8_t* p) { return little_endian ? ReadU32LE(p) : ReadU32BE(p); };
+
+  const uint32_t ifd = u32(data + 4);
+  if (ifd > size || size - ifd < 2) {
+    return;
+  }
+  const uint16_t count = u16(data + ifd);
+  for (uint16_t i = 0; i < count; ++i) {
+    const size_t entry = ifd + 2 + static_cast<size_t>(i) * 12;
+    if (entry + 12 > size) {
+      break;
+    }
+    const uint16_t tag = u16(data + entry);
+    const uint16_t type = u16(data + entry + 2);
+    if (tag != 256 && tag != 257) {
+      continue;
+    }
+    // SHORT (3) values are left-aligned in the 4-byte value field
+    const uint32_t value = type == 3 ? u16(data + entry + 8) : u32(data + entry + 8);
+    if (tag == 256) {
+      info.width = ClampDimension(value);
+    } else {
+      info.height = ClampDimension(value);
+    }
+  }
+}
+
+bool LooksLikeSvg(const uint8_t* data, size_t size) {
+  std::string_view text(reinterpret_cast<const char*>(data), size < 1024 ? size : 1024);
+  // Skip a UTF-8 byte order mark and leading whitespace
+  if (text.substr(0, 3) == "\xEF\xBB\xBF") {
+    text.remove_prefix(3);
+  }
+  const size_t start = text.find_first_not_of(" \t\r\n");
+  if (start == std::string_view::npos || text[start] != '<') {
+    return false;
+  }
+  return text.find("<svg", start) != std::string_view::npos;
+}
+
+}  // namespace
+
+ImageHeaderInfo ImageHeader::Probe(const uint8_t* data, size_t size) {
+  ImageHeaderInfo info;
+  if (!data || size < 4) {
+    return info;
+  }
+
+  if (StartsWith(data, size, "\x89PNG\r\n\x1A\n", 8)) {
+    ProbePng(data, size, info);
+  } else if (StartsWith(data, size, "\xFF\xD8\xFF", 3)) {
+    ProbeJpeg(data, size, info);
+  } else if (StartsWith(data, size, "GIF87a", 6) || StartsWith(data, size, "GIF89a", 6)) {
+    ProbeGif(data, size, info);
+  } else if (StartsWith(data, size, "BM", 2) && size >= 18) {
+    ProbeBmp(data, size, info);
+  } else if (StartsWith(data, size, "\0\0\1\0", 4) && size >= 6) {
+    ProbeIco(data, size, info);
+  } else if (StartsWith(data, size, "RIFF", 4) && size >= 16 &&
+             std::memcmp(data + 8, "WEBP", 4) == 0) {
+    ProbeWebp(data, size, info);
+  } else if ((StartsWith(data, size, "II*\0", 4) || StartsWith(data, size, "MM\0*", 4)) &&
+             size >= 8) {
+    ProbeTiff(data, size, info);
+  } else if (LooksLikeSvg(data, size)) {
+    info.format = "SVG";
+  }
+
+  return info;
+}
+
+ImageHeaderInfo ImageHeader::ProbeFile(const std::string& file_path) {
+  std::ifstream file(std::filesystem::u8path(file_path), std::ios::binary);
+  if (!file) {
+    return ImageHeaderInfo();
+  }
+  // Small files are read whole rather than into a full probe buffer
+  std::error_code error;
+  const uintmax_t file_size = std::filesystem::file_size(std::filesystem::u8path(file_path), error);
+  const size_t probe_size =
+      error ? kProbeSize : static_cast<size_t>(std::min<uintmax_t>(file_size, kProbeSize));
+  std::vector<uint8_t> buffer(probe_size);
+  file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+  return Probe(buffer.data(), static_cast<size_t>(file.gcount()));
+}
+
+}  // namespace nativeapi
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nativeapi {
+
+/**
+ * @brief Format and dimensions read from an encoded image's header.
+ */
+struct ImageHeaderInfo {
+  /**
+   * Format name ("PNG", "JPEG", "GIF", "BMP", "ICO", "WEBP", "TIFF", "SVG"),
+   * or an empty string if the data was not recognized.
+   */
+  std::string format;
+
+  int width = 0;   ///< Width in pixels, 0 if unknown
+  int height = 0;  ///< Height in pixels, 0 if unknown
+
+  /**
+   * @brief Check whether both dimensions were read from the header.
+   */
+  bool HasSize() const { return width > 0 && height > 0; }
+};
+
+/**
+ * @brief Identifies encoded images from their magic bytes and reads their
+ * dimensions without decoding any pixel data.
+ *
+ * The image backends use this to report the format and size of an image
+ * immediately while deferring the expensive pixel decode until the native
+ * image object is first needed.
+ *
+ * @note SVG is recognized but its size is never reported, since it depends
+ * on rendering. ICO reports the largest entry in the directory.
+ */
+class ImageHeader {
+ public:
+  /**
+   * @brief Number of leading bytes that is enough to probe virtually all
+   * images, including JPEGs with sizeable EXIF blocks before the frame
+   * header.
+   */
+  static constexpr size_t kProbeSize = 64 * 1024;
+
+  /**
+   * @brief Probe the first @p size bytes of an encoded image.
+   */
+  static ImageHeaderInfo Probe(const uint8_t* data, size_t size);
+
+  /**
+   * @brief Probe the first kProbeSize bytes of an image file, or the whole
+   * file when it is smaller.
+   *
+   * @param file_path UTF-8 path of the file
+   * @return Probe result; empty format if the file cannot be read
+   */
+  static ImageHeaderInfo ProbeFile(const std::string& file_path);
+};
+
+}  // namespace nativeapi
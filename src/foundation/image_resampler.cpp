@@ -0,0 +1,259 @@
+#include "image_resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NATIVEAPI_RESAMPLER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define NATIVEAPI_RESAMPLER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace nativeapi {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// One premultiplied RGBA pixel held in four float lanes
+#if defined(NATIVEAPI_RESAMPLER_SSE2)
+struct Pixel {
+  __m128 v;
+};
+inline Pixel PixelZero() {
+  return {_mm_setzero_ps()};
+}
+inline Pixel PixelLoad(const float* p) {
+  return {_mm_loadu_ps(p)};
+}
+inline void PixelStore(float* p, Pixel a) {
+  _mm_storeu_ps(p, a.v);
+}
+inline Pixel PixelMulAdd(Pixel acc, Pixel a, float w) {
+  return {_mm_add_ps(acc.v, _mm_mul_ps(a.v, _mm_set1_ps(w)))};
+}
+#elif defined(NATIVEAPI_RESAMPLER_NEON)
+struct Pixel {
+  float32x4_t v;
+};
+inline Pixel PixelZero() {
+  return {vdupq_n_f32(0.0f)};
+}
+inline Pixel PixelLoad(const float* p) {
+  return {vld1q_f32(p)};
+}
+inline void PixelStore(float* p, Pixel a) {
+  vst1q_f32(p, a.v);
+}
+inline Pixel PixelMulAdd(Pixel acc, Pixel a, float w) {
+  return {vmlaq_n_f32(acc.v, a.v, w)};
+}
+#else
+struct Pixel {
+  float v[4];
+};
+inline Pixel PixelZero() {
+  return {{0.0f, 0.0f, 0.0f, 0.0f}};
+}
+inline Pixel PixelLoad(const float* p) {
+  return {{p[0], p[1], p[2], p[3]}};
+}
+inline void PixelStore(float* p, Pixel a) {
+  p[0] = a.v[0];
+  p[1] = a.v[1];
+  p[2] = a.v[2];
+  p[3] = a.v[3];
+}
+inline Pixel PixelMulAdd(Pixel acc, Pixel a, float w) {
+  for (int i = 0; i < 4; ++i) {
+    acc.v[i] += a.v[i] * w;
+  }
+  return acc;
+}
+#endif
+
+double FilterSupport(ResampleFilter filter) {
+  switch (filter) {
+    case ResampleFilter::Box:
+      return 0.5;
+    case ResampleFilter::Bilinear:
+      return 1.0;
+    case ResampleFilter::Lanczos3:
+      return 3.0;
+  }
+  return 1.0;
+}
+
+double Sinc(double x) {
+  if (x == 0.0) {
+    return 1.0;
+  }
+  x *= kPi;
+  return std::sin(x) / x;
+}
+
+double FilterWeight(ResampleFilter filter, double x) {
+  x = std::fabs(x);
+  switch (filter) {
+    case ResampleFilter::Box:
+      return x <= 0.5 ? 1.0 : 0.0;
+    case ResampleFilter::Bilinear:
+      return x < 1.0 ? 1.0 - x : 0.0;
+    case ResampleFilter::Lanczos3:
+      return x < 3.0 ? Sinc(x) * Sinc(x / 3.0) : 0.0;
+  }
+  return 0.0;
+}
+
+// Source taps contributing to each output sample along one axis.
+struct Contributions {
+  std::vector<int> first;       // First source index per output sample
+  std::vector<int> count;       // Number of taps per output sample
+  std::vector<float> weights;   // Normalized weights, |max_taps| per sample
+  int max_taps = 0;
+};
+
+Contributions ComputeContributions(int src_size, int dst_size, ResampleFilter filter) {
+  Contributions c;
+  const double scale = static_cast<double>(src_size) / dst_size;
+  // When downscaling, stretch the filter over the source to avoid aliasing
+  const double filter_scale = std::max(scale, 1.0);
+  const double support = FilterSupport(filter) * filter_scale;
+
+  c.max_taps = static_cast<int>(std::ceil(support * 2.0)) + 2;
+  c.first.resize(dst_size);
+  c.count.resize(dst_size);
+  c.weights.assign(static_cast<size_t>(dst_size) * c.max_taps, 0.0f);
+
+  std::vector<double> raw(c.max_taps);
+  for (int i = 0; i < dst_size; ++i) {
+    const double center = (i + 0.5) * scale;
+    int left = static_cast<int>(std::floor(center - support));
+    int right = static_cast<int>(std::ceil(center + support));
+    left = std::max(left, 0);
+    right = std::min(right, src_size);
+    if (right - left > c.max_taps) {
+      right = left + c.max_taps;
+    }
+
+    double total = 0.0;
+    int taps = 0;
+    for (int j = left; j < right; ++j) {
+      const double w = FilterWeight(filter, (j + 0.5 - center) / filter_scale);
+      raw[taps++] = w;
+      total += w;
+    }
+
+    // Trim zero-weight taps at both ends
+    int begin = 0;
+    while (begin < taps && raw[begin] == 0.0) {
+      ++begin;
+    }
+    while (taps > begin && raw[taps - 1] == 0.0) {
+      --taps;
+    }
+    if (begin == taps) {
+      // Degenerate footprint: fall back to the nearest source sample
+      begin = 0;
+      taps = 1;
+      left = std::min(std::max(static_cast<int>(center), 0), src_size - 1);
+      raw[0] = 1.0;
+      total = 1.0;
+    }
+
+    c.first[i] = left + begin;
+    c.count[i] = taps - begin;
+    float* out = &c.weights[static_cast<size_t>(i) * c.max_taps];
+    for (int t = begin; t < taps; ++t) {
+      out[t - begin] = static_cast<float>(raw[t] / total);
+    }
+  }
+  return c;
+}
+
+}  // namespace
+
+bool ImageResampler::Resize(const uint8_t* src,
+                            int src_width,
+                            int src_height,
+                            size_t src_stride,
+                            uint8_t* dst,
+                            int dst_width,
+                            int dst_height,
+                            size_t dst_stride,
+                            ResampleFilter filter) {
+  if (!src || !dst || src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0) {
+    return false;
+  }
+
+  const Contributions horizontal = ComputeContributions(src_width, dst_width, filter);
+  const Contributions vertical = ComputeContributions(src_height, dst_height, filter);
+
+  // Convert one source row at a time to premultiplied floats and filter it
+  // horizontally into |intermediate| (src_height rows of dst_width pixels).
+  std::vector<float> row(static_cast<size_t>(src_width) * 4);
+  std::vector<float> intermediate(static_cast<size_t>(src_height) * dst_width * 4);
+  for (int y = 0; y < src_height; ++y) {
+    const uint8_t* in = src + static_cast<size_t>(y) * src_stride;
+    for (int x = 0; x < src_width; ++x) {
+      const float alpha = in[x * 4 + 3];
+      const float factor = alpha / 255.0f;
+      row[x * 4 + 0] = in[x * 4 + 0] * factor;
+      row[x * 4 + 1] = in[x * 4 + 1] * factor;
+      row[x * 4 + 2] = in[x * 4 + 2] * factor;
+      row[x * 4 + 3] = alpha;
+    }
+
+    float* out = &intermediate[static_cast<size_t>(y) * dst_width * 4];
+    for (int x = 0; x < dst_width; ++x) {
+      const float* weights = &horizontal.weights[static_cast<size_t>(x) * horizontal.max_taps];
+      const float* taps = &row[static_cast<size_t>(horizontal.first[x]) * 4];
+      Pixel acc = PixelZero();
+      for (int t = 0; t < horizontal.count[x]; ++t) {
+        acc = PixelMulAdd(acc, PixelLoad(taps + t * 4), weights[t]);
+      }
+      PixelStore(out + x * 4, acc);
+    }
+  }
+
+  // Filter vertically a whole row at a time (contiguous, cache friendly)
+  // and convert back to straight-alpha bytes.
+  std::vector<float> accum(static_cast<size_t>(dst_width) * 4);
+  for (int y = 0; y < dst_height; ++y) {
+    std::fill(accum.begin(), accum.end(), 0.0f);
+    const float* weights = &vertical.weights[static_cast<size_t>(y) * vertical.max_taps];
+    for (int t = 0; t < vertical.count[y]; ++t) {
+      const float* in =
+          &intermediate[static_cast<size_t>(vertical.first[y] + t) * dst_width * 4];
+      const float w = weights[t];
+      for (int x = 0; x < dst_width; ++x) {
+        PixelStore(&accum[x * 4], PixelMulAdd(PixelLoad(&accum[x * 4]), PixelLoad(in + x * 4), w));
+      }
+    }
+
+    uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+    for (int x = 0; x < dst_width; ++x) {
+      const float* p = &accum[x * 4];
+      // Lanczos lobes can overshoot; unpremultiply with the unclamped alpha
+      // so the color ratio is kept, then clamp each channel.
+      if (p[3] <= 0.5f) {
+        out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = out[x * 4 + 3] = 0;
+        continue;
+      }
+      const float unpremultiply = 255.0f / p[3];
+      for (int c = 0; c < 3; ++c) {
+        const float value = std::min(std::max(p[c] * unpremultiply, 0.0f), 255.0f);
+        out[x * 4 + c] = static_cast<uint8_t>(value + 0.5f);
+      }
+      const float alpha = std::min(p[3], 255.0f);
+      out[x * 4 + 3] = static_cast<uint8_t>(alpha + 0.5f);
+    }
+  }
+
+  return true;
+}
+
+}  // namespace nativeapi
@@ -0,0 +1,497 @@
+#include "png_encoder.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace nativeapi {
+
+namespace {
+
+// IDAT payload size at which a chunk is handed to the sink
+constexpr size_t kChunkCapacity = 64 * 1024;
+
+// Chunk framing: 4-byte length and 4-byte type before the data, CRC after
+constexpr size_t kChunkHeaderSize = 8;
+
+// Largest payload of a stored deflate block
+constexpr size_t kMaxStoredBlock = 65535;
+
+constexpr int kMinMatch = 3;
+constexpr int kMaxMatch = 258;
+
+struct CrcTable {
+  uint32_t values[256];
+
+  constexpr CrcTable() : values() {
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      values[n] = c;
+    }
+  }
+};
+
+constexpr CrcTable kCrcTable;
+
+uint32_t UpdateCrc(uint32_t crc, const uint8_t* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    crc = kCrcTable.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+uint32_t UpdateAdler(uint32_t adler, const uint8_t* data, size_t size) {
+  // 5552 is the largest run for which the sums cannot overflow 32 bits
+  constexpr uint32_t kBase = 65521;
+  uint32_t a = adler & 0xFFFF;
+  uint32_t b = adler >> 16;
+  while (size > 0) {
+    const size_t block = size < 5552 ? size : 5552;
+    for (size_t i = 0; i < block; ++i) {
+      a += data[i];
+      b += a;
+    }
+    a %= kBase;
+    b %= kBase;
+    data += block;
+    size -= block;
+  }
+  return (b << 16) | a;
+}
+
+void PutBigEndian(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+uint16_t ReverseBits(uint16_t code, int length) {
+  uint16_t reversed = 0;
+  for (int i = 0; i < length; ++i) {
+    reversed = static_cast<uint16_t>((reversed << 1) | ((code >> i) & 1));
+  }
+  return reversed;
+}
+
+struct HuffmanCode {
+  uint16_t bits;  // already bit-reversed for LSB-first output
+  uint8_t length;
+};
+
+// Fixed literal/length code from RFC 1951, section 3.2.6
+struct FixedLiteralTable {
+  HuffmanCode codes[288];
+
+  FixedLiteralTable() : codes() {
+    for (int symbol = 0; symbol < 288; ++symbol) {
+      uint16_t code;
+      int length;
+      if (symbol < 144) {
+        code = static_cast<uint16_t>(0x30 + symbol);
+        length = 8;
+      } else if (symbol < 256) {
+        code = static_cast<uint16_t>(0x190 + symbol - 144);
+        length = 9;
+      } else if (symbol < 280) {
+        code = static_cast<uint16_t>(symbol - 256);
+        length = 7;
+      } else {
+        code = static_cast<uint16_t>(0xC0 + symbol - 280);
+        length = 8;
+      }
+      codes[symbol] = {ReverseBits(code, length), static_cast<uint8_t>(length)};
+    }
+  }
+};
+
+// Length code symbol and extra bits for every match length 3-258
+struct LengthTable {
+  struct Entry {
+    uint16_t symbol;
+    uint8_t extra_bits;
+    uint8_t extra_value;
+  };
+  Entry entries[kMaxMatch + 1];
+
+  LengthTable() : entries() {
+    static const uint16_t kBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                     31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t kExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                     2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    for (int code = 0; code < 29; ++code) {
+      const int span = code == 28 ? 1 : (1 << kExtra[code]);
+      for (int offset = 0; offset < span; ++offset) {
+        const int length = kBase[code] + offset;
+        if (length <= kMaxMatch) {
+          entries[length] = {static_cast<uint16_t>(257 + code), kExtra[code],
+                             static_cast<uint8_t>(offset)};
+        }
+      }
+    }
+  }
+};
+
+const FixedLiteralTable& GetFixedLiteralTable() {
+  static const FixedLiteralTable table;
+  return table;
+}
+
+const LengthTable& GetLengthTable() {
+  static const LengthTable table;
+  return table;
+}
+
+// Collects IDAT payload and forwards complete chunks to the sink. Stops
+// writing after the first sink failure.
+class ChunkWriter {
+ public:
+  explicit ChunkWriter(const ByteSink& sink) : sink_(sink) {
+    buffer_.reserve(kChunkHeaderSize + kChunkCapacity + 4);
+    buffer_.resize(kChunkHeaderSize);
+  }
+
+  bool ok() const { return ok_; }
+
+  void PutByte(uint8_t byte) {
+    buffer_.push_back(byte);
+    if (buffer_.size() - kChunkHeaderSize >= kChunkCapacity) {
+      FlushData();
+    }
+  }
+
+  void PutBytes(const uint8_t* data, size_t size) {
+    while (size > 0) {
+      const size_t room = kChunkHeaderSize + kChunkCapacity - buffer_.size();
+      const size_t count = size < room ? size : room;
+      buffer_.insert(buffer_.end(), data, data + count);
+      data += count;
+      size -= count;
+      if (buffer_.size() - kChunkHeaderSize >= kChunkCapacity) {
+        FlushData();
+      }
+    }
+  }
+
+  // Emits the pending payload as an IDAT chunk
+  void FlushData() {
+    if (buffer_.size() > kChunkHeaderSize) {
+      EmitBuffer("IDAT");
+    }
+  }
+
+  // Emits a complete non-IDAT chunk
+  void WriteChunk(const char* type, const uint8_t* data, size_t size) {
+    FlushData();
+    buffer_.insert(buffer_.end(), data, data + size);
+    EmitBuffer(type);
+  }
+
+  void WriteRaw(const uint8_t* data, size_t size) {
+    if (ok_ && !sink_(data, size)) {
+      ok_ = false;
+    }
+  }
+
+ private:
+  void EmitBuffer(const char* type) {
+    const size_t size = buffer_.size() - kChunkHeaderSize;
+    PutBigEndian(&buffer_[0], static_cast<uint32_t>(size));
+    memcpy(&buffer_[4], type, 4);
+    const uint32_t crc = UpdateCrc(0xFFFFFFFFu, &buffer_[4], size + 4) ^ 0xFFFFFFFFu;
+    uint8_t trailer[4];
+    PutBigEndian(trailer, crc);
+    buffer_.insert(buffer_.end(), trailer, trailer + 4);
+    WriteRaw(buffer_.data(), buffer_.size());
+    buffer_.resize(kChunkHeaderSize);
+  }
+
+  const ByteSink& sink_;
+  std::vector<uint8_t> buffer_;
+  bool ok_ = true;
+};
+
+// Deflate stream of uncompressed blocks
+class StoredDeflater {
+ public:
+  explicit StoredDeflater(ChunkWriter& out) : out_(out) { pending_.reserve(kMaxStoredBlock); }
+
+  void Write(const uint8_t* data, size_t size) {
+    while (size > 0) {
+      const size_t room = kMaxStoredBlock - pending_.size();
+      const size_t count = size < room ? size : room;
+      pending_.insert(pending_.end(), data, data + count);
+      data += count;
+      size -= count;
+      if (pending_.size() == kMaxStoredBlock) {
+        EmitBlock(false);
+      }
+    }
+  }
+
+  void Finish() { EmitBlock(true); }
+
+ private:
+  void EmitBlock(bool final_block) {
+    const uint16_t length = static_cast<uint16_t>(pending_.size());
+    const uint8_t header[5] = {static_cast<uint8_t>(final_block ? 1 : 0),
+                               static_cast<uint8_t>(length),
+                               static_cast<uint8_t>(length >> 8),
+                               static_cast<uint8_t>(~length),
+                               static_cast<uint8_t>(~length >> 8)};
+    out_.PutBytes(header, sizeof(header));
+    out_.PutBytes(pending_.data(), pending_.size());
+    pending_.clear();
+  }
+
+  ChunkWriter& out_;
+  std::vector<uint8_t> pending_;
+};
+
+// Distance code and extra bits for a match distance (RFC 1951, 3.2.5)
+struct DistanceCode {
+  uint16_t bits;  // bit-reversed 5-bit code
+  uint8_t extra_bits;
+  uint16_t extra_value;
+};
+
+DistanceCode GetDistanceCode(int distance) {
+  static const uint16_t kBase[] = {1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+                                   33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+                                   1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+  int code = 29;
+  while (kBase[code] > distance) {
+    --code;
+  }
+  const uint8_t extra_bits = code < 4 ? 0 : static_cast<uint8_t>(code / 2 - 1);
+  return {ReverseBits(static_cast<uint16_t>(code), 5), extra_bits,
+          static_cast<uint16_t>(distance - kBase[code])};
+}
+
+// Single fixed-Huffman deflate block with a greedy matcher that only tries
+// three distances: the previous byte, the previous pixel and the byte one row
+// above. Filtered icon rows are dominated by exactly these repeats, so this
+// gets most of zlib's gain without hash chains.
+class RunLengthDeflater {
+ public:
+  explicit RunLengthDeflater(ChunkWriter& out)
+      : out_(out), literals_(GetFixedLiteralTable()), lengths_(GetLengthTable()) {
+    PutBits(1, 1);  // BFINAL
+    PutBits(1, 2);  // BTYPE = fixed Huffman
+  }
+
+  // |size| must be the same for every call (one filtered row)
+  void Write(const uint8_t* data, size_t size) {
+    // Keep the previous row in front of the current one so matches can
+    // reach back across the row boundary.
+    const size_t start = window_.size();
+    window_.insert(window_.end(), data, data + size);
+
+    const int row_distance = static_cast<int>(size);
+    const int distances[] = {1, 4, row_distance <= kMaxDistance ? row_distance : 0};
+    const DistanceCode codes[] = {GetDistanceCode(1), GetDistanceCode(4),
+                                  GetDistanceCode(distances[2] > 0 ? distances[2] : 1)};
+
+    const size_t end = window_.size();
+    size_t i = start;
+    while (i < end) {
+      int best_length = 0;
+      int best = 0;
+      for (int candidate = 0; candidate < 3; ++candidate) {
+        const size_t distance = static_cast<size_t>(distances[candidate]);
+        if (distance == 0 || distance > i) {
+          continue;
+        }
+        int length = 0;
+        while (i + length < end && length < kMaxMatch &&
+               window_[i + length] == window_[i + length - distance]) {
+          ++length;
+        }
+        if (length > best_length) {
+          best_length = length;
+          best = candidate;
+        }
+      }
+
+      if (best_length >= kMinMatch) {
+        PutMatch(best_length, codes[best]);
+        i += best_length;
+      } else {
+        PutSymbol(window_[i]);
+        ++i;
+      }
+    }
+
+    window_.erase(window_.begin(), window_.begin() + start);
+  }
+
+  void Finish() {
+    PutSymbol(256);
+    if (bit_count_ > 0) {
+      out_.PutByte(static_cast<uint8_t>(bits_));
+      bits_ = 0;
+      bit_count_ = 0;
+    }
+  }
+
+ private:
+  static constexpr int kMaxDistance = 32768;
+
+  void PutBits(uint32_t value, int count) {
+    bits_ |= static_cast<uint64_t>(value) << bit_count_;
+    bit_count_ += count;
+    while (bit_count_ >= 8) {
+      out_.PutByte(static_cast<uint8_t>(bits_));
+      bits_ >>= 8;
+      bit_count_ -= 8;
+    }
+  }
+
+  void PutSymbol(int symbol) {
+    const HuffmanCode& code = literals_.codes[symbol];
+    PutBits(code.bits, code.length);
+  }
+
+  void PutMatch(int length, const DistanceCode& distance) {
+    const LengthTable::Entry& entry = lengths_.entries[length];
+    PutSymbol(entry.symbol);
+    if (entry.extra_bits > 0) {
+      PutBits(entry.extra_value, entry.extra_bits);
+    }
+    PutBits(distance.bits, 5);
+    if (distance.extra_bits > 0) {
+      PutBits(distance.extra_value, distance.extra_bits);
+    }
+  }
+
+  ChunkWriter& out_;
+  const FixedLiteralTable& literals_;
+  const LengthTable& lengths_;
+  std::vector<uint8_t> window_;
+  uint64_t bits_ = 0;
+  int bit_count_ = 0;
+};
+
+// Writes |row| filtered with PNG filter |type| (0 = None, 1 = Sub, 2 = Up)
+// into |out|, including the leading filter-type byte.
+void FilterRow(const uint8_t* row,
+               const uint8_t* above,
+               size_t row_bytes,
+               uint8_t type,
+               uint8_t* out) {
+  out[0] = type;
+  ++out;
+  if (type == 1) {
+    memcpy(out, row, row_bytes < 4 ? row_bytes : 4);
+    for (size_t i = 4; i < row_bytes; ++i) {
+      out[i] = static_cast<uint8_t>(row[i] - row[i - 4]);
+    }
+  } else if (type == 2) {
+    for (size_t i = 0; i < row_bytes; ++i) {
+      out[i] = static_cast<uint8_t>(row[i] - above[i]);
+    }
+  } else {
+    memcpy(out, row, row_bytes);
+  }
+}
+
+// Sum of absolute signed residuals; the usual heuristic for picking a filter
+size_t FilterCost(const uint8_t* filtered, size_t row_bytes) {
+  size_t cost = 0;
+  for (size_t i = 1; i <= row_bytes; ++i) {
+    cost += static_cast<size_t>(std::abs(static_cast<int8_t>(filtered[i])));
+  }
+  return cost;
+}
+
+// Filters every row and feeds it to |deflater|. Store mode skips filtering,
+// since nothing is gained from it without compression. Returns the Adler-32
+// checksum of the filtered stream.
+template <typename Deflater>
+uint32_t WriteRows(const uint8_t* rgba,
+                   int height,
+                   size_t stride,
+                   size_t row_bytes,
+                   bool filter,
+                   const ChunkWriter& writer,
+                   Deflater& deflater) {
+  uint32_t adler = 1;
+  std::vector<uint8_t> sub(row_bytes + 1);
+  std::vector<uint8_t> up(row_bytes + 1);
+  for (int y = 0; y < height && writer.ok(); ++y) {
+    const uint8_t* row = rgba + static_cast<size_t>(y) * stride;
+    const uint8_t* filtered = sub.data();
+    if (!filter) {
+      FilterRow(row, nullptr, row_bytes, 0, sub.data());
+    } else {
+      FilterRow(row, nullptr, row_bytes, 1, sub.data());
+      if (y > 0) {
+        FilterRow(row, row - stride, row_bytes, 2, up.data());
+        if (FilterCost(up.data(), row_bytes) < FilterCost(sub.data(), row_bytes)) {
+          filtered = up.data();
+        }
+      }
+    }
+    adler = UpdateAdler(adler, filtered, row_bytes + 1);
+    deflater.Write(filtered, row_bytes + 1);
+  }
+  deflater.Finish();
+  return adler;
+}
+
+}  // namespace
+
+bool PngEncoder::Encode(const uint8_t* rgba,
+                        int width,
+                        int height,
+                        size_t stride,
+                        PngEncodeMode mode,
+                        const ByteSink& sink) {
+  if (!rgba || width <= 0 || height <= 0 || !sink) {
+    return false;
+  }
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  if (stride < row_bytes) {
+    return false;
+  }
+
+  ChunkWriter writer(sink);
+
+  static const uint8_t kSignature[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+  writer.WriteRaw(kSignature, sizeof(kSignature));
+
+  uint8_t ihdr[13];
+  PutBigEndian(ihdr, static_cast<uint32_t>(width));
+  PutBigEndian(ihdr + 4, static_cast<uint32_t>(height));
+  ihdr[8] = 8;   // bit depth
+  ihdr[9] = 6;   // color type: RGBA
+  ihdr[10] = 0;  // deflate
+  ihdr[11] = 0;  // adaptive filtering
+  ihdr[12] = 0;  // no interlace
+  writer.WriteChunk("IHDR", ihdr, sizeof(ihdr));
+
+  // zlib header: deflate, 32K window, fastest-compression hint
+  const uint8_t zlib_header[2] = {0x78, 0x01};
+  writer.PutBytes(zlib_header, sizeof(zlib_header));
+
+  uint32_t adler;
+  if (mode == PngEncodeMode::Store) {
+    StoredDeflater deflater(writer);
+    adler = WriteRows(rgba, height, stride, row_bytes, false, writer, deflater);
+  } else {
+    RunLengthDeflater deflater(writer);
+    adler = WriteRows(rgba, height, stride, row_bytes, true, writer, deflater);
+  }
+
+  uint8_t adler_bytes[4];
+  PutBigEndian(adler_bytes, adler);
+  writer.PutBytes(adler_bytes, sizeof(adler_bytes));
+  writer.FlushData();
+  writer.WriteChunk("IEND", nullptr, 0);
+  return writer.ok();
+}
+
+}  // namespace nativeapi
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace nativeapi {
+
+/**
+ * @brief How PNG data is compressed.
+ */
+enum class PngEncodeMode {
+  /**
+   * The platform encoder (gdk-pixbuf, GDI+, ImageIO) at the requested
+   * compression level. Smallest output, slowest.
+   */
+  Default,
+
+  /**
+   * Built-in single-pass encoder: Sub/Up row filters and run-length deflate
+   * with fixed Huffman codes. Several times faster than Default and still
+   * compact for flat-colored icons.
+   */
+  Fast,
+
+  /**
+   * Built-in encoder writing uncompressed deflate blocks. Fastest; the output
+   * is slightly larger than the raw pixels.
+   */
+  Store
+};
+
+/**
+ * @brief Receives encoded bytes in order.
+ *
+ * Returning false aborts encoding.
+ */
+using ByteSink = std::function<bool(const uint8_t* data, size_t size)>;
+
+/**
+ * @brief Minimal streaming PNG writer for 8-bit RGBA pixels.
+ *
+ * Output is produced in IDAT chunks of at most 64 KiB and handed to the sink
+ * as soon as each chunk is complete, so encoding never holds the whole file
+ * in memory.
+ *
+ * @example
+ * ```cpp
+ * std::vector<uint8_t> png;
+ * PngEncoder::Encode(pixels.data(), 32, 32, 32 * 4, PngEncodeMode::Fast,
+ *                    [&](const uint8_t* data, size_t size) {
+ *                      png.insert(png.end(), data, data + size);
+ *                      return true;
+ *                    });
+ * ```
+ */
+class PngEncoder {
+ public:
+  /**
+   * @brief Encode straight-alpha RGBA pixels.
+   *
+   * @param rgba Source pixels
+   * @param width Width in pixels
+   * @param height Height in pixels
+   * @param stride Bytes between the starts of consecutive rows
+   * @param mode Fast or Store; Default is treated as Fast
+   * @param sink Receives the encoded file
+   * @return false if the arguments are invalid or the sink aborted
+   */
+  static bool Encode(const uint8_t* rgba,
+                     int width,
+                     int height,
+                     size_t stride,
+                     PngEncodeMode mode,
+                     const ByteSink& sink);
+};
+
+}  // namespace nativeapi
@@ -0,0 +1,73 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+
+namespace nativeapi {
+
+namespace {
+
+size_t DefaultThreadCount() {
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  // Leave a core for the UI thread; decoding small icons does not need more.
+  return std::clamp<size_t>(hardware > 1 ? hardware - 1 : 1, 1, 4);
+}
+
+}  // namespace
+
+WorkerPool::WorkerPool(size_t thread_count)
+    : thread_count_(thread_count > 0 ? thread_count : DefaultThreadCount()) {}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+  }
+  condition_.notify_all();
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+WorkerPool& WorkerPool::GetShared() {
+  static WorkerPool instance;
+  return instance;
+}
+
+void WorkerPool::Submit(Task task) {
+  if (!task) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+    queue_.push_back(std::move(task));
+    // Threads are started on demand until the pool reaches its capacity
+    if (threads_.size() < thread_count_) {
+      threads_.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+  }
+  condition_.notify_one();
+}
+
+void WorkerPool::WorkerLoop() {
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace nativeapi
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nativeapi {
+
+/**
+ * @brief Fixed-size pool of worker threads executing queued tasks in FIFO
+ * order.
+ *
+ * Used for work that must not block the UI thread, such as decoding images.
+ * Tasks still queued when the pool is destroyed are discarded; tasks that are
+ * already running are allowed to finish.
+ *
+ * Thread Safety: All public methods are thread-safe.
+ */
+class WorkerPool {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Create a pool with @p thread_count workers.
+   *
+   * @param thread_count Number of threads; 0 selects a default based on the
+   *                     hardware concurrency.
+   */
+  explicit WorkerPool(size_t thread_count = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Get the process-wide pool shared by the library.
+   *
+   * Threads are started lazily on first use.
+   */
+  static WorkerPool& GetShared();
+
+  /**
+   * @brief Queue a task for execution on one of the worker threads.
+   */
+  void Submit(Task task);
+
+  /**
+   * @brief Number of worker threads in the pool.
+   */
+  size_t GetThreadCount() const { return thread_count_; }
+
+ private:
+  void WorkerLoop();
+
+  const size_t thread_count_;
+  std::vector<std::thread> threads_;
+  std::deque<Task> queue_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stopping_ = false;
+};
+
+}  // namespace nativeapi
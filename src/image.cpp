@@ -0,0 +1,293 @@
+#include "image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#include "foundation/base64.h"
+#include "foundation/worker_pool.h"
+#include "main_thread.h"
+
+namespace nativeapi {
+
+namespace {
+
+enum class DecodeTaskState { Pending, Cancelled, Completed };
+
+const char* MimeTypeForFormat(ImageEncodeFormat format) {
+  switch (format) {
+    case ImageEncodeFormat::PNG:
+      return "image/png";
+    case ImageEncodeFormat::JPEG:
+      return "image/jpeg";
+    case ImageEncodeFormat::BMP:
+      return "image/bmp";
+    case ImageEncodeFormat::GIF:
+      return "image/gif";
+    case ImageEncodeFormat::TIFF:
+      return "image/tiff";
+    case ImageEncodeFormat::ICO:
+      return "image/x-icon";
+  }
+  return "application/octet-stream";
+}
+
+// Encodes @p image into @p file_path, removing the file on failure.
+// @p wrote_data reports whether the encoder produced any output.
+bool WriteEncodedFile(const Image& image,
+                      const std::string& file_path,
+                      const ImageEncodeOptions& options,
+                      bool& wrote_data) {
+  wrote_data = false;
+  std::ofstream file(std::filesystem::u8path(file_path), std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+  bool success = image.EncodeTo(
+      [&file, &wrote_data](const uint8_t* data, size_t size) {
+        wrote_data = true;
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(file);
+      },
+      options);
+  file.close();
+  if (!success || file.fail()) {
+    std::error_code error;
+    std::filesystem::remove(std::filesystem::u8path(file_path), error);
+    return false;
+  }
+  return true;
+}
+
+// Output format for a file name; PNG when the extension is not recognized
+ImageEncodeFormat FormatForPath(const std::string& file_path) {
+  const size_t dot = file_path.find_last_of('.');
+  if (dot == std::string::npos) {
+    return ImageEncodeFormat::PNG;
+  }
+  std::string extension = file_path.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  if (extension == "jpg" || extension == "jpeg") {
+    return ImageEncodeFormat::JPEG;
+  } else if (extension == "bmp") {
+    return ImageEncodeFormat::BMP;
+  } else if (extension == "gif") {
+    return ImageEncodeFormat::GIF;
+  } else if (extension == "tiff" || extension == "tif") {
+    return ImageEncodeFormat::TIFF;
+  } else if (extension == "ico") {
+    return ImageEncodeFormat::ICO;
+  }
+  return ImageEncodeFormat::PNG;
+}
+
+}  // namespace
+
+class ImageDecodeTask::Impl {
+ public:
+  std::atomic<DecodeTaskState> state_{DecodeTaskState::Pending};
+};
+
+ImageDecodeTask::ImageDecodeTask() : pimpl_(std::make_unique<Impl>()) {}
+
+ImageDecodeTask::~ImageDecodeTask() = default;
+
+bool ImageDecodeTask::Cancel() {
+  DecodeTaskState expected = DecodeTaskState::Pending;
+  return pimpl_->state_.compare_exchange_strong(expected, DecodeTaskState::Cancelled) ||
+         expected == DecodeTaskState::Cancelled;
+}
+
+bool ImageDecodeTask::IsCancelled() const {
+  return pimpl_->state_.load() == DecodeTaskState::Cancelled;
+}
+
+bool ImageDecodeTask::IsCompleted() const {
+  return pimpl_->state_.load() == DecodeTaskState::Completed;
+}
+
+bool ImageDecodeTask::BeginDelivery() {
+  DecodeTaskState expected = DecodeTaskState::Pending;
+  return pimpl_->state_.compare_exchange_strong(expected, DecodeTaskState::Completed);
+}
+
+// Runs a decode on the shared worker pool and hands the result to the
+// callback on the requested thread, unless the task is cancelled first.
+class ImageDecodeRunner {
+ public:
+  static std::shared_ptr<ImageDecodeTask> Start(std::function<std::shared_ptr<Image>()> decode,
+                                                ImageDecodeCallback callback,
+                                                ImageCallbackContext context) {
+    auto task = std::make_shared<ImageDecodeTask>();
+    if (context == ImageCallbackContext::MainThread && !IsMainThreadDispatchSupported()) {
+      // The result could never be delivered; report a failure instead
+      WorkerPool::GetShared().Submit([task, callback = std::move(callback)]() {
+        Deliver(*task, callback, nullptr);
+      });
+      return task;
+    }
+    WorkerPool::GetShared().Submit(
+        [task, decode = std::move(decode), callback = std::move(callback), context]() mutable {
+          if (task->IsCancelled()) {
+            return;
+          }
+          // FromFile() and FromBytes() defer the pixels; decode them here,
+          // off the UI thread
+          std::shared_ptr<Image> image = decode();
+          if (image && !image->EnsureDecoded()) {
+            image = nullptr;
+          }
+
+          if (context == ImageCallbackContext::WorkerThread) {
+            Deliver(*task, callback, std::move(image));
+            return;
+          }
+
+          // Cancellation is re-checked on the main thread so that a Cancel()
+          // issued there after decoding finished still suppresses the callback.
+          PostToMainThread(
+              [task, image = std::move(image), callback = std::move(callback)]() mutable {
+                Deliver(*task, callback, std::move(image));
+              });
+        });
+
+    return task;
+  }
+
+ private:
+  static void Deliver(ImageDecodeTask& task,
+                      const ImageDecodeCallback& callback,
+                      std::shared_ptr<Image> image) {
+    if (task.BeginDelivery() && callback) {
+      callback(std::move(image));
+    }
+  }
+};
+
+std::shared_ptr<ImageDecodeTask> Image::FromFileAsync(const std::string& file_path,
+                                                      ImageDecodeCallback callback,
+                                                      ImageCallbackContext context) {
+  return ImageDecodeRunner::Start([file_path]() { return Image::FromFile(file_path); },
+                                  std::move(callback), context);
+}
+
+std::shared_ptr<ImageDecodeTask> Image::FromBytesAsync(std::vector<uint8_t> data,
+                                                       ImageDecodeCallback callback,
+                                                       ImageCallbackContext context) {
+  return ImageDecodeRunner::Start(
+      [data = std::move(data)]() { return Image::FromBytes(data.data(), data.size()); },
+      std::move(callback), context);
+}
+
+std::shared_ptr<Image> Image::Resize(const Size& size, ResampleFilter filter) const {
+  const int dst_width = static_cast<int>(std::lround(size.width));
+  const int dst_height = static_cast<int>(std::lround(size.height));
+  if (dst_width <= 0 || dst_height <= 0) {
+    return nullptr;
+  }
+
+  std::vector<uint8_t> src;
+  int src_width = 0;
+  int src_height = 0;
+  if (!ToRawData(src, src_width, src_height, ImagePixelFormat::RGBA32)) {
+    return nullptr;
+  }
+  if (src_width == dst_width && src_height == dst_height) {
+    return FromRawData(src.data(), src_width, src_height, ImagePixelFormat::RGBA32);
+  }
+
+  std::vector<uint8_t> dst(static_cast<size_t>(dst_width) * dst_height * 4);
+  if (!ImageResampler::Resize(src.data(), src_width, src_height,
+                              static_cast<size_t>(src_width) * 4, dst.data(), dst_width,
+                              dst_height, static_cast<size_t>(dst_width) * 4, filter)) {
+    return nullptr;
+  }
+  return FromRawData(dst.data(), dst_width, dst_height, ImagePixelFormat::RGBA32);
+}
+
+bool Image::EncodeTo(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
+  if (!sink) {
+    return false;
+  }
+  if (options.format != ImageEncodeFormat::PNG || options.png_mode == PngEncodeMode::Default) {
+    return EncodeNative(sink, options);
+  }
+
+  std::vector<uint8_t> pixels;
+  int width = 0;
+  int height = 0;
+  if (!ToRawData(pixels, width, height, ImagePixelFormat::RGBA32)) {
+    return false;
+  }
+  return PngEncoder::Encode(pixels.data(), width, height, static_cast<size_t>(width) * 4,
+                            options.png_mode, sink);
+}
+
+std::string Image::ToBase64() const {
+  return ToBase64(ImageEncodeOptions());
+}
+
+std::string Image::ToBase64(const ImageEncodeOptions& options) const {
+  std::string result = "data:";
+  result += MimeTypeForFormat(options.format);
+  result += ";base64,";
+
+  // Encode whole 3-byte groups as they arrive and carry the remainder over
+  // to the next piece, so the encoded file is never buffered.
+  uint8_t carry[3];
+  size_t carry_size = 0;
+  bool success = EncodeTo(
+      [&](const uint8_t* data, size_t size) {
+        if (carry_size > 0) {
+          while (carry_size < 3 && size > 0) {
+            carry[carry_size++] = *data++;
+            --size;
+          }
+          if (carry_size < 3) {
+            return true;
+          }
+          Base64::EncodeAppend(carry, 3, result);
+          carry_size = 0;
+        }
+        const size_t whole = size - size % 3;
+        Base64::EncodeAppend(data, whole, result);
+        for (size_t i = whole; i < size; ++i) {
+          carry[carry_size++] = data[i];
+        }
+        return true;
+      },
+      options);
+  if (!success) {
+    return "";
+  }
+  Base64::EncodeAppend(carry, carry_size, result);
+  return result;
+}
+
+bool Image::SaveToFile(const std::string& file_path) const {
+  ImageEncodeOptions options;
+  options.format = FormatForPath(file_path);
+  bool wrote_data = false;
+  if (WriteEncodedFile(*this, file_path, options, wrote_data)) {
+    return true;
+  }
+  // The backend rejects formats it cannot write before producing any output;
+  // save those as PNG rather than failing.
+  if (wrote_data || options.format == ImageEncodeFormat::PNG) {
+    return false;
+  }
+  options.format = ImageEncodeFormat::PNG;
+  return WriteEncodedFile(*this, file_path, options, wrote_data);
+}
+
+bool Image::SaveToFile(const std::string& file_path, const ImageEncodeOptions& options) const {
+  bool wrote_data = false;
+  return WriteEncodedFile(*this, file_path, options, wrote_data);
+}
+
+}  // namespace nativeapi
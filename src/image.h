@@ -1,14 +1,164 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "foundation/geometry.h"
+#include "foundation/image_resampler.h"
+#include "foundation/png_encoder.h"
 #include "foundation/native_object_provider.h"
 
 namespace nativeapi {
 
+class Image;
+
+/**
+ * @brief Memory layout of raw 8-bit-per-channel pixel data.
+ *
+ * Rows are tightly packed (stride = width * 4) and alpha is not
+ * premultiplied.
+ */
+enum class ImagePixelFormat {
+  RGBA32,  ///< Bytes in R, G, B, A order
+  BGRA32   ///< Bytes in B, G, R, A order
+};
+
+/**
+ * @brief File format produced when encoding an image.
+ */
+enum class ImageEncodeFormat {
+  PNG,
+  JPEG,
+  BMP,
+  GIF,
+  TIFF,
+  ICO
+};
+
+/**
+ * @brief Options controlling how an image is encoded.
+ *
+ * Formats a platform cannot write (e.g. GIF on Linux, ICO on Windows and
+ * macOS) make encoding fail; Image::SaveToFile(const std::string&) saves
+ * those as PNG instead.
+ *
+ * @example
+ * ```cpp
+ * ImageEncodeOptions options;
+ * options.png_mode = PngEncodeMode::Fast;  // snapshot for a web view
+ * std::string uri = image->ToBase64(options);
+ * ```
+ */
+struct ImageEncodeOptions {
+  /**
+   * Output format.
+   */
+  ImageEncodeFormat format = ImageEncodeFormat::PNG;
+
+  /**
+   * PNG zlib level (0-9) for PngEncodeMode::Default, or -1 for the platform
+   * encoder's default. Ignored where the encoder has no such setting
+   * (Windows, Apple platforms).
+   */
+  int compression_level = -1;
+
+  /**
+   * JPEG quality (1-100).
+   */
+  int quality = 90;
+
+  /**
+   * PNG compression strategy. Fast and Store use the library's own encoder
+   * and behave identically on every platform.
+   */
+  PngEncodeMode png_mode = PngEncodeMode::Default;
+};
+
+/**
+ * @brief Receives encoded image bytes in order; return false to abort.
+ */
+using ImageEncodeSink = ByteSink;
+
+/**
+ * @brief Thread on which an asynchronous image decode reports its result.
+ */
+enum class ImageCallbackContext {
+  /**
+   * The callback runs on the worker thread that decoded the image, as soon
+   * as decoding finishes. The callback must not touch UI objects.
+   */
+  WorkerThread,
+
+  /**
+   * The callback is posted to the main (UI) thread's event loop (see
+   * PostToMainThread()). On Windows and Android, call
+   * PrepareMainThreadDispatcher() from the main thread first.
+   *
+   * On OpenHarmony, where the library cannot reach that loop, the callback
+   * instead runs on a worker thread with a null image.
+   */
+  MainThread
+};
+
+/**
+ * @brief Callback receiving the result of an asynchronous decode.
+ *
+ * @param image The decoded image, or nullptr if loading or decoding failed
+ */
+using ImageDecodeCallback = std::function<void(std::shared_ptr<Image> image)>;
+
+/**
+ * @brief Handle to an asynchronous image decode started by
+ * Image::FromFileAsync() or Image::FromBytesAsync().
+ *
+ * Thread Safety: All methods are thread-safe.
+ */
+class ImageDecodeTask {
+ public:
+  ImageDecodeTask();
+  ~ImageDecodeTask();
+
+  ImageDecodeTask(const ImageDecodeTask&) = delete;
+  ImageDecodeTask& operator=(const ImageDecodeTask&) = delete;
+
+  /**
+   * @brief Cancel the decode.
+   *
+   * If the task has not started yet it is skipped entirely; if it is being
+   * decoded the result is discarded.
+   *
+   * @return true if the callback is guaranteed not to be invoked, false if it
+   *         has already run or is about to run
+   */
+  bool Cancel();
+
+  /**
+   * @brief Check whether Cancel() succeeded.
+   */
+  bool IsCancelled() const;
+
+  /**
+   * @brief Check whether the result has been delivered to the callback.
+   */
+  bool IsCompleted() const;
+
+ private:
+  friend class ImageDecodeRunner;
+
+  /**
+   * @brief Claim the right to deliver the result; fails once cancelled.
+   */
+  bool BeginDelivery();
+
+  class Impl;
+  std::unique_ptr<Impl> pimpl_;
+};
+
 /**
  * @brief Image class for cross-platform image handling.
  *
@@ -22,8 +172,9 @@ namespace nativeapi {
  * Features:
  * - Load images from file paths
  * - Load images from base64-encoded strings
- * - Automatic format detection and conversion
- * - Memory-efficient internal representation
+ * - Automatic format detection from the encoded data's magic bytes
+ * - Memory-efficient internal representation: format and size are read from
+ *   the image header and pixels are decoded lazily on first native use
  *
  * @note This class uses the PIMPL idiom to hide platform-specific
  * implementation details and ensure binary compatibility.
@@ -103,6 +254,12 @@ class Image : public NativeObjectProvider {
    * Loads an image from the specified file path on disk. The image format
    * is automatically detected based on the file contents.
    *
+   * Only the file header is read by this call. For formats whose header
+   * carries the dimensions (PNG, JPEG, GIF, BMP, ICO, WebP, TIFF) the pixels
+   * are decoded on first native use (GetNativeObject(), ToBase64(),
+   * SaveToFile()); if decoding fails at that point the native object is
+   * null. Other formats are decoded immediately.
+   *
    * @param file_path Path to the image file
    * @return A shared pointer to the created Image, or nullptr if loading failed
    *
@@ -126,13 +283,17 @@ class Image : public NativeObjectProvider {
    *
    * Decodes and loads an image from a base64-encoded string. The string
    * can optionally include a data URI prefix (e.g., "data:image/png;base64,").
+   * The prefix is skipped in place and the payload is decoded directly into
+   * the buffer handed to the platform decoder, so no intermediate copies of
+   * the input are made.
    *
    * @param base64_data Base64-encoded image data, with or without data URI
    * prefix
    * @return A shared pointer to the created Image, or nullptr if decoding
    * failed
    *
-   * @note The image format is automatically detected from the decoded data.
+   * @note The image format is automatically detected from the decoded data,
+   * and pixel decoding is deferred as described for FromFile().
    *
    * @example
    * ```cpp
@@ -143,16 +304,136 @@ class Image : public NativeObjectProvider {
    * auto image2 = Image::FromBase64("iVBORw0KGgo...");
    * ```
    */
-  static std::shared_ptr<Image> FromBase64(const std::string& base64_data);
+  static std::shared_ptr<Image> FromBase64(std::string_view base64_data);
+
+  /**
+   * @brief Create an image from encoded image bytes held in memory.
+   *
+   * @param data Pointer to the encoded image (PNG, JPEG, ...)
+   * @param size Number of bytes at @p data
+   * @return A shared pointer to the created Image, or nullptr if decoding
+   * failed
+   *
+   * @note The bytes are only read during the call and may be released
+   * afterwards.
+   */
+  static std::shared_ptr<Image> FromBytes(const uint8_t* data, size_t size);
+
+  /**
+   * @brief Create an image from raw pixel data.
+   *
+   * @param pixels Tightly packed pixels, width * height * 4 bytes
+   * @param width Width in pixels
+   * @param height Height in pixels
+   * @param format Channel order of @p pixels
+   * @return A shared pointer to the created Image, or nullptr on invalid input
+   *
+   * @example
+   * ```cpp
+   * std::vector<uint8_t> pixels(32 * 32 * 4, 0xFF);
+   * auto image = Image::FromRawData(pixels.data(), 32, 32, ImagePixelFormat::RGBA32);
+   * ```
+   */
+  static std::shared_ptr<Image> FromRawData(const uint8_t* pixels,
+                                            int width,
+                                            int height,
+                                            ImagePixelFormat format = ImagePixelFormat::RGBA32);
+
+  /**
+   * @brief Load and decode an image file on a worker thread.
+   *
+   * Returns immediately. File I/O and decoding run on the library's shared
+   * worker pool, keeping the calling (UI) thread responsive when loading
+   * many or large images.
+   *
+   * @param file_path Path to the image file
+   * @param callback Receives the decoded image, or nullptr on failure. Not
+   *                 invoked if the task is cancelled.
+   * @param context Thread on which @p callback runs
+   * @return Handle that can be used to cancel the decode
+   *
+   * @example
+   * ```cpp
+   * auto task = Image::FromFileAsync(
+   *     "/path/to/icon.png",
+   *     [tray](std::shared_ptr<Image> image) {
+   *       if (image) {
+   *         tray->SetIcon(image);
+   *       }
+   *     },
+   *     ImageCallbackContext::MainThread);
+   *
+   * // Later, if the result is no longer needed:
+   * task->Cancel();
+   * ```
+   */
+  static std::shared_ptr<ImageDecodeTask> FromFileAsync(
+      const std::string& file_path,
+      ImageDecodeCallback callback,
+      ImageCallbackContext context = ImageCallbackContext::MainThread);
+
+  /**
+   * @brief Decode encoded image bytes on a worker thread.
+   *
+   * The bytes are moved into the task, so the caller does not need to keep
+   * them alive.
+   *
+   * @param data Encoded image bytes
+   * @param callback Receives the decoded image, or nullptr on failure. Not
+   *                 invoked if the task is cancelled.
+   * @param context Thread on which @p callback runs
+   * @return Handle that can be used to cancel the decode
+   */
+  static std::shared_ptr<ImageDecodeTask> FromBytesAsync(
+      std::vector<uint8_t> data,
+      ImageDecodeCallback callback,
+      ImageCallbackContext context = ImageCallbackContext::MainThread);
 
   /**
    * @brief Get the size of the image in pixels.
    *
+   * For an ICO image the size comes from its largest directory entry until
+   * the pixels are decoded, and from the decoded entry afterwards.
+   *
    * @return The image size with width and height as double values,
    *         or Size(0,0) if the image is invalid
    */
   Size GetSize() const;
 
+  /**
+   * @brief Read the image's pixels.
+   *
+   * @param pixels Receives width * height * 4 tightly packed bytes
+   * @param width Receives the width in pixels
+   * @param height Receives the height in pixels
+   * @param format Channel order to produce
+   * @return false if the image could not be decoded
+   */
+  bool ToRawData(std::vector<uint8_t>& pixels,
+                 int& width,
+                 int& height,
+                 ImagePixelFormat format = ImagePixelFormat::RGBA32) const;
+
+  /**
+   * @brief Create a resampled copy of the image.
+   *
+   * Resampling is done by the library's own separable resampler in
+   * premultiplied alpha, so results are identical on every platform and
+   * transparent regions do not darken icon edges.
+   *
+   * @param size Target size in pixels (rounded to whole pixels)
+   * @param filter Reconstruction filter
+   * @return The resized image, or nullptr if the size is empty or the image
+   *         could not be decoded
+   *
+   * @example
+   * ```cpp
+   * auto menu_icon = image->Resize({16, 16}, ResampleFilter::Lanczos3);
+   * ```
+   */
+  std::shared_ptr<Image> Resize(const Size& size,
+                                ResampleFilter filter = ResampleFilter::Lanczos3) const;
+
   /**
    * @brief Get the image format string for debugging purposes.
    *
@@ -161,6 +442,17 @@ class Image : public NativeObjectProvider {
    */
   std::string GetFormat() const;
 
+  /**
+   * @brief Check whether the pixels are decoded.
+   *
+   * FromFile() and FromBytes() only read the header of formats that carry
+   * their dimensions there and decode the pixels on first use; the async
+   * factories hand out images that are already decoded.
+   *
+   * @return true if the pixels are decoded, false if they are still deferred
+   */
+  bool IsDecoded() const;
+
   /**
    * @brief Convert the image to base64-encoded PNG data.
    *
@@ -179,6 +471,41 @@ class Image : public NativeObjectProvider {
    */
   std::string ToBase64() const;
 
+  /**
+   * @brief Convert the image to a base64 data URI using @p options.
+   *
+   * The encoder output is base64-encoded as it is produced, without an
+   * intermediate copy of the encoded file.
+   *
+   * @return Data URI with the mime type of @p options.format, or empty string
+   * on error
+   */
+  std::string ToBase64(const ImageEncodeOptions& options) const;
+
+  /**
+   * @brief Encode the image and stream the result into @p sink.
+   *
+   * The sink may be called several times with consecutive pieces of the
+   * file, which lets callers append to a preallocated buffer or write to a
+   * file descriptor directly. A still-encoded PNG source requested as PNG
+   * with default options is passed through without decoding.
+   *
+   * @param sink Receives the encoded bytes; returning false aborts encoding
+   * @param options Encoding options
+   * @return true if the whole image was encoded and accepted by the sink
+   *
+   * @example
+   * ```cpp
+   * ImageEncodeOptions options;
+   * options.png_mode = PngEncodeMode::Store;
+   * image->EncodeTo([fd](const uint8_t* data, size_t size) {
+   *   return write(fd, data, size) == static_cast<ssize_t>(size);
+   * }, options);
+   * ```
+   */
+  bool EncodeTo(const ImageEncodeSink& sink,
+                const ImageEncodeOptions& options = ImageEncodeOptions()) const;
+
   /**
    * @brief Save the image to a file.
    *
@@ -189,7 +516,8 @@ class Image : public NativeObjectProvider {
    * @return true if saved successfully, false otherwise
    *
    * @note Supported output formats depend on the platform but typically
-   *       include PNG, JPEG, BMP, and TIFF.
+   *       include PNG, JPEG, BMP, and TIFF. When the platform cannot write
+   *       the format the extension names, the file is saved as PNG data.
    *
    * @example
    * ```cpp
@@ -199,6 +527,17 @@ class Image : public NativeObjectProvider {
    */
   bool SaveToFile(const std::string& file_path) const;
 
+  /**
+   * @brief Save the image to a file using @p options.
+   *
+   * The format comes from @p options, not from the file extension.
+   *
+   * @param file_path Path where the image should be saved
+   * @param options Encoding options
+   * @return true if saved successfully, false otherwise
+   */
+  bool SaveToFile(const std::string& file_path, const ImageEncodeOptions& options) const;
+
  protected:
   /**
    * @brief Internal method to get the platform-specific native image object.
@@ -211,6 +550,8 @@ class Image : public NativeObjectProvider {
   void* GetNativeObjectInternal() const override;
 
  private:
+  friend class ImageDecodeRunner;
+
   /**
    * @brief Private default constructor for use by factory methods.
    *
@@ -219,6 +560,23 @@ class Image : public NativeObjectProvider {
    */
   Image();
 
+  /**
+   * @brief Encode with the platform's native encoder.
+   *
+   * Implemented per platform; EncodeTo() handles the built-in PNG modes.
+   */
+  bool EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const;
+
+  /**
+   * @brief Decode deferred pixels now; used by the async factories so that
+   * the decode happens on the worker instead of at first use.
+   *
+   * Implemented per platform.
+   *
+   * @return true if the pixels are decoded
+   */
+  bool EnsureDecoded() const;
+
   /**
    * @brief Private implementation class using the PIMPL idiom.
    *
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+
+namespace nativeapi {
+
+/**
+ * @brief Queue @p task to run on the main (UI) thread.
+ *
+ * The task always runs asynchronously from a later iteration of the
+ * platform event loop, even when called from the main thread itself. Use it
+ * to deliver results produced on worker threads to code that touches UI
+ * objects.
+ *
+ * Implemented per platform:
+ * - Linux: idle source on the default GLib main context
+ * - macOS/iOS: main dispatch queue
+ * - Windows: message-only window owned by the thread that first called
+ *   PrepareMainThreadDispatcher()
+ * - Android: pipe watched by the main thread's ALooper
+ * - OpenHarmony: not supported; the task is dropped and an error logged.
+ *   Callers that promise a completion must check
+ *   IsMainThreadDispatchSupported() first.
+ *
+ * On Windows and Android the dispatcher is set up from the main thread.
+ * Windows cannot tell which thread that is, so it is the first thread to
+ * call PrepareMainThreadDispatcher(); Application::Run() and the Menu
+ * constructors do. On Android, the main thread's first PostToMainThread()
+ * also sets it up. Tasks posted before that stay queued.
+ */
+void PostToMainThread(std::function<void()> task);
+
+/**
+ * @brief Set up main-thread delivery ahead of time.
+ *
+ * Call from the main thread before handing work to another thread that will
+ * use PostToMainThread(). Only Windows and Android need this (the dispatcher
+ * must be created by the main thread); elsewhere it is a no-op. On Windows
+ * the first calling thread is taken to be the main thread and must run a
+ * message loop; later calls do nothing. On Android, calls from other threads
+ * do nothing.
+ */
+void PrepareMainThreadDispatcher();
+
+/**
+ * @brief Whether PostToMainThread() can run tasks on this platform.
+ *
+ * False on OpenHarmony, whose main event loop belongs to the ArkTS runtime.
+ */
+bool IsMainThreadDispatchSupported();
+
+}  // namespace nativeapi
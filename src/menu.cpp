@@ -1,3 +1,1116 @@
 #include "menu.h"
 
-namespace nativeapi {}  // namespace nativeapi
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "foundation/worker_pool.h"
+#include "image.h"
+#include "main_thread.h"
+#include "menu_event.h"
+#include "menu_model.h"
+
+namespace nativeapi {
+
+// Menu::Apply() is implemented once on top of the public Menu/MenuItem API,
+// so every platform backend gets it without platform code.
+struct Menu::AppliedModel {
+  struct Entry {
+    std::shared_ptr<MenuItem> item;
+    MenuItemDescriptor descriptor;  // as last applied to |item|
+  };
+  std::unordered_map<std::string, Entry> entries;  // by effective key
+};
+
+namespace {
+
+// Items without a key, or with a key already used by an earlier sibling,
+// are identified by position. The leading NUL keeps these apart from any
+// key an application would choose.
+std::string PositionalKey(size_t index) {
+  return std::string(1, '\0') + std::to_string(index);
+}
+
+bool IsCheckable(MenuItemType type) {
+  return type == MenuItemType::Checkbox || type == MenuItemType::Radio;
+}
+
+// Marks the elements of |values| that form a longest strictly increasing
+// subsequence (patience sorting, O(n log n)). Kept items on it stay where
+// they are; every other kept item has to move.
+std::vector<bool> LongestIncreasingSubsequence(const std::vector<size_t>& values) {
+  std::vector<size_t> tails;  // index into |values| of the smallest tail per length
+  std::vector<size_t> previous(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    size_t low = 0;
+    size_t high = tails.size();
+    while (low < high) {
+      const size_t middle = (low + high) / 2;
+      if (values[tails[middle]] < values[i]) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    previous[i] = low > 0 ? tails[low - 1] : i;
+    if (low == tails.size()) {
+      tails.push_back(i);
+    } else {
+      tails[low] = i;
+    }
+  }
+
+  std::vector<bool> result(values.size(), false);
+  if (!tails.empty()) {
+    size_t i = tails.back();
+    while (true) {
+      result[i] = true;
+      if (previous[i] == i) {
+        break;
+      }
+      i = previous[i];
+    }
+  }
+  return result;
+}
+
+void ApplySubmenu(MenuItem& item,
+                  const std::shared_ptr<const MenuModel>& model,
+                  MenuApplyStats& stats) {
+  std::shared_ptr<Menu> submenu = item.GetSubmenu();
+  if (!model) {
+    if (submenu) {
+      item.SetSubmenu(nullptr);
+      ++stats.updated;
+    }
+    return;
+  }
+
+  const bool created = !submenu;
+  if (created) {
+    submenu = std::make_shared<Menu>();
+  }
+  const MenuApplyStats nested = submenu->Apply(*model);
+  stats.inserted += nested.inserted;
+  stats.removed += nested.removed;
+  stats.moved += nested.moved;
+  stats.updated += nested.updated;
+  if (created) {
+    item.SetSubmenu(submenu);
+  }
+}
+
+std::shared_ptr<MenuItem> CreateItem(const MenuItemDescriptor& descriptor,
+                                     MenuApplyStats& stats) {
+  auto item = std::make_shared<MenuItem>(descriptor.label.value_or(""), descriptor.type);
+  if (descriptor.icon) {
+    item->SetIcon(descriptor.icon);
+  }
+  if (descriptor.tooltip) {
+    item->SetTooltip(descriptor.tooltip);
+  }
+  if (descriptor.accelerator) {
+    item->SetAccelerator(descriptor.accelerator);
+  }
+  if (!descriptor.enabled) {
+    item->SetEnabled(false);
+  }
+  if (descriptor.type == MenuItemType::Radio && descriptor.radio_group >= 0) {
+    item->SetRadioGroup(descriptor.radio_group);
+  }
+  if (IsCheckable(descriptor.type) && descriptor.state != MenuItemState::Unchecked) {
+    item->SetState(descriptor.state);
+  }
+  if (descriptor.submenu) {
+    ApplySubmenu(*item, descriptor.submenu, stats);
+  }
+  return item;
+}
+
+// Sets only the properties that differ from the last applied descriptor
+void UpdateItem(MenuItem& item,
+                const MenuItemDescriptor& applied,
+                const MenuItemDescriptor& descriptor,
+                MenuApplyStats& stats) {
+  if (descriptor.label != applied.label) {
+    item.SetLabel(descriptor.label);
+    ++stats.updated;
+  }
+  if (descriptor.icon != applied.icon) {
+    item.SetIcon(descriptor.icon);
+    ++stats.updated;
+  }
+  if (descriptor.tooltip != applied.tooltip) {
+    item.SetTooltip(descriptor.tooltip);
+    ++stats.updated;
+  }
+  if (descriptor.accelerator != applied.accelerator) {
+    item.SetAccelerator(descriptor.accelerator);
+    ++stats.updated;
+  }
+  if (descriptor.enabled != applied.enabled) {
+    item.SetEnabled(descriptor.enabled);
+    ++stats.updated;
+  }
+  if (descriptor.type == MenuItemType::Radio && descriptor.radio_group != applied.radio_group) {
+    item.SetRadioGroup(descriptor.radio_group);
+    ++stats.updated;
+  }
+  // Compared with the item itself: clicks toggle checkboxes and radio items
+  // without going through a model.
+  if (IsCheckable(descriptor.type) && descriptor.state != item.GetState()) {
+    item.SetState(descriptor.state);
+    ++stats.updated;
+  }
+  // The same model instance means an unchanged subtree
+  if (descriptor.submenu != applied.submenu) {
+    ApplySubmenu(item, descriptor.submenu, stats);
+  }
+}
+
+}  // namespace
+
+MenuApplyStats Menu::Apply(const MenuModel& model) {
+  MenuApplyStats stats;
+  if (!applied_model_) {
+    applied_model_ = std::make_shared<AppliedModel>();
+  }
+  auto& entries = applied_model_->entries;
+  const std::vector<MenuItemDescriptor>& descriptors = model.GetItems();
+
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, size_t> target_indices;
+  keys.reserve(descriptors.size());
+  for (size_t i = 0; i < descriptors.size(); ++i) {
+    std::string key = descriptors[i].key;
+    if (key.empty() || target_indices.count(key) != 0) {
+      key = PositionalKey(i);
+    }
+    target_indices.emplace(key, i);
+    keys.push_back(std::move(key));
+  }
+
+  std::unordered_map<MenuItemId, const std::string*> item_keys;
+  for (const auto& [key, entry] : entries) {
+    item_keys.emplace(entry.item->GetId(), &key);
+  }
+
+  // Remove items that left the model, changed type or were never applied
+  std::vector<std::shared_ptr<MenuItem>> kept;
+  std::vector<size_t> kept_targets;
+  for (const auto& item : GetAllItems()) {
+    auto key = item_keys.find(item->GetId());
+    auto target = key == item_keys.end() ? target_indices.end()
+                                         : target_indices.find(*key->second);
+    if (target == target_indices.end() || descriptors[target->second].type != item->GetType()) {
+      RemoveItem(item);
+      ++stats.removed;
+      continue;
+    }
+    item_keys.erase(key);  // an item listed twice is kept once
+    kept.push_back(item);
+    kept_targets.push_back(target->second);
+  }
+
+  // Take out the kept items that are out of order; they are reinserted below
+  const std::vector<bool> stays = LongestIncreasingSubsequence(kept_targets);
+  std::vector<std::shared_ptr<MenuItem>> reused(descriptors.size());
+  std::vector<bool> moved(descriptors.size(), false);
+  for (size_t i = 0; i < kept.size(); ++i) {
+    reused[kept_targets[i]] = kept[i];
+    if (!stays[i]) {
+      RemoveItem(kept[i]);
+      moved[kept_targets[i]] = true;
+    }
+  }
+
+  // Items before |i| already match the model, so |i| is the insertion index
+  std::unordered_map<std::string, AppliedModel::Entry> applied;
+  for (size_t i = 0; i < descriptors.size(); ++i) {
+    const MenuItemDescriptor& descriptor = descriptors[i];
+    std::shared_ptr<MenuItem> item = reused[i];
+    if (!item) {
+      item = CreateItem(descriptor, stats);
+      InsertItem(i, item);
+      ++stats.inserted;
+    } else {
+      if (moved[i]) {
+        InsertItem(i, item);
+        ++stats.moved;
+      }
+      UpdateItem(*item, entries.at(keys[i]).descriptor, descriptor, stats);
+    }
+    applied.emplace(keys[i], AppliedModel::Entry{std::move(item), descriptor});
+  }
+  entries = std::move(applied);
+  return stats;
+}
+
+// Serialize() and Deserialize() also work on the public API only. Layout:
+//   header  "NMNU" and the format version (one byte)
+//   icons   count, then per icon its size and PNG bytes
+//   menu    item count, then per item: type, flags and state (one byte
+//           each), radio group + 1, icon index + 1 (0 for none), the label,
+//           tooltip and accelerator key and modifiers when flagged, and the
+//           submenu as a nested menu when flagged
+// Numbers are unsigned LEB128 varints and strings are a size followed by
+// their bytes, so a typical item takes a few bytes plus its label.
+namespace {
+
+constexpr uint8_t kSnapshotMagic[] = {'N', 'M', 'N', 'U'};
+constexpr uint8_t kSnapshotVersion = 1;
+// Type, flags, state, radio group and icon index
+constexpr size_t kSnapshotMinItemSize = 5;
+
+enum SnapshotItemFlags : uint8_t {
+  kSnapshotEnabled = 1 << 0,
+  kSnapshotHasLabel = 1 << 1,
+  kSnapshotHasTooltip = 1 << 2,
+  kSnapshotHasAccelerator = 1 << 3,
+  kSnapshotHasSubmenu = 1 << 4,
+};
+
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  void Byte(uint8_t value) { out_.push_back(value); }
+
+  void Varint(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    out_.push_back(static_cast<uint8_t>(value));
+  }
+
+  void Bytes(const uint8_t* data, size_t size) {
+    Varint(size);
+    out_.insert(out_.end(), data, data + size);
+  }
+
+  void String(const std::string& value) {
+    Bytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  }
+
+ private:
+  std::vector<uint8_t>& out_;
+};
+
+// Every read checks the remaining size; a failed read leaves the reader at
+// the end, so callers only need to check the result they use.
+class SnapshotReader {
+ public:
+  SnapshotReader(const uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+
+  size_t Remaining() const { return static_cast<size_t>(end_ - pos_); }
+
+  bool Byte(uint8_t& value) {
+    if (pos_ == end_) {
+      return false;
+    }
+    value = *pos_++;
+    return true;
+  }
+
+  bool Varint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!Byte(byte)) {
+        return false;
+      }
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    pos_ = end_;
+    return false;
+  }
+
+  bool Bytes(const uint8_t*& data, size_t& size) {
+    uint64_t length;
+    if (!Varint(length) || length > Remaining()) {
+      pos_ = end_;
+      return false;
+    }
+    data = pos_;
+    size = static_cast<size_t>(length);
+    pos_ += size;
+    return true;
+  }
+
+  bool String(std::string& value) {
+    const uint8_t* data;
+    size_t size;
+    if (!Bytes(data, size)) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char*>(data), size);
+    return true;
+  }
+
+ private:
+  const uint8_t* pos_;
+  const uint8_t* end_;
+};
+
+// Icons in order of first use, each encoded once
+struct SnapshotIcons {
+  std::vector<std::vector<uint8_t>> encoded;
+  std::unordered_map<const Image*, size_t> indices;  // index + 1, 0 if not encodable
+
+  size_t IndexOf(const std::shared_ptr<Image>& icon) {
+    if (!icon) {
+      return 0;
+    }
+    auto [it, inserted] = indices.try_emplace(icon.get(), 0);
+    if (inserted) {
+      std::vector<uint8_t> png;
+      if (icon->EncodeTo([&png](const uint8_t* data, size_t size) {
+            png.insert(png.end(), data, data + size);
+            return true;
+          })) {
+        encoded.push_back(std::move(png));
+        it->second = encoded.size();
+      }
+    }
+    return it->second;
+  }
+};
+
+// Returns false when submenus nest deeper than Menu::kMaxSubmenuDepth
+bool WriteMenu(const Menu& menu, SnapshotWriter& writer, SnapshotIcons& icons, int depth) {
+  const std::vector<std::shared_ptr<MenuItem>> items = menu.GetAllItems();
+  writer.Varint(items.size());
+  for (const auto& item : items) {
+    const std::optional<std::string> label = item->GetLabel();
+    const std::optional<std::string> tooltip = item->GetTooltip();
+    const KeyboardAccelerator accelerator = item->GetAccelerator();
+    const std::shared_ptr<Menu> submenu = item->GetSubmenu();
+    uint8_t flags = 0;
+    flags |= item->IsEnabled() ? kSnapshotEnabled : 0;
+    flags |= label ? kSnapshotHasLabel : 0;
+    flags |= tooltip ? kSnapshotHasTooltip : 0;
+    flags |= accelerator.IsEmpty() ? 0 : kSnapshotHasAccelerator;
+    flags |= submenu ? kSnapshotHasSubmenu : 0;
+
+    writer.Byte(static_cast<uint8_t>(item->GetType()));
+    writer.Byte(flags);
+    writer.Byte(static_cast<uint8_t>(item->GetState()));
+    writer.Varint(item->GetRadioGroup() < 0 ? 0 : uint64_t(item->GetRadioGroup()) + 1);
+    writer.Varint(icons.IndexOf(item->GetIcon()));
+    if (label) {
+      writer.String(*label);
+    }
+    if (tooltip) {
+      writer.String(*tooltip);
+    }
+    if (!accelerator.IsEmpty()) {
+      writer.String(accelerator.key);
+      writer.Varint(static_cast<uint32_t>(accelerator.modifiers));
+    }
+    if (submenu &&
+        (depth >= Menu::kMaxSubmenuDepth || !WriteMenu(*submenu, writer, icons, depth + 1))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads one menu level into |items|, which are not yet added to any menu
+bool ReadItems(SnapshotReader& reader,
+               const std::vector<std::shared_ptr<Image>>& icons,
+               int depth,
+               std::vector<std::shared_ptr<MenuItem>>& items);
+
+std::shared_ptr<MenuItem> ReadItem(SnapshotReader& reader,
+                                   const std::vector<std::shared_ptr<Image>>& icons,
+                                   int depth) {
+  uint8_t type_value, flags, state_value;
+  uint64_t radio_group, icon;
+  if (!reader.Byte(type_value) || !reader.Byte(flags) || !reader.Byte(state_value) ||
+      !reader.Varint(radio_group) || !reader.Varint(icon) ||
+      type_value > static_cast<uint8_t>(MenuItemType::Submenu) ||
+      state_value > static_cast<uint8_t>(MenuItemState::Mixed) ||
+      radio_group > static_cast<uint64_t>(INT32_MAX) + 1 || icon > icons.size()) {
+    return nullptr;
+  }
+  const auto type = static_cast<MenuItemType>(type_value);
+  const auto state = static_cast<MenuItemState>(state_value);
+
+  std::string label, tooltip;
+  std::optional<KeyboardAccelerator> accelerator;
+  if ((flags & kSnapshotHasLabel) && !reader.String(label)) {
+    return nullptr;
+  }
+  if ((flags & kSnapshotHasTooltip) && !reader.String(tooltip)) {
+    return nullptr;
+  }
+  if (flags & kSnapshotHasAccelerator) {
+    std::string key;
+    uint64_t modifiers;
+    if (!reader.String(key) || !reader.Varint(modifiers) || modifiers > UINT32_MAX) {
+      return nullptr;
+    }
+    accelerator = KeyboardAccelerator(key, static_cast<ModifierKey>(modifiers));
+  }
+
+  // Only non-default properties are set, as in CreateItem()
+  auto item = std::make_shared<MenuItem>(label, type);
+  if (icon) {
+    item->SetIcon(icons[icon - 1]);
+  }
+  if (flags & kSnapshotHasTooltip) {
+    item->SetTooltip(tooltip);
+  }
+  if (accelerator) {
+    item->SetAccelerator(accelerator);
+  }
+  if (!(flags & kSnapshotEnabled)) {
+    item->SetEnabled(false);
+  }
+  if (type == MenuItemType::Radio && radio_group > 0) {
+    item->SetRadioGroup(static_cast<int>(radio_group - 1));
+  }
+  if (IsCheckable(type) && state != MenuItemState::Unchecked) {
+    item->SetState(state);
+  }
+  if (flags & kSnapshotHasSubmenu) {
+    std::vector<std::shared_ptr<MenuItem>> children;
+    if (depth >= Menu::kMaxSubmenuDepth || !ReadItems(reader, icons, depth + 1, children)) {
+      return nullptr;
+    }
+    auto submenu = std::make_shared<Menu>();
+    for (auto& child : children) {
+      submenu->AddItem(std::move(child));
+    }
+    item->SetSubmenu(submenu);
+  }
+  return item;
+}
+
+bool ReadItems(SnapshotReader& reader,
+               const std::vector<std::shared_ptr<Image>>& icons,
+               int depth,
+               std::vector<std::shared_ptr<MenuItem>>& items) {
+  uint64_t count;
+  // Bounds the reservation by what the remaining bytes can hold
+  if (!reader.Varint(count) || count > reader.Remaining() / kSnapshotMinItemSize) {
+    return false;
+  }
+  items.reserve(static_cast<size_t>(count));
+  for (uint64_t i = 0; i < count; ++i) {
+    std::shared_ptr<MenuItem> item = ReadItem(reader, icons, depth);
+    if (!item) {
+      return false;
+    }
+    items.push_back(std::move(item));
+  }
+  return true;
+}
+
+}  // namespace
+
+std::vector<uint8_t> Menu::Serialize() const {
+  // Items are written first so that icons are encoded once, in order of use
+  std::vector<uint8_t> body;
+  SnapshotWriter body_writer(body);
+  SnapshotIcons icons;
+  if (!WriteMenu(*this, body_writer, icons, 0)) {
+    return {};
+  }
+
+  std::vector<uint8_t> snapshot(std::begin(kSnapshotMagic), std::end(kSnapshotMagic));
+  SnapshotWriter writer(snapshot);
+  writer.Byte(kSnapshotVersion);
+  writer.Varint(icons.encoded.size());
+  for (const auto& png : icons.encoded) {
+    writer.Bytes(png.data(), png.size());
+  }
+  snapshot.insert(snapshot.end(), body.begin(), body.end());
+  return snapshot;
+}
+
+bool Menu::Deserialize(const uint8_t* data, size_t size) {
+  if (!data || size < sizeof(kSnapshotMagic) + 1 ||
+      !std::equal(std::begin(kSnapshotMagic), std::end(kSnapshotMagic), data) ||
+      data[sizeof(kSnapshotMagic)] != kSnapshotVersion) {
+    return false;
+  }
+  const size_t header_size = sizeof(kSnapshotMagic) + 1;
+  SnapshotReader reader(data + header_size, size - header_size);
+
+  uint64_t icon_count;
+  if (!reader.Varint(icon_count) || icon_count > reader.Remaining()) {
+    return false;
+  }
+  std::vector<std::shared_ptr<Image>> icons;
+  icons.reserve(static_cast<size_t>(icon_count));
+  for (uint64_t i = 0; i < icon_count; ++i) {
+    const uint8_t* png;
+    size_t png_size;
+    if (!reader.Bytes(png, png_size)) {
+      return false;
+    }
+    std::shared_ptr<Image> icon = Image::FromBytes(png, png_size);
+    if (!icon) {
+      return false;
+    }
+    icons.push_back(std::move(icon));
+  }
+
+  std::vector<std::shared_ptr<MenuItem>> items;
+  if (!ReadItems(reader, icons, 0, items) || reader.Remaining() != 0) {
+    return false;
+  }
+  Clear();
+  for (auto& item : items) {
+    AddItem(std::move(item));
+  }
+  return true;
+}
+
+// Like Apply(), submenu providers live above the platform layer; backends
+// only call PrepareSubmenu() when a submenu is about to be shown.
+struct MenuItem::SubmenuProviderState {
+  SubmenuProvider provider;
+  uint64_t token = 1;        // advanced by InvalidateSubmenu()
+  uint64_t built_token = 0;  // token the submenu was last built for
+  bool running = false;
+};
+
+void MenuItem::SetSubmenuProvider(SubmenuProvider provider) {
+  if (!provider) {
+    submenu_provider_.reset();
+    return;
+  }
+  if (!submenu_provider_) {
+    submenu_provider_ = std::make_shared<SubmenuProviderState>();
+  }
+  submenu_provider_->provider = std::move(provider);
+  ++submenu_provider_->token;  // a new provider invalidates the old result
+  if (!GetSubmenu()) {
+    SetSubmenu(std::make_shared<Menu>());
+  }
+}
+
+void MenuItem::InvalidateSubmenu() {
+  if (submenu_provider_) {
+    ++submenu_provider_->token;
+  }
+}
+
+bool MenuItem::PrepareSubmenu() {
+  // Held locally: the provider may replace or remove itself
+  std::shared_ptr<SubmenuProviderState> state = submenu_provider_;
+  if (!state || state->running || state->built_token == state->token) {
+    return false;
+  }
+  std::shared_ptr<Menu> submenu = GetSubmenu();
+  if (!submenu) {
+    return false;
+  }
+  // Recorded first, so an InvalidateSubmenu() from inside the provider
+  // still triggers the next rebuild
+  state->built_token = state->token;
+  state->running = true;
+  SubmenuProvider provider = state->provider;
+  provider(*submenu);
+  state->running = false;
+  return true;
+}
+
+// The backends report items entering and leaving menus, submenus and
+// accelerators through the Link*() calls, so the tree structure that
+// accelerator dispatch and radio groups need is kept here, once for all
+// platforms. Each menu indexes the accelerators of its whole tree: a change
+// updates the menus above it, and a key press is one lookup in the menu it
+// is dispatched to, however many items the tree has.
+namespace {
+
+const ModifierKey kAcceleratorModifiers =
+    ModifierKey::Shift | ModifierKey::Ctrl | ModifierKey::Alt | ModifierKey::Meta | ModifierKey::Fn;
+
+// Modifier bits, then the key with ASCII letters upper-cased
+std::string AcceleratorIndexKey(const KeyboardAccelerator& accelerator) {
+  const ModifierKey modifiers = accelerator.modifiers & kAcceleratorModifiers;
+  std::string key = std::to_string(static_cast<uint32_t>(modifiers));
+  key += '+';
+  for (char c : accelerator.key) {
+    key += (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+  }
+  return key;
+}
+
+using AcceleratorEntries = std::vector<std::pair<std::string, MenuItem*>>;
+
+}  // namespace
+
+struct MenuItem::TreeLink {
+  explicit TreeLink(MenuItem* item) : item(item) {}
+  ~TreeLink();
+
+  // The accelerators this item brings into the tree of its menu
+  AcceleratorEntries Entries() const;
+  void DetachSubmenu();
+
+  MenuItem* item;
+  std::weak_ptr<MenuItem> self;  // as held by |parent|
+  Menu* parent = nullptr;
+  Menu* submenu = nullptr;  // while this item is the submenu's owner
+  std::string accelerator;  // index key, empty without an accelerator
+};
+
+struct Menu::TreeLink {
+  explicit TreeLink(Menu* menu) : menu(menu) {}
+  ~TreeLink();
+
+  void Add(MenuItem::TreeLink& link);
+  void Remove(MenuItem::TreeLink& link);
+
+  // Adds or removes |entries| in the index of this menu and the menus above
+  void Propagate(const AcceleratorEntries& entries, bool add);
+  AcceleratorEntries Entries() const;
+
+  Menu* menu;
+  MenuItem* owner = nullptr;
+  std::unordered_set<MenuItem*> items;
+  std::unordered_map<std::string, std::vector<MenuItem*>> accelerators;
+  std::unordered_map<int, MenuItem*> checked;  // by radio group
+};
+
+MenuItem::TreeLink::~TreeLink() {
+  DetachSubmenu();
+  if (parent) {
+    parent->tree_link_->Remove(*this);
+  }
+}
+
+AcceleratorEntries MenuItem::TreeLink::Entries() const {
+  AcceleratorEntries entries;
+  if (!accelerator.empty()) {
+    entries.emplace_back(accelerator, item);
+  }
+  if (submenu) {
+    AcceleratorEntries below = submenu->tree_link_->Entries();
+    entries.insert(entries.end(), std::make_move_iterator(below.begin()),
+                   std::make_move_iterator(below.end()));
+  }
+  return entries;
+}
+
+void MenuItem::TreeLink::DetachSubmenu() {
+  if (!submenu) {
+    return;
+  }
+  Menu::TreeLink& submenu_link = *submenu->tree_link_;
+  if (parent) {
+    parent->tree_link_->Propagate(submenu_link.Entries(), false);
+  }
+  submenu_link.owner = nullptr;
+  submenu = nullptr;
+}
+
+Menu::TreeLink::~TreeLink() {
+  for (MenuItem* item : items) {
+    item->tree_link_->parent = nullptr;
+    item->tree_link_->self.reset();
+  }
+  if (owner) {
+    MenuItem::TreeLink& owner_link = *owner->tree_link_;
+    if (owner_link.parent) {
+      owner_link.parent->tree_link_->Propagate(Entries(), false);
+    }
+    owner_link.submenu = nullptr;
+  }
+}
+
+void Menu::TreeLink::Add(MenuItem::TreeLink& link) {
+  items.insert(link.item);
+  link.parent = menu;
+  Propagate(link.Entries(), true);
+}
+
+void Menu::TreeLink::Remove(MenuItem::TreeLink& link) {
+  for (auto it = checked.begin(); it != checked.end();) {
+    it = it->second == link.item ? checked.erase(it) : std::next(it);
+  }
+  Propagate(link.Entries(), false);
+  items.erase(link.item);
+  link.parent = nullptr;
+  link.self.reset();
+}
+
+void Menu::TreeLink::Propagate(const AcceleratorEntries& entries, bool add) {
+  TreeLink* link = this;
+  for (int depth = 0; link && !entries.empty() && depth < kMaxSubmenuDepth; ++depth) {
+    for (const auto& [key, item] : entries) {
+      if (add) {
+        link->accelerators[key].push_back(item);
+        continue;
+      }
+      auto it = link->accelerators.find(key);
+      if (it == link->accelerators.end()) {
+        continue;
+      }
+      auto& items_of_key = it->second;
+      auto position = std::find(items_of_key.begin(), items_of_key.end(), item);
+      if (position != items_of_key.end()) {
+        items_of_key.erase(position);
+      }
+      if (items_of_key.empty()) {
+        link->accelerators.erase(it);
+      }
+    }
+    Menu* above = link->owner ? link->owner->tree_link_->parent : nullptr;
+    link = above ? above->tree_link_.get() : nullptr;
+  }
+}
+
+AcceleratorEntries Menu::TreeLink::Entries() const {
+  AcceleratorEntries entries;
+  for (const auto& [key, items_of_key] : accelerators) {
+    for (MenuItem* item : items_of_key) {
+      entries.emplace_back(key, item);
+    }
+  }
+  return entries;
+}
+
+MenuItem::TreeLink& MenuItem::Link() {
+  if (!tree_link_) {
+    tree_link_ = std::make_shared<TreeLink>(this);
+  }
+  return *tree_link_;
+}
+
+void MenuItem::LinkSubmenu(const std::shared_ptr<Menu>& submenu) {
+  TreeLink& link = Link();
+  if (link.submenu == submenu.get()) {
+    return;
+  }
+  link.DetachSubmenu();
+  if (!submenu) {
+    return;
+  }
+  // A menu has one owner in the tree, the item it was last set on
+  Menu::TreeLink& submenu_link = submenu->Link();
+  if (submenu_link.owner) {
+    submenu_link.owner->tree_link_->DetachSubmenu();
+  }
+  submenu_link.owner = this;
+  link.submenu = submenu.get();
+  if (link.parent) {
+    link.parent->tree_link_->Propagate(submenu_link.Entries(), true);
+  }
+}
+
+void MenuItem::LinkAccelerator(const KeyboardAccelerator& accelerator) {
+  std::string key = accelerator.IsEmpty() ? std::string() : AcceleratorIndexKey(accelerator);
+  if (!tree_link_ && key.empty()) {
+    return;
+  }
+  TreeLink& link = Link();
+  if (link.accelerator == key) {
+    return;
+  }
+  Menu::TreeLink* parent_link = link.parent ? link.parent->tree_link_.get() : nullptr;
+  if (parent_link && !link.accelerator.empty()) {
+    parent_link->Propagate({{link.accelerator, this}}, false);
+  }
+  link.accelerator = std::move(key);
+  if (parent_link && !link.accelerator.empty()) {
+    parent_link->Propagate({{link.accelerator, this}}, true);
+  }
+}
+
+void MenuItem::SyncRadioGroup() {
+  if (tree_link_ && tree_link_->parent) {
+    tree_link_->parent->SyncRadioGroup(*this);
+  }
+}
+
+void MenuItem::ForgetRadioGroup() {
+  if (tree_link_ && tree_link_->parent) {
+    tree_link_->parent->ForgetRadioItem(*this);
+  }
+}
+
+Menu::TreeLink& Menu::Link() {
+  if (!tree_link_) {
+    tree_link_ = std::make_shared<TreeLink>(this);
+  }
+  return *tree_link_;
+}
+
+// An item added to several menus belongs to the tree of the last one, like
+// on the platforms that track the parent of an item
+void Menu::LinkItem(const std::shared_ptr<MenuItem>& item) {
+  MenuItem::TreeLink& link = item->Link();
+  if (link.parent != this) {
+    if (link.parent) {
+      link.parent->tree_link_->Remove(link);
+    }
+    Link().Add(link);
+  }
+  link.self = item;
+  SyncRadioGroup(*item);
+}
+
+void Menu::UnlinkItem(MenuItem& item) {
+  if (item.tree_link_ && item.tree_link_->parent == this) {
+    tree_link_->Remove(*item.tree_link_);
+  }
+}
+
+// Radio groups are kept per menu: the checked item of each group, so
+// checking an item unchecks exactly one other item.
+void Menu::SyncRadioGroup(MenuItem& item) {
+  const int group = item.GetRadioGroup();
+  if (item.GetType() != MenuItemType::Radio || group < 0) {
+    return;
+  }
+  if (item.GetState() != MenuItemState::Checked) {
+    ForgetRadioItem(item);
+    return;
+  }
+  auto [it, inserted] = Link().checked.try_emplace(group, &item);
+  if (inserted || it->second == &item) {
+    return;
+  }
+  MenuItem* previous = it->second;
+  it->second = &item;
+  // Reports back here, where |item| is already the checked one
+  if (previous->GetState() != MenuItemState::Unchecked) {
+    previous->SetState(MenuItemState::Unchecked);
+  }
+}
+
+void Menu::ForgetRadioItem(const MenuItem& item) {
+  if (!tree_link_) {
+    return;
+  }
+  auto& checked = tree_link_->checked;
+  auto it = checked.find(item.GetRadioGroup());
+  if (it != checked.end() && it->second == &item) {
+    checked.erase(it);
+  }
+}
+
+// Walks the tree links, so it serves every backend without copying item
+// lists. Each menu is visited once, so a submenu cycle is not walked again
+// and again.
+std::shared_ptr<MenuItem> Menu::FindItemById(MenuItemId item_id) const {
+  if (std::shared_ptr<MenuItem> item = GetItemById(item_id)) {
+    return item;
+  }
+  std::vector<std::pair<const Menu*, int>> pending = {{this, 0}};
+  std::unordered_set<const Menu*> visited = {this};
+  while (!pending.empty()) {
+    auto [menu, depth] = pending.back();
+    pending.pop_back();
+    if (!menu->tree_link_) {
+      continue;
+    }
+    for (MenuItem* item : menu->tree_link_->items) {
+      if (item->GetId() == item_id) {
+        return item->tree_link_->self.lock();
+      }
+      const Menu* submenu = item->tree_link_->submenu;
+      if (submenu && depth < kMaxSubmenuDepth && visited.insert(submenu).second) {
+        pending.emplace_back(submenu, depth + 1);
+      }
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<MenuItem> Menu::GetCheckedRadioItem(int group_id) const {
+  if (!tree_link_) {
+    return nullptr;
+  }
+  auto it = tree_link_->checked.find(group_id);
+  return it == tree_link_->checked.end() ? nullptr : it->second->tree_link_->self.lock();
+}
+
+bool Menu::DispatchAccelerator(const KeyboardAccelerator& accelerator) {
+  if (accelerator.IsEmpty() || !tree_link_) {
+    return false;
+  }
+  const auto& index = tree_link_->accelerators;
+  auto it = index.find(AcceleratorIndexKey(accelerator));
+  if (it == index.end()) {
+    return false;
+  }
+  std::shared_ptr<MenuItem> item;
+  for (MenuItem* candidate : it->second) {
+    if (candidate->IsEnabled() && candidate->GetType() != MenuItemType::Separator) {
+      item = candidate->tree_link_->self.lock();
+      if (item) {
+        break;
+      }
+    }
+  }
+  if (!item) {
+    return false;
+  }
+
+  // The same click handling as the platform backends; |item| stays alive if
+  // its handlers rebuild the menu
+  switch (item->GetType()) {
+    case MenuItemType::Checkbox:
+      item->SetState(item->GetState() == MenuItemState::Checked ? MenuItemState::Unchecked
+                                                                : MenuItemState::Checked);
+      break;
+    case MenuItemType::Radio:
+      if (item->GetState() == MenuItemState::Checked) {
+        return true;
+      }
+      item->SetState(MenuItemState::Checked);
+      break;
+    default:
+      break;
+  }
+  item->Emit(MenuItemClickedEvent(item->GetId()));
+  return true;
+}
+
+// OpenAsync() is built on PostToMainThread() and the MenuOpenedEvent and
+// MenuClosedEvent every backend emits, so it needs no platform code either.
+// Queued requests hold the anchor weakly: once the menu is destroyed, the
+// anchor is gone and they report Failed instead of touching the menu.
+struct Menu::OpenAsyncAnchor {
+  Menu* menu;
+};
+
+namespace {
+
+// One OpenAsync() request, kept alive by the two menu listeners it
+// installs. Statuses are delivered from a later main loop iteration: the
+// listeners run inside Emit(), which holds the menu's listener lock.
+class OpenRequest {
+ public:
+  explicit OpenRequest(Menu::OpenCallback callback) : callback_(std::move(callback)) {}
+
+  // The menu was destroyed with the listeners still installed
+  ~OpenRequest() { Report(opened_ ? MenuOpenStatus::Closed : MenuOpenStatus::Failed); }
+
+  void Report(MenuOpenStatus status) {
+    if (finished_ || (status == MenuOpenStatus::Opened && opened_) ||
+        (status == MenuOpenStatus::Closed && !opened_)) {
+      return;
+    }
+    opened_ = opened_ || status == MenuOpenStatus::Opened;
+    finished_ = status != MenuOpenStatus::Opened;
+    if (callback_) {
+      PostToMainThread([callback = callback_, status]() { callback(status); });
+    }
+  }
+
+  bool opened() const { return opened_; }
+  bool finished() const { return finished_; }
+
+  void Listen(Menu& menu, std::weak_ptr<void> anchor, const std::shared_ptr<OpenRequest>& self) {
+    menu_ = &menu;
+    anchor_ = std::move(anchor);
+    opened_listener_id_ = menu.AddListener<MenuOpenedEvent>([self](const MenuOpenedEvent&) {
+      self->Report(MenuOpenStatus::Opened);
+      self->StopListeningLater(self);
+    });
+    closed_listener_id_ = menu.AddListener<MenuClosedEvent>([self](const MenuClosedEvent&) {
+      self->Report(MenuOpenStatus::Closed);
+      self->StopListeningLater(self);
+    });
+  }
+
+  void StopListening() {
+    if (anchor_.lock()) {
+      menu_->RemoveListener(opened_listener_id_);
+      menu_->RemoveListener(closed_listener_id_);
+    }
+    anchor_.reset();
+  }
+
+ private:
+  void StopListeningLater(const std::shared_ptr<OpenRequest>& self) {
+    if (finished_) {
+      PostToMainThread([self]() { self->StopListening(); });
+    }
+  }
+
+  Menu::OpenCallback callback_;
+  bool opened_ = false;
+  bool finished_ = false;
+  Menu* menu_ = nullptr;
+  std::weak_ptr<void> anchor_;  // the menu's OpenAsyncAnchor
+  size_t opened_listener_id_ = 0;
+  size_t closed_listener_id_ = 0;
+};
+
+}  // namespace
+
+void Menu::OpenAsync(const PositioningStrategy& strategy,
+                     Placement placement,
+                     OpenCallback callback) {
+  // Without main-thread dispatch the request could never run
+  if (!IsMainThreadDispatchSupported()) {
+    if (callback) {
+      WorkerPool::GetShared().Submit(
+          [callback = std::move(callback)]() { callback(MenuOpenStatus::Failed); });
+    }
+    return;
+  }
+
+  // Created on first use; OpenAsync() may race with itself across threads
+  std::shared_ptr<OpenAsyncAnchor> anchor = std::atomic_load(&open_async_anchor_);
+  if (!anchor) {
+    auto created = std::make_shared<OpenAsyncAnchor>(OpenAsyncAnchor{this});
+    if (std::atomic_compare_exchange_strong(&open_async_anchor_, &anchor, created)) {
+      anchor = std::move(created);
+    }
+  }
+
+  auto request = std::make_shared<OpenRequest>(std::move(callback));
+  std::weak_ptr<OpenAsyncAnchor> weak_anchor = anchor;
+  PostToMainThread([weak_anchor, request, strategy, placement]() {
+    {
+      // Only held for the call: a handler running inside a modal Open() may
+      // destroy the menu, and StopListening() must then see the anchor gone.
+      std::shared_ptr<OpenAsyncAnchor> anchor = weak_anchor.lock();
+      if (!anchor) {
+        request->Report(MenuOpenStatus::Failed);
+        return;
+      }
+      request->Listen(*anchor->menu, weak_anchor, request);
+      anchor->menu->Open(strategy, placement);
+    }
+    // Every backend emits MenuOpenedEvent from within Open() once the menu
+    // is showing. A popup the window system refused never does, even if
+    // Open() reported success, and would otherwise never finish.
+    if (!request->opened()) {
+      request->Report(MenuOpenStatus::Failed);
+    }
+    if (request->finished()) {
+      request->StopListening();
+    }
+  });
+}
+
+std::future<bool> Menu::OpenAsync(const PositioningStrategy& strategy, Placement placement) {
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  OpenAsync(strategy, placement, [promise](MenuOpenStatus status) {
+    if (status != MenuOpenStatus::Closed) {
+      promise->set_value(status == MenuOpenStatus::Opened);
+    }
+  });
+  return future;
+}
+
+}  // namespace nativeapi
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <string>
@@ -18,10 +21,32 @@
 namespace nativeapi {
 
 class Image;
+class MenuModel;
+struct MenuApplyStats;
 
 typedef IdAllocator::IdType MenuId;
 typedef IdAllocator::IdType MenuItemId;
 
+/**
+ * @brief Outcome of Menu::OpenAsync(), reported in this order.
+ */
+enum class MenuOpenStatus {
+  /**
+   * The menu is showing. Followed by Closed.
+   */
+  Opened,
+
+  /**
+   * The menu could not be shown, or was destroyed before it was. Final.
+   */
+  Failed,
+
+  /**
+   * The menu was dismissed or an item was selected. Final.
+   */
+  Closed
+};
+
 /**
  * @brief Enumeration of different menu item types.
  *
@@ -326,10 +351,11 @@ class MenuItem : public EventEmitter<MenuEvent>, public NativeObjectProvider {
   /**
    * @brief Set the radio group ID for radio menu items.
    *
-   * Radio items with the same group ID are mutually exclusive -
-   * only one item in the group can be checked at a time.
+   * Radio items with the same group ID in the same menu are mutually
+   * exclusive - checking one unchecks the one that was checked before.
+   * Group IDs are scoped to the menu, so unrelated menus may reuse them.
    *
-   * @param group_id The radio group identifier
+   * @param group_id The radio group identifier, or -1 for none
    */
   void SetRadioGroup(int group_id);
 
@@ -357,6 +383,56 @@ class MenuItem : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    */
   std::shared_ptr<Menu> GetSubmenu() const;
 
+  /**
+   * @brief Callback that fills a submenu right before it opens.
+   *
+   * The callback receives the (possibly already populated) submenu and
+   * should bring it up to date, e.g. with Menu::Apply() or Clear() and
+   * AddItem().
+   */
+  using SubmenuProvider = std::function<void(Menu& submenu)>;
+
+  /**
+   * @brief Populate the submenu on demand instead of up front.
+   *
+   * The provider runs when the submenu is about to be shown (a native
+   * submenu opening, or a tray host asking for it over dbusmenu), never
+   * before. Its result is cached: it only runs again after
+   * InvalidateSubmenu(). An empty submenu is attached if the item has none,
+   * so the item is shown as a submenu right away. Pass nullptr to remove
+   * the provider; the submenu keeps its current items.
+   *
+   * @param provider Callback that fills the submenu, or nullptr
+   *
+   * @example
+   * ```cpp
+   * recent_item->SetSubmenuProvider([&history](Menu& submenu) {
+   *   submenu.Apply(BuildRecentFilesModel(history));
+   * });
+   * // Whenever the list changes; cheap, nothing is built until shown
+   * history.OnChanged([recent_item] { recent_item->InvalidateSubmenu(); });
+   * ```
+   */
+  void SetSubmenuProvider(SubmenuProvider provider);
+
+  /**
+   * @brief Mark the submenu built by the provider as stale.
+   *
+   * Advances the item's invalidation token; the provider runs again the
+   * next time the submenu is about to be shown. Does nothing without a
+   * provider.
+   */
+  void InvalidateSubmenu();
+
+  /**
+   * @brief Run the submenu provider if its cached result is stale.
+   *
+   * Called by the platform backends right before the submenu is shown.
+   *
+   * @return true if the provider ran, i.e. the submenu may have changed
+   */
+  bool PrepareSubmenu();
+
  protected:
   /**
    * @brief Internal method to get the platform-specific native menu item object.
@@ -380,6 +456,41 @@ class MenuItem : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    * @brief Pointer to the private implementation instance.
    */
   std::unique_ptr<Impl> pimpl_;
+
+  /**
+   * @brief Submenu provider and its cache token, shared by all platforms
+   * (see menu.cpp).
+   */
+  struct SubmenuProviderState;
+  std::shared_ptr<SubmenuProviderState> submenu_provider_;
+
+  /**
+   * @brief The menu holding this item, its submenu and its accelerator, as
+   * seen by the platform-independent code (see menu.cpp). Unlinks the item
+   * when it is destroyed.
+   */
+  struct TreeLink;
+  std::shared_ptr<TreeLink> tree_link_;
+
+  TreeLink& Link();
+
+  /**
+   * @brief Called by the platform code after the submenu changed.
+   */
+  void LinkSubmenu(const std::shared_ptr<Menu>& submenu);
+
+  /**
+   * @brief Called by the platform code after the accelerator changed.
+   */
+  void LinkAccelerator(const KeyboardAccelerator& accelerator);
+
+  /**
+   * @brief Called by the platform code after the state changed, and before
+   * and after the radio group changes. Forwards to the radio groups of the
+   * item's menu, if it is in one.
+   */
+  void SyncRadioGroup();
+  void ForgetRadioGroup();
 };
 
 /**
@@ -431,6 +542,15 @@ class MenuItem : public EventEmitter<MenuEvent>, public NativeObjectProvider {
  */
 class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
  public:
+  /**
+   * @brief Deepest submenu nesting that tree operations follow.
+   *
+   * FindItemById(), Serialize(), Deserialize() and accelerator dispatch
+   * stop at this many levels of submenus, which also bounds them when
+   * submenus form a cycle.
+   */
+  static constexpr int kMaxSubmenuDepth = 64;
+
   /**
    * @brief Constructor to create a new menu.
    *
@@ -573,6 +693,61 @@ class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    */
   std::shared_ptr<MenuItem> GetItemById(MenuItemId item_id) const;
 
+  /**
+   * @brief Find a menu item by its ID in this menu or any of its submenus.
+   *
+   * Submenus nested deeper than kMaxSubmenuDepth are not searched.
+   *
+   * @param item_id The ID of the menu item to find
+   * @return Shared pointer to the menu item, or nullptr if it is not part of
+   * this menu's tree
+   *
+   * @example
+   * ```cpp
+   * // Resolve a click reported by id, wherever the item is nested
+   * if (auto item = menu->FindItemById(event.GetItemId())) {
+   *   item->SetEnabled(false);
+   * }
+   * ```
+   */
+  std::shared_ptr<MenuItem> FindItemById(MenuItemId item_id) const;
+
+  /**
+   * @brief Get the checked item of one of this menu's radio groups.
+   *
+   * @param group_id The radio group ID, as given to MenuItem::SetRadioGroup()
+   * @return The checked radio item of the group, or nullptr if none is
+   * checked
+   */
+  std::shared_ptr<MenuItem> GetCheckedRadioItem(int group_id) const;
+
+  /**
+   * @brief Activate the item of this menu's tree that has |accelerator|,
+   * as if it was clicked.
+   *
+   * Lets shortcuts work while the menu is closed. The item is found through
+   * an index of the accelerators of the menu's tree, kept up to date as
+   * items, submenus and accelerators change, instead of a scan of the tree.
+   * Keys compare case-insensitively and lock modifiers (Caps Lock, Num Lock,
+   * Scroll Lock) are ignored. Disabled items and separators are skipped.
+   *
+   * Checkboxes are toggled and radio items checked, as a click would, then
+   * MenuItemClickedEvent is emitted; a checked radio item is not clicked
+   * again.
+   *
+   * @param accelerator The pressed key and modifiers
+   * @return true if an item has the accelerator, false otherwise
+   *
+   * @example
+   * ```cpp
+   * // From the application's key handler
+   * if (menu->DispatchAccelerator(KeyboardAccelerator("S", ModifierKey::Ctrl))) {
+   *   return;  // handled by the menu
+   * }
+   * ```
+   */
+  bool DispatchAccelerator(const KeyboardAccelerator& accelerator);
+
   /**
    * @brief Get all menu items in the menu.
    *
@@ -582,6 +757,85 @@ class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    */
   std::vector<std::shared_ptr<MenuItem>> GetAllItems() const;
 
+  /**
+   * @brief Show the items through a scrolling window of reused widgets.
+   *
+   * Meant for menus with thousands of items, such as bookmark trees. Only
+   * |visible_items| items are shown at a time, with scroll arrows for the
+   * rest; the native widgets are bound to items as the user scrolls instead
+   * of being created per item. Items, lookups and events are unaffected.
+   *
+   * @param visible_items Number of items shown at once, or 0 (the default)
+   * to give every item its own widget
+   *
+   * @note Only the GTK backend creates a widget per item; other platforms
+   * store the setting without acting on it.
+   */
+  void SetVirtualWindow(size_t visible_items);
+
+  /**
+   * @brief Get the number of items a virtualized menu shows at once.
+   *
+   * @return The value given to SetVirtualWindow(), 0 if not virtualized
+   */
+  size_t GetVirtualWindow() const;
+
+  /**
+   * @brief Bring the menu's items in line with a declarative model.
+   *
+   * Items are matched to the previous Apply() by their descriptor keys.
+   * Matched items are kept, with their ids and listeners, and only the
+   * properties that changed are set; items are moved only when they are out
+   * of order, and the rest are inserted or removed. Submenus are reconciled
+   * recursively. Items added to the menu by other means are removed.
+   *
+   * @param model The items the menu should have
+   * @return The native operations that were performed
+   *
+   * @example
+   * ```cpp
+   * // Called whenever the application state changes
+   * MenuApplyStats stats = menu->Apply(BuildTrayMenuModel(state));
+   * ```
+   */
+  MenuApplyStats Apply(const MenuModel& model);
+
+  /**
+   * @brief Save the menu's items, submenus included, as a compact binary
+   * snapshot.
+   *
+   * The snapshot holds the labels, tooltips, icons, accelerators, enabled
+   * and check states and radio groups of the whole tree. Each icon is stored
+   * once as PNG, however many items use it. Listeners, item ids and submenu
+   * providers are not included; a provider's submenu is saved as last built.
+   *
+   * @return The snapshot, to be restored with Deserialize(), or an empty
+   *         vector if submenus nest deeper than kMaxSubmenuDepth (as a
+   *         submenu cycle does)
+   *
+   * @example
+   * ```cpp
+   * std::vector<uint8_t> snapshot = menu->Serialize();
+   * SaveToCache(snapshot);
+   * ```
+   */
+  std::vector<uint8_t> Serialize() const;
+
+  /**
+   * @brief Replace the menu's items with those of a snapshot made by
+   * Serialize().
+   *
+   * The snapshot is decoded in one pass: every item is created with its
+   * final properties before it is added, so no item is updated afterwards.
+   * The restored items get new ids.
+   *
+   * @param data The snapshot
+   * @param size Size of the snapshot in bytes
+   * @return true on success; false if the snapshot is malformed or of an
+   * unknown version, in which case the menu is left unchanged
+   */
+  bool Deserialize(const uint8_t* data, size_t size);
+
   /**
    * @brief Display the menu as a context menu using the specified positioning strategy.
    *
@@ -594,6 +848,9 @@ class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    *                  relative to the reference point (default: BottomStart)
    * @return true if the menu was successfully opened, false otherwise
    *
+   * @note Called off the main thread, this blocks until the main loop has
+   * shown the menu. Use OpenAsync() from worker threads.
+   *
    * @example
    * ```cpp
    * // Open context menu at cursor position, below the cursor
@@ -612,6 +869,61 @@ class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    */
   bool Open(const PositioningStrategy& strategy, Placement placement = Placement::BottomStart);
 
+  /**
+   * @brief Callback receiving the progress of an OpenAsync() request.
+   */
+  using OpenCallback = std::function<void(MenuOpenStatus status)>;
+
+  /**
+   * @brief Display the menu as a context menu without blocking the caller.
+   *
+   * May be called from any thread and always returns immediately; the menu
+   * is opened from the main thread's event loop. Unlike Open() called off
+   * the main thread, the caller never waits for a busy main loop, so this
+   * cannot deadlock against it.
+   *
+   * The callback runs on the main thread: with Opened and then Closed, or
+   * with Failed alone. Exactly one of Closed or Failed is always reported,
+   * also when the menu is destroyed first or the window system refuses to
+   * show it (e.g. a Wayland popup without a triggering event).
+   *
+   * On Windows and Android, main-thread delivery is set up by the main
+   * thread itself, which menu constructors do. Create the menu (or call
+   * PrepareMainThreadDispatcher()) on the main thread before calling this
+   * from a worker. On OpenHarmony, which has no main-thread delivery,
+   * Failed is reported from a worker thread.
+   *
+   * @param strategy The positioning strategy determining where to display the menu
+   * @param placement The placement option determining how the menu is positioned
+   * @param callback Receives the outcome; may be nullptr
+   *
+   * @example
+   * ```cpp
+   * // From a worker thread
+   * menu->OpenAsync(PositioningStrategy::CursorPosition(), Placement::BottomStart,
+   *                 [](MenuOpenStatus status) {
+   *                   if (status == MenuOpenStatus::Failed) {
+   *                     // e.g. fall back to another UI
+   *                   }
+   *                 });
+   * ```
+   */
+  void OpenAsync(const PositioningStrategy& strategy, Placement placement, OpenCallback callback);
+
+  /**
+   * @brief Display the menu without blocking, reporting through a future.
+   *
+   * Same as the callback overload. The future becomes ready with true once
+   * the menu is showing, or with false if it could not be shown. Do not
+   * wait on it from the main thread, which has to run the request.
+   *
+   * @param strategy The positioning strategy determining where to display the menu
+   * @param placement The placement option determining how the menu is positioned
+   * @return Future for whether the menu was shown
+   */
+  std::future<bool> OpenAsync(const PositioningStrategy& strategy,
+                              Placement placement = Placement::BottomStart);
+
   /**
    * @brief Programmatically close the menu if it's currently showing.
    *
@@ -631,6 +943,8 @@ class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
   void* GetNativeObjectInternal() const override;
 
  private:
+  friend class MenuItem;
+
   /**
    * @brief Private implementation class using the PIMPL idiom.
    */
@@ -640,6 +954,54 @@ class Menu : public EventEmitter<MenuEvent>, public NativeObjectProvider {
    * @brief Pointer to the private implementation instance.
    */
   std::unique_ptr<Impl> pimpl_;
+
+  /**
+   * @brief Items and descriptors from the last Apply(), shared by all
+   * platforms (see menu.cpp). shared_ptr so platform destructors need not
+   * see the complete type.
+   */
+  struct AppliedModel;
+  std::shared_ptr<AppliedModel> applied_model_;
+
+  /**
+   * @brief Lets OpenAsync() requests queued on the main thread detect that
+   * the menu is gone (see menu.cpp).
+   */
+  struct OpenAsyncAnchor;
+  std::shared_ptr<OpenAsyncAnchor> open_async_anchor_;
+
+  /**
+   * @brief The items of this menu, the item it is the submenu of and the
+   * accelerators of its whole tree and the checked item of each radio group
+   * (see menu.cpp). Unlinks the menu when it is destroyed.
+   */
+  struct TreeLink;
+  std::shared_ptr<TreeLink> tree_link_;
+
+  TreeLink& Link();
+
+  /**
+   * @brief Called by the platform code after |item| was added to this menu.
+   * Moves the item's accelerators into this tree and joins its radio group.
+   */
+  void LinkItem(const std::shared_ptr<MenuItem>& item);
+
+  /**
+   * @brief Called by the platform code when |item| leaves this menu.
+   */
+  void UnlinkItem(MenuItem& item);
+
+  /**
+   * @brief Unchecks the previously checked item of |item|'s radio group
+   * once |item| is checked.
+   */
+  void SyncRadioGroup(MenuItem& item);
+
+  /**
+   * @brief Drops |item| from its radio group before it leaves the menu or
+   * the group.
+   */
+  void ForgetRadioItem(const MenuItem& item);
 };
 
 }  // namespace nativeapi
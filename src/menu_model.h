@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "foundation/keyboard.h"
+#include "menu.h"
+
+namespace nativeapi {
+
+class Image;
+class MenuModel;
+
+/**
+ * @brief Description of one menu item in a MenuModel.
+ *
+ * The fields mirror the MenuItem setters. @c key identifies the item across
+ * successive models: Menu::Apply() keeps the MenuItem (and its native
+ * widget, id and listeners) of every key that is still present and only
+ * changes what differs. Keys must be unique among siblings; an item with an
+ * empty key is identified by its position instead.
+ */
+struct MenuItemDescriptor {
+  std::string key;
+  MenuItemType type = MenuItemType::Normal;
+  std::optional<std::string> label;
+  std::shared_ptr<Image> icon;
+  std::optional<std::string> tooltip;
+  std::optional<KeyboardAccelerator> accelerator;
+  bool enabled = true;
+  MenuItemState state = MenuItemState::Unchecked;  ///< Checkbox and radio items only
+  int radio_group = -1;                            ///< Radio items only
+
+  /**
+   * Items of the submenu, or nullptr for none. Reusing the same model
+   * instance across applies lets Menu::Apply() skip the whole subtree.
+   */
+  std::shared_ptr<const MenuModel> submenu;
+};
+
+/**
+ * @brief Immutable, declarative description of a menu's items.
+ *
+ * Build a new model whenever the application state changes and hand it to
+ * Menu::Apply(); the menu is brought in line with the model using the
+ * fewest native insertions, removals, moves and property updates.
+ *
+ * @example
+ * ```cpp
+ * MenuItemDescriptor status;
+ * status.key = "status";
+ * status.label = connected ? "Connected" : "Offline";
+ * status.enabled = false;
+ *
+ * MenuItemDescriptor quit;
+ * quit.key = "quit";
+ * quit.label = "Quit";
+ *
+ * MenuApplyStats stats = menu->Apply(MenuModel({status, quit}));
+ * ```
+ */
+class MenuModel {
+ public:
+  MenuModel() = default;
+  explicit MenuModel(std::vector<MenuItemDescriptor> items) : items_(std::move(items)) {}
+
+  const std::vector<MenuItemDescriptor>& GetItems() const { return items_; }
+
+ private:
+  std::vector<MenuItemDescriptor> items_;
+};
+
+/**
+ * @brief Native operations performed by one Menu::Apply() call, submenus
+ * included.
+ */
+struct MenuApplyStats {
+  size_t inserted = 0;  ///< Items created and inserted
+  size_t removed = 0;   ///< Items removed
+  size_t moved = 0;     ///< Kept items moved to another position
+  size_t updated = 0;   ///< Property setter calls on kept items
+
+  /**
+   * @brief Total number of native operations.
+   */
+  size_t Total() const { return inserted + removed + moved + updated; }
+};
+
+}  // namespace nativeapi
@@ -21,11 +21,32 @@ std::shared_ptr<Image> Image::FromFile(const std::string& file_path) {
   return nullptr;
 }
 
-std::shared_ptr<Image> Image::FromBase64(const std::string& base64_data) {
+std::shared_ptr<Image> Image::FromBytes(const uint8_t* data, size_t size) {
+  ALOGW("Image::FromBytes not implemented on Android");
+  return nullptr;
+}
+
+std::shared_ptr<Image> Image::FromBase64(std::string_view base64_data) {
   ALOGW("Image::FromBase64 not implemented on Android");
   return nullptr;
 }
 
+std::shared_ptr<Image> Image::FromRawData(const uint8_t* pixels,
+                                          int width,
+                                          int height,
+                                          ImagePixelFormat format) {
+  ALOGW("Image::Image::FromRawData not implemented on Android");
+  return nullptr;
+}
+
+bool Image::ToRawData(std::vector<uint8_t>& pixels,
+                      int& width,
+                      int& height,
+                      ImagePixelFormat format) const {
+  ALOGW("Image::Image::ToRawData not implemented on Android");
+  return false;
+}
+
 Size Image::GetSize() const {
   return Size{0, 0};
 }
@@ -34,13 +55,8 @@ std::string Image::GetFormat() const {
   return "";
 }
 
-std::string Image::ToBase64() const {
-  ALOGW("Image::ToBase64 not implemented on Android");
-  return "";
-}
-
-bool Image::SaveToFile(const std::string& file_path) const {
-  ALOGW("Image::SaveToFile not implemented on Android");
+bool Image::EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
+  ALOGW("Image::EncodeNative not implemented on Android");
   return false;
 }
 
@@ -48,4 +64,12 @@ void* Image::GetNativeObjectInternal() const {
   return nullptr;
 }
 
+bool Image::IsDecoded() const {
+  return false;
+}
+
+bool Image::EnsureDecoded() const {
+  return false;
+}
+
 }  // namespace nativeapi
@@ -0,0 +1,99 @@
+#include <android/looper.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <deque>
+#include <mutex>
+
+#include "../../main_thread.h"
+
+namespace nativeapi {
+
+namespace {
+
+std::mutex g_tasks_mutex;
+std::deque<std::function<void()>> g_tasks;
+int g_wake_fds[2] = {-1, -1};  // pipe watched by the main thread's looper
+
+// The main thread of a process is the one whose thread id is the process id
+bool IsMainThread() {
+  return gettid() == getpid();
+}
+
+void RunPendingTasks() {
+  std::deque<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    tasks.swap(g_tasks);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+int OnWake(int fd, int events, void* data) {
+  char buffer[64];
+  while (read(fd, buffer, sizeof(buffer)) > 0) {
+  }
+  RunPendingTasks();
+  return 1;  // Keep watching
+}
+
+// Adds the wake pipe to the main thread's looper, from the main thread. Must
+// be called with g_tasks_mutex held.
+bool EnsureDispatcher() {
+  if (g_wake_fds[0] >= 0) {
+    return true;
+  }
+  ALooper* looper = IsMainThread() ? ALooper_forThread() : nullptr;
+  if (!looper || pipe2(g_wake_fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+    return false;
+  }
+  ALooper_acquire(looper);
+  ALooper_addFd(looper, g_wake_fds[0], ALOOPER_POLL_CALLBACK, ALOOPER_EVENT_INPUT, OnWake,
+                nullptr);
+  return true;
+}
+
+// A full pipe already has a wake-up pending, so a failed write is harmless
+void Wake() {
+  const char byte = 1;
+  (void)write(g_wake_fds[1], &byte, 1);
+}
+
+}  // namespace
+
+void PostToMainThread(std::function<void()> task) {
+  if (!task) {
+    return;
+  }
+  bool ready = false;
+  {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    g_tasks.push_back(std::move(task));
+    ready = EnsureDispatcher();
+  }
+  // Until the main thread has posted once or called
+  // PrepareMainThreadDispatcher(), tasks stay queued
+  if (ready) {
+    Wake();
+  }
+}
+
+void PrepareMainThreadDispatcher() {
+  bool ready = false;
+  bool has_tasks = false;
+  {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    ready = EnsureDispatcher();
+    has_tasks = !g_tasks.empty();
+  }
+  if (ready && has_tasks) {
+    Wake();
+  }
+}
+
+bool IsMainThreadDispatchSupported() {
+  return true;
+}
+
+}  // namespace nativeapi
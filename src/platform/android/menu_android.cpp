@@ -1,4 +1,8 @@
 #include <android/log.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "../../main_thread.h"
 #include "../../menu.h"
 
 #define LOG_TAG "NativeApi"
@@ -6,72 +10,122 @@
 
 namespace nativeapi {
 
+// Like the items, menus only keep their items until there are native menus
+// on Android.
 class Menu::Impl {
  public:
-  Impl() {}
+  explicit Impl(MenuId id) : id_(id) {}
+
+  MenuId id_;
+  void* native_menu_ = nullptr;
+  std::vector<std::shared_ptr<MenuItem>> items_;
+  size_t virtual_window_ = 0;  // Only reported back; items are drawn by the Java view
 };
 
-Menu::Menu() : pimpl_(std::make_unique<Impl>()) {}
-Menu::Menu(void* native_menu) : pimpl_(std::make_unique<Impl>()) {}
-Menu::~Menu() {}
+Menu::Menu() : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<Menu>())) {
+  PrepareMainThreadDispatcher();
+}
+
+Menu::Menu(void* native_menu) : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<Menu>())) {
+  pimpl_->native_menu_ = native_menu;
+  PrepareMainThreadDispatcher();
+}
+
+Menu::~Menu() = default;
 
 void* Menu::GetNativeObjectInternal() const {
-  return nullptr;
+  return pimpl_->native_menu_;
 }
 
 MenuId Menu::GetId() const {
-  return IdAllocator::kInvalidId;
+  return pimpl_->id_;
 }
 
 void Menu::AddItem(std::shared_ptr<MenuItem> item) {
-  ALOGW("Menu::AddItem not fully implemented on Android");
+  if (!item)
+    return;
+
+  pimpl_->items_.push_back(item);
+  LinkItem(item);
 }
 
 void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
-  ALOGW("Menu::InsertItem not implemented on Android");
+  if (!item)
+    return;
+
+  index = std::min(index, pimpl_->items_.size());
+  pimpl_->items_.insert(pimpl_->items_.begin() + index, item);
+  LinkItem(item);
 }
 
 bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
-  ALOGW("Menu::RemoveItem not implemented on Android");
-  return false;
+  auto it = std::find(pimpl_->items_.begin(), pimpl_->items_.end(), item);
+  if (!item || it == pimpl_->items_.end()) {
+    return false;
+  }
+  return RemoveItemAt(it - pimpl_->items_.begin());
 }
 
 bool Menu::RemoveItemById(MenuItemId item_id) {
-  ALOGW("Menu::RemoveItemById not implemented on Android");
+  for (size_t i = 0; i < pimpl_->items_.size(); ++i) {
+    if (pimpl_->items_[i]->GetId() == item_id) {
+      return RemoveItemAt(i);
+    }
+  }
   return false;
 }
 
 bool Menu::RemoveItemAt(size_t index) {
-  ALOGW("Menu::RemoveItemAt not implemented on Android");
-  return false;
+  if (index >= pimpl_->items_.size()) {
+    return false;
+  }
+  UnlinkItem(*pimpl_->items_[index]);
+  pimpl_->items_.erase(pimpl_->items_.begin() + index);
+  return true;
 }
 
 void Menu::Clear() {
-  ALOGW("Menu::Clear not implemented on Android");
+  for (const auto& item : pimpl_->items_) {
+    UnlinkItem(*item);
+  }
+  pimpl_->items_.clear();
 }
 
 void Menu::AddSeparator() {
-  ALOGW("Menu::AddSeparator not implemented on Android");
+  AddItem(std::make_shared<MenuItem>("", MenuItemType::Separator));
 }
 
 void Menu::InsertSeparator(size_t index) {
-  ALOGW("Menu::InsertSeparator not implemented on Android");
+  InsertItem(index, std::make_shared<MenuItem>("", MenuItemType::Separator));
 }
 
 size_t Menu::GetItemCount() const {
-  return 0;
+  return pimpl_->items_.size();
 }
 
 std::shared_ptr<MenuItem> Menu::GetItemAt(size_t index) const {
-  return nullptr;
+  return index < pimpl_->items_.size() ? pimpl_->items_[index] : nullptr;
 }
 
 std::shared_ptr<MenuItem> Menu::GetItemById(MenuItemId item_id) const {
+  for (const auto& item : pimpl_->items_) {
+    if (item->GetId() == item_id) {
+      return item;
+    }
+  }
   return nullptr;
 }
 
 std::vector<std::shared_ptr<MenuItem>> Menu::GetAllItems() const {
-  return {};
+  return pimpl_->items_;
+}
+
+void Menu::SetVirtualWindow(size_t visible_items) {
+  pimpl_->virtual_window_ = visible_items;
+}
+
+size_t Menu::GetVirtualWindow() const {
+  return pimpl_->virtual_window_;
 }
 
 bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
@@ -31,6 +31,17 @@ std::shared_ptr<Image> TrayIcon::GetIcon() const {
   return nullptr;
 }
 
+bool TrayIcon::SetIconAnimation(const std::vector<std::shared_ptr<Image>>& frames,
+                                std::chrono::milliseconds frame_interval) {
+  return false;
+}
+
+void TrayIcon::StopIconAnimation() {}
+
+bool TrayIcon::IsIconAnimating() const {
+  return false;
+}
+
 void TrayIcon::SetTitle(std::optional<std::string> title) {
   ALOGW("TrayIcon::SetTitle uses Android notification title");
 }
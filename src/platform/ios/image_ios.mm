@@ -1,26 +1,148 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "../../foundation/base64.h"
+#include "../../foundation/image_header.h"
 #include "../../image.h"
 
 namespace nativeapi {
 
+// Format name for files whose contents were not recognized by the header probe
+static std::string FormatFromExtension(NSString* path) {
+  NSString* extension = [[path pathExtension] lowercaseString];
+  if ([extension isEqualToString:@"png"]) {
+    return "PNG";
+  } else if ([extension isEqualToString:@"jpg"] || [extension isEqualToString:@"jpeg"]) {
+    return "JPEG";
+  } else if ([extension isEqualToString:@"gif"]) {
+    return "GIF";
+  }
+  return "Unknown";
+}
+
+// Draws |cgImage| into a premultiplied RGBA context and converts the result
+// to tightly packed, straight-alpha pixels in the requested channel order.
+static bool CopyCGImagePixels(CGImageRef cgImage,
+                              std::vector<uint8_t>& pixels,
+                              int& width,
+                              int& height,
+                              ImagePixelFormat format) {
+  if (!cgImage) {
+    return false;
+  }
+  width = static_cast<int>(CGImageGetWidth(cgImage));
+  height = static_cast<int>(CGImageGetHeight(cgImage));
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  pixels.assign(row_bytes * height, 0);
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef context =
+      CGBitmapContextCreate(pixels.data(), width, height, 8, row_bytes, colorSpace,
+                            kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big);
+  CGColorSpaceRelease(colorSpace);
+  if (!context) {
+    return false;
+  }
+  CGContextSetBlendMode(context, kCGBlendModeCopy);
+  CGContextDrawImage(context, CGRectMake(0, 0, width, height), cgImage);
+  CGContextRelease(context);
+
+  const bool swap = format == ImagePixelFormat::BGRA32;
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    uint8_t* p = &pixels[i];
+    const uint8_t a = p[3];
+    if (a != 0 && a != 255) {
+      p[0] = static_cast<uint8_t>(std::min(255, (p[0] * 255 + a / 2) / a));
+      p[1] = static_cast<uint8_t>(std::min(255, (p[1] * 255 + a / 2) / a));
+      p[2] = static_cast<uint8_t>(std::min(255, (p[2] * 255 + a / 2) / a));
+    }
+    if (swap) {
+      std::swap(p[0], p[2]);
+    }
+  }
+  return true;
+}
+
+// Creating the UIImage is deferred until it is first needed whenever the
+// header probe yields the dimensions.
 class Image::Impl {
  public:
-  Impl() : ui_image_(nil), size_({0, 0}), format_("Unknown") {}
+  Impl() : ui_image_(nil), encoded_(nil), size_({0, 0}), format_("Unknown") {}
 
   UIImage* ui_image_;
+  std::string source_;
+  NSData* encoded_;
   Size size_;
   std::string format_;
+  std::mutex decode_mutex_;
+
+  // Returns the UIImage, creating it from the deferred source on first use
+  UIImage* EnsureDecoded() {
+    std::lock_guard<std::mutex> lock(decode_mutex_);
+    if (ui_image_) {
+      return ui_image_;
+    }
+    if (encoded_) {
+      ui_image_ = [UIImage imageWithData:encoded_];
+      if (ui_image_) {
+        encoded_ = nil;
+      }
+    } else if (!source_.empty()) {
+      ui_image_ = [UIImage imageWithContentsOfFile:[NSString stringWithUTF8String:source_.c_str()]];
+    }
+    // An ICO header only names its largest entry, which the decoder may
+    // not pick; the decoded image decides the size
+    if (ui_image_ && format_ == "ICO") {
+      CGSize imageSize = ui_image_.size;
+      size_ = {static_cast<double>(imageSize.width), static_cast<double>(imageSize.height)};
+    }
+    return ui_image_;
+  }
+
+  // Creates an image from encoded bytes, deferring the decode when the
+  // header already provides the dimensions. |data| is retained, not copied.
+  static std::shared_ptr<Image> FromEncoded(NSData* data) {
+    ImageHeaderInfo header =
+        ImageHeader::Probe(static_cast<const uint8_t*>([data bytes]), [data length]);
+    auto image = std::shared_ptr<Image>(new Image());
+    Impl* impl = image->pimpl_.get();
+    impl->format_ = header.format.empty() ? "Unknown" : header.format;
+    impl->encoded_ = data;
+
+    if (header.HasSize()) {
+      impl->size_ = {static_cast<double>(header.width), static_cast<double>(header.height)};
+      return image;
+    }
+
+    UIImage* uiImage = impl->EnsureDecoded();
+    if (!uiImage) {
+      return nullptr;
+    }
+    CGSize imageSize = uiImage.size;
+    impl->size_ = {static_cast<double>(imageSize.width), static_cast<double>(imageSize.height)};
+    return image;
+  }
 };
 
 Image::Image() : pimpl_(std::make_unique<Impl>()) {}
 Image::~Image() {}
 
 Image::Image(const Image& other) : pimpl_(std::make_unique<Impl>()) {
-  if (other.pimpl_ && other.pimpl_->ui_image_) {
+  if (other.pimpl_) {
+    // EnsureDecoded() may be swapping the encoded bytes on a worker thread
+    std::lock_guard<std::mutex> lock(other.pimpl_->decode_mutex_);
     pimpl_->ui_image_ = other.pimpl_->ui_image_;
+    pimpl_->source_ = other.pimpl_->source_;
+    pimpl_->encoded_ = other.pimpl_->encoded_;
     pimpl_->size_ = other.pimpl_->size_;
     pimpl_->format_ = other.pimpl_->format_;
   }
@@ -29,66 +151,113 @@ Image::Image(const Image& other) : pimpl_(std::make_unique<Impl>()) {
 Image::Image(Image&& other) noexcept : pimpl_(std::move(other.pimpl_)) {}
 
 std::shared_ptr<Image> Image::FromFile(const std::string& file_path) {
+  // Only the header is read here; the pixels are decoded on first use.
+  ImageHeaderInfo header = ImageHeader::ProbeFile(file_path);
   auto image = std::shared_ptr<Image>(new Image());
-  NSString* nsPath = [NSString stringWithUTF8String:file_path.c_str()];
-  UIImage* uiImage = [UIImage imageWithContentsOfFile:nsPath];
-
-  if (uiImage) {
-    image->pimpl_->ui_image_ = uiImage;
-
-    // Get actual image size
-    CGSize size = uiImage.size;
-    image->pimpl_->size_ = {static_cast<double>(size.width), static_cast<double>(size.height)};
-
-    // Determine format from file extension
-    NSString* extension = [[nsPath pathExtension] lowercaseString];
-    if ([extension isEqualToString:@"png"]) {
-      image->pimpl_->format_ = "PNG";
-    } else if ([extension isEqualToString:@"jpg"] || [extension isEqualToString:@"jpeg"]) {
-      image->pimpl_->format_ = "JPEG";
-    } else if ([extension isEqualToString:@"gif"]) {
-      image->pimpl_->format_ = "GIF";
-    } else {
-      image->pimpl_->format_ = "Unknown";
-    }
-  } else {
+  image->pimpl_->source_ = file_path;
+  image->pimpl_->format_ =
+      header.format.empty()
+          ? FormatFromExtension([NSString stringWithUTF8String:file_path.c_str()])
+          : header.format;
+
+  if (header.HasSize()) {
+    image->pimpl_->size_ = {static_cast<double>(header.width),
+                            static_cast<double>(header.height)};
+    return image;
+  }
+
+  UIImage* uiImage = image->pimpl_->EnsureDecoded();
+  if (!uiImage) {
     return nullptr;
   }
 
+  // Get actual image size
+  CGSize size = uiImage.size;
+  image->pimpl_->size_ = {static_cast<double>(size.width), static_cast<double>(size.height)};
+
   return image;
 }
 
-std::shared_ptr<Image> Image::FromBase64(const std::string& base64_data) {
-  auto image = std::shared_ptr<Image>(new Image());
-  // Parse data URI if present
-  std::string data = base64_data;
-  size_t pos = data.find(",");
-  if (pos != std::string::npos) {
-    data = data.substr(pos + 1);
+std::shared_ptr<Image> Image::FromBytes(const uint8_t* data, size_t size) {
+  if (!data || size == 0) {
+    return nullptr;
   }
+  return Impl::FromEncoded([NSData dataWithBytes:data length:size]);
+}
 
-  NSData* nsData =
-      [[NSData alloc] initWithBase64EncodedString:[NSString stringWithUTF8String:data.c_str()]
-                                          options:0];
-  UIImage* uiImage = [UIImage imageWithData:nsData];
+std::shared_ptr<Image> Image::FromBase64(std::string_view base64_data) {
+  // Skip the data URI prefix in place and decode straight into the NSData buffer
+  std::string_view payload = Base64::StripDataUriPrefix(base64_data);
+  NSMutableData* nsData = [NSMutableData dataWithLength:Base64::MaxDecodedLength(payload.size())];
+  size_t decodedSize = 0;
+  if (!Base64::Decode(payload, static_cast<uint8_t*>([nsData mutableBytes]), [nsData length],
+                      &decodedSize) ||
+      decodedSize == 0) {
+    return nullptr;
+  }
+  [nsData setLength:decodedSize];
 
-  if (uiImage) {
-    image->pimpl_->ui_image_ = uiImage;
+  return Impl::FromEncoded(nsData);
+}
 
-    // Get actual image size
-    CGSize size = uiImage.size;
-    image->pimpl_->size_ = {static_cast<double>(size.width), static_cast<double>(size.height)};
+std::shared_ptr<Image> Image::FromRawData(const uint8_t* pixels,
+                                          int width,
+                                          int height,
+                                          ImagePixelFormat format) {
+  if (!pixels || width <= 0 || height <= 0) {
+    return nullptr;
+  }
 
-    // Default assumption for base64 images
-    image->pimpl_->format_ = "PNG";
-  } else {
+  NSMutableData* nsData = [NSMutableData dataWithLength:static_cast<size_t>(width) * height * 4];
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = pixels + y * row_bytes;
+    uint8_t* out = static_cast<uint8_t*>([nsData mutableBytes]) + y * row_bytes;
+    if (format == ImagePixelFormat::RGBA32) {
+      memcpy(out, in, row_bytes);
+    } else {
+      for (int x = 0; x < width; ++x) {
+        out[x * 4 + 0] = in[x * 4 + 2];
+        out[x * 4 + 1] = in[x * 4 + 1];
+        out[x * 4 + 2] = in[x * 4 + 0];
+        out[x * 4 + 3] = in[x * 4 + 3];
+      }
+    }
+  }
+
+  CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)nsData);
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGImageRef cgImage =
+      CGImageCreate(width, height, 8, 32, row_bytes, colorSpace,
+                    kCGImageAlphaLast | kCGBitmapByteOrder32Big, provider, NULL, false,
+                    kCGRenderingIntentDefault);
+  CGColorSpaceRelease(colorSpace);
+  CGDataProviderRelease(provider);
+  if (!cgImage) {
     return nullptr;
   }
+  UIImage* uiImage = [UIImage imageWithCGImage:cgImage];
+  CGImageRelease(cgImage);
 
+  auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->ui_image_ = uiImage;
+  image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
   return image;
 }
 
+bool Image::ToRawData(std::vector<uint8_t>& pixels,
+                      int& width,
+                      int& height,
+                      ImagePixelFormat format) const {
+  UIImage* uiImage = pimpl_->EnsureDecoded();
+  if (!uiImage) {
+    return false;
+  }
+  return CopyCGImagePixels(uiImage.CGImage, pixels, width, height, format);
+}
+
 Size Image::GetSize() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
   return pimpl_->size_;
 }
 
@@ -96,28 +265,46 @@ std::string Image::GetFormat() const {
   return pimpl_->format_;
 }
 
-std::string Image::ToBase64() const {
-  if (!pimpl_->ui_image_) {
-    return "";
+bool Image::EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
+  NSData* imageData = nil;
+  {
+    // Still-encoded PNG data can be passed through without decoding
+    std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+    if (options.format == ImageEncodeFormat::PNG && !pimpl_->ui_image_ && pimpl_->encoded_ &&
+        pimpl_->format_ == "PNG") {
+      imageData = pimpl_->encoded_;
+    }
   }
 
-  NSData* pngData = UIImagePNGRepresentation(pimpl_->ui_image_);
-  NSString* base64String = [pngData base64EncodedStringWithOptions:0];
-  return std::string("data:image/png;base64,") + [base64String UTF8String];
-}
-
-bool Image::SaveToFile(const std::string& file_path) const {
-  if (!pimpl_->ui_image_) {
+  if (!imageData) {
+    UIImage* uiImage = pimpl_->EnsureDecoded();
+    if (!uiImage) {
+      return false;
+    }
+    // UIKit only writes PNG and JPEG
+    if (options.format == ImageEncodeFormat::PNG) {
+      imageData = UIImagePNGRepresentation(uiImage);
+    } else if (options.format == ImageEncodeFormat::JPEG) {
+      imageData = UIImageJPEGRepresentation(uiImage, std::clamp(options.quality, 1, 100) / 100.0);
+    }
+  }
+  if (!imageData) {
     return false;
   }
-
-  NSData* pngData = UIImagePNGRepresentation(pimpl_->ui_image_);
-  NSString* nsPath = [NSString stringWithUTF8String:file_path.c_str()];
-  return [pngData writeToFile:nsPath atomically:YES];
+  return sink(static_cast<const uint8_t*>([imageData bytes]), [imageData length]);
 }
 
 void* Image::GetNativeObjectInternal() const {
-  return (__bridge void*)pimpl_->ui_image_;
+  return (__bridge void*)pimpl_->EnsureDecoded();
+}
+
+bool Image::IsDecoded() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+  return pimpl_->ui_image_ != nullptr;
+}
+
+bool Image::EnsureDecoded() const {
+  return pimpl_->EnsureDecoded() != nullptr;
 }
 
 }  // namespace nativeapi
@@ -0,0 +1,23 @@
+#import <Foundation/Foundation.h>
+
+#include "../../main_thread.h"
+
+namespace nativeapi {
+
+void PostToMainThread(std::function<void()> task) {
+  if (!task) {
+    return;
+  }
+  __block std::function<void()> block_task = std::move(task);
+  dispatch_async(dispatch_get_main_queue(), ^{
+    block_task();
+  });
+}
+
+void PrepareMainThreadDispatcher() {}
+
+bool IsMainThreadDispatchSupported() {
+  return true;
+}
+
+}  // namespace nativeapi
@@ -1,5 +1,7 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
+#include <algorithm>
+#include <vector>
 #include "../../foundation/id_allocator.h"
 #include "../../image.h"
 #include "../../menu.h"
@@ -17,6 +19,7 @@ class MenuItem::Impl {
   std::optional<std::string> tooltip_;
   KeyboardAccelerator accelerator_;
   bool has_accelerator_;
+  bool enabled_;
   MenuItemState state_;
   int radio_group_;
   std::shared_ptr<Menu> submenu_;
@@ -26,6 +29,7 @@ class MenuItem::Impl {
         type_(type),
         accelerator_("", ModifierKey::None),
         has_accelerator_(false),
+        enabled_(true),
         state_(MenuItemState::Unchecked),
         radio_group_(-1) {}
 };
@@ -84,6 +88,7 @@ void MenuItem::SetAccelerator(const std::optional<KeyboardAccelerator>& accelera
     pimpl_->has_accelerator_ = false;
     pimpl_->accelerator_ = KeyboardAccelerator("", ModifierKey::None);
   }
+  LinkAccelerator(GetAccelerator());
 }
 
 KeyboardAccelerator MenuItem::GetAccelerator() const {
@@ -94,11 +99,11 @@ KeyboardAccelerator MenuItem::GetAccelerator() const {
 }
 
 void MenuItem::SetEnabled(bool enabled) {
-  // iOS implementation would go here
+  pimpl_->enabled_ = enabled;
 }
 
 bool MenuItem::IsEnabled() const {
-  return true;
+  return pimpl_->enabled_;
 }
 
 void MenuItem::SetState(MenuItemState state) {
@@ -107,6 +112,7 @@ void MenuItem::SetState(MenuItemState state) {
       return;
     }
     pimpl_->state_ = state;
+    SyncRadioGroup();
   }
 }
 
@@ -115,7 +121,9 @@ MenuItemState MenuItem::GetState() const {
 }
 
 void MenuItem::SetRadioGroup(int group_id) {
+  ForgetRadioGroup();
   pimpl_->radio_group_ = group_id;
+  SyncRadioGroup();
 }
 
 int MenuItem::GetRadioGroup() const {
@@ -124,6 +132,7 @@ int MenuItem::GetRadioGroup() const {
 
 void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
   pimpl_->submenu_ = submenu;
+  LinkSubmenu(submenu);
 }
 
 std::shared_ptr<Menu> MenuItem::GetSubmenu() const {
@@ -135,65 +144,111 @@ void* MenuItem::GetNativeObjectInternal() const {
 }
 
 // Menu::Impl implementation
+//
+// iOS menus are context menus or action sheets, built from the items when
+// shown; until then the items are kept here.
 class Menu::Impl {
  public:
-  Impl() {}
+  explicit Impl(MenuId id) : id_(id) {}
+
+  MenuId id_;
+  std::vector<std::shared_ptr<MenuItem>> items_;
+  size_t virtual_window_ = 0;  // Only reported back; UIMenu builds item views itself
 };
 
-Menu::Menu() : pimpl_(std::make_unique<Impl>()) {}
-Menu::Menu(void* native_menu) : pimpl_(std::make_unique<Impl>()) {}
+Menu::Menu() : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<Menu>())) {}
+Menu::Menu(void* native_menu) : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<Menu>())) {}
 Menu::~Menu() {}
 
 MenuId Menu::GetId() const {
-  return IdAllocator::kInvalidId;
+  return pimpl_->id_;
 }
 
 void Menu::AddItem(std::shared_ptr<MenuItem> item) {
-  // iOS menus are context menus or action sheets
+  if (!item)
+    return;
+
+  pimpl_->items_.push_back(item);
+  LinkItem(item);
 }
 
 void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
-  // Implementation needed
+  if (!item)
+    return;
+
+  index = std::min(index, pimpl_->items_.size());
+  pimpl_->items_.insert(pimpl_->items_.begin() + index, item);
+  LinkItem(item);
 }
 
 bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
-  return false;
+  auto it = std::find(pimpl_->items_.begin(), pimpl_->items_.end(), item);
+  if (!item || it == pimpl_->items_.end()) {
+    return false;
+  }
+  return RemoveItemAt(it - pimpl_->items_.begin());
 }
 
 bool Menu::RemoveItemById(MenuItemId item_id) {
+  for (size_t i = 0; i < pimpl_->items_.size(); ++i) {
+    if (pimpl_->items_[i]->GetId() == item_id) {
+      return RemoveItemAt(i);
+    }
+  }
   return false;
 }
 
 bool Menu::RemoveItemAt(size_t index) {
-  return false;
+  if (index >= pimpl_->items_.size()) {
+    return false;
+  }
+  UnlinkItem(*pimpl_->items_[index]);
+  pimpl_->items_.erase(pimpl_->items_.begin() + index);
+  return true;
 }
 
 void Menu::Clear() {
-  // Implementation needed
+  for (const auto& item : pimpl_->items_) {
+    UnlinkItem(*item);
+  }
+  pimpl_->items_.clear();
 }
 
 void Menu::AddSeparator() {
-  // Implementation needed
+  AddItem(std::make_shared<MenuItem>("", MenuItemType::Separator));
 }
 
 void Menu::InsertSeparator(size_t index) {
-  // Implementation needed
+  InsertItem(index, std::make_shared<MenuItem>("", MenuItemType::Separator));
 }
 
 size_t Menu::GetItemCount() const {
-  return 0;
+  return pimpl_->items_.size();
 }
 
 std::shared_ptr<MenuItem> Menu::GetItemAt(size_t index) const {
-  return nullptr;
+  return index < pimpl_->items_.size() ? pimpl_->items_[index] : nullptr;
 }
 
 std::shared_ptr<MenuItem> Menu::GetItemById(MenuItemId item_id) const {
+  for (const auto& item : pimpl_->items_) {
+    if (item->GetId() == item_id) {
+      return item;
+    }
+  }
   return nullptr;
 }
 
 std::vector<std::shared_ptr<MenuItem>> Menu::GetAllItems() const {
-  return std::vector<std::shared_ptr<MenuItem>>();
+  return pimpl_->items_;
+}
+
+void Menu::SetVirtualWindow(size_t visible_items) {
+  pimpl_->virtual_window_ = visible_items;
+}
+
+size_t Menu::GetVirtualWindow() const {
+  return pimpl_->virtual_window_;
 }
 
 bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
@@ -26,6 +26,17 @@ std::shared_ptr<Image> TrayIcon::GetIcon() const {
   return nullptr;
 }
 
+bool TrayIcon::SetIconAnimation(const std::vector<std::shared_ptr<Image>>& frames,
+                                std::chrono::milliseconds frame_interval) {
+  return false;
+}
+
+void TrayIcon::StopIconAnimation() {}
+
+bool TrayIcon::IsIconAnimating() const {
+  return false;
+}
+
 void TrayIcon::SetTitle(std::optional<std::string> title) {
   // Not applicable to iOS
 }
@@ -0,0 +1,874 @@
+// com.canonical.dbusmenu exporter used by the StatusNotifierItem tray icon.
+// https://github.com/AyatanaIndicators/libdbusmenu/blob/master/libdbusmenu-glib/dbus-menu.xml
+
+#include "dbus_menu_exporter_linux.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <unordered_set>
+#include <utility>
+
+#include "../../image.h"
+#include "../../menu_event.h"
+
+namespace nativeapi {
+
+static const char kDbusMenuIntrospectionXml[] =
+    "<node>"
+    "  <interface name='com.canonical.dbusmenu'>"
+    "    <property name='Version' type='u' access='read'/>"
+    "    <property name='TextDirection' type='s' access='read'/>"
+    "    <property name='Status' type='s' access='read'/>"
+    "    <property name='IconThemePath' type='as' access='read'/>"
+    "    <method name='GetLayout'>"
+    "      <arg type='i' name='parentId' direction='in'/>"
+    "      <arg type='i' name='recursionDepth' direction='in'/>"
+    "      <arg type='as' name='propertyNames' direction='in'/>"
+    "      <arg type='u' name='revision' direction='out'/>"
+    "      <arg type='(ia{sv}av)' name='layout' direction='out'/>"
+    "    </method>"
+    "    <method name='GetGroupProperties'>"
+    "      <arg type='ai' name='ids' direction='in'/>"
+    "      <arg type='as' name='propertyNames' direction='in'/>"
+    "      <arg type='a(ia{sv})' name='properties' direction='out'/>"
+    "    </method>"
+    "    <method name='GetProperty'>"
+    "      <arg type='i' name='id' direction='in'/>"
+    "      <arg type='s' name='name' direction='in'/>"
+    "      <arg type='v' name='value' direction='out'/>"
+    "    </method>"
+    "    <method name='Event'>"
+    "      <arg type='i' name='id' direction='in'/>"
+    "      <arg type='s' name='eventId' direction='in'/>"
+    "      <arg type='v' name='data' direction='in'/>"
+    "      <arg type='u' name='timestamp' direction='in'/>"
+    "    </method>"
+    "    <method name='EventGroup'>"
+    "      <arg type='a(isvu)' name='events' direction='in'/>"
+    "      <arg type='ai' name='idErrors' direction='out'/>"
+    "    </method>"
+    "    <method name='AboutToShow'>"
+    "      <arg type='i' name='id' direction='in'/>"
+    "      <arg type='b' name='needUpdate' direction='out'/>"
+    "    </method>"
+    "    <method name='AboutToShowGroup'>"
+    "      <arg type='ai' name='ids' direction='in'/>"
+    "      <arg type='ai' name='updatesNeeded' direction='out'/>"
+    "      <arg type='ai' name='idErrors' direction='out'/>"
+    "    </method>"
+    "    <signal name='ItemsPropertiesUpdated'>"
+    "      <arg type='a(ia{sv})' name='updatedProps'/>"
+    "      <arg type='a(ias)' name='removedProps'/>"
+    "    </signal>"
+    "    <signal name='LayoutUpdated'>"
+    "      <arg type='u' name='revision'/>"
+    "      <arg type='i' name='parent'/>"
+    "    </signal>"
+    "    <signal name='ItemActivationRequested'>"
+    "      <arg type='i' name='id'/>"
+    "      <arg type='u' name='timestamp'/>"
+    "    </signal>"
+    "  </interface>"
+    "</node>";
+
+static const char kDbusMenuInterface[] = "com.canonical.dbusmenu";
+
+static std::vector<std::string> StringArrayToVector(GVariant* array) {
+  std::vector<std::string> result;
+  if (!array) {
+    return result;
+  }
+  GVariantIter iter;
+  const gchar* value = nullptr;
+  g_variant_iter_init(&iter, array);
+  while (g_variant_iter_next(&iter, "&s", &value)) {
+    result.emplace_back(value);
+  }
+  return result;
+}
+
+// Menu icons are drawn at 16 logical pixels; 32 covers a 2x panel.
+constexpr int kMaxIconDataSize = 32;
+
+// "icon-data" value: the icon as PNG bytes, or nullptr if it cannot be encoded
+static GVariant* BuildIconData(const Image& image) {
+  std::shared_ptr<Image> scaled;
+  const Size size = image.GetSize();
+  const double longest = std::max(size.width, size.height);
+  if (longest > kMaxIconDataSize) {
+    // Scale the longer edge down so non-square icons keep their shape
+    const double ratio = kMaxIconDataSize / longest;
+    scaled = image.Resize({std::max(1.0, std::round(size.width * ratio)),
+                           std::max(1.0, std::round(size.height * ratio))},
+                          ResampleFilter::Lanczos3);
+  }
+
+  std::vector<uint8_t> png;
+  ImageEncodeOptions options;
+  options.png_mode = PngEncodeMode::Fast;
+  const bool encoded = (scaled ? *scaled : image).EncodeTo(
+      [&png](const uint8_t* data, size_t length) {
+        png.insert(png.end(), data, data + length);
+        return true;
+      },
+      options);
+  if (!encoded || png.empty()) {
+    return nullptr;
+  }
+  return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, png.data(), png.size(), sizeof(uint8_t));
+}
+
+// "shortcut" value: one key combination of modifier names followed by the key
+static GVariant* BuildShortcut(const KeyboardAccelerator& accelerator) {
+  static const struct {
+    ModifierKey modifier;
+    const char* name;
+  } kModifierNames[] = {
+      {ModifierKey::Ctrl, "Control"},
+      {ModifierKey::Alt, "Alt"},
+      {ModifierKey::Shift, "Shift"},
+      {ModifierKey::Meta, "Super"},
+  };
+
+  GVariantBuilder keys;
+  g_variant_builder_init(&keys, G_VARIANT_TYPE("as"));
+  for (const auto& entry : kModifierNames) {
+    if ((accelerator.modifiers & entry.modifier) != ModifierKey::None) {
+      g_variant_builder_add(&keys, "s", entry.name);
+    }
+  }
+  g_variant_builder_add(&keys, "s", accelerator.key.c_str());
+
+  GVariantBuilder shortcut;
+  g_variant_builder_init(&shortcut, G_VARIANT_TYPE("aas"));
+  g_variant_builder_add_value(&shortcut, g_variant_builder_end(&keys));
+  return g_variant_builder_end(&shortcut);
+}
+
+static bool IsActivationEvent(const gchar* event_id) {
+  return g_strcmp0(event_id, "clicked") == 0 || g_strcmp0(event_id, "activated") == 0;
+}
+
+DbusMenuExporter::DbusMenuExporter(GDBusConnection* connection, std::string object_path)
+    : connection_(connection),
+      object_path_(std::move(object_path)),
+      registration_id_(0),
+      flush_source_id_(0),
+      revision_(1) {
+  if (connection_) {
+    g_object_ref(connection_);
+  }
+  nodes_[kRootId] = Node{};
+  AddMenuObserver(this);
+}
+
+DbusMenuExporter::~DbusMenuExporter() {
+  RemoveMenuObserver(this);
+  Unregister();
+  if (connection_) {
+    g_object_unref(connection_);
+    connection_ = nullptr;
+  }
+}
+
+bool DbusMenuExporter::Register() {
+  if (!connection_) {
+    return false;
+  }
+  if (registration_id_ != 0) {
+    return true;
+  }
+
+  GError* error = nullptr;
+  GDBusNodeInfo* node_info = g_dbus_node_info_new_for_xml(kDbusMenuIntrospectionXml, &error);
+  if (!node_info) {
+    if (error) {
+      std::cerr << "[nativeapi] dbusmenu: Bad introspection XML: " << error->message << std::endl;
+      g_error_free(error);
+    }
+    return false;
+  }
+
+  static const GDBusInterfaceVTable vtable = {
+      &DbusMenuExporter::OnMethodCall,
+      &DbusMenuExporter::OnGetProperty,
+      nullptr  // no writable properties
+  };
+
+  registration_id_ = g_dbus_connection_register_object(
+      connection_, object_path_.c_str(),
+      g_dbus_node_info_lookup_interface(node_info, kDbusMenuInterface), &vtable, this, nullptr,
+      &error);
+  g_dbus_node_info_unref(node_info);
+
+  if (registration_id_ == 0) {
+    if (error) {
+      std::cerr << "[nativeapi] dbusmenu: Object registration failed: " << error->message
+                << std::endl;
+      g_error_free(error);
+    }
+    return false;
+  }
+  return true;
+}
+
+void DbusMenuExporter::Unregister() {
+  if (flush_source_id_ != 0) {
+    g_source_remove(flush_source_id_);
+    flush_source_id_ = 0;
+  }
+  dirty_items_.clear();
+  stale_menus_.clear();
+  layout_parents_.clear();
+  if (connection_ && registration_id_ != 0) {
+    g_dbus_connection_unregister_object(connection_, registration_id_);
+    registration_id_ = 0;
+  }
+}
+
+void DbusMenuExporter::SetMenu(std::shared_ptr<Menu> menu) {
+  nodes_.clear();
+  menu_nodes_.clear();
+  dirty_items_.clear();
+  stale_menus_.clear();
+  layout_parents_.clear();
+
+  nodes_[kRootId] = Node{};
+  AttachSubmenu(kRootId, std::move(menu));
+  Node& root = nodes_.at(kRootId);
+  root.properties = BuildProperties(root);
+  MarkLayoutChanged(kRootId);
+}
+
+// ── Model maintenance ────────────────────────────────────────────────────────
+
+int DbusMenuExporter::AddNode(const std::shared_ptr<MenuItem>& item, int parent_id) {
+  const int id = ToDbusId(item->GetId());
+  if (nodes_.count(id) != 0) {
+    // Already exported under another parent; detach it from there first.
+    Node& previous = nodes_.at(id);
+    std::vector<int>& siblings = nodes_.at(previous.parent_id).children;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), id), siblings.end());
+    RemoveNode(id);
+  }
+  Node& node = nodes_[id];
+  node.parent_id = parent_id;
+  node.item = item;
+  AttachSubmenu(id, item->GetSubmenu());
+  // Element references of unordered_map survive rehashing, so |node| is
+  // still valid after the recursive insertions above.
+  node.properties = BuildProperties(node);
+  return id;
+}
+
+void DbusMenuExporter::RemoveNode(int id) {
+  auto it = nodes_.find(id);
+  if (it == nodes_.end()) {
+    return;
+  }
+  Node node = std::move(it->second);
+  nodes_.erase(it);
+
+  for (int child_id : node.children) {
+    auto child = nodes_.find(child_id);
+    if (child != nodes_.end() && child->second.parent_id == id) {
+      RemoveNode(child_id);
+    }
+  }
+  if (node.submenu) {
+    auto menu_it = menu_nodes_.find(node.submenu->GetId());
+    if (menu_it != menu_nodes_.end() && menu_it->second == id) {
+      menu_nodes_.erase(menu_it);
+    }
+  }
+  dirty_items_.erase(id);
+  stale_menus_.erase(id);
+}
+
+void DbusMenuExporter::RebuildChildren(int id) {
+  Node& node = nodes_.at(id);
+  std::vector<int> old_children = std::move(node.children);
+  const std::unordered_set<int> previous(old_children.begin(), old_children.end());
+  std::vector<int> children;
+
+  if (node.submenu) {
+    for (const auto& item : node.submenu->GetAllItems()) {
+      if (!item) {
+        continue;
+      }
+      // Items that stay in the menu keep their node and cached properties.
+      const int child_id = ToDbusId(item->GetId());
+      if (previous.count(child_id) != 0) {
+        children.push_back(child_id);
+      } else if (CanNest(child_id, id)) {
+        children.push_back(AddNode(item, id));
+      }
+    }
+  }
+
+  const std::unordered_set<int> kept(children.begin(), children.end());
+  for (int child_id : old_children) {
+    auto child = nodes_.find(child_id);
+    if (kept.count(child_id) == 0 && child != nodes_.end() && child->second.parent_id == id) {
+      RemoveNode(child_id);
+    }
+  }
+  nodes_.at(id).children = std::move(children);
+}
+
+// Whether |ancestor| is |id| or lies on its path to the root
+bool DbusMenuExporter::IsSelfOrAncestor(int ancestor, int id) const {
+  for (int node = id;; node = nodes_.at(node).parent_id) {
+    if (node == ancestor) {
+      return true;
+    }
+    if (node == kRootId) {
+      return false;
+    }
+  }
+}
+
+// An item can be exported below |parent_id| unless it is that node or one of
+// its ancestors, which happens when submenus form a cycle, or it would nest
+// deeper than Menu::kMaxSubmenuDepth. Moving an ancestor would free the
+// nodes the recursion above is still building.
+bool DbusMenuExporter::CanNest(int id, int parent_id) const {
+  int depth = 0;
+  for (int node = parent_id; node != kRootId; node = nodes_.at(node).parent_id) {
+    if (node == id || ++depth >= Menu::kMaxSubmenuDepth) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DbusMenuExporter::AttachSubmenu(int id, std::shared_ptr<Menu> submenu) {
+  Node& node = nodes_.at(id);
+  node.submenu = std::move(submenu);
+  if (node.submenu) {
+    // Where the submenu closes a cycle it stays with the outer node, which
+    // is the one exporting its items
+    auto [it, inserted] = menu_nodes_.emplace(node.submenu->GetId(), id);
+    if (!inserted && !IsSelfOrAncestor(it->second, id)) {
+      it->second = id;
+    }
+  }
+  RebuildChildren(id);
+}
+
+// Diffs the children of every node whose menu changed since the last sync,
+// once per node however many insertions and removals it saw, and bumps the
+// revision once for each.
+void DbusMenuExporter::SyncStaleMenus() {
+  if (stale_menus_.empty()) {
+    return;
+  }
+  // Rebuilding a parent may remove stale descendants, which erases them from
+  // |stale_menus_|; take the set before iterating.
+  std::set<int> stale;
+  stale.swap(stale_menus_);
+  for (int id : stale) {
+    if (nodes_.count(id) == 0) {
+      continue;
+    }
+    RebuildChildren(id);
+    ++revision_;
+    layout_parents_.insert(id);
+  }
+}
+
+void DbusMenuExporter::MarkLayoutChanged(int parent_id) {
+  ++revision_;
+  layout_parents_.insert(parent_id);
+  ScheduleFlush();
+}
+
+void DbusMenuExporter::OnMenuItemChanged(const MenuItem& item) {
+  const int id = ToDbusId(item.GetId());
+  if (nodes_.count(id) == 0) {
+    return;
+  }
+  dirty_items_.insert(id);
+  ScheduleFlush();
+}
+
+void DbusMenuExporter::OnMenuItemSubmenuChanged(const MenuItem& item) {
+  const int id = ToDbusId(item.GetId());
+  auto it = nodes_.find(id);
+  if (it == nodes_.end()) {
+    return;
+  }
+  Node& node = it->second;
+  std::shared_ptr<Menu> submenu = item.GetSubmenu();
+  if (node.submenu == submenu) {
+    return;
+  }
+
+  if (node.submenu) {
+    auto menu_it = menu_nodes_.find(node.submenu->GetId());
+    if (menu_it != menu_nodes_.end() && menu_it->second == id) {
+      menu_nodes_.erase(menu_it);
+    }
+  }
+  AttachSubmenu(id, std::move(submenu));
+  dirty_items_.insert(id);  // children-display
+  MarkLayoutChanged(id);
+}
+
+void DbusMenuExporter::OnMenuItemsChanged(const Menu& menu) {
+  auto it = menu_nodes_.find(menu.GetId());
+  if (it == menu_nodes_.end()) {
+    return;
+  }
+  // Building a menu item by item reports every insertion; only note the
+  // node here and diff its children once when flushing.
+  stale_menus_.insert(it->second);
+  ScheduleFlush();
+}
+
+// ── Serialization ────────────────────────────────────────────────────────────
+
+// Properties equal to the dbusmenu defaults (enabled, visible, type
+// "standard", empty label) are left out, as the specification allows. The
+// encoded icon is cached on the node and reused until the item's Image
+// changes, so label or state updates do not re-encode it.
+DbusMenuExporter::PropertyMap DbusMenuExporter::BuildProperties(Node& node) {
+  PropertyMap properties;
+  auto set = [&properties](const char* name, GVariant* value) {
+    properties[name] = VariantPtr(g_variant_ref_sink(value));
+  };
+
+  if (node.submenu) {
+    set("children-display", g_variant_new_string("submenu"));
+  }
+  if (!node.item) {
+    return properties;
+  }
+
+  const MenuItem& item = *node.item;
+  if (!item.IsEnabled()) {
+    set("enabled", g_variant_new_boolean(FALSE));
+  }
+
+  const MenuItemType type = item.GetType();
+  if (type == MenuItemType::Separator) {
+    set("type", g_variant_new_string("separator"));
+    return properties;
+  }
+
+  const std::string label = item.GetLabel().value_or("");
+  if (!label.empty()) {
+    set("label", g_variant_new_string(label.c_str()));
+  }
+
+  std::shared_ptr<Image> icon = item.GetIcon();
+  if (icon != node.icon) {
+    node.icon = icon;
+    GVariant* icon_data = icon ? BuildIconData(*icon) : nullptr;
+    node.icon_data.reset(icon_data ? g_variant_ref_sink(icon_data) : nullptr);
+  }
+  if (node.icon_data) {
+    properties["icon-data"] = VariantPtr(g_variant_ref(node.icon_data.get()));
+  }
+
+  const KeyboardAccelerator accelerator = item.GetAccelerator();
+  if (!accelerator.IsEmpty()) {
+    set("shortcut", BuildShortcut(accelerator));
+  }
+
+  if (type == MenuItemType::Checkbox || type == MenuItemType::Radio) {
+    set("toggle-type", g_variant_new_string(type == MenuItemType::Radio ? "radio" : "checkmark"));
+    int state = -1;
+    switch (item.GetState()) {
+      case MenuItemState::Unchecked:
+        state = 0;
+        break;
+      case MenuItemState::Checked:
+        state = 1;
+        break;
+      case MenuItemState::Mixed:
+        state = -1;
+        break;
+    }
+    set("toggle-state", g_variant_new_int32(state));
+  }
+  return properties;
+}
+
+GVariant* DbusMenuExporter::BuildPropertyDict(const PropertyMap& properties,
+                                              const std::vector<std::string>& names) {
+  GVariantBuilder dict;
+  g_variant_builder_init(&dict, G_VARIANT_TYPE("a{sv}"));
+  for (const auto& [name, value] : properties) {
+    if (names.empty() || std::find(names.begin(), names.end(), name) != names.end()) {
+      g_variant_builder_add(&dict, "{sv}", name.c_str(), value.get());
+    }
+  }
+  return g_variant_builder_end(&dict);
+}
+
+// |depth| follows recursionDepth: -1 for the whole subtree, 0 for the node
+// alone, n for n levels of children.
+GVariant* DbusMenuExporter::BuildLayout(int id,
+                                        int depth,
+                                        const std::vector<std::string>& names) const {
+  const Node& node = nodes_.at(id);
+  GVariantBuilder children;
+  g_variant_builder_init(&children, G_VARIANT_TYPE("av"));
+  if (depth != 0) {
+    for (int child_id : node.children) {
+      g_variant_builder_add(&children, "v", BuildLayout(child_id, depth < 0 ? -1 : depth - 1,
+                                                        names));
+    }
+  }
+  return g_variant_new("(i@a{sv}@av)", id, BuildPropertyDict(node.properties, names),
+                       g_variant_builder_end(&children));
+}
+
+// ── Signal emission ──────────────────────────────────────────────────────────
+
+void DbusMenuExporter::ScheduleFlush() {
+  if (flush_source_id_ == 0 && registration_id_ != 0) {
+    flush_source_id_ = g_idle_add(&DbusMenuExporter::OnFlushIdle, this);
+  }
+}
+
+gboolean DbusMenuExporter::OnFlushIdle(gpointer user_data) {
+  DbusMenuExporter* self = static_cast<DbusMenuExporter*>(user_data);
+  self->flush_source_id_ = 0;
+  self->Flush();
+  return G_SOURCE_REMOVE;
+}
+
+void DbusMenuExporter::Flush() {
+  SyncStaleMenus();
+
+  if (!dirty_items_.empty()) {
+    GVariantBuilder updated;
+    GVariantBuilder removed;
+    g_variant_builder_init(&updated, G_VARIANT_TYPE("a(ia{sv})"));
+    g_variant_builder_init(&removed, G_VARIANT_TYPE("a(ias)"));
+    bool has_delta = false;
+
+    for (int id : dirty_items_) {
+      auto it = nodes_.find(id);
+      if (it == nodes_.end()) {
+        continue;
+      }
+      Node& node = it->second;
+      PropertyMap properties = BuildProperties(node);
+
+      std::vector<std::string> changed_names;
+      for (const auto& [name, value] : properties) {
+        auto old = node.properties.find(name);
+        if (old == node.properties.end() || !g_variant_equal(old->second.get(), value.get())) {
+          changed_names.push_back(name);
+        }
+      }
+      std::vector<std::string> removed_names;
+      for (const auto& [name, value] : node.properties) {
+        if (properties.count(name) == 0) {
+          removed_names.push_back(name);
+        }
+      }
+
+      if (!changed_names.empty()) {
+        g_variant_builder_add(&updated, "(i@a{sv})", id,
+                              BuildPropertyDict(properties, changed_names));
+        has_delta = true;
+      }
+      if (!removed_names.empty()) {
+        GVariantBuilder names;
+        g_variant_builder_init(&names, G_VARIANT_TYPE("as"));
+        for (const auto& name : removed_names) {
+          g_variant_builder_add(&names, "s", name.c_str());
+        }
+        g_variant_builder_add(&removed, "(i@as)", id, g_variant_builder_end(&names));
+        has_delta = true;
+      }
+      node.properties = std::move(properties);
+    }
+    dirty_items_.clear();
+
+    if (has_delta) {
+      EmitSignal("ItemsPropertiesUpdated",
+                 g_variant_new("(@a(ia{sv})@a(ias))", g_variant_builder_end(&updated),
+                               g_variant_builder_end(&removed)));
+    } else {
+      g_variant_builder_clear(&updated);
+      g_variant_builder_clear(&removed);
+    }
+  }
+
+  if (!layout_parents_.empty()) {
+    // Several independent subtrees changed in one batch: report the root.
+    const int parent_id = layout_parents_.size() == 1 ? *layout_parents_.begin() : kRootId;
+    layout_parents_.clear();
+    EmitSignal("LayoutUpdated", g_variant_new("(ui)", revision_, parent_id));
+  }
+}
+
+void DbusMenuExporter::EmitSignal(const char* signal_name, GVariant* params) {
+  if (!connection_ || registration_id_ == 0) {
+    if (params) {
+      g_variant_unref(g_variant_ref_sink(params));
+    }
+    return;
+  }
+  g_dbus_connection_emit_signal(connection_, nullptr, object_path_.c_str(), kDbusMenuInterface,
+                                signal_name, params, nullptr);
+}
+
+// Applies the click to the model the way GtkCheckMenuItem and
+// GtkRadioMenuItem would, then emits MenuItemClickedEvent. No widget is
+// involved, so tray-only menus never need GTK.
+void DbusMenuExporter::ActivateItem(int id) {
+  auto it = nodes_.find(id);
+  if (it == nodes_.end() || !it->second.item) {
+    return;
+  }
+  // Keep the item alive: its click handlers may rebuild the menu.
+  std::shared_ptr<MenuItem> item = it->second.item;
+  if (!item->IsEnabled()) {
+    return;
+  }
+
+  switch (item->GetType()) {
+    case MenuItemType::Separator:
+      return;
+    case MenuItemType::Checkbox:
+      item->SetState(item->GetState() == MenuItemState::Checked ? MenuItemState::Unchecked
+                                                                : MenuItemState::Checked);
+      break;
+    case MenuItemType::Radio: {
+      // Only becoming active counts as a click, as with GTK
+      if (item->GetState() == MenuItemState::Checked) {
+        return;
+      }
+      // The menu's radio group model unchecks the previous item
+      item->SetState(MenuItemState::Checked);
+      break;
+    }
+    case MenuItemType::Normal:
+    case MenuItemType::Submenu:
+      break;
+  }
+  item->Emit(MenuItemClickedEvent(item->GetId()));
+}
+
+// Returns whether the item's submenu provider ran. The node tree is synced
+// before every method call, so a GetLayout that follows already sees the
+// new children.
+bool DbusMenuExporter::PrepareSubmenu(int id) {
+  auto it = nodes_.find(id);
+  if (it == nodes_.end() || !it->second.item) {
+    return false;
+  }
+  // Keep the item alive: the provider may rebuild the menu around it.
+  std::shared_ptr<MenuItem> item = it->second.item;
+  if (!item->PrepareSubmenu()) {
+    return false;
+  }
+  // Rebuild the nodes the provider touched so the host's refetch sees them
+  SyncStaleMenus();
+  return true;
+}
+
+// ── D-Bus handlers ───────────────────────────────────────────────────────────
+
+void DbusMenuExporter::OnMethodCall(GDBusConnection*,
+                                    const gchar*,
+                                    const gchar*,
+                                    const gchar*,
+                                    const gchar* method_name,
+                                    GVariant* parameters,
+                                    GDBusMethodInvocation* invocation,
+                                    gpointer user_data) {
+  DbusMenuExporter* self = static_cast<DbusMenuExporter*>(user_data);
+  if (!self) {
+    g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED,
+                                          "Internal error");
+    return;
+  }
+  // Answer from the current tree even if the idle flush has not run yet
+  self->SyncStaleMenus();
+
+  if (g_strcmp0(method_name, "GetLayout") == 0) {
+    gint parent_id = 0;
+    gint recursion_depth = -1;
+    GVariant* property_names = nullptr;
+    g_variant_get(parameters, "(ii@as)", &parent_id, &recursion_depth, &property_names);
+    const std::vector<std::string> names = StringArrayToVector(property_names);
+    g_variant_unref(property_names);
+
+    if (self->nodes_.count(parent_id) == 0) {
+      g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                                            "Unknown menu item id: %d", parent_id);
+      return;
+    }
+    g_dbus_method_invocation_return_value(
+        invocation, g_variant_new("(u@(ia{sv}av))", self->revision_,
+                                  self->BuildLayout(parent_id, recursion_depth, names)));
+    return;
+  }
+
+  if (g_strcmp0(method_name, "GetGroupProperties") == 0) {
+    GVariant* ids = nullptr;
+    GVariant* property_names = nullptr;
+    g_variant_get(parameters, "(@ai@as)", &ids, &property_names);
+    const std::vector<std::string> names = StringArrayToVector(property_names);
+    g_variant_unref(property_names);
+
+    GVariantBuilder result;
+    g_variant_builder_init(&result, G_VARIANT_TYPE("a(ia{sv})"));
+    gsize count = 0;
+    const gint32* id_values =
+        static_cast<const gint32*>(g_variant_get_fixed_array(ids, &count, sizeof(gint32)));
+    if (count == 0) {
+      // An empty id list asks for every item
+      for (const auto& [id, node] : self->nodes_) {
+        g_variant_builder_add(&result, "(i@a{sv})", id, BuildPropertyDict(node.properties, names));
+      }
+    }
+    for (gsize i = 0; i < count; ++i) {
+      auto it = self->nodes_.find(id_values[i]);
+      if (it != self->nodes_.end()) {
+        g_variant_builder_add(&result, "(i@a{sv})", id_values[i],
+                              BuildPropertyDict(it->second.properties, names));
+      }
+    }
+    g_variant_unref(ids);
+    g_dbus_method_invocation_return_value(
+        invocation, g_variant_new("(@a(ia{sv}))", g_variant_builder_end(&result)));
+    return;
+  }
+
+  if (g_strcmp0(method_name, "GetProperty") == 0) {
+    gint item_id = 0;
+    const gchar* name = nullptr;
+    g_variant_get(parameters, "(i&s)", &item_id, &name);
+
+    auto it = self->nodes_.find(item_id);
+    if (it == self->nodes_.end()) {
+      g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                                            "Unknown menu item id: %d", item_id);
+      return;
+    }
+    auto property = it->second.properties.find(name);
+    if (property == it->second.properties.end()) {
+      g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                                            "Property %s is not set on item %d", name, item_id);
+      return;
+    }
+    g_dbus_method_invocation_return_value(invocation,
+                                          g_variant_new("(v)", property->second.get()));
+    return;
+  }
+
+  if (g_strcmp0(method_name, "Event") == 0) {
+    gint item_id = 0;
+    const gchar* event_id = nullptr;
+    GVariant* data = nullptr;
+    guint timestamp = 0;
+    g_variant_get(parameters, "(i&svu)", &item_id, &event_id, &data, &timestamp);
+    g_variant_unref(data);
+    // Reply first: activation may run arbitrary application code.
+    g_dbus_method_invocation_return_value(invocation, nullptr);
+    if (IsActivationEvent(event_id)) {
+      self->ActivateItem(item_id);
+    }
+    return;
+  }
+
+  if (g_strcmp0(method_name, "EventGroup") == 0) {
+    GVariantIter* events = nullptr;
+    g_variant_get(parameters, "(a(isvu))", &events);
+
+    std::vector<gint> activated;
+    GVariantBuilder errors;
+    g_variant_builder_init(&errors, G_VARIANT_TYPE("ai"));
+    gint item_id = 0;
+    const gchar* event_id = nullptr;
+    GVariant* data = nullptr;
+    guint timestamp = 0;
+    while (g_variant_iter_loop(events, "(i&svu)", &item_id, &event_id, &data, &timestamp)) {
+      if (self->nodes_.count(item_id) == 0) {
+        g_variant_builder_add(&errors, "i", item_id);
+      } else if (IsActivationEvent(event_id)) {
+        activated.push_back(item_id);
+      }
+    }
+    g_variant_iter_free(events);
+
+    g_dbus_method_invocation_return_value(invocation,
+                                          g_variant_new("(@ai)", g_variant_builder_end(&errors)));
+    for (gint id : activated) {
+      self->ActivateItem(id);
+    }
+    return;
+  }
+
+  if (g_strcmp0(method_name, "AboutToShow") == 0) {
+    // The model is otherwise always current; only a provider that just
+    // ran makes the host's copy stale.
+    gint32 id = 0;
+    g_variant_get(parameters, "(i)", &id);
+    const gboolean need_update = self->PrepareSubmenu(id) ? TRUE : FALSE;
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(b)", need_update));
+    return;
+  }
+
+  if (g_strcmp0(method_name, "AboutToShowGroup") == 0) {
+    GVariant* ids = nullptr;
+    g_variant_get(parameters, "(@ai)", &ids);
+    GVariantBuilder updates;
+    GVariantBuilder errors;
+    g_variant_builder_init(&updates, G_VARIANT_TYPE("ai"));
+    g_variant_builder_init(&errors, G_VARIANT_TYPE("ai"));
+    gsize count = 0;
+    const gint32* id_values =
+        static_cast<const gint32*>(g_variant_get_fixed_array(ids, &count, sizeof(gint32)));
+    for (gsize i = 0; i < count; ++i) {
+      if (self->nodes_.count(id_values[i]) == 0) {
+        g_variant_builder_add(&errors, "i", id_values[i]);
+      } else if (self->PrepareSubmenu(id_values[i])) {
+        g_variant_builder_add(&updates, "i", id_values[i]);
+      }
+    }
+    g_variant_unref(ids);
+    g_dbus_method_invocation_return_value(
+        invocation,
+        g_variant_new("(@ai@ai)", g_variant_builder_end(&updates), g_variant_builder_end(&errors)));
+    return;
+  }
+
+  g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
+                                        "Unknown dbusmenu method: %s", method_name);
+}
+
+GVariant* DbusMenuExporter::OnGetProperty(GDBusConnection*,
+                                          const gchar*,
+                                          const gchar*,
+                                          const gchar*,
+                                          const gchar* property_name,
+                                          GError** error,
+                                          gpointer) {
+  if (g_strcmp0(property_name, "Version") == 0) return g_variant_new_uint32(3);
+  if (g_strcmp0(property_name, "TextDirection") == 0) return g_variant_new_string("ltr");
+  if (g_strcmp0(property_name, "Status") == 0) return g_variant_new_string("normal");
+  if (g_strcmp0(property_name, "IconThemePath") == 0) {
+    GVariantBuilder paths;
+    g_variant_builder_init(&paths, G_VARIANT_TYPE("as"));
+    return g_variant_builder_end(&paths);
+  }
+
+  if (error) {
+    *error = g_error_new(G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY,
+                         "Unknown dbusmenu property: %s", property_name);
+  }
+  return nullptr;
+}
+
+}  // namespace nativeapi
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <gio/gio.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../menu.h"
+#include "menu_linux.h"
+
+namespace nativeapi {
+
+/**
+ * @brief Exports a Menu on D-Bus through the com.canonical.dbusmenu interface.
+ *
+ * The exporter keeps a revisioned model of the menu tree: every item gets a
+ * node holding its children and the property values last sent to hosts.
+ * GetLayout, GetGroupProperties and GetProperty are answered from that model
+ * without touching GTK: properties, including the icon as PNG "icon-data"
+ * and the accelerator as "shortcut", are read from Menu/MenuItem state, and
+ * clicks update checkbox and radio state and emit MenuItemClickedEvent
+ * directly. Since the Linux backend creates widgets lazily, a menu that is
+ * only exported never creates any.
+ *
+ * dbusmenu ids are the MenuItemIds of the exported items (IdAllocator keeps
+ * them below 2^31) and the root is 0, so ids survive rebuilds of the menu and
+ * hosts caching them never address the wrong item. The node map doubles as
+ * the id index: Event and EventGroup resolve an id with one hash lookup. An
+ * item can therefore appear only once in an exported tree; where submenus
+ * form a cycle, the item that would close it is left out, and submenus
+ * nested deeper than Menu::kMaxSubmenuDepth are exported empty.
+ *
+ * Changes reported through MenuObserver are batched and flushed from an idle
+ * callback: property changes become a single ItemsPropertiesUpdated signal
+ * carrying only the values that differ, while insertions and removals only
+ * mark the affected menu; its children are diffed once per flush (or before
+ * answering a method call), bumping the revision and emitting LayoutUpdated
+ * once however many items changed. Submenu swaps are applied immediately.
+ *
+ * AboutToShow and AboutToShowGroup run the submenu provider of the items
+ * asked about (MenuItem::SetSubmenuProvider()); the node tree is rebuilt
+ * before the reply, which tells the host to refetch only when a provider
+ * actually ran.
+ *
+ * All methods must be called on the main thread.
+ */
+class DbusMenuExporter : public MenuObserver {
+ public:
+  DbusMenuExporter(GDBusConnection* connection, std::string object_path);
+  ~DbusMenuExporter() override;
+
+  DbusMenuExporter(const DbusMenuExporter&) = delete;
+  DbusMenuExporter& operator=(const DbusMenuExporter&) = delete;
+
+  /**
+   * @brief Register the dbusmenu object on the connection.
+   *
+   * @return false if registration failed (the error is logged)
+   */
+  bool Register();
+
+  /**
+   * @brief Remove the object from the connection and drop pending signals.
+   */
+  void Unregister();
+
+  /**
+   * @brief Replace the exported menu; nullptr exports an empty menu.
+   */
+  void SetMenu(std::shared_ptr<Menu> menu);
+
+  /**
+   * @brief Current layout revision as reported by GetLayout.
+   */
+  unsigned int GetRevision() const { return revision_; }
+
+  // MenuObserver
+  void OnMenuItemChanged(const MenuItem& item) override;
+  void OnMenuItemSubmenuChanged(const MenuItem& item) override;
+  void OnMenuItemsChanged(const Menu& menu) override;
+
+ private:
+  struct VariantUnref {
+    void operator()(GVariant* value) const { g_variant_unref(value); }
+  };
+  using VariantPtr = std::unique_ptr<GVariant, VariantUnref>;
+  using PropertyMap = std::map<std::string, VariantPtr>;
+
+  struct Node {
+    int parent_id = 0;
+    std::shared_ptr<MenuItem> item;  // nullptr for the root node
+    std::shared_ptr<Menu> submenu;   // Menu whose items are the children
+    std::vector<int> children;
+    PropertyMap properties;
+    std::shared_ptr<Image> icon;  // image |icon_data| was encoded from
+    VariantPtr icon_data;
+  };
+
+  static constexpr int kRootId = 0;
+
+  static int ToDbusId(MenuItemId id) { return static_cast<int>(id); }
+
+  int AddNode(const std::shared_ptr<MenuItem>& item, int parent_id);
+  void RemoveNode(int id);
+  void RebuildChildren(int id);
+  bool IsSelfOrAncestor(int ancestor, int id) const;
+  bool CanNest(int id, int parent_id) const;
+  void SyncStaleMenus();
+  void AttachSubmenu(int id, std::shared_ptr<Menu> submenu);
+  void MarkLayoutChanged(int parent_id);
+
+  static PropertyMap BuildProperties(Node& node);
+  static GVariant* BuildPropertyDict(const PropertyMap& properties,
+                                     const std::vector<std::string>& names);
+  GVariant* BuildLayout(int id, int depth, const std::vector<std::string>& names) const;
+
+  void ScheduleFlush();
+  void Flush();
+  void EmitSignal(const char* signal_name, GVariant* params);
+  void ActivateItem(int id);
+  bool PrepareSubmenu(int id);
+
+  static gboolean OnFlushIdle(gpointer user_data);
+  static void OnMethodCall(GDBusConnection* connection,
+                           const gchar* sender,
+                           const gchar* object_path,
+                           const gchar* interface_name,
+                           const gchar* method_name,
+                           GVariant* parameters,
+                           GDBusMethodInvocation* invocation,
+                           gpointer user_data);
+  static GVariant* OnGetProperty(GDBusConnection* connection,
+                                 const gchar* sender,
+                                 const gchar* object_path,
+                                 const gchar* interface_name,
+                                 const gchar* property_name,
+                                 GError** error,
+                                 gpointer user_data);
+
+  GDBusConnection* connection_;
+  std::string object_path_;
+  guint registration_id_;
+  guint flush_source_id_;
+  unsigned int revision_;
+
+  std::unordered_map<int, Node> nodes_;         // dbusmenu id -> node
+  std::unordered_map<MenuId, int> menu_nodes_;  // Menu -> id of its parent node
+
+  std::set<int> dirty_items_;
+  std::set<int> stale_menus_;  // nodes whose children must be diffed
+  std::set<int> layout_parents_;
+};
+
+}  // namespace nativeapi
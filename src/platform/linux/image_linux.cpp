@@ -1,22 +1,82 @@
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <glib.h>
 #include <gtk/gtk.h>
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "../../foundation/base64.h"
 #include "../../foundation/geometry.h"
+#include "../../foundation/image_header.h"
 #include "../../image.h"
 
 namespace nativeapi {
 
-// Linux-specific implementation of Image class using GdkPixbuf
+// Decodes encoded image bytes with the GdkPixbuf loader
+static GdkPixbuf* DecodePixbuf(const uint8_t* data, size_t size) {
+  GError* error = nullptr;
+  GdkPixbufLoader* loader = gdk_pixbuf_loader_new();
+  gboolean written = gdk_pixbuf_loader_write(loader, data, size, &error);
+  gboolean closed = gdk_pixbuf_loader_close(loader, written ? &error : nullptr);
+  GdkPixbuf* pixbuf = (written && closed) ? gdk_pixbuf_loader_get_pixbuf(loader) : nullptr;
+  if (pixbuf) {
+    g_object_ref(pixbuf);
+  }
+  g_object_unref(loader);
+  if (error) {
+    g_error_free(error);
+  }
+  return pixbuf;
+}
+
+// Format name for files whose contents were not recognized by the header probe
+static std::string FormatFromExtension(const std::string& file_path) {
+  size_t dotPos = file_path.find_last_of('.');
+  if (dotPos == std::string::npos) {
+    return "Unknown";
+  }
+  std::string extension = file_path.substr(dotPos + 1);
+  // Convert to lowercase
+  for (auto& c : extension) {
+    c = std::tolower(c);
+  }
+
+  if (extension == "png") {
+    return "PNG";
+  } else if (extension == "jpg" || extension == "jpeg") {
+    return "JPEG";
+  } else if (extension == "gif") {
+    return "GIF";
+  } else if (extension == "bmp") {
+    return "BMP";
+  } else if (extension == "tiff" || extension == "tif") {
+    return "TIFF";
+  } else if (extension == "ico") {
+    return "ICO";
+  } else if (extension == "svg") {
+    return "SVG";
+  } else if (extension == "xpm") {
+    return "XPM";
+  }
+  return "Unknown";
+}
+
+// Linux-specific implementation of Image class using GdkPixbuf.
+//
+// When the header probe yields the dimensions, pixel decoding is deferred
+// until the GdkPixbuf is first needed; until then the image only keeps its
+// source (file path or encoded bytes).
 class Image::Impl {
  public:
   GdkPixbuf* pixbuf_;
   std::string source_;
+  std::vector<uint8_t> encoded_;
   Size size_;
   std::string format_;
+  mutable std::mutex decode_mutex_;
 
   Impl() : pixbuf_(nullptr), size_({0, 0}), format_("Unknown") {}
 
@@ -26,28 +86,87 @@ class Image::Impl {
     }
   }
 
-  Impl(const Impl& other)
-      : pixbuf_(nullptr), source_(other.source_), size_(other.size_), format_(other.format_) {
-    if (other.pixbuf_) {
-      pixbuf_ = gdk_pixbuf_copy(other.pixbuf_);
-    }
+  // The source is locked because EnsureDecoded() may be swapping its
+  // encoded bytes for pixels on a worker thread
+  Impl(const Impl& other) : Impl() {
+    std::lock_guard<std::mutex> lock(other.decode_mutex_);
+    CopyFrom(other);
   }
 
   Impl& operator=(const Impl& other) {
     if (this != &other) {
+      std::scoped_lock lock(decode_mutex_, other.decode_mutex_);
       if (pixbuf_) {
         g_object_unref(pixbuf_);
       }
       pixbuf_ = nullptr;
-      source_ = other.source_;
-      size_ = other.size_;
-      format_ = other.format_;
-      if (other.pixbuf_) {
-        pixbuf_ = gdk_pixbuf_copy(other.pixbuf_);
-      }
+      CopyFrom(other);
     }
     return *this;
   }
+
+  // Copies |other|'s state into this one, which holds no pixbuf; both
+  // decode locks must be held
+  void CopyFrom(const Impl& other) {
+    source_ = other.source_;
+    encoded_ = other.encoded_;
+    size_ = other.size_;
+    format_ = other.format_;
+    if (other.pixbuf_) {
+      pixbuf_ = gdk_pixbuf_copy(other.pixbuf_);
+    }
+  }
+
+  // Returns the decoded pixbuf, decoding the deferred source on first use
+  GdkPixbuf* EnsureDecoded() {
+    std::lock_guard<std::mutex> lock(decode_mutex_);
+    if (pixbuf_) {
+      return pixbuf_;
+    }
+    if (!encoded_.empty()) {
+      pixbuf_ = DecodePixbuf(encoded_.data(), encoded_.size());
+      if (pixbuf_) {
+        // The pixels are authoritative from now on
+        std::vector<uint8_t>().swap(encoded_);
+      }
+    } else if (!source_.empty()) {
+      GError* error = nullptr;
+      pixbuf_ = gdk_pixbuf_new_from_file(source_.c_str(), &error);
+      if (error) {
+        g_error_free(error);
+      }
+    }
+    // An ICO header only names its largest entry, which the decoder may
+    // not pick; the decoded image decides the size
+    if (pixbuf_ && format_ == "ICO") {
+      size_ = {static_cast<double>(gdk_pixbuf_get_width(pixbuf_)),
+               static_cast<double>(gdk_pixbuf_get_height(pixbuf_))};
+    }
+    return pixbuf_;
+  }
+
+  // Creates an image from encoded bytes, deferring the decode when the
+  // header already provides the dimensions.
+  static std::shared_ptr<Image> FromEncoded(std::vector<uint8_t> data) {
+    ImageHeaderInfo header = ImageHeader::Probe(data.data(), data.size());
+    auto image = std::shared_ptr<Image>(new Image());
+    Impl* impl = image->pimpl_.get();
+    impl->format_ = header.format.empty() ? "Unknown" : header.format;
+
+    if (header.HasSize()) {
+      impl->size_ = {static_cast<double>(header.width), static_cast<double>(header.height)};
+      impl->encoded_ = std::move(data);
+      return image;
+    }
+
+    impl->pixbuf_ = DecodePixbuf(data.data(), data.size());
+    if (!impl->pixbuf_) {
+      return nullptr;
+    }
+    impl->size_ = {static_cast<double>(gdk_pixbuf_get_width(impl->pixbuf_)),
+                   static_cast<double>(gdk_pixbuf_get_height(impl->pixbuf_))};
+    return image;
+  }
 };
 
 Image::Image() : pimpl_(std::make_unique<Impl>()) {}
@@ -59,120 +178,125 @@ Image::Image(const Image& other) : pimpl_(std::make_unique<Impl>(*other.pimpl_))
 Image::Image(Image&& other) noexcept : pimpl_(std::move(other.pimpl_)) {}
 
 std::shared_ptr<Image> Image::FromFile(const std::string& file_path) {
+  // Only the header is read here; the pixels are decoded on first use.
+  ImageHeaderInfo header = ImageHeader::ProbeFile(file_path);
   auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->source_ = file_path;
+  image->pimpl_->format_ =
+      header.format.empty() ? FormatFromExtension(file_path) : header.format;
+
+  if (header.HasSize()) {
+    image->pimpl_->size_ = {static_cast<double>(header.width),
+                            static_cast<double>(header.height)};
+    return image;
+  }
 
-  GError* error = nullptr;
-  GdkPixbuf* pixbuf = gdk_pixbuf_new_from_file(file_path.c_str(), &error);
-
-  if (pixbuf) {
-    image->pimpl_->pixbuf_ = pixbuf;
-    image->pimpl_->source_ = file_path;
-
-    // Get actual image size
-    int width = gdk_pixbuf_get_width(pixbuf);
-    int height = gdk_pixbuf_get_height(pixbuf);
-    image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
-
-    // Determine format from file extension
-    size_t dotPos = file_path.find_last_of('.');
-    if (dotPos != std::string::npos) {
-      std::string extension = file_path.substr(dotPos + 1);
-      // Convert to lowercase
-      for (auto& c : extension) {
-        c = std::tolower(c);
-      }
-
-      if (extension == "png") {
-        image->pimpl_->format_ = "PNG";
-      } else if (extension == "jpg" || extension == "jpeg") {
-        image->pimpl_->format_ = "JPEG";
-      } else if (extension == "gif") {
-        image->pimpl_->format_ = "GIF";
-      } else if (extension == "bmp") {
-        image->pimpl_->format_ = "BMP";
-      } else if (extension == "tiff" || extension == "tif") {
-        image->pimpl_->format_ = "TIFF";
-      } else if (extension == "ico") {
-        image->pimpl_->format_ = "ICO";
-      } else if (extension == "svg") {
-        image->pimpl_->format_ = "SVG";
-      } else if (extension == "xpm") {
-        image->pimpl_->format_ = "XPM";
-      } else {
-        image->pimpl_->format_ = "Unknown";
-      }
-    }
-  } else {
-    if (error) {
-      g_error_free(error);
-    }
+  // Formats without header dimensions (SVG, XPM, ...) are decoded eagerly
+  GdkPixbuf* pixbuf = image->pimpl_->EnsureDecoded();
+  if (!pixbuf) {
     return nullptr;
   }
 
+  // Get actual image size
+  int width = gdk_pixbuf_get_width(pixbuf);
+  int height = gdk_pixbuf_get_height(pixbuf);
+  image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
+
   return image;
 }
 
-// Helper function to decode base64
-static std::vector<unsigned char> DecodeBase64(const std::string& base64_data) {
-  std::vector<unsigned char> result;
-
-  gsize out_len = 0;
-  guchar* decoded = g_base64_decode(base64_data.c_str(), &out_len);
-
-  if (decoded && out_len > 0) {
-    result.assign(decoded, decoded + out_len);
-    g_free(decoded);
+std::shared_ptr<Image> Image::FromBytes(const uint8_t* data, size_t size) {
+  if (!data || size == 0) {
+    return nullptr;
   }
-
-  return result;
+  return Impl::FromEncoded(std::vector<uint8_t>(data, data + size));
 }
 
-std::shared_ptr<Image> Image::FromBase64(const std::string& base64_data) {
-  auto image = std::shared_ptr<Image>(new Image());
-
-  // Remove data URI prefix if present
-  std::string cleanBase64 = base64_data;
-  size_t commaPos = base64_data.find(',');
-  if (commaPos != std::string::npos) {
-    cleanBase64 = base64_data.substr(commaPos + 1);
+std::shared_ptr<Image> Image::FromBase64(std::string_view base64_data) {
+  // Decode straight into the buffer the image keeps; the data URI prefix is
+  // skipped in place rather than copied away.
+  std::string_view payload = Base64::StripDataUriPrefix(base64_data);
+  std::vector<uint8_t> image_data;
+  if (!Base64::Decode(payload, image_data) || image_data.empty()) {
+    return nullptr;
   }
+  return Impl::FromEncoded(std::move(image_data));
+}
 
-  // Decode base64
-  std::vector<unsigned char> imageData = DecodeBase64(cleanBase64);
-
-  if (!imageData.empty()) {
-    GError* error = nullptr;
-    GInputStream* stream =
-        g_memory_input_stream_new_from_data(imageData.data(), imageData.size(), nullptr);
-
-    GdkPixbuf* pixbuf = gdk_pixbuf_new_from_stream(stream, nullptr, &error);
-    g_object_unref(stream);
-
-    if (pixbuf) {
-      image->pimpl_->pixbuf_ = pixbuf;
-      image->pimpl_->source_ = base64_data;
+std::shared_ptr<Image> Image::FromRawData(const uint8_t* pixels,
+                                          int width,
+                                          int height,
+                                          ImagePixelFormat format) {
+  if (!pixels || width <= 0 || height <= 0) {
+    return nullptr;
+  }
 
-      // Get actual image size
-      int width = gdk_pixbuf_get_width(pixbuf);
-      int height = gdk_pixbuf_get_height(pixbuf);
-      image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
+  GdkPixbuf* pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, TRUE, 8, width, height);
+  if (!pixbuf) {
+    return nullptr;
+  }
 
-      // Default assumption for base64 images
-      image->pimpl_->format_ = "PNG";
+  // GdkPixbuf stores non-premultiplied RGBA with a padded row stride
+  const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+  guchar* dst = gdk_pixbuf_get_pixels(pixbuf);
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = pixels + y * row_bytes;
+    guchar* out = dst + static_cast<size_t>(y) * rowstride;
+    if (format == ImagePixelFormat::RGBA32) {
+      memcpy(out, in, row_bytes);
     } else {
-      if (error) {
-        g_error_free(error);
+      for (int x = 0; x < width; ++x) {
+        out[x * 4 + 0] = in[x * 4 + 2];
+        out[x * 4 + 1] = in[x * 4 + 1];
+        out[x * 4 + 2] = in[x * 4 + 0];
+        out[x * 4 + 3] = in[x * 4 + 3];
       }
-      return nullptr;
     }
-  } else {
-    return nullptr;
   }
 
+  auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->pixbuf_ = pixbuf;
+  image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
   return image;
 }
 
+bool Image::ToRawData(std::vector<uint8_t>& pixels,
+                      int& width,
+                      int& height,
+                      ImagePixelFormat format) const {
+  GdkPixbuf* pixbuf = pimpl_->EnsureDecoded();
+  if (!pixbuf) {
+    return false;
+  }
+
+  width = gdk_pixbuf_get_width(pixbuf);
+  height = gdk_pixbuf_get_height(pixbuf);
+  const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+  const int n_channels = gdk_pixbuf_get_n_channels(pixbuf);
+  const bool has_alpha = gdk_pixbuf_get_has_alpha(pixbuf);
+  const guchar* src = gdk_pixbuf_get_pixels(pixbuf);
+  const int r = format == ImagePixelFormat::RGBA32 ? 0 : 2;
+  const int b = 2 - r;
+
+  pixels.resize(static_cast<size_t>(width) * height * 4);
+  uint8_t* out = pixels.data();
+  for (int y = 0; y < height; ++y) {
+    const guchar* in = src + static_cast<size_t>(y) * rowstride;
+    for (int x = 0; x < width; ++x) {
+      out[r] = in[0];
+      out[1] = in[1];
+      out[b] = in[2];
+      out[3] = has_alpha ? in[3] : 255;
+      in += n_channels;
+      out += 4;
+    }
+  }
+  return true;
+}
+
 Size Image::GetSize() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
   return pimpl_->size_;
 }
 
@@ -180,93 +304,89 @@ std::string Image::GetFormat() const {
   return pimpl_->format_;
 }
 
-// Helper function to encode to base64
-static std::string EncodeBase64(const unsigned char* data, size_t length) {
-  gchar* encoded = g_base64_encode(data, length);
-  std::string result(encoded);
-  g_free(encoded);
-  return result;
-}
-
-std::string Image::ToBase64() const {
-  if (!pimpl_->pixbuf_) {
-    return "";
+// Forwards gdk-pixbuf's encoder output to an ImageEncodeSink
+static gboolean WriteToSink(const gchar* buffer, gsize count, GError** error, gpointer data) {
+  const auto* sink = static_cast<const ImageEncodeSink*>(data);
+  if (!(*sink)(reinterpret_cast<const uint8_t*>(buffer), count)) {
+    g_set_error_literal(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Encode sink aborted");
+    return FALSE;
   }
+  return TRUE;
+}
 
-  gchar* buffer = nullptr;
-  gsize buffer_size = 0;
-  GError* error = nullptr;
-
-  // Save pixbuf to PNG in memory
-  gboolean success =
-      gdk_pixbuf_save_to_buffer(pimpl_->pixbuf_, &buffer, &buffer_size, "png", &error, nullptr);
-
-  if (!success || !buffer) {
-    if (error) {
-      g_error_free(error);
-    }
-    if (buffer) {
-      g_free(buffer);
+bool Image::EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
+  {
+    // Still-encoded PNG data can be passed through without decoding
+    std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+    if (options.format == ImageEncodeFormat::PNG && options.compression_level < 0 &&
+        !pimpl_->pixbuf_ && !pimpl_->encoded_.empty() && pimpl_->format_ == "PNG") {
+      return sink(pimpl_->encoded_.data(), pimpl_->encoded_.size());
     }
-    return "";
   }
 
-  // Convert to base64
-  std::string base64String = EncodeBase64(reinterpret_cast<unsigned char*>(buffer), buffer_size);
-  g_free(buffer);
-
-  return "data:image/png;base64," + base64String;
-}
-
-bool Image::SaveToFile(const std::string& file_path) const {
-  if (!pimpl_->pixbuf_) {
+  GdkPixbuf* pixbuf = pimpl_->EnsureDecoded();
+  if (!pixbuf) {
     return false;
   }
 
-  // Determine file type from extension
-  size_t dotPos = file_path.find_last_of('.');
-  std::string type = "png";  // default
-
-  if (dotPos != std::string::npos) {
-    std::string extension = file_path.substr(dotPos + 1);
-    // Convert to lowercase
-    for (auto& c : extension) {
-      c = std::tolower(c);
-    }
-
-    if (extension == "jpg" || extension == "jpeg") {
-      type = "jpeg";
-    } else if (extension == "png") {
+  const char* type = nullptr;
+  switch (options.format) {
+    case ImageEncodeFormat::PNG:
       type = "png";
-    } else if (extension == "bmp") {
+      break;
+    case ImageEncodeFormat::JPEG:
+      type = "jpeg";
+      break;
+    case ImageEncodeFormat::BMP:
       type = "bmp";
-    } else if (extension == "ico") {
-      type = "ico";
-    } else if (extension == "tiff" || extension == "tif") {
+      break;
+    case ImageEncodeFormat::TIFF:
       type = "tiff";
-    }
+      break;
+    case ImageEncodeFormat::ICO:
+      type = "ico";
+      break;
+    case ImageEncodeFormat::GIF:
+      // gdk-pixbuf has no GIF writer
+      return false;
+    default:
+      return false;
   }
 
-  GError* error = nullptr;
-  gboolean success = FALSE;
-
-  if (type == "jpeg") {
-    // For JPEG, specify quality
-    success = gdk_pixbuf_save(pimpl_->pixbuf_, file_path.c_str(), type.c_str(), &error, "quality",
-                              "90", nullptr);
-  } else {
-    success = gdk_pixbuf_save(pimpl_->pixbuf_, file_path.c_str(), type.c_str(), &error, nullptr);
+  std::string value;
+  char* keys[2] = {nullptr, nullptr};
+  char* values[2] = {nullptr, nullptr};
+  if (options.format == ImageEncodeFormat::PNG && options.compression_level >= 0) {
+    value = std::to_string(std::min(options.compression_level, 9));
+    keys[0] = const_cast<char*>("compression");
+    values[0] = const_cast<char*>(value.c_str());
+  } else if (options.format == ImageEncodeFormat::JPEG) {
+    value = std::to_string(std::clamp(options.quality, 1, 100));
+    keys[0] = const_cast<char*>("quality");
+    values[0] = const_cast<char*>(value.c_str());
   }
 
+  GError* error = nullptr;
+  gboolean success = gdk_pixbuf_save_to_callbackv(pixbuf, WriteToSink,
+                                                  const_cast<ImageEncodeSink*>(&sink), type,
+                                                  keys, values, &error);
   if (error) {
     g_error_free(error);
   }
-
   return success == TRUE;
 }
 
 void* Image::GetNativeObjectInternal() const {
-  return pimpl_->pixbuf_;
+  return pimpl_->EnsureDecoded();
+}
+
+bool Image::IsDecoded() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+  return pimpl_->pixbuf_ != nullptr;
+}
+
+bool Image::EnsureDecoded() const {
+  return pimpl_->EnsureDecoded() != nullptr;
 }
 
 }  // namespace nativeapi
@@ -0,0 +1,27 @@
+#include <glib.h>
+
+#include "../../main_thread.h"
+
+namespace nativeapi {
+
+void PostToMainThread(std::function<void()> task) {
+  if (!task) {
+    return;
+  }
+  using Task = std::function<void()>;
+  g_idle_add_full(
+      G_PRIORITY_DEFAULT,
+      [](gpointer data) -> gboolean {
+        (*static_cast<Task*>(data))();
+        return G_SOURCE_REMOVE;
+      },
+      new Task(std::move(task)), [](gpointer data) { delete static_cast<Task*>(data); });
+}
+
+void PrepareMainThreadDispatcher() {}
+
+bool IsMainThreadDispatchSupported() {
+  return true;
+}
+
+}  // namespace nativeapi
@@ -1,5 +1,6 @@
 #include <gtk/gtk.h>
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <iostream>
 #include <memory>
@@ -13,9 +14,114 @@
 #include "../../menu.h"
 #include "../../menu_event.h"
 #include "../../window.h"
+#include "menu_linux.h"
 
 namespace nativeapi {
 
+// ── Change observers ─────────────────────────────────────────────────────────
+
+// Menus may be built on any thread, so the observer list is locked; the
+// observers themselves are called without holding the lock.
+static std::mutex s_observers_mutex;
+
+static std::vector<MenuObserver*>& GetMenuObservers() {
+  static std::vector<MenuObserver*> observers;
+  return observers;
+}
+
+void AddMenuObserver(MenuObserver* observer) {
+  std::lock_guard<std::mutex> lock(s_observers_mutex);
+  auto& observers = GetMenuObservers();
+  if (observer && std::find(observers.begin(), observers.end(), observer) == observers.end()) {
+    observers.push_back(observer);
+  }
+}
+
+void RemoveMenuObserver(MenuObserver* observer) {
+  std::lock_guard<std::mutex> lock(s_observers_mutex);
+  auto& observers = GetMenuObservers();
+  observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+static bool IsMenuObserver(MenuObserver* observer) {
+  std::lock_guard<std::mutex> lock(s_observers_mutex);
+  const auto& observers = GetMenuObservers();
+  return std::find(observers.begin(), observers.end(), observer) != observers.end();
+}
+
+// Iterates over a copy so observers may unregister themselves while notified
+template <typename Callback>
+static void NotifyMenuObservers(Callback callback) {
+  std::vector<MenuObserver*> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(s_observers_mutex);
+    snapshot = GetMenuObservers();
+  }
+  for (MenuObserver* observer : snapshot) {
+    if (IsMenuObserver(observer)) {
+      callback(observer);
+    }
+  }
+}
+
+static void NotifyMenuItemChanged(const MenuItem& item) {
+  NotifyMenuObservers([&item](MenuObserver* observer) { observer->OnMenuItemChanged(item); });
+}
+
+static void NotifyMenuItemSubmenuChanged(const MenuItem& item) {
+  NotifyMenuObservers(
+      [&item](MenuObserver* observer) { observer->OnMenuItemSubmenuChanged(item); });
+}
+
+static void NotifyMenuItemsChanged(const Menu& menu) {
+  NotifyMenuObservers([&menu](MenuObserver* observer) { observer->OnMenuItemsChanged(menu); });
+}
+
+// ── Item index ───────────────────────────────────────────────────────────────
+
+// Every live MenuItem and Menu by id. Together with the parent links kept
+// in the Impls (item → containing menu, submenu → owning item) this lets
+// GTK signal handlers and virtual rows resolve the objects they were set up
+// for. The links are ids rather than pointers, so neither side has to
+// outlive the other; the C API destroys items and menus in any order.
+// Items and menus are created and destroyed on any thread, so every access
+// to the index holds s_index_mutex.
+
+static std::mutex s_index_mutex;
+
+static std::unordered_map<MenuItemId, MenuItem*>& GetItemIndex() {
+  static std::unordered_map<MenuItemId, MenuItem*> index;
+  return index;
+}
+
+static std::unordered_map<MenuId, Menu*>& GetMenuIndex() {
+  static std::unordered_map<MenuId, Menu*> index;
+  return index;
+}
+
+template <typename T>
+static T* Lookup(const std::unordered_map<IdAllocator::IdType, T*>& index,
+                 IdAllocator::IdType id) {
+  std::lock_guard<std::mutex> lock(s_index_mutex);
+  auto it = index.find(id);
+  return it == index.end() ? nullptr : it->second;
+}
+
+template <typename T>
+static void AddToIndex(std::unordered_map<IdAllocator::IdType, T*>& index,
+                       IdAllocator::IdType id,
+                       T* object) {
+  std::lock_guard<std::mutex> lock(s_index_mutex);
+  index[id] = object;
+}
+
+template <typename T>
+static void RemoveFromIndex(std::unordered_map<IdAllocator::IdType, T*>& index,
+                            IdAllocator::IdType id) {
+  std::lock_guard<std::mutex> lock(s_index_mutex);
+  index.erase(id);
+}
+
 // GTK signal handlers → Event emission
 static void OnGtkMenuItemActivate(GtkMenuItem* /*item*/, gpointer user_data) {
   MenuItem* menu_item = static_cast<MenuItem*>(user_data);
@@ -26,7 +132,7 @@ static void OnGtkMenuItemActivate(GtkMenuItem* /*item*/, gpointer user_data) {
 }
 
 // For checkbox and radio items we listen to "toggled" to avoid recursive
-// activate emissions when GTK internally updates group state. For radio items,
+// activate emissions when GTK internally updates check state. For radio items,
 // we only emit when the item becomes active.
 static void OnGtkCheckMenuItemToggled(GtkCheckMenuItem* item, gpointer user_data) {
   MenuItem* menu_item = static_cast<MenuItem*>(user_data);
@@ -34,6 +140,15 @@ static void OnGtkCheckMenuItemToggled(GtkCheckMenuItem* item, gpointer user_data
     return;
   }
   gboolean active = gtk_check_menu_item_get_active(item);
+  // Radio widgets are check items drawn as radios, which GTK lets the user
+  // uncheck; only checking another item of the group may do that
+  if (!active && menu_item->GetType() == MenuItemType::Radio &&
+      menu_item->GetState() == MenuItemState::Checked) {
+    menu_item->SetState(MenuItemState::Checked);
+    return;
+  }
+  // Store the state GTK just toggled to; SetState also notifies observers
+  menu_item->SetState(active ? MenuItemState::Checked : MenuItemState::Unchecked);
   if (menu_item->GetType() == MenuItemType::Radio) {
     if (active) {
       menu_item->Emit(MenuItemClickedEvent(menu_item->GetId()));
@@ -60,11 +175,17 @@ static void OnGtkMenuUnmap(GtkWidget* /*menu*/, gpointer user_data) {
   menu_obj->Emit(MenuClosedEvent(menu_obj->GetId()));
 }
 
-static void OnGtkSubmenuMap(GtkWidget* /*submenu*/, gpointer user_data) {
+static void OnGtkSubmenuMap(GtkWidget* submenu, gpointer user_data) {
   MenuItem* menu_item = static_cast<MenuItem*>(user_data);
   if (!menu_item) {
     return;
   }
+  // Items a provider just added have hidden widgets, and the popup was
+  // sized for the old contents
+  if (menu_item->PrepareSubmenu()) {
+    gtk_widget_show_all(submenu);
+    gtk_menu_reposition(GTK_MENU(submenu));
+  }
   // Emit submenu opened on the item
   menu_item->Emit(MenuItemSubmenuOpenedEvent(menu_item->GetId()));
 }
@@ -78,7 +199,130 @@ static void OnGtkSubmenuUnmap(GtkWidget* /*submenu*/, gpointer user_data) {
   menu_item->Emit(MenuItemSubmenuClosedEvent(menu_item->GetId()));
 }
 
-// Private implementation class for MenuItem
+// Updates the text of a menu item widget, with or without an icon box
+static void SetItemWidgetLabel(GtkWidget* widget, const char* label) {
+  // Check if we have a custom box layout (with icon)
+  GtkWidget* child = gtk_bin_get_child(GTK_BIN(widget));
+  if (child && GTK_IS_BOX(child)) {
+    // Custom layout with icon - find the label widget and update it
+    GList* children = gtk_container_get_children(GTK_CONTAINER(child));
+    for (GList* iter = children; iter != nullptr; iter = iter->next) {
+      GtkWidget* child_widget = GTK_WIDGET(iter->data);
+      if (GTK_IS_LABEL(child_widget)) {
+        gtk_label_set_text(GTK_LABEL(child_widget), label);
+        break;
+      }
+    }
+    g_list_free(children);
+  } else {
+    // Simple label-only layout
+    gtk_menu_item_set_label(GTK_MENU_ITEM(widget), label);
+  }
+}
+
+// Replaces the content of a menu item widget with |label| and, if any, |image|
+static void SetItemWidgetContent(GtkWidget* widget,
+                                 const std::string& current_label,
+                                 const std::shared_ptr<Image>& image) {
+  // Remove existing child widget
+  GtkWidget* existing_child = gtk_bin_get_child(GTK_BIN(widget));
+  if (existing_child) {
+    gtk_container_remove(GTK_CONTAINER(widget), existing_child);
+  }
+
+  if (image && image->GetNativeObject()) {
+    // Create a horizontal box to hold icon and label
+    GtkWidget* box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);  // 6px spacing
+
+    // Scale the icon to a reasonable menu size (16x16 is standard for menu items)
+    const int icon_size = 16;
+    std::shared_ptr<Image> scaled = image;
+    const Size image_size = image->GetSize();
+    if (static_cast<int>(image_size.width) != icon_size ||
+        static_cast<int>(image_size.height) != icon_size) {
+      auto resized = image->Resize({icon_size, icon_size}, ResampleFilter::Lanczos3);
+      if (resized) {
+        scaled = resized;
+      }
+    }
+    GdkPixbuf* scaled_pixbuf = static_cast<GdkPixbuf*>(scaled->GetNativeObject());
+
+    // Create GtkImage from the pixbuf
+    GtkWidget* gtk_image = gtk_image_new_from_pixbuf(scaled_pixbuf);
+
+    // Create label widget; an accel label, to show the accelerator
+    GtkWidget* label = gtk_accel_label_new(current_label.c_str());
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);  // Left-align the label
+
+    // Pack icon and label into box
+    gtk_box_pack_start(GTK_BOX(box), gtk_image, FALSE, FALSE, 0);
+    gtk_box_pack_start(GTK_BOX(box), label, TRUE, TRUE, 0);
+
+    // Add box to menu item
+    gtk_container_add(GTK_CONTAINER(widget), box);
+    gtk_widget_show_all(box);
+  } else {
+    // No icon - restore simple label display
+    GtkWidget* label = gtk_accel_label_new(current_label.c_str());
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
+    gtk_container_add(GTK_CONTAINER(widget), label);
+    gtk_widget_show(label);
+  }
+}
+
+// Shows |accelerator| next to the label of a menu item widget. Only the
+// label: the keys reach the item through Menu::DispatchAccelerator(), not a
+// GtkAccelGroup.
+static void SetItemWidgetAccelerator(GtkWidget* widget, const KeyboardAccelerator& accelerator) {
+  GtkWidget* label = gtk_bin_get_child(GTK_BIN(widget));
+  if (label && GTK_IS_BOX(label)) {
+    GList* children = gtk_container_get_children(GTK_CONTAINER(label));
+    label = nullptr;
+    for (GList* iter = children; iter != nullptr; iter = iter->next) {
+      if (GTK_IS_ACCEL_LABEL(iter->data)) {
+        label = GTK_WIDGET(iter->data);
+        break;
+      }
+    }
+    g_list_free(children);
+  }
+  if (!label || !GTK_IS_ACCEL_LABEL(label)) {
+    return;
+  }
+
+  guint key = 0;
+  GdkModifierType modifiers = static_cast<GdkModifierType>(0);
+  if (!accelerator.IsEmpty()) {
+    key = gdk_keyval_from_name(accelerator.key.c_str());
+    if (key == GDK_KEY_VoidSymbol && accelerator.key.size() == 1) {
+      // Punctuation, which has no key name of its own spelling
+      key = gdk_unicode_to_keyval(static_cast<guchar>(accelerator.key[0]));
+    }
+    static const struct {
+      ModifierKey modifier;
+      GdkModifierType mask;
+    } kModifierMasks[] = {
+        {ModifierKey::Shift, GDK_SHIFT_MASK},
+        {ModifierKey::Ctrl, GDK_CONTROL_MASK},
+        {ModifierKey::Alt, GDK_MOD1_MASK},
+        {ModifierKey::Meta, GDK_SUPER_MASK},
+    };
+    for (const auto& entry : kModifierMasks) {
+      if ((accelerator.modifiers & entry.modifier) != ModifierKey::None) {
+        modifiers = static_cast<GdkModifierType>(modifiers | entry.mask);
+      }
+    }
+  }
+  gtk_accel_label_set_accel(GTK_ACCEL_LABEL(label), key == GDK_KEY_VoidSymbol ? 0 : key,
+                            modifiers);
+}
+
+// Private implementation class for MenuItem.
+//
+// The item's state lives here and is the source of truth; the GTK widget is
+// created on first use (GetNativeObject(), or when a Menu that already has a
+// widget needs it) and mirrors that state from then on. Menus that are only
+// exported over dbusmenu therefore never create widgets.
 class MenuItem::Impl {
  public:
   Impl(MenuItemId id, GtkWidget* menu_item, MenuItemType type)
@@ -88,40 +332,139 @@ class MenuItem::Impl {
         tooltip_(""),
         type_(type),
         state_(MenuItemState::Unchecked),
+        enabled_(true),
         radio_group_(-1),
         accelerator_("", ModifierKey::None),
         activate_handler_id_(0),
         toggled_handler_id_(0) {}
 
-  void ApplyRadioGroup() {
-    if (!gtk_menu_item_ || type_ != MenuItemType::Radio || radio_group_ < 0) {
-      return;
+  GtkWidget* EnsureWidget(MenuItem* owner) {
+    if (gtk_menu_item_) {
+      return gtk_menu_item_;
     }
 
-    std::lock_guard<std::mutex> lock(s_group_map_mutex_);
+    const char* label = title_.has_value() ? title_->c_str() : "";
+    switch (type_) {
+      case MenuItemType::Separator:
+        gtk_menu_item_ = gtk_separator_menu_item_new();
+        break;
+      case MenuItemType::Checkbox:
+        gtk_menu_item_ = gtk_check_menu_item_new_with_label(label);
+        break;
+      case MenuItemType::Radio:
+        // The menu's radio group model unchecks siblings; a GtkRadioMenuItem
+        // outside a GTK group could not be unchecked at all
+        gtk_menu_item_ = gtk_check_menu_item_new_with_label(label);
+        gtk_check_menu_item_set_draw_as_radio(GTK_CHECK_MENU_ITEM(gtk_menu_item_), TRUE);
+        break;
+      case MenuItemType::Normal:
+      case MenuItemType::Submenu:
+      default:
+        gtk_menu_item_ = gtk_menu_item_new_with_label(label);
+        break;
+    }
+    // Our own reference keeps the widget alive while it is outside a menu,
+    // e.g. while Menu::Apply() moves the item.
+    g_object_ref_sink(gtk_menu_item_);
 
-    GSList* target_group = nullptr;
-    auto it = s_group_map_.find(radio_group_);
-    if (it != s_group_map_.end()) {
-      target_group = it->second;
+    if (image_) {
+      ApplyIcon();
     } else {
-      target_group = gtk_radio_menu_item_get_group(GTK_RADIO_MENU_ITEM(gtk_menu_item_));
-      s_group_map_[radio_group_] = target_group;
+      ApplyAccelerator();
     }
+    ApplyTooltip();
+    gtk_widget_set_sensitive(gtk_menu_item_, enabled_ ? TRUE : FALSE);
+    ApplyState(owner);
+    ApplySubmenu(owner);
+    ConnectSignals(owner);
+    return gtk_menu_item_;
+  }
 
-    gtk_radio_menu_item_set_group(GTK_RADIO_MENU_ITEM(gtk_menu_item_), target_group);
+  void ConnectSignals(MenuItem* owner) {
+    if (!gtk_menu_item_ || type_ == MenuItemType::Separator) {
+      return;
+    }
+    if (GTK_IS_CHECK_MENU_ITEM(gtk_menu_item_)) {
+      toggled_handler_id_ = g_signal_connect(G_OBJECT(gtk_menu_item_), "toggled",
+                                             G_CALLBACK(OnGtkCheckMenuItemToggled), owner);
+    } else {
+      activate_handler_id_ = g_signal_connect(G_OBJECT(gtk_menu_item_), "activate",
+                                              G_CALLBACK(OnGtkMenuItemActivate), owner);
+    }
+  }
 
-    // Update stored head pointer after potential re-linking
-    s_group_map_[radio_group_] = gtk_radio_menu_item_get_group(GTK_RADIO_MENU_ITEM(gtk_menu_item_));
+  void ApplyLabel() {
+    if (!gtk_menu_item_ || type_ == MenuItemType::Separator) {
+      return;
+    }
+    SetItemWidgetLabel(gtk_menu_item_, title_.has_value() ? title_->c_str() : "");
+  }
+
+  void ApplyIcon() {
+    if (!gtk_menu_item_ || type_ == MenuItemType::Separator) {
+      return;
+    }
+    SetItemWidgetContent(gtk_menu_item_, title_.value_or(""), image_);
+    ApplyAccelerator();
+  }
+
+  void ApplyAccelerator() {
+    if (!gtk_menu_item_ || type_ == MenuItemType::Separator) {
+      return;
+    }
+    SetItemWidgetAccelerator(gtk_menu_item_, accelerator_);
+  }
+
+  void ApplyTooltip() {
+    if (gtk_menu_item_) {
+      gtk_widget_set_tooltip_text(gtk_menu_item_, tooltip_.has_value() ? tooltip_->c_str()
+                                                                       : nullptr);
+    }
+  }
+
+  void ApplyState(MenuItem* owner) {
+    if (!gtk_menu_item_ || !GTK_IS_CHECK_MENU_ITEM(gtk_menu_item_)) {
+      return;
+    }
+    GtkCheckMenuItem* check_item = GTK_CHECK_MENU_ITEM(gtk_menu_item_);
+    // Block the "toggled" signal to prevent recursive triggering when setting active
+    g_signal_handlers_block_by_func(G_OBJECT(gtk_menu_item_), (gpointer)OnGtkCheckMenuItemToggled,
+                                    owner);
+    gtk_check_menu_item_set_active(check_item, state_ == MenuItemState::Checked ? TRUE : FALSE);
+    g_signal_handlers_unblock_by_func(G_OBJECT(gtk_menu_item_),
+                                      (gpointer)OnGtkCheckMenuItemToggled, owner);
+    if (type_ == MenuItemType::Checkbox) {
+      // Reflect tri-state (Mixed) visually using GTK's inconsistent state
+      gtk_check_menu_item_set_inconsistent(check_item,
+                                           state_ == MenuItemState::Mixed ? TRUE : FALSE);
+    }
+  }
+
+  void ApplySubmenu(MenuItem* owner) {
+    if (!gtk_menu_item_ || !submenu_) {
+      return;
+    }
+    GtkWidget* submenu_widget = static_cast<GtkWidget*>(submenu_->GetNativeObject());
+    gtk_menu_item_set_submenu(GTK_MENU_ITEM(gtk_menu_item_), submenu_widget);
+
+    // Emit submenu open/close events on the parent item when submenu
+    // maps/unmaps (actual visibility on screen)
+    if (submenu_widget) {
+      g_signal_connect(G_OBJECT(submenu_widget), "map", G_CALLBACK(OnGtkSubmenuMap), owner);
+      g_signal_connect(G_OBJECT(submenu_widget), "unmap", G_CALLBACK(OnGtkSubmenuUnmap), owner);
+    }
   }
 
   MenuItemId id_;
-  GtkWidget* gtk_menu_item_;
+  GtkWidget* gtk_menu_item_;  // nullptr until first needed
+  MenuId parent_id_ = 0;      // Menu the item was last added to, 0 for none
+  size_t position_ = 0;       // Index in that menu's items
   std::optional<std::string> title_;
   std::shared_ptr<Image> image_;
   std::optional<std::string> tooltip_;
   MenuItemType type_;
   MenuItemState state_;
+  bool enabled_;
   int radio_group_;
   KeyboardAccelerator accelerator_;
   std::shared_ptr<Menu> submenu_;
@@ -129,81 +472,656 @@ class MenuItem::Impl {
   // Signal handler IDs for cleanup
   gulong activate_handler_id_;
   gulong toggled_handler_id_;
-
-  // Shared map from logical group id to GTK group list
-  static std::unordered_map<int, GSList*> s_group_map_;
-  static std::mutex s_group_map_mutex_;
 };
 
-// Static member definitions
-std::unordered_map<int, GSList*> MenuItem::Impl::s_group_map_;
-std::mutex MenuItem::Impl::s_group_map_mutex_;
+// Virtualized menus (Menu::SetVirtualWindow)
+constexpr size_t kVirtualScrollStep = 3;          // Items per mouse wheel notch
+constexpr size_t kVirtualSpareRows = 8;           // Unbound rows kept per kind
+constexpr guint kVirtualAutoScrollInterval = 50;  // ms per item while an arrow is hovered
+constexpr const char* kRowItemKey = "nativeapi-menu-item-id";
+
+// Private implementation class for Menu. Like MenuItem, the GtkMenu is
+// created on first use and then filled with the widgets of the items.
+//
+// A virtualized menu instead shows a window of its items in rows: generic
+// widgets that are bound to an item by id and rebound as the window scrolls,
+// so its items never create widgets of their own. The rows follow changes
+// of the items through the MenuObserver notifications.
+class Menu::Impl : public MenuObserver {
+ public:
+  Impl(MenuId id, GtkWidget* menu)
+      : id_(id), gtk_menu_(menu), map_handler_id_(0), unmap_handler_id_(0) {}
 
-MenuItem::MenuItem(const std::string& label, MenuItemType type) {
-  MenuItemId id = IdAllocator::Allocate<MenuItem>();
-  GtkWidget* gtk_item = nullptr;
+  GtkWidget* EnsureWidget(Menu* owner) {
+    if (gtk_menu_) {
+      return gtk_menu_;
+    }
+    gtk_menu_ = gtk_menu_new();
+    ConnectSignals(owner);
+    if (virtual_window_ > 0) {
+      StartVirtual();
+      return gtk_menu_;
+    }
+    for (const auto& item : items_) {
+      gtk_menu_shell_append(GTK_MENU_SHELL(gtk_menu_), (GtkWidget*)item->GetNativeObject());
+    }
+    return gtk_menu_;
+  }
 
-  switch (type) {
-    case MenuItemType::Separator:
-      gtk_item = gtk_separator_menu_item_new();
-      break;
-    case MenuItemType::Checkbox:
-      gtk_item = gtk_check_menu_item_new_with_label(label.c_str());
-      break;
-    case MenuItemType::Radio:
-      gtk_item = gtk_radio_menu_item_new_with_label(nullptr, label.c_str());
-      break;
-    case MenuItemType::Normal:
-    case MenuItemType::Submenu:
-    default:
-      gtk_item = gtk_menu_item_new_with_label(label.c_str());
-      break;
+  // Connect menu map/unmap to emit open/close events when actually visible
+  void ConnectSignals(Menu* owner) {
+    if (!gtk_menu_) {
+      return;
+    }
+    map_handler_id_ = g_signal_connect(G_OBJECT(gtk_menu_), "map", G_CALLBACK(OnGtkMenuMap), owner);
+    unmap_handler_id_ =
+        g_signal_connect(G_OBJECT(gtk_menu_), "unmap", G_CALLBACK(OnGtkMenuUnmap), owner);
   }
 
-  pimpl_ = std::unique_ptr<Impl>(new Impl(id, gtk_item, type));
+  // Appends or inserts |item| at |index| in the model and its widget
+  void Insert(size_t index, std::shared_ptr<MenuItem> item) {
+    std::shared_ptr<MenuItem> added = item;
+    item->pimpl_->parent_id_ = id_;
+    if (gtk_menu_ && virtual_window_ == 0) {
+      gtk_menu_shell_insert(GTK_MENU_SHELL(gtk_menu_), (GtkWidget*)item->GetNativeObject(),
+                            static_cast<gint>(index));
+    }
+    if (index >= items_.size()) {
+      item->pimpl_->position_ = items_.size();
+      items_.push_back(std::move(item));
+    } else {
+      items_.insert(items_.begin() + index, std::move(item));
+      Reindex(index);
+    }
+    if (Menu* owner = Lookup(GetMenuIndex(), id_)) {
+      owner->LinkItem(added);
+    }
+  }
 
-  if (!label.empty()) {
-    pimpl_->title_ = label;
-  } else {
-    pimpl_->title_.reset();
+  void RemoveAt(size_t index) {
+    std::shared_ptr<MenuItem> item = std::move(items_[index]);
+    items_.erase(items_.begin() + index);
+    Reindex(index);
+    Detach(*item);
   }
 
-  // Connect signals for click/toggle events (except separators)
-  if (gtk_item && type != MenuItemType::Separator) {
-    if (type == MenuItemType::Checkbox || type == MenuItemType::Radio) {
-      pimpl_->toggled_handler_id_ = g_signal_connect(G_OBJECT(gtk_item), "toggled",
-                                                     G_CALLBACK(OnGtkCheckMenuItemToggled), this);
+  // Items of a non-virtualized menu with a widget always have one too
+  void Detach(MenuItem& item) {
+    if (gtk_menu_ && virtual_window_ == 0) {
+      gtk_container_remove(GTK_CONTAINER(gtk_menu_), (GtkWidget*)item.GetNativeObject());
+    }
+    if (item.pimpl_->parent_id_ == id_) {
+      item.pimpl_->parent_id_ = 0;
+    }
+    if (Menu* owner = Lookup(GetMenuIndex(), id_)) {
+      owner->UnlinkItem(item);
+    }
+  }
+
+  // Positions of the items from |from| on changed. A plain store per item,
+  // so this costs about as much as the vector shift that caused it.
+  void Reindex(size_t from) {
+    for (size_t i = from; i < items_.size(); ++i) {
+      if (items_[i]->pimpl_->parent_id_ == id_) {
+        items_[i]->pimpl_->position_ = i;
+      }
+    }
+  }
+
+  // An item added to several menus is only found in the last one
+  std::optional<size_t> PositionOf(MenuItemId item_id) const {
+    const MenuItem* item = Lookup(GetItemIndex(), item_id);
+    if (!item || item->pimpl_->parent_id_ != id_) {
+      return std::nullopt;
+    }
+    return item->pimpl_->position_;
+  }
+
+  // ── Virtualized mode ──────────────────────────────────────────────────────
+
+  enum class RowKind { Plain, Check, Separator };
+
+  struct Row {
+    GtkWidget* widget;
+    RowKind kind;
+    MenuItemId item_id;
+    std::shared_ptr<Image> image;  // Icon the row content was built with
+  };
+
+  void SetVirtualWindow(size_t visible_items) {
+    const size_t previous = virtual_window_;
+    virtual_window_ = visible_items;
+    if (!gtk_menu_ || previous == visible_items) {
+      return;
+    }
+    if (previous > 0 && visible_items > 0) {
+      Render();
+    } else if (visible_items > 0) {
+      for (const auto& item : items_) {
+        gtk_container_remove(GTK_CONTAINER(gtk_menu_), (GtkWidget*)item->GetNativeObject());
+      }
+      StartVirtual();
+    } else {
+      StopVirtual();
+      for (const auto& item : items_) {
+        gtk_menu_shell_append(GTK_MENU_SHELL(gtk_menu_), (GtkWidget*)item->GetNativeObject());
+      }
+    }
+  }
+
+  void StartVirtual() {
+    scroll_up_ = CreateScrollArrow("▲", OnScrollUpSelect);
+    scroll_down_ = CreateScrollArrow("▼", OnScrollDownSelect);
+    const gpointer menu_id = GUINT_TO_POINTER(id_);
+    gtk_widget_add_events(gtk_menu_, GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+    scroll_handler_id_ = g_signal_connect(G_OBJECT(gtk_menu_), "scroll-event",
+                                          G_CALLBACK(OnVirtualMenuScroll), menu_id);
+    move_current_handler_id_ = g_signal_connect(G_OBJECT(gtk_menu_), "move-current",
+                                                G_CALLBACK(OnVirtualMenuMoveCurrent), menu_id);
+    AddMenuObserver(this);
+    Render();
+  }
+
+  // Drops every row and spare; the menu keeps its item records
+  void StopVirtual() {
+    if (!scroll_up_) {
+      return;
+    }
+    RemoveMenuObserver(this);
+    StopAutoScroll();
+    g_signal_handler_disconnect(G_OBJECT(gtk_menu_), scroll_handler_id_);
+    g_signal_handler_disconnect(G_OBJECT(gtk_menu_), move_current_handler_id_);
+    scroll_handler_id_ = 0;
+    move_current_handler_id_ = 0;
+    for (Row& row : rows_) {
+      ReleaseRow(row);
+    }
+    rows_.clear();
+    for (auto& spares : spare_rows_) {
+      for (GtkWidget* widget : spares) {
+        g_object_unref(widget);
+      }
+      spares.clear();
+    }
+    for (GtkWidget* arrow : {scroll_up_, scroll_down_}) {
+      SetArrowAttached(arrow, false, false);
+      g_object_unref(arrow);
+    }
+    scroll_up_ = nullptr;
+    scroll_down_ = nullptr;
+  }
+
+  // Binds the rows to the items of the current window. Rows whose kind still
+  // fits are rebound in place; only kind changes and a growing window take
+  // widgets from the spares or create them.
+  void Render() {
+    if (!gtk_menu_ || !scroll_up_) {
+      return;
+    }
+    GtkMenuShell* shell = GTK_MENU_SHELL(gtk_menu_);
+    const size_t count = items_.size();
+    const size_t last_first = count > virtual_window_ ? count - virtual_window_ : 0;
+    first_visible_ = std::min(first_visible_, last_first);
+    const size_t visible = std::min(virtual_window_, count - first_visible_);
+
+    SetArrowAttached(scroll_up_, first_visible_ > 0, true);
+    const size_t offset = first_visible_ > 0 ? 1 : 0;
+    for (size_t i = 0; i < visible; ++i) {
+      const MenuItem& item = *items_[first_visible_ + i];
+      const RowKind kind = KindOf(item);
+      if (i == rows_.size() || rows_[i].kind != kind) {
+        if (i < rows_.size()) {
+          ReleaseRow(rows_[i]);
+          rows_[i] = Row{AcquireRow(kind), kind, 0, nullptr};
+        } else {
+          rows_.push_back(Row{AcquireRow(kind), kind, 0, nullptr});
+        }
+        gtk_menu_shell_insert(shell, rows_[i].widget, static_cast<gint>(offset + i));
+        gtk_widget_show(rows_[i].widget);
+      }
+      BindRow(rows_[i], item);
+    }
+    while (rows_.size() > visible) {
+      ReleaseRow(rows_.back());
+      rows_.pop_back();
+    }
+    SetArrowAttached(scroll_down_, first_visible_ + visible < count, false);
+  }
+
+  // Moves the window by |delta| items; false when it is already at that end
+  bool ScrollBy(long delta) {
+    const size_t count = items_.size();
+    const size_t last_first = count > virtual_window_ ? count - virtual_window_ : 0;
+    size_t first = first_visible_;
+    if (delta < 0) {
+      first -= std::min(first, static_cast<size_t>(-delta));
     } else {
-      pimpl_->activate_handler_id_ =
-          g_signal_connect(G_OBJECT(gtk_item), "activate", G_CALLBACK(OnGtkMenuItemActivate), this);
+      first = std::min(last_first, first + static_cast<size_t>(delta));
+    }
+    if (first == first_visible_) {
+      return false;
+    }
+    first_visible_ = first;
+    Render();
+    return true;
+  }
+
+  static RowKind KindOf(const MenuItem& item) {
+    switch (item.pimpl_->type_) {
+      case MenuItemType::Separator:
+        return RowKind::Separator;
+      case MenuItemType::Checkbox:
+      case MenuItemType::Radio:
+        return RowKind::Check;
+      default:
+        return RowKind::Plain;
+    }
+  }
+
+  GtkWidget* AcquireRow(RowKind kind) {
+    auto& spares = spare_rows_[static_cast<size_t>(kind)];
+    if (!spares.empty()) {
+      GtkWidget* widget = spares.back();
+      spares.pop_back();
+      return widget;
+    }
+    GtkWidget* widget = nullptr;
+    switch (kind) {
+      case RowKind::Separator:
+        widget = gtk_separator_menu_item_new();
+        break;
+      case RowKind::Check:
+        // Radio items too: a GtkRadioMenuItem would keep a group of its own
+        // and refuse to be rebound as inactive
+        widget = gtk_check_menu_item_new();
+        break;
+      case RowKind::Plain:
+        widget = gtk_menu_item_new();
+        break;
+    }
+    g_object_ref_sink(widget);
+    if (kind != RowKind::Separator) {
+      g_signal_connect(G_OBJECT(widget), "activate", G_CALLBACK(OnRowActivate), nullptr);
+    }
+    return widget;
+  }
+
+  // Takes |row| out of the menu and keeps its widget as a spare
+  void ReleaseRow(Row& row) {
+    gtk_container_remove(GTK_CONTAINER(gtk_menu_), row.widget);
+    if (row.kind != RowKind::Separator &&
+        gtk_menu_item_get_submenu(GTK_MENU_ITEM(row.widget)) != nullptr) {
+      gtk_menu_item_set_submenu(GTK_MENU_ITEM(row.widget), nullptr);
+    }
+    g_object_set_data(G_OBJECT(row.widget), kRowItemKey, nullptr);
+    auto& spares = spare_rows_[static_cast<size_t>(row.kind)];
+    if (spares.size() < kVirtualSpareRows) {
+      spares.push_back(row.widget);
+    } else {
+      g_object_unref(row.widget);
+    }
+    row.widget = nullptr;
+  }
+
+  // Mirrors |item| into |row|; a row of the right kind needs no new widgets
+  // unless the icon changed
+  void BindRow(Row& row, const MenuItem& item) {
+    const MenuItem::Impl& record = *item.pimpl_;
+    GtkWidget* widget = row.widget;
+    if (row.item_id != record.id_) {
+      row.item_id = record.id_;
+      g_object_set_data(G_OBJECT(widget), kRowItemKey, GUINT_TO_POINTER(record.id_));
+    }
+    gtk_widget_set_sensitive(widget, record.enabled_ ? TRUE : FALSE);
+    gtk_widget_set_tooltip_text(widget,
+                                record.tooltip_.has_value() ? record.tooltip_->c_str() : nullptr);
+    if (row.kind == RowKind::Separator) {
+      return;
+    }
+
+    const std::string label = record.title_.value_or("");
+    if (row.image != record.image_ || !gtk_bin_get_child(GTK_BIN(widget))) {
+      SetItemWidgetContent(widget, label, record.image_);
+      row.image = record.image_;
+    } else {
+      SetItemWidgetLabel(widget, label.c_str());
+    }
+    // An empty accelerator clears the one a recycled row showed before
+    SetItemWidgetAccelerator(widget, record.accelerator_);
+
+    if (row.kind == RowKind::Check) {
+      GtkCheckMenuItem* check_item = GTK_CHECK_MENU_ITEM(widget);
+      // set_active emits "activate", which is not a click here
+      g_signal_handlers_block_by_func(G_OBJECT(widget), (gpointer)OnRowActivate, nullptr);
+      gtk_check_menu_item_set_draw_as_radio(
+          check_item, record.type_ == MenuItemType::Radio ? TRUE : FALSE);
+      gtk_check_menu_item_set_active(check_item,
+                                     record.state_ == MenuItemState::Checked ? TRUE : FALSE);
+      const bool mixed =
+          record.type_ == MenuItemType::Checkbox && record.state_ == MenuItemState::Mixed;
+      gtk_check_menu_item_set_inconsistent(check_item, mixed ? TRUE : FALSE);
+      g_signal_handlers_unblock_by_func(G_OBJECT(widget), (gpointer)OnRowActivate, nullptr);
+    }
+
+    GtkWidget* submenu =
+        record.submenu_ ? static_cast<GtkWidget*>(record.submenu_->GetNativeObject()) : nullptr;
+    if (gtk_menu_item_get_submenu(GTK_MENU_ITEM(widget)) != submenu) {
+      if (submenu) {
+        // A GtkMenu is attached to one item at a time; take it from the row
+        // that showed it before the window moved
+        GtkWidget* attached = gtk_menu_get_attach_widget(GTK_MENU(submenu));
+        if (attached && GTK_IS_MENU_ITEM(attached)) {
+          gtk_menu_item_set_submenu(GTK_MENU_ITEM(attached), nullptr);
+        }
+        ConnectRowSubmenuSignals(submenu, record.submenu_->GetId());
+      }
+      gtk_menu_item_set_submenu(GTK_MENU_ITEM(widget), submenu);
+    }
+  }
+
+  // The map handlers resolve the submenu by id, since the item showing it
+  // changes as rows are rebound
+  static void ConnectRowSubmenuSignals(GtkWidget* submenu, MenuId submenu_id) {
+    if (g_signal_handler_find(G_OBJECT(submenu), G_SIGNAL_MATCH_FUNC, 0, 0, nullptr,
+                              (gpointer)OnRowSubmenuMap, nullptr) != 0) {
+      return;
+    }
+    g_signal_connect(G_OBJECT(submenu), "map", G_CALLBACK(OnRowSubmenuMap),
+                     GUINT_TO_POINTER(submenu_id));
+    g_signal_connect(G_OBJECT(submenu), "unmap", G_CALLBACK(OnRowSubmenuUnmap),
+                     GUINT_TO_POINTER(submenu_id));
+  }
+
+  GtkWidget* CreateScrollArrow(const char* label, void (*on_select)(GtkMenuItem*, gpointer)) {
+    GtkWidget* arrow = gtk_menu_item_new_with_label(label);
+    g_object_ref_sink(arrow);
+    GtkWidget* child = gtk_bin_get_child(GTK_BIN(arrow));
+    if (child && GTK_IS_LABEL(child)) {
+      gtk_label_set_xalign(GTK_LABEL(child), 0.5);
+    }
+    const gpointer menu_id = GUINT_TO_POINTER(id_);
+    g_signal_connect(G_OBJECT(arrow), "select", G_CALLBACK(on_select), menu_id);
+    g_signal_connect(G_OBJECT(arrow), "deselect", G_CALLBACK(OnScrollArrowDeselect), menu_id);
+    // Clicking an arrow must not activate it, which would close the menu
+    g_signal_connect(G_OBJECT(arrow), "button-press-event", G_CALLBACK(OnScrollArrowButton),
+                     nullptr);
+    g_signal_connect(G_OBJECT(arrow), "button-release-event", G_CALLBACK(OnScrollArrowButton),
+                     nullptr);
+    return arrow;
+  }
+
+  void SetArrowAttached(GtkWidget* arrow, bool attached, bool top) {
+    const bool is_attached = gtk_widget_get_parent(arrow) == gtk_menu_;
+    if (attached && !is_attached) {
+      if (top) {
+        gtk_menu_shell_prepend(GTK_MENU_SHELL(gtk_menu_), arrow);
+      } else {
+        gtk_menu_shell_append(GTK_MENU_SHELL(gtk_menu_), arrow);
+      }
+      gtk_widget_show_all(arrow);
+    } else if (!attached && is_attached) {
+      gtk_container_remove(GTK_CONTAINER(gtk_menu_), arrow);
+    }
+  }
+
+  void StartAutoScroll(long direction) {
+    StopAutoScroll();
+    auto_scroll_direction_ = direction;
+    auto_scroll_source_id_ =
+        g_timeout_add(kVirtualAutoScrollInterval, OnAutoScroll, GUINT_TO_POINTER(id_));
+  }
+
+  void StopAutoScroll() {
+    if (auto_scroll_source_id_ != 0) {
+      g_source_remove(auto_scroll_source_id_);
+      auto_scroll_source_id_ = 0;
+    }
+  }
+
+  // The first or last row keyboard navigation can stop on
+  GtkWidget* EdgeRow(bool bottom) const {
+    for (size_t i = 0; i < rows_.size(); ++i) {
+      const Row& row = rows_[bottom ? rows_.size() - 1 - i : i];
+      if (row.kind != RowKind::Separator && gtk_widget_is_sensitive(row.widget)) {
+        return row.widget;
+      }
+    }
+    return nullptr;
+  }
+
+  static Impl* VirtualMenuImpl(gpointer menu_id) {
+    Menu* menu = Lookup(GetMenuIndex(), GPOINTER_TO_UINT(menu_id));
+    return menu && menu->pimpl_->scroll_up_ ? menu->pimpl_.get() : nullptr;
+  }
+
+  // Rows are not the item's own widget, so the click is applied to the
+  // item the way the dbusmenu exporter does it
+  static void OnRowActivate(GtkMenuItem* row, gpointer /*user_data*/) {
+    MenuItem* item =
+        Lookup(GetItemIndex(), GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(row), kRowItemKey)));
+    if (!item) {
+      return;
+    }
+    switch (item->GetType()) {
+      case MenuItemType::Checkbox:
+        item->SetState(item->GetState() == MenuItemState::Checked ? MenuItemState::Unchecked
+                                                                  : MenuItemState::Checked);
+        break;
+      case MenuItemType::Radio: {
+        // GTK unchecked the row; only becoming active counts as a click
+        const bool was_checked = item->GetState() == MenuItemState::Checked;
+        item->SetState(MenuItemState::Checked);
+        if (was_checked) {
+          return;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    item->Emit(MenuItemClickedEvent(item->GetId()));
+  }
+
+  static void OnRowSubmenuMap(GtkWidget* submenu, gpointer submenu_id) {
+    Menu* menu = Lookup(GetMenuIndex(), GPOINTER_TO_UINT(submenu_id));
+    MenuItem* owner = menu ? Lookup(GetItemIndex(), menu->pimpl_->owner_id_) : nullptr;
+    OnGtkSubmenuMap(submenu, owner);
+  }
+
+  static void OnRowSubmenuUnmap(GtkWidget* submenu, gpointer submenu_id) {
+    Menu* menu = Lookup(GetMenuIndex(), GPOINTER_TO_UINT(submenu_id));
+    MenuItem* owner = menu ? Lookup(GetItemIndex(), menu->pimpl_->owner_id_) : nullptr;
+    OnGtkSubmenuUnmap(submenu, owner);
+  }
+
+  static gboolean OnVirtualMenuScroll(GtkWidget* /*menu*/,
+                                      GdkEventScroll* event,
+                                      gpointer menu_id) {
+    Impl* impl = VirtualMenuImpl(menu_id);
+    if (!impl) {
+      return FALSE;
+    }
+    switch (event->direction) {
+      case GDK_SCROLL_UP:
+        impl->ScrollBy(-static_cast<long>(kVirtualScrollStep));
+        break;
+      case GDK_SCROLL_DOWN:
+        impl->ScrollBy(static_cast<long>(kVirtualScrollStep));
+        break;
+      case GDK_SCROLL_SMOOTH: {
+        // Touchpads report fractions of a notch; carry the remainder over
+        impl->scroll_remainder_ += event->delta_y * kVirtualScrollStep;
+        const long steps = static_cast<long>(impl->scroll_remainder_);
+        impl->scroll_remainder_ -= steps;
+        if (steps != 0) {
+          impl->ScrollBy(steps);
+        }
+        break;
+      }
+      default:
+        return FALSE;
+    }
+    return TRUE;
+  }
+
+  // Moving past the first or last row scrolls the window instead of
+  // wrapping around
+  static void OnVirtualMenuMoveCurrent(GtkMenuShell* shell,
+                                       GtkMenuDirectionType direction,
+                                       gpointer menu_id) {
+    Impl* impl = VirtualMenuImpl(menu_id);
+    if (!impl || (direction != GTK_MENU_DIR_NEXT && direction != GTK_MENU_DIR_PREV)) {
+      return;
+    }
+    const bool down = direction == GTK_MENU_DIR_NEXT;
+    GtkWidget* edge = impl->EdgeRow(down);
+    if (!edge || gtk_menu_shell_get_selected_item(shell) != edge ||
+        !impl->ScrollBy(down ? 1 : -1)) {
+      return;
+    }
+    g_signal_stop_emission_by_name(shell, "move-current");
+    if (GtkWidget* row = impl->EdgeRow(down)) {
+      gtk_menu_shell_select_item(shell, row);
+    }
+  }
+
+  static void OnScrollUpSelect(GtkMenuItem* /*arrow*/, gpointer menu_id) {
+    if (Impl* impl = VirtualMenuImpl(menu_id)) {
+      impl->StartAutoScroll(-1);
+    }
+  }
+
+  static void OnScrollDownSelect(GtkMenuItem* /*arrow*/, gpointer menu_id) {
+    if (Impl* impl = VirtualMenuImpl(menu_id)) {
+      impl->StartAutoScroll(1);
     }
   }
+
+  static void OnScrollArrowDeselect(GtkMenuItem* /*arrow*/, gpointer menu_id) {
+    if (Impl* impl = VirtualMenuImpl(menu_id)) {
+      impl->StopAutoScroll();
+    }
+  }
+
+  static gboolean OnScrollArrowButton(GtkWidget* /*arrow*/,
+                                      GdkEventButton* /*event*/,
+                                      gpointer /*user_data*/) {
+    return TRUE;
+  }
+
+  static gboolean OnAutoScroll(gpointer menu_id) {
+    Impl* impl = VirtualMenuImpl(menu_id);
+    if (!impl) {
+      return G_SOURCE_REMOVE;
+    }
+    const guint source_id = impl->auto_scroll_source_id_;
+    const bool scrolled = impl->ScrollBy(impl->auto_scroll_direction_);
+    // Reaching the end removes the arrow, whose deselect stops this timer
+    if (impl->auto_scroll_source_id_ != source_id) {
+      return G_SOURCE_REMOVE;
+    }
+    if (!scrolled) {
+      impl->auto_scroll_source_id_ = 0;
+      return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+  }
+
+  // MenuObserver: keeps the bound rows in sync with their items
+  void OnMenuItemChanged(const MenuItem& item) override {
+    const MenuItem::Impl& record = *item.pimpl_;
+    if (record.parent_id_ != id_ || record.position_ < first_visible_ ||
+        record.position_ - first_visible_ >= rows_.size()) {
+      return;
+    }
+    BindRow(rows_[record.position_ - first_visible_], item);
+  }
+
+  void OnMenuItemSubmenuChanged(const MenuItem& item) override { OnMenuItemChanged(item); }
+
+  void OnMenuItemsChanged(const Menu& menu) override {
+    if (menu.pimpl_.get() == this) {
+      Render();
+    }
+  }
+
+  MenuId id_;
+  GtkWidget* gtk_menu_;  // nullptr until first needed
+  std::vector<std::shared_ptr<MenuItem>> items_;
+  MenuItemId owner_id_ = 0;  // Item this menu is the submenu of, 0 for none
+
+  // Virtualized mode; the rows and arrows exist while scroll_up_ is set
+  size_t virtual_window_ = 0;  // Rows shown at once, 0 when not virtualized
+  size_t first_visible_ = 0;   // Index of the item in the first row
+  std::vector<Row> rows_;
+  std::array<std::vector<GtkWidget*>, 3> spare_rows_;  // By RowKind
+  GtkWidget* scroll_up_ = nullptr;
+  GtkWidget* scroll_down_ = nullptr;
+  double scroll_remainder_ = 0.0;
+  long auto_scroll_direction_ = 0;
+  guint auto_scroll_source_id_ = 0;
+
+  // Signal handler IDs for cleanup
+  gulong map_handler_id_;
+  gulong unmap_handler_id_;
+  gulong scroll_handler_id_ = 0;
+  gulong move_current_handler_id_ = 0;
+};
+
+MenuItem::MenuItem(const std::string& label, MenuItemType type) {
+  MenuItemId id = IdAllocator::Allocate<MenuItem>();
+  pimpl_ = std::unique_ptr<Impl>(new Impl(id, nullptr, type));
+  AddToIndex(GetItemIndex(), id, this);
+
+  if (!label.empty()) {
+    pimpl_->title_ = label;
+  } else {
+    pimpl_->title_.reset();
+  }
 }
 
 MenuItem::MenuItem(void* menu_item) {
   MenuItemId id = IdAllocator::Allocate<MenuItem>();
-  pimpl_ = std::unique_ptr<Impl>(new Impl(id, (GtkWidget*)menu_item, MenuItemType::Normal));
-  if (pimpl_->gtk_menu_item_ && pimpl_->type_ != MenuItemType::Separator) {
-    const char* label = gtk_menu_item_get_label(GTK_MENU_ITEM(pimpl_->gtk_menu_item_));
+  GtkWidget* widget = static_cast<GtkWidget*>(menu_item);
+  MenuItemType type = MenuItemType::Normal;
+  if (widget && GTK_IS_SEPARATOR_MENU_ITEM(widget)) {
+    type = MenuItemType::Separator;
+  } else if (widget && GTK_IS_RADIO_MENU_ITEM(widget)) {
+    type = MenuItemType::Radio;
+  } else if (widget && GTK_IS_CHECK_MENU_ITEM(widget)) {
+    type = MenuItemType::Checkbox;
+  }
+  pimpl_ = std::unique_ptr<Impl>(new Impl(id, widget, type));
+  AddToIndex(GetItemIndex(), id, this);
+  if (!widget) {
+    return;
+  }
+  g_object_ref_sink(widget);
+
+  // Adopt the wrapped widget's current state
+  if (pimpl_->type_ != MenuItemType::Separator) {
+    const char* label = gtk_menu_item_get_label(GTK_MENU_ITEM(widget));
     if (label && label[0] != '\0') {
       pimpl_->title_ = std::string(label);
     } else {
       pimpl_->title_.reset();
     }
   }
-
-  if (pimpl_->gtk_menu_item_) {
-    if (GTK_IS_CHECK_MENU_ITEM(pimpl_->gtk_menu_item_)) {
-      pimpl_->toggled_handler_id_ = g_signal_connect(G_OBJECT(pimpl_->gtk_menu_item_), "toggled",
-                                                     G_CALLBACK(OnGtkCheckMenuItemToggled), this);
-    } else {
-      pimpl_->activate_handler_id_ = g_signal_connect(G_OBJECT(pimpl_->gtk_menu_item_), "activate",
-                                                      G_CALLBACK(OnGtkMenuItemActivate), this);
+  pimpl_->enabled_ = gtk_widget_get_sensitive(widget) == TRUE;
+  if (GTK_IS_CHECK_MENU_ITEM(widget)) {
+    GtkCheckMenuItem* check_item = GTK_CHECK_MENU_ITEM(widget);
+    if (gtk_check_menu_item_get_inconsistent(check_item)) {
+      pimpl_->state_ = MenuItemState::Mixed;
+    } else if (gtk_check_menu_item_get_active(check_item)) {
+      pimpl_->state_ = MenuItemState::Checked;
     }
   }
+  pimpl_->ConnectSignals(this);
 }
 
 MenuItem::~MenuItem() {
+  RemoveFromIndex(GetItemIndex(), pimpl_->id_);
+
   // Disconnect signal handlers before destruction to prevent accessing freed memory
   if (pimpl_->gtk_menu_item_) {
     // Disconnect submenu map/unmap handlers first if they exist
@@ -227,8 +1145,9 @@ MenuItem::~MenuItem() {
       pimpl_->toggled_handler_id_ = 0;
     }
 
-    // Note: We don't destroy the gtk_menu_item_ here because it's owned by the parent Menu
-    // and will be destroyed when the Menu container is destroyed
+    // Drop our reference; a menu that still contains the widget keeps it alive
+    g_object_unref(pimpl_->gtk_menu_item_);
+    pimpl_->gtk_menu_item_ = nullptr;
   }
 }
 
@@ -242,27 +1161,8 @@ MenuItemType MenuItem::GetType() const {
 
 void MenuItem::SetLabel(const std::optional<std::string>& label) {
   pimpl_->title_ = label;
-  if (pimpl_->gtk_menu_item_ && pimpl_->type_ != MenuItemType::Separator) {
-    const char* labelStr = label.has_value() ? label->c_str() : "";
-
-    // Check if we have a custom box layout (with icon)
-    GtkWidget* child = gtk_bin_get_child(GTK_BIN(pimpl_->gtk_menu_item_));
-    if (child && GTK_IS_BOX(child)) {
-      // Custom layout with icon - find the label widget and update it
-      GList* children = gtk_container_get_children(GTK_CONTAINER(child));
-      for (GList* iter = children; iter != nullptr; iter = iter->next) {
-        GtkWidget* widget = GTK_WIDGET(iter->data);
-        if (GTK_IS_LABEL(widget)) {
-          gtk_label_set_text(GTK_LABEL(widget), labelStr);
-          break;
-        }
-      }
-      g_list_free(children);
-    } else {
-      // Simple label-only layout
-      gtk_menu_item_set_label(GTK_MENU_ITEM(pimpl_->gtk_menu_item_), labelStr);
-    }
-  }
+  pimpl_->ApplyLabel();
+  NotifyMenuItemChanged(*this);
 }
 
 std::optional<std::string> MenuItem::GetLabel() const {
@@ -271,69 +1171,8 @@ std::optional<std::string> MenuItem::GetLabel() const {
 
 void MenuItem::SetIcon(std::shared_ptr<Image> image) {
   pimpl_->image_ = image;
-
-  if (!pimpl_->gtk_menu_item_ || pimpl_->type_ == MenuItemType::Separator) {
-    return;
-  }
-
-  // Get current label text to preserve it - prefer stored title over GTK widget
-  std::string current_label;
-  if (pimpl_->title_.has_value()) {
-    current_label = pimpl_->title_.value();
-  } else {
-    // Fallback to GTK widget if title not set
-    const char* label_text = gtk_menu_item_get_label(GTK_MENU_ITEM(pimpl_->gtk_menu_item_));
-    current_label = label_text ? label_text : "";
-  }
-
-  // Remove existing child widget
-  GtkWidget* existing_child = gtk_bin_get_child(GTK_BIN(pimpl_->gtk_menu_item_));
-  if (existing_child) {
-    gtk_container_remove(GTK_CONTAINER(pimpl_->gtk_menu_item_), existing_child);
-  }
-
-  if (image && image->GetNativeObject()) {
-    // Create a horizontal box to hold icon and label
-    GtkWidget* box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);  // 6px spacing
-
-    // Get the GdkPixbuf from the image
-    GdkPixbuf* pixbuf = static_cast<GdkPixbuf*>(image->GetNativeObject());
-
-    // Scale the icon to a reasonable menu size (16x16 is standard for menu items)
-    const int icon_size = 16;
-    GdkPixbuf* scaled_pixbuf = nullptr;
-
-    int original_width = gdk_pixbuf_get_width(pixbuf);
-    int original_height = gdk_pixbuf_get_height(pixbuf);
-
-    if (original_width != icon_size || original_height != icon_size) {
-      scaled_pixbuf = gdk_pixbuf_scale_simple(pixbuf, icon_size, icon_size, GDK_INTERP_BILINEAR);
-    } else {
-      scaled_pixbuf = gdk_pixbuf_copy(pixbuf);
-    }
-
-    // Create GtkImage from the pixbuf
-    GtkWidget* gtk_image = gtk_image_new_from_pixbuf(scaled_pixbuf);
-    g_object_unref(scaled_pixbuf);  // GtkImage takes its own reference
-
-    // Create label widget
-    GtkWidget* label = gtk_label_new(current_label.c_str());
-    gtk_label_set_xalign(GTK_LABEL(label), 0.0);  // Left-align the label
-
-    // Pack icon and label into box
-    gtk_box_pack_start(GTK_BOX(box), gtk_image, FALSE, FALSE, 0);
-    gtk_box_pack_start(GTK_BOX(box), label, TRUE, TRUE, 0);
-
-    // Add box to menu item
-    gtk_container_add(GTK_CONTAINER(pimpl_->gtk_menu_item_), box);
-    gtk_widget_show_all(box);
-  } else {
-    // No icon - restore simple label display
-    GtkWidget* label = gtk_label_new(current_label.c_str());
-    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
-    gtk_container_add(GTK_CONTAINER(pimpl_->gtk_menu_item_), label);
-    gtk_widget_show(label);
-  }
+  pimpl_->ApplyIcon();
+  NotifyMenuItemChanged(*this);
 }
 
 std::shared_ptr<Image> MenuItem::GetIcon() const {
@@ -342,13 +1181,8 @@ std::shared_ptr<Image> MenuItem::GetIcon() const {
 
 void MenuItem::SetTooltip(const std::optional<std::string>& tooltip) {
   pimpl_->tooltip_ = tooltip;
-  if (pimpl_->gtk_menu_item_) {
-    if (tooltip.has_value()) {
-      gtk_widget_set_tooltip_text(pimpl_->gtk_menu_item_, tooltip->c_str());
-    } else {
-      gtk_widget_set_tooltip_text(pimpl_->gtk_menu_item_, nullptr);
-    }
-  }
+  pimpl_->ApplyTooltip();
+  NotifyMenuItemChanged(*this);
 }
 
 std::optional<std::string> MenuItem::GetTooltip() const {
@@ -361,7 +1195,9 @@ void MenuItem::SetAccelerator(const std::optional<KeyboardAccelerator>& accelera
   } else {
     pimpl_->accelerator_ = KeyboardAccelerator("", ModifierKey::None);
   }
-  // TODO: Implement GTK accelerator setting
+  LinkAccelerator(pimpl_->accelerator_);
+  pimpl_->ApplyAccelerator();
+  NotifyMenuItemChanged(*this);
 }
 
 KeyboardAccelerator MenuItem::GetAccelerator() const {
@@ -369,68 +1205,38 @@ KeyboardAccelerator MenuItem::GetAccelerator() const {
 }
 
 void MenuItem::SetEnabled(bool enabled) {
+  pimpl_->enabled_ = enabled;
   if (pimpl_->gtk_menu_item_) {
     gtk_widget_set_sensitive(pimpl_->gtk_menu_item_, enabled ? TRUE : FALSE);
   }
+  NotifyMenuItemChanged(*this);
 }
 
 bool MenuItem::IsEnabled() const {
-  if (pimpl_->gtk_menu_item_) {
-    return gtk_widget_get_sensitive(pimpl_->gtk_menu_item_) == TRUE;
-  }
-  return true;
+  return pimpl_->enabled_;
 }
 
 void MenuItem::SetState(MenuItemState state) {
-  pimpl_->state_ = state;
-  if (pimpl_->gtk_menu_item_) {
-    if (pimpl_->type_ == MenuItemType::Checkbox) {
-      // Update checked state
-      gboolean active = (state == MenuItemState::Checked) ? TRUE : FALSE;
-      // Block the "toggled" signal to prevent recursive triggering when setting active
-      g_signal_handlers_block_by_func(G_OBJECT(pimpl_->gtk_menu_item_),
-                                      (gpointer)OnGtkCheckMenuItemToggled, this);
-      gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pimpl_->gtk_menu_item_), active);
-      g_signal_handlers_unblock_by_func(G_OBJECT(pimpl_->gtk_menu_item_),
-                                        (gpointer)OnGtkCheckMenuItemToggled, this);
-
-      // Reflect tri-state (Mixed) visually using GTK's inconsistent state
-      gtk_check_menu_item_set_inconsistent(GTK_CHECK_MENU_ITEM(pimpl_->gtk_menu_item_),
-                                           (state == MenuItemState::Mixed) ? TRUE : FALSE);
-    } else if (pimpl_->type_ == MenuItemType::Radio) {
-      gboolean active = (state == MenuItemState::Checked) ? TRUE : FALSE;
-      // Block the "toggled" signal to prevent recursive triggering
-      g_signal_handlers_block_by_func(G_OBJECT(pimpl_->gtk_menu_item_),
-                                      (gpointer)OnGtkCheckMenuItemToggled, this);
-      gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pimpl_->gtk_menu_item_), active);
-      g_signal_handlers_unblock_by_func(G_OBJECT(pimpl_->gtk_menu_item_),
-                                        (gpointer)OnGtkCheckMenuItemToggled, this);
-    }
+  if (state == pimpl_->state_) {
+    // Still reset the widget, which GTK may have toggled on its own
+    pimpl_->ApplyState(this);
+    return;
   }
+  pimpl_->state_ = state;
+  pimpl_->ApplyState(this);
+  SyncRadioGroup();
+  NotifyMenuItemChanged(*this);
 }
 
 MenuItemState MenuItem::GetState() const {
-  // For checkbox and radio items, get the actual state from GTK widget
-  if (pimpl_->gtk_menu_item_ &&
-      (pimpl_->type_ == MenuItemType::Checkbox || pimpl_->type_ == MenuItemType::Radio)) {
-    if (pimpl_->type_ == MenuItemType::Checkbox) {
-      // If inconsistent is set, treat as Mixed regardless of active
-      gboolean inconsistent =
-          gtk_check_menu_item_get_inconsistent(GTK_CHECK_MENU_ITEM(pimpl_->gtk_menu_item_));
-      if (inconsistent) {
-        return MenuItemState::Mixed;
-      }
-    }
-
-    gboolean active = gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(pimpl_->gtk_menu_item_));
-    return active ? MenuItemState::Checked : MenuItemState::Unchecked;
-  }
   return pimpl_->state_;
 }
 
 void MenuItem::SetRadioGroup(int group_id) {
+  ForgetRadioGroup();
   pimpl_->radio_group_ = group_id;
-  pimpl_->ApplyRadioGroup();
+  SyncRadioGroup();
+  NotifyMenuItemChanged(*this);
 }
 
 int MenuItem::GetRadioGroup() const {
@@ -438,19 +1244,16 @@ int MenuItem::GetRadioGroup() const {
 }
 
 void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
+  if (pimpl_->submenu_ && pimpl_->submenu_->pimpl_->owner_id_ == pimpl_->id_) {
+    pimpl_->submenu_->pimpl_->owner_id_ = 0;
+  }
   pimpl_->submenu_ = submenu;
-  if (pimpl_->gtk_menu_item_ && submenu) {
-    gtk_menu_item_set_submenu(GTK_MENU_ITEM(pimpl_->gtk_menu_item_),
-                              (GtkWidget*)submenu->GetNativeObject());
-
-    // Emit submenu open/close events on the parent item when submenu
-    // maps/unmaps (actual visibility on screen)
-    GtkWidget* submenu_widget = (GtkWidget*)submenu->GetNativeObject();
-    if (submenu_widget) {
-      g_signal_connect(G_OBJECT(submenu_widget), "map", G_CALLBACK(OnGtkSubmenuMap), this);
-      g_signal_connect(G_OBJECT(submenu_widget), "unmap", G_CALLBACK(OnGtkSubmenuUnmap), this);
-    }
+  if (submenu) {
+    submenu->pimpl_->owner_id_ = pimpl_->id_;
   }
+  LinkSubmenu(submenu);
+  pimpl_->ApplySubmenu(this);
+  NotifyMenuItemSubmenuChanged(*this);
 }
 
 std::shared_ptr<Menu> MenuItem::GetSubmenu() const {
@@ -458,48 +1261,25 @@ std::shared_ptr<Menu> MenuItem::GetSubmenu() const {
 }
 
 void* MenuItem::GetNativeObjectInternal() const {
-  return (void*)pimpl_->gtk_menu_item_;
+  return pimpl_->EnsureWidget(const_cast<MenuItem*>(this));
 }
 
-// Private implementation class for Menu
-class Menu::Impl {
- public:
-  Impl(MenuId id, GtkWidget* menu)
-      : id_(id), gtk_menu_(menu), map_handler_id_(0), unmap_handler_id_(0) {}
-
-  MenuId id_;
-  GtkWidget* gtk_menu_;
-  std::vector<std::shared_ptr<MenuItem>> items_;
-
-  // Signal handler IDs for cleanup
-  gulong map_handler_id_;
-  gulong unmap_handler_id_;
-};
-
 Menu::Menu() {
   MenuId id = IdAllocator::Allocate<Menu>();
-  pimpl_ = std::unique_ptr<Impl>(new Impl(id, gtk_menu_new()));
-  // Connect menu map/unmap to emit open/close events when actually visible
-  if (pimpl_->gtk_menu_) {
-    pimpl_->map_handler_id_ =
-        g_signal_connect(G_OBJECT(pimpl_->gtk_menu_), "map", G_CALLBACK(OnGtkMenuMap), this);
-    pimpl_->unmap_handler_id_ =
-        g_signal_connect(G_OBJECT(pimpl_->gtk_menu_), "unmap", G_CALLBACK(OnGtkMenuUnmap), this);
-  }
+  pimpl_ = std::unique_ptr<Impl>(new Impl(id, nullptr));
+  AddToIndex(GetMenuIndex(), id, this);
 }
 
 Menu::Menu(void* menu) {
   MenuId id = IdAllocator::Allocate<Menu>();
   pimpl_ = std::unique_ptr<Impl>(new Impl(id, (GtkWidget*)menu));
-  if (pimpl_->gtk_menu_) {
-    pimpl_->map_handler_id_ =
-        g_signal_connect(G_OBJECT(pimpl_->gtk_menu_), "map", G_CALLBACK(OnGtkMenuMap), this);
-    pimpl_->unmap_handler_id_ =
-        g_signal_connect(G_OBJECT(pimpl_->gtk_menu_), "unmap", G_CALLBACK(OnGtkMenuUnmap), this);
-  }
+  AddToIndex(GetMenuIndex(), id, this);
+  pimpl_->ConnectSignals(this);
 }
 
 Menu::~Menu() {
+  RemoveFromIndex(GetMenuIndex(), pimpl_->id_);
+
   // Disconnect signal handlers and properly clean up GTK widget
   if (pimpl_->gtk_menu_) {
     // Ensure menu is closed before destroying to prevent processing events on freed widget
@@ -507,6 +1287,9 @@ Menu::~Menu() {
       gtk_menu_popdown(GTK_MENU(pimpl_->gtk_menu_));
     }
 
+    // Rows and the observer registration of a virtualized menu
+    pimpl_->StopVirtual();
+
     // Disconnect signal handlers before destroying to prevent accessing freed memory
     if (pimpl_->map_handler_id_ > 0) {
       g_signal_handler_disconnect(G_OBJECT(pimpl_->gtk_menu_), pimpl_->map_handler_id_);
@@ -529,61 +1312,64 @@ MenuId Menu::GetId() const {
 }
 
 void Menu::AddItem(std::shared_ptr<MenuItem> item) {
-  if (pimpl_->gtk_menu_ && item && item->GetNativeObject()) {
-    pimpl_->items_.push_back(item);
-    gtk_menu_shell_append(GTK_MENU_SHELL(pimpl_->gtk_menu_), (GtkWidget*)item->GetNativeObject());
-  }
+  if (!item)
+    return;
+
+  pimpl_->Insert(pimpl_->items_.size(), std::move(item));
+  NotifyMenuItemsChanged(*this);
 }
 
 void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
   if (!item)
     return;
 
-  if (index >= pimpl_->items_.size()) {
-    AddItem(item);
-    return;
-  }
-
-  pimpl_->items_.insert(pimpl_->items_.begin() + index, item);
-  if (pimpl_->gtk_menu_ && item->GetNativeObject()) {
-    gtk_menu_shell_insert(GTK_MENU_SHELL(pimpl_->gtk_menu_), (GtkWidget*)item->GetNativeObject(),
-                          index);
-  }
+  pimpl_->Insert(std::min(index, pimpl_->items_.size()), std::move(item));
+  NotifyMenuItemsChanged(*this);
 }
 
 bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
-  if (pimpl_->gtk_menu_ && item && item->GetNativeObject()) {
-    auto it = std::find(pimpl_->items_.begin(), pimpl_->items_.end(), item);
-    if (it != pimpl_->items_.end()) {
-      pimpl_->items_.erase(it);
-      gtk_container_remove(GTK_CONTAINER(pimpl_->gtk_menu_), (GtkWidget*)item->GetNativeObject());
-      return true;
-    }
+  if (!item)
+    return false;
+
+  std::optional<size_t> index = pimpl_->PositionOf(item->GetId());
+  if (!index || pimpl_->items_[*index] != item) {
+    return false;
   }
-  return false;
+  pimpl_->RemoveAt(*index);
+  NotifyMenuItemsChanged(*this);
+  return true;
 }
 
 bool Menu::RemoveItemById(MenuItemId item_id) {
-  for (auto& item : pimpl_->items_) {
-    if (item->GetId() == item_id) {
-      return RemoveItem(item);
-    }
+  std::optional<size_t> index = pimpl_->PositionOf(item_id);
+  if (!index) {
+    return false;
   }
-  return false;
+  pimpl_->RemoveAt(*index);
+  NotifyMenuItemsChanged(*this);
+  return true;
 }
 
 bool Menu::RemoveItemAt(size_t index) {
-  if (index < pimpl_->items_.size()) {
-    auto item = pimpl_->items_[index];
-    return RemoveItem(item);
+  if (index >= pimpl_->items_.size()) {
+    return false;
   }
-  return false;
+  pimpl_->RemoveAt(index);
+  NotifyMenuItemsChanged(*this);
+  return true;
 }
 
 void Menu::Clear() {
-  while (!pimpl_->items_.empty()) {
-    RemoveItem(pimpl_->items_.back());
+  if (pimpl_->items_.empty()) {
+    return;
   }
+  // Front to back: GTK finds each widget at the head of its child list
+  std::vector<std::shared_ptr<MenuItem>> items;
+  items.swap(pimpl_->items_);
+  for (const auto& item : items) {
+    pimpl_->Detach(*item);
+  }
+  NotifyMenuItemsChanged(*this);
 }
 
 void Menu::AddSeparator() {
@@ -608,18 +1394,22 @@ std::shared_ptr<MenuItem> Menu::GetItemAt(size_t index) const {
 }
 
 std::shared_ptr<MenuItem> Menu::GetItemById(MenuItemId item_id) const {
-  for (const auto& item : pimpl_->items_) {
-    if (item->GetId() == item_id) {
-      return item;
-    }
-  }
-  return nullptr;
+  std::optional<size_t> index = pimpl_->PositionOf(item_id);
+  return index ? pimpl_->items_[*index] : nullptr;
 }
 
 std::vector<std::shared_ptr<MenuItem>> Menu::GetAllItems() const {
   return pimpl_->items_;
 }
 
+void Menu::SetVirtualWindow(size_t visible_items) {
+  pimpl_->SetVirtualWindow(visible_items);
+}
+
+size_t Menu::GetVirtualWindow() const {
+  return pimpl_->virtual_window_;
+}
+
 bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
   // Ensure GTK operations run on the main thread (owner of default GMainContext)
   if (!g_main_context_is_owner(g_main_context_default())) {
@@ -661,11 +1451,12 @@ bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
     return data.result;
   }
 
-  if (!pimpl_->gtk_menu_) {
+  GtkWidget* gtk_menu = pimpl_->EnsureWidget(this);
+  if (!gtk_menu) {
     return false;
   }
 
-  gtk_widget_show_all(pimpl_->gtk_menu_);
+  gtk_widget_show_all(gtk_menu);
 
   // Get GdkWindow from relative window if available, otherwise use root window
   GdkWindow* gdk_window = nullptr;
@@ -835,10 +1626,12 @@ bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
   }
 
   // Position menu using gtk_menu_popup_at_rect
-  gtk_menu_popup_at_rect(GTK_MENU(pimpl_->gtk_menu_), gdk_window, &rectangle,
-                         GDK_GRAVITY_NORTH_WEST, menu_anchor, nullptr);
+  gtk_menu_popup_at_rect(GTK_MENU(gtk_menu), gdk_window, &rectangle, GDK_GRAVITY_NORTH_WEST,
+                         menu_anchor, nullptr);
 
-  return true;
+  // GTK gives up without showing the menu when it cannot grab the pointer,
+  // e.g. on Wayland without a triggering event; a shown menu is mapped here.
+  return gtk_widget_get_mapped(gtk_menu);
 }
 
 bool Menu::Close() {
@@ -880,15 +1673,15 @@ bool Menu::Close() {
     return data.result;
   }
 
+  // A menu without a widget has never been shown
   if (pimpl_->gtk_menu_) {
     gtk_menu_popdown(GTK_MENU(pimpl_->gtk_menu_));
-    return true;
   }
-  return false;
+  return true;
 }
 
 void* Menu::GetNativeObjectInternal() const {
-  return (void*)pimpl_->gtk_menu_;
+  return pimpl_->EnsureWidget(const_cast<Menu*>(this));
 }
 
 }  // namespace nativeapi
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../../menu.h"
+
+namespace nativeapi {
+
+/**
+ * @brief Receives change notifications from the Linux Menu/MenuItem backend.
+ *
+ * Used by exporters that mirror menus elsewhere (the dbusmenu exporter of the
+ * StatusNotifierItem tray) so they can send deltas instead of re-reading the
+ * whole tree. Notifications are delivered synchronously on the thread that
+ * mutated the menu, which for GTK-backed menus is the main thread.
+ */
+class MenuObserver {
+ public:
+  virtual ~MenuObserver() = default;
+
+  // Label, icon, tooltip, accelerator, enabled or check state of |item| changed
+  virtual void OnMenuItemChanged(const MenuItem& item) = 0;
+
+  // |item| was given a different submenu (or none)
+  virtual void OnMenuItemSubmenuChanged(const MenuItem& item) = 0;
+
+  // Items were inserted into or removed from |menu|
+  virtual void OnMenuItemsChanged(const Menu& menu) = 0;
+};
+
+// Registers |observer| for changes of every menu in the process
+void AddMenuObserver(MenuObserver* observer);
+
+// Unregisters |observer|; safe to call from within a notification
+void RemoveMenuObserver(MenuObserver* observer);
+
+}  // namespace nativeapi
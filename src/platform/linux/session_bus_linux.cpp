@@ -0,0 +1,117 @@
+#include "session_bus_linux.h"
+
+#include <glib.h>
+#include <iostream>
+#include <map>
+#include <utility>
+
+namespace nativeapi {
+
+namespace {
+
+struct SessionBusState {
+  GDBusConnection* connection = nullptr;
+  bool connecting = false;
+  guint next_request_id = 1;
+  guint dispatch_source_id = 0;
+  // Ordered so that callbacks run in request order
+  std::map<guint, SessionBusCallback> pending;
+};
+
+SessionBusState& GetState() {
+  static SessionBusState state;
+  return state;
+}
+
+// Runs the callbacks queued so far. Each one is removed before it runs, so a
+// callback may cancel later requests or queue new ones (which are dispatched
+// separately).
+void DispatchPending() {
+  SessionBusState& state = GetState();
+  const guint end_id = state.next_request_id;
+  while (!state.pending.empty() && state.pending.begin()->first < end_id) {
+    SessionBusCallback callback = std::move(state.pending.begin()->second);
+    state.pending.erase(state.pending.begin());
+    callback(state.connection);
+  }
+}
+
+gboolean OnDispatchIdle(gpointer) {
+  GetState().dispatch_source_id = 0;
+  DispatchPending();
+  return G_SOURCE_REMOVE;
+}
+
+void OnConnectionClosed(GDBusConnection* connection, gboolean, GError*, gpointer) {
+  SessionBusState& state = GetState();
+  if (state.connection == connection) {
+    // The next request reconnects.
+    g_signal_handlers_disconnect_by_func(connection, (gpointer)&OnConnectionClosed, nullptr);
+    g_object_unref(state.connection);
+    state.connection = nullptr;
+  }
+}
+
+void OnBusReady(GObject*, GAsyncResult* result, gpointer) {
+  SessionBusState& state = GetState();
+  state.connecting = false;
+
+  GError* error = nullptr;
+  state.connection = g_bus_get_finish(result, &error);
+  if (state.connection) {
+    // A lost session bus must not terminate the application.
+    g_dbus_connection_set_exit_on_close(state.connection, FALSE);
+    g_signal_connect(state.connection, "closed", G_CALLBACK(OnConnectionClosed), nullptr);
+  } else if (error) {
+    std::cerr << "[nativeapi] D-Bus session connection failed: " << error->message << std::endl;
+    g_error_free(error);
+  }
+  DispatchPending();
+}
+
+}  // namespace
+
+guint RequestSessionBus(SessionBusCallback callback) {
+  SessionBusState& state = GetState();
+  const guint request_id = state.next_request_id++;
+  state.pending.emplace(request_id, std::move(callback));
+
+  if (state.connection) {
+    if (state.dispatch_source_id == 0) {
+      state.dispatch_source_id = g_idle_add(&OnDispatchIdle, nullptr);
+    }
+  } else if (!state.connecting) {
+    state.connecting = true;
+    g_bus_get(G_BUS_TYPE_SESSION, nullptr, &OnBusReady, nullptr);
+  }
+  return request_id;
+}
+
+void CancelSessionBusRequest(guint request_id) {
+  SessionBusState& state = GetState();
+  auto it = state.pending.find(request_id);
+  if (it != state.pending.end()) {
+    state.pending.erase(it);
+  }
+}
+
+GDBusConnection* GetSessionBusIfConnected() {
+  return GetState().connection;
+}
+
+bool HasSessionBusAddress() {
+  if (GetState().connection) {
+    return true;
+  }
+  const gchar* address = g_getenv("DBUS_SESSION_BUS_ADDRESS");
+  if (address && address[0] != '\0') {
+    return true;
+  }
+  // systemd and other session managers expose the bus at a well-known path
+  gchar* path = g_build_filename(g_get_user_runtime_dir(), "bus", nullptr);
+  const bool exists = g_file_test(path, G_FILE_TEST_EXISTS);
+  g_free(path);
+  return exists;
+}
+
+}  // namespace nativeapi
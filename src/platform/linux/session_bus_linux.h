@@ -0,0 +1,29 @@
+#pragma once
+
+#include <gio/gio.h>
+#include <functional>
+
+namespace nativeapi {
+
+/**
+ * @brief Receives the shared session bus connection, or nullptr if the bus is
+ * unavailable. The connection is borrowed; take a reference to keep it.
+ */
+using SessionBusCallback = std::function<void(GDBusConnection* connection)>;
+
+// Obtains the process-wide session bus connection without blocking and calls
+// |callback| from the main loop, never from within this call. The first
+// request starts connecting; later requests share the same connection.
+// Returns an id for CancelSessionBusRequest.
+guint RequestSessionBus(SessionBusCallback callback);
+
+// Drops a pending request so that its callback never runs
+void CancelSessionBusRequest(guint request_id);
+
+// Returns the shared connection if it is established, nullptr otherwise
+GDBusConnection* GetSessionBusIfConnected();
+
+// Returns true if a session bus address is configured, without connecting
+bool HasSessionBusAddress();
+
+}  // namespace nativeapi
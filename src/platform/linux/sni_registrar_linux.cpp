@@ -0,0 +1,239 @@
+#include "sni_registrar_linux.h"
+
+#include <glib.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace nativeapi {
+
+namespace {
+
+// KDE's name is the standard one; some older Ayatana hosts use Canonical's.
+const char* const kWatcherNames[] = {
+    "org.kde.StatusNotifierWatcher",
+    "com.canonical.StatusNotifierWatcher",
+};
+constexpr int kWatcherCount = 2;
+
+enum class WatcherState { Unknown, Present, Absent };
+
+struct Item {
+  std::string object_path;
+  SniItemCallbacks callbacks;
+  GCancellable* cancellable;  // bound to every call made for this item
+  bool registered;
+  bool reported_no_watcher;
+};
+
+struct RegistrarState {
+  GDBusConnection* connection = nullptr;
+  guint watch_ids[kWatcherCount] = {};
+  WatcherState watcher_states[kWatcherCount] = {};
+  std::string watcher_owners[kWatcherCount];
+  guint next_item_id = 1;
+  std::map<guint, Item> items;
+  std::vector<guint> queued;  // added since the last batch
+  guint batch_source_id = 0;
+};
+
+RegistrarState& GetState() {
+  static RegistrarState state;
+  return state;
+}
+
+int WatcherIndex(const gchar* name) {
+  for (int i = 0; i < kWatcherCount; ++i) {
+    if (g_strcmp0(name, kWatcherNames[i]) == 0) return i;
+  }
+  return -1;
+}
+
+bool AllWatchersAbsent() {
+  for (WatcherState state : GetState().watcher_states) {
+    if (state != WatcherState::Absent) return false;
+  }
+  return true;
+}
+
+void OnRegisterReply(GObject* source, GAsyncResult* result, gpointer user_data) {
+  GError* error = nullptr;
+  GVariant* reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+
+  // Removed items cancel their calls; anything not found is stale.
+  RegistrarState& state = GetState();
+  auto it = state.items.find(GPOINTER_TO_UINT(user_data));
+  if (it == state.items.end() || g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+    if (error) g_error_free(error);
+    if (reply) g_variant_unref(reply);
+    return;
+  }
+
+  Item& item = it->second;
+  if (!reply) {
+    const std::string message = std::string("Watcher rejected the tray icon: ") + error->message;
+    g_error_free(error);
+    item.callbacks.on_failed(message);
+    return;
+  }
+  g_variant_unref(reply);
+  if (!item.registered) {
+    item.registered = true;
+    item.callbacks.on_registered();
+  }
+}
+
+// Sends the call without waiting for the reply, so a batch of items is
+// pipelined on the connection.
+void Register(guint item_id, const Item& item, int watcher_index) {
+  RegistrarState& state = GetState();
+  g_dbus_connection_call(state.connection, state.watcher_owners[watcher_index].c_str(),
+                         "/StatusNotifierWatcher", kWatcherNames[watcher_index],
+                         "RegisterStatusNotifierItem",
+                         g_variant_new("(s)", item.object_path.c_str()), nullptr,
+                         G_DBUS_CALL_FLAGS_NONE, -1, item.cancellable, &OnRegisterReply,
+                         GUINT_TO_POINTER(item_id));
+}
+
+void ReportNoWatcher(Item& item) {
+  item.registered = false;
+  if (!item.reported_no_watcher) {
+    item.reported_no_watcher = true;
+    item.callbacks.on_failed(
+        "no StatusNotifierWatcher found; tray icon is not shown until one appears");
+  }
+}
+
+gboolean OnBatchIdle(gpointer) {
+  RegistrarState& state = GetState();
+  state.batch_source_id = 0;
+  std::vector<guint> batch;
+  batch.swap(state.queued);
+
+  // Until a watch reports, the watcher callbacks cover queued items.
+  const bool no_watcher = AllWatchersAbsent();
+  for (guint item_id : batch) {
+    auto it = state.items.find(item_id);
+    if (it == state.items.end()) continue;
+    if (no_watcher) {
+      ReportNoWatcher(it->second);
+      continue;
+    }
+    for (int i = 0; i < kWatcherCount; ++i) {
+      if (state.watcher_states[i] == WatcherState::Present) {
+        Register(item_id, it->second, i);
+      }
+    }
+  }
+  return G_SOURCE_REMOVE;
+}
+
+void OnWatcherAppeared(GDBusConnection*, const gchar* name, const gchar* name_owner, gpointer) {
+  RegistrarState& state = GetState();
+  const int index = WatcherIndex(name);
+  if (index < 0) return;
+
+  state.watcher_states[index] = WatcherState::Present;
+  // Address the current owner so a reply always belongs to this owner.
+  state.watcher_owners[index] = name_owner;
+  // Every item goes to the new owner in one batch, queued ones included.
+  state.queued.clear();
+  for (auto& [item_id, item] : state.items) {
+    item.reported_no_watcher = false;
+    Register(item_id, item, index);
+  }
+}
+
+void OnWatcherVanished(GDBusConnection*, const gchar* name, gpointer) {
+  RegistrarState& state = GetState();
+  const int index = WatcherIndex(name);
+  if (index < 0) return;
+
+  state.watcher_states[index] = WatcherState::Absent;
+  state.watcher_owners[index].clear();
+  if (!AllWatchersAbsent()) return;
+
+  // Callbacks may remove items, so iterate over a snapshot of the ids.
+  std::vector<guint> item_ids;
+  for (const auto& entry : state.items) {
+    item_ids.push_back(entry.first);
+  }
+  for (guint item_id : item_ids) {
+    auto it = state.items.find(item_id);
+    if (it != state.items.end()) {
+      ReportNoWatcher(it->second);
+    }
+  }
+}
+
+void StopWatching() {
+  RegistrarState& state = GetState();
+  for (int i = 0; i < kWatcherCount; ++i) {
+    if (state.watch_ids[i] != 0) {
+      g_bus_unwatch_name(state.watch_ids[i]);
+      state.watch_ids[i] = 0;
+    }
+    state.watcher_states[i] = WatcherState::Unknown;
+    state.watcher_owners[i].clear();
+  }
+  if (state.connection) {
+    g_object_unref(state.connection);
+    state.connection = nullptr;
+  }
+}
+
+// Follows the owners of both watcher names on |connection|. GDBus reports
+// the current owner asynchronously and again whenever it changes, so a panel
+// started or restarted later still receives the items.
+void StartWatching(GDBusConnection* connection) {
+  RegistrarState& state = GetState();
+  state.connection = G_DBUS_CONNECTION(g_object_ref(connection));
+  for (int i = 0; i < kWatcherCount; ++i) {
+    state.watch_ids[i] = g_bus_watch_name_on_connection(
+        connection, kWatcherNames[i], G_BUS_NAME_WATCHER_FLAGS_NONE, &OnWatcherAppeared,
+        &OnWatcherVanished, nullptr, nullptr);
+  }
+}
+
+}  // namespace
+
+guint AddSniItem(GDBusConnection* connection,
+                 const std::string& object_path,
+                 SniItemCallbacks callbacks) {
+  RegistrarState& state = GetState();
+  if (state.connection != connection) {
+    // The session bus was reconnected; items on the old one are gone.
+    StopWatching();
+    StartWatching(connection);
+  }
+
+  const guint item_id = state.next_item_id++;
+  state.items.emplace(item_id, Item{object_path, std::move(callbacks), g_cancellable_new(),
+                                    false, false});
+  state.queued.push_back(item_id);
+  if (state.batch_source_id == 0) {
+    state.batch_source_id = g_idle_add(&OnBatchIdle, nullptr);
+  }
+  return item_id;
+}
+
+void RemoveSniItem(guint item_id) {
+  RegistrarState& state = GetState();
+  auto it = state.items.find(item_id);
+  if (it == state.items.end()) return;
+
+  g_cancellable_cancel(it->second.cancellable);
+  g_object_unref(it->second.cancellable);
+  state.items.erase(it);
+
+  if (state.items.empty()) {
+    if (state.batch_source_id != 0) {
+      g_source_remove(state.batch_source_id);
+      state.batch_source_id = 0;
+    }
+    state.queued.clear();
+    StopWatching();
+  }
+}
+
+}  // namespace nativeapi
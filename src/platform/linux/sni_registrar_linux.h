@@ -0,0 +1,37 @@
+#pragma once
+
+#include <gio/gio.h>
+#include <functional>
+#include <string>
+
+namespace nativeapi {
+
+/**
+ * @brief Outcome callbacks for one StatusNotifierItem registration.
+ *
+ * on_registered runs when a watcher accepts the item, and again after a
+ * watcher restart. on_failed runs when a watcher rejects the item, and once
+ * each time no watcher is running.
+ */
+struct SniItemCallbacks {
+  std::function<void()> on_registered;
+  std::function<void(const std::string& message)> on_failed;
+};
+
+// Registers the process's tray items with the StatusNotifierWatcher. Every
+// item lives on the shared session bus connection under its own object path
+// and is registered by path, so no well-known bus names are requested. The
+// watcher names are watched once for all items. Items added during one
+// main-loop iteration are registered in a single batch of pipelined
+// RegisterStatusNotifierItem calls, and a restarted watcher receives every
+// item again in one batch. Main thread only.
+//
+// Returns an id for RemoveSniItem. Callbacks never run from within this call.
+guint AddSniItem(GDBusConnection* connection,
+                 const std::string& object_path,
+                 SniItemCallbacks callbacks);
+
+// Cancels the item's pending calls; its callbacks never run again
+void RemoveSniItem(guint item_id);
+
+}  // namespace nativeapi
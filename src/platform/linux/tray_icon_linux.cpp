@@ -6,22 +6,26 @@
 
 #include <gio/gio.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gdk/gdk.h>
 #include <glib.h>
-#include <gtk/gtk.h>
-#include <sys/types.h>
-#include <unistd.h>
-#include <atomic>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../../foundation/id_allocator.h"
 #include "../../image.h"
 #include "../../menu.h"
 #include "../../tray_icon.h"
+#include "dbus_menu_exporter_linux.h"
+#include "session_bus_linux.h"
+#include "sni_registrar_linux.h"
+#include "tray_icon_linux.h"
 
 namespace nativeapi {
 
@@ -72,110 +76,156 @@ static const char kSniIntrospectionXml[] =
     "  </interface>"
     "</node>";
 
-static const char kDbusMenuIntrospectionXml[] =
-    "<node>"
-    "  <interface name='com.canonical.dbusmenu'>"
-    "    <property name='Version' type='u' access='read'/>"
-    "    <property name='TextDirection' type='s' access='read'/>"
-    "    <property name='Status' type='s' access='read'/>"
-    "    <property name='IconThemePath' type='as' access='read'/>"
-    "    <method name='GetLayout'>"
-    "      <arg type='i' name='parentId' direction='in'/>"
-    "      <arg type='i' name='recursionDepth' direction='in'/>"
-    "      <arg type='as' name='propertyNames' direction='in'/>"
-    "      <arg type='u' name='revision' direction='out'/>"
-    "      <arg type='(ia{sv}av)' name='layout' direction='out'/>"
-    "    </method>"
-    "    <method name='GetGroupProperties'>"
-    "      <arg type='ai' name='ids' direction='in'/>"
-    "      <arg type='as' name='propertyNames' direction='in'/>"
-    "      <arg type='a(ia{sv})' name='properties' direction='out'/>"
-    "    </method>"
-    "    <method name='GetProperty'>"
-    "      <arg type='i' name='id' direction='in'/>"
-    "      <arg type='s' name='name' direction='in'/>"
-    "      <arg type='v' name='value' direction='out'/>"
-    "    </method>"
-    "    <method name='Event'>"
-    "      <arg type='i' name='id' direction='in'/>"
-    "      <arg type='s' name='eventId' direction='in'/>"
-    "      <arg type='v' name='data' direction='in'/>"
-    "      <arg type='u' name='timestamp' direction='in'/>"
-    "    </method>"
-    "    <method name='EventGroup'>"
-    "      <arg type='a(isvu)' name='events' direction='in'/>"
-    "      <arg type='ai' name='idErrors' direction='out'/>"
-    "    </method>"
-    "    <method name='AboutToShow'>"
-    "      <arg type='i' name='id' direction='in'/>"
-    "      <arg type='b' name='needUpdate' direction='out'/>"
-    "    </method>"
-    "    <method name='AboutToShowGroup'>"
-    "      <arg type='ai' name='ids' direction='in'/>"
-    "      <arg type='ai' name='updatesNeeded' direction='out'/>"
-    "      <arg type='ai' name='idErrors' direction='out'/>"
-    "    </method>"
-    "    <signal name='ItemsPropertiesUpdated'>"
-    "      <arg type='a(ia{sv})' name='updatedProps'/>"
-    "      <arg type='a(ias)' name='removedProps'/>"
-    "    </signal>"
-    "    <signal name='LayoutUpdated'>"
-    "      <arg type='u' name='revision'/>"
-    "      <arg type='i' name='parent'/>"
-    "    </signal>"
-    "    <signal name='ItemActivationRequested'>"
-    "      <arg type='i' name='id'/>"
-    "      <arg type='u' name='timestamp'/>"
-    "    </signal>"
-    "  </interface>"
-    "</node>";
-
 // ── Icon pixel-data conversion ───────────────────────────────────────────────
 
-// Returns a GVariant of type a(iiay) containing one entry for the supplied
-// pixbuf (or an empty array when pixbuf is nullptr).  Each pixel is encoded as
-// four bytes in network byte order: Alpha, Red, Green, Blue (ARGB32).
-static GVariant* PixbufToSniIconPixmaps(GdkPixbuf* pixbuf) {
-  GVariantBuilder array_builder;
-  g_variant_builder_init(&array_builder, G_VARIANT_TYPE("a(iiay)"));
-
-  if (pixbuf) {
-    const int width = gdk_pixbuf_get_width(pixbuf);
-    const int height = gdk_pixbuf_get_height(pixbuf);
-    const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
-    const int n_channels = gdk_pixbuf_get_n_channels(pixbuf);
-    const gboolean has_alpha = gdk_pixbuf_get_has_alpha(pixbuf);
-    const guchar* pixels = gdk_pixbuf_get_pixels(pixbuf);
-
-    std::vector<uint8_t> argb;
-    argb.reserve(static_cast<size_t>(width * height * 4));
-
-    for (int row = 0; row < height; ++row) {
-      const guchar* p = pixels + row * rowstride;
-      for (int col = 0; col < width; ++col) {
-        const uint8_t r = p[0];
-        const uint8_t g = p[1];
-        const uint8_t b = p[2];
-        const uint8_t a = has_alpha ? p[3] : 255u;
-        argb.push_back(a);
-        argb.push_back(r);
-        argb.push_back(g);
-        argb.push_back(b);
-        p += n_channels;
-      }
+// Appends one (iiay) entry for |pixbuf| to an a(iiay) builder. Each pixel is
+// encoded as four bytes in network byte order: Alpha, Red, Green, Blue
+// (ARGB32). Returns false, appending nothing, for a null |pixbuf|.
+static bool AppendSniIconPixmap(GVariantBuilder* array_builder, GdkPixbuf* pixbuf) {
+  if (!pixbuf) {
+    return false;
+  }
+  const int width = gdk_pixbuf_get_width(pixbuf);
+  const int height = gdk_pixbuf_get_height(pixbuf);
+  const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+  const int n_channels = gdk_pixbuf_get_n_channels(pixbuf);
+  const gboolean has_alpha = gdk_pixbuf_get_has_alpha(pixbuf);
+  const guchar* pixels = gdk_pixbuf_get_pixels(pixbuf);
+
+  std::vector<uint8_t> argb;
+  argb.reserve(static_cast<size_t>(width * height * 4));
+
+  for (int row = 0; row < height; ++row) {
+    const guchar* p = pixels + row * rowstride;
+    for (int col = 0; col < width; ++col) {
+      const uint8_t r = p[0];
+      const uint8_t g = p[1];
+      const uint8_t b = p[2];
+      const uint8_t a = has_alpha ? p[3] : 255u;
+      argb.push_back(a);
+      argb.push_back(r);
+      argb.push_back(g);
+      argb.push_back(b);
+      p += n_channels;
     }
+  }
+
+  GVariantBuilder entry_builder;
+  g_variant_builder_init(&entry_builder, G_VARIANT_TYPE("(iiay)"));
+  g_variant_builder_add(&entry_builder, "i", width);
+  g_variant_builder_add(&entry_builder, "i", height);
+  g_variant_builder_add_value(
+      &entry_builder,
+      g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, argb.data(), argb.size(), sizeof(uint8_t)));
+  g_variant_builder_add_value(array_builder, g_variant_builder_end(&entry_builder));
+  return true;
+}
+
+// An empty a(iiay), for icons that are not set
+static GVariant* EmptySniIconPixmaps() {
+  return g_variant_new_array(G_VARIANT_TYPE("(iiay)"), nullptr, 0);
+}
+
+// Edge lengths panels commonly draw tray icons at (logical pixels)
+constexpr int kSniIconSizes[] = {16, 22, 24, 32, 48};
+
+// Scale factor of the primary monitor, or 1 without a display
+static int GetDisplayScale() {
+  GdkDisplay* display = gdk_display_get_default();
+  if (!display) {
+    return 1;
+  }
+  GdkMonitor* monitor = gdk_display_get_primary_monitor(display);
+  if (!monitor && gdk_display_get_n_monitors(display) > 0) {
+    monitor = gdk_display_get_monitor(display, 0);
+  }
+  return monitor ? std::max(1, gdk_monitor_get_scale_factor(monitor)) : 1;
+}
+
+// Builds the IconPixmap value for |image|: one entry per standard size, plus
+// the same sizes multiplied by the display scale, so hosts pick an exact
+// match instead of rescaling. Sizes above the source are not upscaled; the
+// source is sent at its own size instead. An image that fails to decode
+// exports no entries. The result is sunk and meant to be cached until the
+// icon changes.
+static GVariant* BuildSniIconPixmaps(const std::shared_ptr<Image>& image) {
+  if (!image) {
+    return g_variant_ref_sink(EmptySniIconPixmaps());
+  }
+
+  const Size size = image->GetSize();
+  const double longest = std::max(size.width, size.height);
+  const int scale = GetDisplayScale();
 
-    GVariantBuilder entry_builder;
-    g_variant_builder_init(&entry_builder, G_VARIANT_TYPE("(iiay)"));
-    g_variant_builder_add(&entry_builder, "i", width);
-    g_variant_builder_add(&entry_builder, "i", height);
-    g_variant_builder_add_value(
-        &entry_builder,
-        g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, argb.data(), argb.size(), sizeof(uint8_t)));
-    g_variant_builder_add_value(&array_builder, g_variant_builder_end(&entry_builder));
+  std::vector<int> edges;
+  for (int edge : kSniIconSizes) {
+    edges.push_back(edge);
+    edges.push_back(edge * scale);
   }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  GVariantBuilder builder;
+  g_variant_builder_init(&builder, G_VARIANT_TYPE("a(iiay)"));
+  bool added_source = false;
+  size_t entries = 0;
+  for (int edge : edges) {
+    if (edge >= longest) {
+      if (!added_source) {
+        // image_linux.cpp's GetNativeObjectInternal() returns GdkPixbuf* on
+        // Linux, or nullptr if a lazily decoded image fails to decode.
+        if (AppendSniIconPixmap(&builder, static_cast<GdkPixbuf*>(image->GetNativeObject()))) {
+          ++entries;
+        }
+        added_source = true;
+      }
+      continue;
+    }
+    const double ratio = edge / longest;
+    auto scaled = image->Resize({std::max(1.0, std::round(size.width * ratio)),
+                                 std::max(1.0, std::round(size.height * ratio))},
+                                ResampleFilter::Lanczos3);
+    if (scaled &&
+        AppendSniIconPixmap(&builder, static_cast<GdkPixbuf*>(scaled->GetNativeObject()))) {
+      ++entries;
+    }
+  }
+  if (entries == 0) {
+    g_variant_builder_clear(&builder);
+    return g_variant_ref_sink(EmptySniIconPixmaps());
+  }
+  return g_variant_ref_sink(g_variant_builder_end(&builder));
+}
+
+// ── Pointer input ────────────────────────────────────────────────────────────
+
+// GTK's default gtk-double-click-time and gtk-double-click-distance
+constexpr gint64 kDoubleClickTime = 400 * G_TIME_SPAN_MILLISECOND;
+constexpr double kDoubleClickDistance = 5;
+
+// ── Update statistics ────────────────────────────────────────────────────────
+
+// Properties that changed since the last flush
+enum PendingProperty : unsigned int {
+  kPendingIcon = 1u << 0,
+  kPendingTitle = 1u << 1,
+  kPendingToolTip = 1u << 2,
+  kPendingStatus = 1u << 3,
+  kPendingMenu = 1u << 4,
+  kPendingIconFrame = 1u << 5,  // animation frame; hosts fetch IconPixmap
+};
+
+static TrayIconUpdateStats& GetUpdateStats() {
+  static TrayIconUpdateStats stats;
+  return stats;
+}
+
+TrayIconUpdateStats GetTrayIconUpdateStats() {
+  return GetUpdateStats();
+}
 
-  return g_variant_builder_end(&array_builder);
+void ResetTrayIconUpdateStats() {
+  GetUpdateStats() = TrayIconUpdateStats{};
 }
 
 // ── Private implementation ───────────────────────────────────────────────────
@@ -186,65 +236,94 @@ class TrayIcon::Impl {
   TrayIconId id_;
 
   std::shared_ptr<Image> image_;
+  GVariant* icon_pixmaps_;  // IconPixmap value, rebuilt only by SetIcon
   std::optional<std::string> title_;
   std::optional<std::string> tooltip_;
   std::shared_ptr<Menu> context_menu_;
   bool visible_;
   ContextMenuTrigger context_menu_trigger_;
 
-  // D-Bus state
+  // D-Bus state; every icon has its own object path on the shared connection
   GDBusConnection* connection_;
+  guint bus_request_id_;
   guint registration_id_;
-  guint menu_registration_id_;
-  guint name_owner_id_;
-  std::string service_name_;
-  std::unordered_map<int, GtkWidget*> dbusmenu_items_;
-  unsigned int menu_revision_;
+  std::string object_path_;
+  std::string menu_path_;
+  std::unique_ptr<DbusMenuExporter> menu_exporter_;
+
+  // Watcher registration, handled in batches by the SNI registrar
+  guint sni_item_id_;
+  bool registered_;
+
+  // Property changes staged for the next flush (PendingProperty bits)
+  unsigned int pending_properties_;
+  guint flush_source_id_;
+
+  // Icon animation; every frame is converted to an IconPixmap value up front
+  std::vector<std::shared_ptr<Image>> animation_images_;
+  std::vector<GVariant*> animation_pixmaps_;
+  size_t animation_frame_;
+  guint animation_interval_ms_;
+  guint animation_source_id_;
+
+  // Last Activate call, for double-click synthesis
+  gint64 last_activate_time_;
+  Point last_activate_position_;
 
   explicit Impl(TrayIcon* owner)
       : owner_(owner),
         image_(nullptr),
+        icon_pixmaps_(g_variant_ref_sink(EmptySniIconPixmaps())),
         title_(std::nullopt),
         tooltip_(std::nullopt),
         context_menu_(nullptr),
         visible_(false),
         context_menu_trigger_(ContextMenuTrigger::None),
         connection_(nullptr),
+        bus_request_id_(0),
         registration_id_(0),
-        menu_registration_id_(0),
-        name_owner_id_(0),
-        menu_revision_(1) {
+        sni_item_id_(0),
+        registered_(false),
+        pending_properties_(0),
+        flush_source_id_(0),
+        animation_frame_(0),
+        animation_interval_ms_(0),
+        animation_source_id_(0),
+        last_activate_time_(0),
+        last_activate_position_{0, 0} {
     id_ = IdAllocator::Allocate<TrayIcon>();
+    object_path_ = "/StatusNotifierItem/" + std::to_string(id_);
+    menu_path_ = object_path_ + "/Menu";
   }
 
-  ~Impl() { Cleanup(); }
+  ~Impl() {
+    Cleanup();
+    g_variant_unref(icon_pixmaps_);
+  }
 
-  // Connect to the session bus, register the SNI object, and request a
-  // well-known service name.  Returns false on error (icon will be invisible).
-  bool Init() {
-    GError* error = nullptr;
-    connection_ = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, &error);
-    if (!connection_) {
-      if (error) {
-        std::cerr << "[nativeapi] SNI: D-Bus session connection failed: " << error->message
-                  << std::endl;
-        g_error_free(error);
-      }
-      return false;
-    }
+  // Starts initialisation without blocking: once the shared session bus is
+  // connected the SNI and dbusmenu objects are exported under this icon's
+  // paths and the item is handed to the registrar. The outcome is reported as
+  // TrayIconReadyEvent or TrayIconFailedEvent.
+  void Init() {
+    bus_request_id_ = RequestSessionBus([this](GDBusConnection* connection) {
+      bus_request_id_ = 0;
+      OnSessionBus(connection);
+    });
+  }
 
-    static std::atomic<int> next_sni_index{1};
-    service_name_ = "org.kde.StatusNotifierItem-" +
-                    std::to_string(static_cast<long>(getpid())) + "-" +
-                    std::to_string(next_sni_index++);
+  void OnSessionBus(GDBusConnection* connection) {
+    if (!connection) {
+      Fail("D-Bus session bus is not available");
+      return;
+    }
+    connection_ = G_DBUS_CONNECTION(g_object_ref(connection));
 
+    GError* error = nullptr;
     GDBusNodeInfo* node_info = g_dbus_node_info_new_for_xml(kSniIntrospectionXml, &error);
     if (!node_info) {
-      if (error) {
-        std::cerr << "[nativeapi] SNI: Bad introspection XML: " << error->message << std::endl;
-        g_error_free(error);
-      }
-      return false;
+      FailWithError("Bad introspection XML", error);
+      return;
     }
 
     GDBusInterfaceInfo* iface_info =
@@ -256,7 +335,7 @@ class TrayIcon::Impl {
         nullptr  // no writable properties
     };
 
-    registration_id_ = g_dbus_connection_register_object(connection_, "/StatusNotifierItem",
+    registration_id_ = g_dbus_connection_register_object(connection_, object_path_.c_str(),
                                                           iface_info, &vtable,
                                                           this,     // user_data
                                                           nullptr,  // user_data_free_func
@@ -264,52 +343,35 @@ class TrayIcon::Impl {
     g_dbus_node_info_unref(node_info);
 
     if (registration_id_ == 0) {
-      if (error) {
-        std::cerr << "[nativeapi] SNI: Object registration failed: " << error->message
-                  << std::endl;
-        g_error_free(error);
-      }
-      return false;
+      FailWithError("Object registration failed", error);
+      return;
     }
 
-    GDBusNodeInfo* menu_node_info =
-        g_dbus_node_info_new_for_xml(kDbusMenuIntrospectionXml, &error);
-    if (!menu_node_info) {
-      if (error) {
-        std::cerr << "[nativeapi] SNI: Bad dbusmenu introspection XML: " << error->message
-                  << std::endl;
-        g_error_free(error);
-      }
-      return false;
+    menu_exporter_ = std::make_unique<DbusMenuExporter>(connection_, menu_path_);
+    if (!menu_exporter_->Register()) {
+      Fail("dbusmenu object registration failed");
+      return;
     }
+    menu_exporter_->SetMenu(context_menu_);
 
-    GDBusInterfaceInfo* menu_iface_info =
-        g_dbus_node_info_lookup_interface(menu_node_info, "com.canonical.dbusmenu");
-
-    static const GDBusInterfaceVTable menu_vtable = {
-        &Impl::OnMenuMethodCall,
-        &Impl::OnMenuGetProperty,
-        nullptr  // no writable properties
-    };
-
-    menu_registration_id_ = g_dbus_connection_register_object(
-        connection_, "/StatusNotifierItem/Menu", menu_iface_info, &menu_vtable, this, nullptr,
-        &error);
-    g_dbus_node_info_unref(menu_node_info);
+    SniItemCallbacks callbacks;
+    callbacks.on_registered = [this] { OnRegistered(); };
+    callbacks.on_failed = [this](const std::string& message) { OnRegistrationFailed(message); };
+    sni_item_id_ = AddSniItem(connection_, object_path_, std::move(callbacks));
+  }
 
-    if (menu_registration_id_ == 0) {
-      if (error) {
-        std::cerr << "[nativeapi] SNI: dbusmenu object registration failed: " << error->message
-                  << std::endl;
-        g_error_free(error);
-      }
-      return false;
+  void OnRegistered() {
+    registered_ = true;
+    UpdateAnimationTimer();
+    if (owner_) {
+      owner_->Emit(TrayIconReadyEvent(id_));
     }
+  }
 
-    name_owner_id_ = g_bus_own_name_on_connection(connection_, service_name_.c_str(),
-                                                   G_BUS_NAME_OWNER_FLAGS_NONE, &Impl::OnNameAcquired,
-                                                   &Impl::OnNameLost, this, nullptr);
-    return true;
+  void OnRegistrationFailed(const std::string& message) {
+    registered_ = false;
+    UpdateAnimationTimer();
+    Fail(message);
   }
 
   void Cleanup() {
@@ -317,28 +379,50 @@ class TrayIcon::Impl {
     // haven't been dispatched yet will see a null owner and skip event emission.
     owner_ = nullptr;
 
-    if (name_owner_id_ != 0) {
-      g_bus_unown_name(name_owner_id_);
-      name_owner_id_ = 0;
+    if (bus_request_id_ != 0) {
+      CancelSessionBusRequest(bus_request_id_);
+      bus_request_id_ = 0;
+    }
+    if (flush_source_id_ != 0) {
+      g_source_remove(flush_source_id_);
+      flush_source_id_ = 0;
+    }
+    StopAnimation();
+    if (sni_item_id_ != 0) {
+      RemoveSniItem(sni_item_id_);
+      sni_item_id_ = 0;
     }
     if (connection_ && registration_id_ != 0) {
       g_dbus_connection_unregister_object(connection_, registration_id_);
       registration_id_ = 0;
     }
-    if (connection_ && menu_registration_id_ != 0) {
-      g_dbus_connection_unregister_object(connection_, menu_registration_id_);
-      menu_registration_id_ = 0;
-    }
+    menu_exporter_.reset();
     if (connection_) {
       g_object_unref(connection_);
       connection_ = nullptr;
     }
   }
 
+  void Fail(const std::string& message) {
+    std::cerr << "[nativeapi] SNI: " << message << std::endl;
+    if (owner_) {
+      owner_->Emit(TrayIconFailedEvent(id_, message));
+    }
+  }
+
+  void FailWithError(const char* context, GError* error) {
+    std::string message = context;
+    if (error) {
+      message += std::string(": ") + error->message;
+      g_error_free(error);
+    }
+    Fail(message);
+  }
+
   void EmitSignal(const char* signal_name, GVariant* params = nullptr) {
     if (!connection_ || registration_id_ == 0) return;
     GError* error = nullptr;
-    g_dbus_connection_emit_signal(connection_, nullptr, "/StatusNotifierItem",
+    g_dbus_connection_emit_signal(connection_, nullptr, object_path_.c_str(),
                                    "org.kde.StatusNotifierItem", signal_name, params, &error);
     if (error) g_error_free(error);
   }
@@ -347,68 +431,154 @@ class TrayIcon::Impl {
     return context_menu_ != nullptr && context_menu_trigger_ == ContextMenuTrigger::Clicked;
   }
 
-  void EmitMenuPropertiesChanged() {
-    if (!connection_ || registration_id_ == 0) return;
+  // ── Property values ───────────────────────────────────────────────────────
+
+  const char* StatusString() const { return visible_ ? "Active" : "Passive"; }
 
-    const bool expose_menu = ShouldExposeMenu();
+  const char* MenuObjectPath() const {
+    return ShouldExposeMenu() ? menu_path_.c_str() : "/";
+  }
+
+  GVariant* BuildToolTip() const {
+    // (sa(iiay)ss): iconName, iconPixmap[], title, description
+    const std::string tip = tooltip_.value_or(title_.value_or(""));
+    return g_variant_new("(s@a(iiay)ss)", "", EmptySniIconPixmaps(),
+                         title_.value_or("").c_str(), tip.c_str());
+  }
+
+  // ── Coalesced property updates ────────────────────────────────────────────
+
+  // Records that the given properties changed. All changes made before the
+  // main loop next goes idle are sent together by Flush().
+  void StageUpdate(unsigned int properties) {
+    pending_properties_ |= properties;
+    ++GetUpdateStats().staged_changes;
+    if (flush_source_id_ == 0 && registration_id_ != 0) {
+      flush_source_id_ = g_idle_add(&Impl::OnFlushIdle, this);
+    }
+  }
+
+  static gboolean OnFlushIdle(gpointer user_data) {
+    Impl* self = static_cast<Impl*>(user_data);
+    self->flush_source_id_ = 0;
+    self->Flush();
+    return G_SOURCE_REMOVE;
+  }
+
+  // Sends one PropertiesChanged carrying the new values, followed by one of
+  // each legacy New* signal for hosts that only listen to those. Animation
+  // frames only emit NewIcon: inlining the multi-size IconPixmap every tick
+  // would marshal tens of KB per frame, and hosts read it with Get anyway.
+  void Flush() {
+    const unsigned int pending = pending_properties_;
+    pending_properties_ = 0;
+    if (pending == 0 || !connection_ || registration_id_ == 0) return;
+
+    TrayIconUpdateStats& stats = GetUpdateStats();
+    ++stats.flushes;
 
     GVariantBuilder changed;
     GVariantBuilder invalidated;
     g_variant_builder_init(&changed, G_VARIANT_TYPE("a{sv}"));
     g_variant_builder_init(&invalidated, G_VARIANT_TYPE("as"));
-    g_variant_builder_add(&changed, "{sv}", "ItemIsMenu", g_variant_new_boolean(expose_menu));
-    g_variant_builder_add(&changed, "{sv}", "Menu",
-                          g_variant_new_object_path(expose_menu ? "/StatusNotifierItem/Menu"
-                                                                : "/"));
+    if (pending & kPendingIcon) {
+      g_variant_builder_add(&changed, "{sv}", "IconPixmap", icon_pixmaps_);
+    }
+    if (pending & kPendingTitle) {
+      g_variant_builder_add(&changed, "{sv}", "Title",
+                            g_variant_new_string(title_.value_or("").c_str()));
+    }
+    if (pending & kPendingToolTip) {
+      g_variant_builder_add(&changed, "{sv}", "ToolTip", BuildToolTip());
+    }
+    if (pending & kPendingStatus) {
+      g_variant_builder_add(&changed, "{sv}", "Status", g_variant_new_string(StatusString()));
+    }
+    if (pending & kPendingMenu) {
+      g_variant_builder_add(&changed, "{sv}", "ItemIsMenu",
+                            g_variant_new_boolean(ShouldExposeMenu()));
+      g_variant_builder_add(&changed, "{sv}", "Menu",
+                            g_variant_new_object_path(MenuObjectPath()));
+    }
+
+    if (pending & ~kPendingIconFrame) {
+      g_dbus_connection_emit_signal(
+          connection_, nullptr, object_path_.c_str(), "org.freedesktop.DBus.Properties",
+          "PropertiesChanged",
+          g_variant_new("(s@a{sv}@as)", "org.kde.StatusNotifierItem",
+                        g_variant_builder_end(&changed), g_variant_builder_end(&invalidated)),
+          nullptr);
+      ++stats.signals_emitted;
+    } else {
+      g_variant_builder_clear(&changed);
+      g_variant_builder_clear(&invalidated);
+    }
 
-    GError* error = nullptr;
-    g_dbus_connection_emit_signal(
-        connection_, nullptr, "/StatusNotifierItem", "org.freedesktop.DBus.Properties",
-        "PropertiesChanged",
-        g_variant_new("(s@a{sv}@as)", "org.kde.StatusNotifierItem",
-                      g_variant_builder_end(&changed), g_variant_builder_end(&invalidated)),
-        &error);
-    if (error) g_error_free(error);
+    if (pending & (kPendingIcon | kPendingIconFrame)) {
+      EmitSignal("NewIcon");
+      ++stats.signals_emitted;
+    }
+    if (pending & kPendingTitle) {
+      EmitSignal("NewTitle");
+      ++stats.signals_emitted;
+    }
+    if (pending & kPendingToolTip) {
+      EmitSignal("NewToolTip");
+      ++stats.signals_emitted;
+    }
+    if (pending & kPendingStatus) {
+      EmitSignal("NewStatus", g_variant_new("(s)", StatusString()));
+      ++stats.signals_emitted;
+    }
   }
 
-  // ── D-Bus name callbacks ──────────────────────────────────────────────────
+  // ── Icon animation ────────────────────────────────────────────────────────
 
-  static void OnNameAcquired(GDBusConnection* conn, const gchar* name, gpointer user_data) {
-    Impl* self = static_cast<Impl*>(user_data);
-    if (self) self->RegisterWithWatcher(conn, name);
+  // Runs the frame timer only while a panel can show the icon
+  void UpdateAnimationTimer() {
+    const bool should_run = !animation_pixmaps_.empty() && visible_ && registered_;
+    if (should_run && animation_source_id_ == 0) {
+      animation_source_id_ =
+          g_timeout_add(animation_interval_ms_, &Impl::OnAnimationTick, this);
+    } else if (!should_run && animation_source_id_ != 0) {
+      g_source_remove(animation_source_id_);
+      animation_source_id_ = 0;
+    }
   }
 
-  static void OnNameLost(GDBusConnection*, const gchar* name, gpointer) {
-    std::cerr << "[nativeapi] SNI: lost D-Bus name " << (name ? name : "(null)") << std::endl;
+  // Swaps in a precomputed frame; the flush then only emits NewIcon
+  void ShowAnimationFrame(size_t index) {
+    animation_frame_ = index;
+    image_ = animation_images_[index];
+    g_variant_unref(icon_pixmaps_);
+    icon_pixmaps_ = g_variant_ref(animation_pixmaps_[index]);
+    StageUpdate(kPendingIconFrame);
   }
 
-  // Try both KDE and Canonical watcher service names.
-  void RegisterWithWatcher(GDBusConnection* conn, const gchar* service_name) {
-    static const char* const kWatchers[] = {
-        "org.kde.StatusNotifierWatcher",
-        "com.canonical.StatusNotifierWatcher",
-        nullptr,
-    };
-    for (int i = 0; kWatchers[i]; ++i) {
-      GError* error = nullptr;
-      GVariant* reply = g_dbus_connection_call_sync(
-          conn, kWatchers[i], "/StatusNotifierWatcher", kWatchers[i],
-          "RegisterStatusNotifierItem", g_variant_new("(s)", service_name), nullptr,
-          G_DBUS_CALL_FLAGS_NONE, 2000, nullptr, &error);
-      if (reply) {
-        g_variant_unref(reply);
-        return;
-      }
-      if (error) g_error_free(error);
+  static gboolean OnAnimationTick(gpointer user_data) {
+    Impl* self = static_cast<Impl*>(user_data);
+    self->ShowAnimationFrame((self->animation_frame_ + 1) % self->animation_pixmaps_.size());
+    return G_SOURCE_CONTINUE;
+  }
+
+  // Drops the frames; the current one stays as the icon
+  void StopAnimation() {
+    if (animation_source_id_ != 0) {
+      g_source_remove(animation_source_id_);
+      animation_source_id_ = 0;
+    }
+    for (GVariant* pixmaps : animation_pixmaps_) {
+      g_variant_unref(pixmaps);
     }
-    std::cerr << "[nativeapi] SNI: no StatusNotifierWatcher found; tray icon may not appear"
-              << std::endl;
+    animation_pixmaps_.clear();
+    animation_images_.clear();
+    animation_frame_ = 0;
   }
 
   // ── D-Bus method-call handler ─────────────────────────────────────────────
 
   static void OnMethodCall(GDBusConnection*, const gchar*, const gchar*, const gchar*,
-                           const gchar* method_name, GVariant*,
+                           const gchar* method_name, GVariant* parameters,
                            GDBusMethodInvocation* invocation, gpointer user_data) {
     if (!user_data) {
       g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED,
@@ -416,11 +586,31 @@ class TrayIcon::Impl {
       return;
     }
 
-    if (g_strcmp0(method_name, "Activate") == 0 ||
-        g_strcmp0(method_name, "SecondaryActivate") == 0 ||
-        g_strcmp0(method_name, "ContextMenu") == 0 ||
-        g_strcmp0(method_name, "Scroll") == 0) {
+    Impl* self = static_cast<Impl*>(user_data);
+    if (g_strcmp0(method_name, "Activate") == 0 || g_strcmp0(method_name, "ContextMenu") == 0 ||
+        g_strcmp0(method_name, "SecondaryActivate") == 0) {
+      gint x = 0;
+      gint y = 0;
+      g_variant_get(parameters, "(ii)", &x, &y);
+      // Reply before dispatching so a slow listener does not stall the host
       g_dbus_method_invocation_return_value(invocation, nullptr);
+      const Point position{static_cast<double>(x), static_cast<double>(y)};
+      if (g_strcmp0(method_name, "Activate") == 0) {
+        self->OnActivate(position);
+      } else if (g_strcmp0(method_name, "ContextMenu") == 0) {
+        self->EmitEvent(TrayIconRightClickedEvent(self->id_, position));
+      }
+      // SecondaryActivate is a middle click, which TrayIcon has no event for
+    } else if (g_strcmp0(method_name, "Scroll") == 0) {
+      gint delta = 0;
+      const gchar* orientation = nullptr;
+      g_variant_get(parameters, "(i&s)", &delta, &orientation);
+      const TrayIconScrollOrientation scroll_orientation =
+          g_ascii_strcasecmp(orientation, "horizontal") == 0
+              ? TrayIconScrollOrientation::Horizontal
+              : TrayIconScrollOrientation::Vertical;
+      g_dbus_method_invocation_return_value(invocation, nullptr);
+      self->EmitEvent(TrayIconScrolledEvent(self->id_, delta, scroll_orientation));
     } else {
       g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR,
                                              G_DBUS_ERROR_UNKNOWN_METHOD,
@@ -428,6 +618,31 @@ class TrayIcon::Impl {
     }
   }
 
+  // Hosts only send Activate, so a second one within the double-click time
+  // at about the same spot is also reported as a double click.
+  void OnActivate(const Point& position) {
+    const gint64 now = g_get_monotonic_time();
+    const bool is_double_click =
+        last_activate_time_ != 0 && now - last_activate_time_ <= kDoubleClickTime &&
+        std::abs(position.x - last_activate_position_.x) <= kDoubleClickDistance &&
+        std::abs(position.y - last_activate_position_.y) <= kDoubleClickDistance;
+    // A third click starts a new pair instead of forming another double click
+    last_activate_time_ = is_double_click ? 0 : now;
+    last_activate_position_ = position;
+
+    EmitEvent(TrayIconClickedEvent(id_, position));
+    if (is_double_click) {
+      EmitEvent(TrayIconDoubleClickedEvent(id_, position));
+    }
+  }
+
+  // Method calls arrive on the main context, so events are emitted directly
+  void EmitEvent(const TrayIconEvent& event) {
+    if (owner_) {
+      owner_->Emit(event);
+    }
+  }
+
   // ── D-Bus property getter ─────────────────────────────────────────────────
 
   static GVariant* OnGetProperty(GDBusConnection*, const gchar*, const gchar*, const gchar*,
@@ -446,7 +661,7 @@ class TrayIcon::Impl {
       return g_variant_new_string(self->title_.value_or("").c_str());
 
     if (g_strcmp0(property_name, "Status") == 0)
-      return g_variant_new_string(self->visible_ ? "Active" : "Passive");
+      return g_variant_new_string(self->StatusString());
 
     if (g_strcmp0(property_name, "WindowId") == 0)
       return g_variant_new_uint32(0);
@@ -454,33 +669,23 @@ class TrayIcon::Impl {
     if (g_strcmp0(property_name, "IconName") == 0)
       return g_variant_new_string("");  // we use IconPixmap instead
 
-    if (g_strcmp0(property_name, "IconPixmap") == 0) {
-      // image_linux.cpp's GetNativeObjectInternal() returns GdkPixbuf* on Linux.
-      GdkPixbuf* pb =
-          self->image_ ? static_cast<GdkPixbuf*>(self->image_->GetNativeObject()) : nullptr;
-      return PixbufToSniIconPixmaps(pb);
-    }
+    if (g_strcmp0(property_name, "IconPixmap") == 0)
+      return g_variant_ref(self->icon_pixmaps_);
 
     if (g_strcmp0(property_name, "OverlayIconName") == 0) return g_variant_new_string("");
-    if (g_strcmp0(property_name, "OverlayIconPixmap") == 0) return PixbufToSniIconPixmaps(nullptr);
+    if (g_strcmp0(property_name, "OverlayIconPixmap") == 0) return EmptySniIconPixmaps();
     if (g_strcmp0(property_name, "AttentionIconName") == 0) return g_variant_new_string("");
     if (g_strcmp0(property_name, "AttentionIconPixmap") == 0)
-      return PixbufToSniIconPixmaps(nullptr);
+      return EmptySniIconPixmaps();
     if (g_strcmp0(property_name, "AttentionMovieName") == 0) return g_variant_new_string("");
 
-    if (g_strcmp0(property_name, "ToolTip") == 0) {
-      // (sa(iiay)ss): iconName, iconPixmap[], title, description
-      const std::string& tip = self->tooltip_.value_or(self->title_.value_or(""));
-      return g_variant_new("(s@a(iiay)ss)", "", PixbufToSniIconPixmaps(nullptr),
-                           self->title_.value_or("").c_str(), tip.c_str());
-    }
+    if (g_strcmp0(property_name, "ToolTip") == 0)
+      return self->BuildToolTip();
 
     if (g_strcmp0(property_name, "ItemIsMenu") == 0)
       return g_variant_new_boolean(self->ShouldExposeMenu());
-    if (g_strcmp0(property_name, "Menu") == 0) {
-      const bool expose_menu = self->ShouldExposeMenu();
-      return g_variant_new_object_path(expose_menu ? "/StatusNotifierItem/Menu" : "/");
-    }
+    if (g_strcmp0(property_name, "Menu") == 0)
+      return g_variant_new_object_path(self->MenuObjectPath());
 
     if (error) {
       *error = g_error_new(G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY,
@@ -488,327 +693,19 @@ class TrayIcon::Impl {
     }
     return nullptr;
   }
-
-  static std::string GtkMenuItemLabel(GtkWidget* item) {
-    if (!item || !GTK_IS_MENU_ITEM(item) || GTK_IS_SEPARATOR_MENU_ITEM(item)) {
-      return "";
-    }
-
-    const char* label = gtk_menu_item_get_label(GTK_MENU_ITEM(item));
-    if (label && label[0] != '\0') {
-      return label;
-    }
-
-    GtkWidget* child = gtk_bin_get_child(GTK_BIN(item));
-    if (!child) {
-      return "";
-    }
-
-    if (GTK_IS_LABEL(child)) {
-      label = gtk_label_get_text(GTK_LABEL(child));
-      return label ? label : "";
-    }
-
-    if (GTK_IS_CONTAINER(child)) {
-      GList* children = gtk_container_get_children(GTK_CONTAINER(child));
-      for (GList* iter = children; iter; iter = iter->next) {
-        GtkWidget* widget = GTK_WIDGET(iter->data);
-        if (GTK_IS_LABEL(widget)) {
-          label = gtk_label_get_text(GTK_LABEL(widget));
-          std::string result = label ? label : "";
-          g_list_free(children);
-          return result;
-        }
-      }
-      g_list_free(children);
-    }
-
-    return "";
-  }
-
-  int RegisterDbusMenuItem(GtkWidget* item) {
-    int id = static_cast<int>(reinterpret_cast<uintptr_t>(item) & 0x7fffffff);
-    if (id == 0) {
-      id = 1;
-    }
-    dbusmenu_items_[id] = item;
-    return id;
-  }
-
-  void AppendMenuItemProperties(GVariantBuilder* props, GtkWidget* item) {
-    const bool is_separator = item && GTK_IS_SEPARATOR_MENU_ITEM(item);
-    const bool enabled = item ? gtk_widget_get_sensitive(item) == TRUE : true;
-    const bool visible = true;
-
-    g_variant_builder_add(props, "{sv}", "enabled", g_variant_new_boolean(enabled));
-    g_variant_builder_add(props, "{sv}", "visible", g_variant_new_boolean(visible));
-
-    if (is_separator) {
-      g_variant_builder_add(props, "{sv}", "type", g_variant_new_string("separator"));
-      return;
-    }
-
-    std::string label = GtkMenuItemLabel(item);
-    if (!label.empty()) {
-      g_variant_builder_add(props, "{sv}", "label", g_variant_new_string(label.c_str()));
-    }
-
-    if (item && GTK_IS_CHECK_MENU_ITEM(item)) {
-      const bool is_radio = GTK_IS_RADIO_MENU_ITEM(item);
-      g_variant_builder_add(props, "{sv}", "toggle-type",
-                            g_variant_new_string(is_radio ? "radio" : "checkmark"));
-      g_variant_builder_add(
-          props, "{sv}", "toggle-state",
-          g_variant_new_int32(gtk_check_menu_item_get_active(GTK_CHECK_MENU_ITEM(item)) ? 1 : 0));
-    }
-
-    if (item && GTK_IS_MENU_ITEM(item) && gtk_menu_item_get_submenu(GTK_MENU_ITEM(item))) {
-      g_variant_builder_add(props, "{sv}", "children-display", g_variant_new_string("submenu"));
-    }
-  }
-
-  GVariant* BuildDbusMenuLayout(GtkWidget* menu, int item_id = 0) {
-    GVariantBuilder props;
-    GVariantBuilder children;
-    g_variant_builder_init(&props, G_VARIANT_TYPE("a{sv}"));
-    g_variant_builder_init(&children, G_VARIANT_TYPE("av"));
-
-    if (item_id != 0 && menu && GTK_IS_MENU_ITEM(menu)) {
-      AppendMenuItemProperties(&props, menu);
-      GtkWidget* submenu = gtk_menu_item_get_submenu(GTK_MENU_ITEM(menu));
-      if (submenu && GTK_IS_MENU_SHELL(submenu)) {
-        GList* items = gtk_container_get_children(GTK_CONTAINER(submenu));
-        for (GList* iter = items; iter; iter = iter->next) {
-          GtkWidget* child = GTK_WIDGET(iter->data);
-          int child_id = RegisterDbusMenuItem(child);
-          g_variant_builder_add(&children, "v", BuildDbusMenuLayout(child, child_id));
-        }
-        g_list_free(items);
-      }
-    } else if (menu && GTK_IS_MENU_SHELL(menu)) {
-      dbusmenu_items_.clear();
-      GList* items = gtk_container_get_children(GTK_CONTAINER(menu));
-      for (GList* iter = items; iter; iter = iter->next) {
-        GtkWidget* child = GTK_WIDGET(iter->data);
-        int child_id = RegisterDbusMenuItem(child);
-        g_variant_builder_add(&children, "v", BuildDbusMenuLayout(child, child_id));
-      }
-      g_list_free(items);
-    }
-
-    return g_variant_new("(i@a{sv}@av)", item_id, g_variant_builder_end(&props),
-                         g_variant_builder_end(&children));
-  }
-
-  GVariant* BuildDbusMenuProperties(int id) {
-    GVariantBuilder props;
-    g_variant_builder_init(&props, G_VARIANT_TYPE("a{sv}"));
-    auto it = dbusmenu_items_.find(id);
-    if (it != dbusmenu_items_.end()) {
-      AppendMenuItemProperties(&props, it->second);
-    }
-    return g_variant_new("(i@a{sv})", id, g_variant_builder_end(&props));
-  }
-
-  void ActivateDbusMenuItem(int id) {
-    auto it = dbusmenu_items_.find(id);
-    if (it == dbusmenu_items_.end() || !it->second || !GTK_IS_MENU_ITEM(it->second)) {
-      return;
-    }
-    gtk_menu_item_activate(GTK_MENU_ITEM(it->second));
-  }
-
-  static void OnMenuMethodCall(GDBusConnection*, const gchar*, const gchar*, const gchar*,
-                               const gchar* method_name, GVariant* parameters,
-                               GDBusMethodInvocation* invocation, gpointer user_data) {
-    Impl* self = static_cast<Impl*>(user_data);
-    if (!self) {
-      g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED,
-                                             "Internal error");
-      return;
-    }
-
-    if (g_strcmp0(method_name, "GetLayout") == 0) {
-      gint parent_id = 0;
-      if (parameters) {
-        gint recursion_depth = -1;
-        GVariantIter* property_names = nullptr;
-        g_variant_get(parameters, "(iias)", &parent_id, &recursion_depth, &property_names);
-        if (property_names) {
-          g_variant_iter_free(property_names);
-        }
-      }
-
-      GtkWidget* menu = self->context_menu_
-                            ? static_cast<GtkWidget*>(self->context_menu_->GetNativeObject())
-                            : nullptr;
-      if (parent_id != 0) {
-        auto it = self->dbusmenu_items_.find(parent_id);
-        menu = it != self->dbusmenu_items_.end() ? it->second : nullptr;
-      }
-      g_dbus_method_invocation_return_value(
-          invocation,
-          g_variant_new("(u@(ia{sv}av))", self->menu_revision_,
-                        self->BuildDbusMenuLayout(menu, parent_id)));
-      return;
-    }
-
-    if (g_strcmp0(method_name, "GetGroupProperties") == 0) {
-      GVariantIter* ids = nullptr;
-      GVariantIter* property_names = nullptr;
-      if (parameters) {
-        g_variant_get(parameters, "(aias)", &ids, &property_names);
-      }
-
-      GVariantBuilder result;
-      g_variant_builder_init(&result, G_VARIANT_TYPE("a(ia{sv})"));
-      if (ids) {
-        gint item_id = 0;
-        while (g_variant_iter_loop(ids, "i", &item_id)) {
-          g_variant_builder_add_value(&result, self->BuildDbusMenuProperties(item_id));
-        }
-        g_variant_iter_free(ids);
-      }
-      if (property_names) {
-        g_variant_iter_free(property_names);
-      }
-      g_dbus_method_invocation_return_value(invocation,
-                                             g_variant_new("(@a(ia{sv}))",
-                                                           g_variant_builder_end(&result)));
-      return;
-    }
-
-    if (g_strcmp0(method_name, "GetProperty") == 0) {
-      gint item_id = 0;
-      const gchar* name = nullptr;
-      if (parameters) {
-        g_variant_get(parameters, "(i&s)", &item_id, &name);
-      }
-
-      GVariantBuilder props;
-      g_variant_builder_init(&props, G_VARIANT_TYPE("a{sv}"));
-      auto it = self->dbusmenu_items_.find(item_id);
-      if (it != self->dbusmenu_items_.end()) {
-        self->AppendMenuItemProperties(&props, it->second);
-      }
-      GVariant* props_variant = g_variant_builder_end(&props);
-      GVariant* value = g_variant_lookup_value(props_variant, name ? name : "", nullptr);
-      g_variant_unref(props_variant);
-      g_dbus_method_invocation_return_value(
-          invocation,
-          g_variant_new("(@v)", value ? g_variant_new_variant(value)
-                                      : g_variant_new_variant(g_variant_new_string(""))));
-      if (value) {
-        g_variant_unref(value);
-      }
-      return;
-    }
-
-    if (g_strcmp0(method_name, "Event") == 0) {
-      gint item_id = 0;
-      const gchar* event_id = nullptr;
-      GVariant* data = nullptr;
-      guint timestamp = 0;
-      if (parameters) {
-        g_variant_get(parameters, "(i&svu)", &item_id, &event_id, &data, &timestamp);
-        if (data) {
-          g_variant_unref(data);
-        }
-      }
-      if (event_id && (g_strcmp0(event_id, "clicked") == 0 ||
-                       g_strcmp0(event_id, "activated") == 0)) {
-        self->ActivateDbusMenuItem(item_id);
-      }
-      g_dbus_method_invocation_return_value(invocation, nullptr);
-      return;
-    }
-
-    if (g_strcmp0(method_name, "EventGroup") == 0) {
-      GVariantIter* events = nullptr;
-      if (parameters) {
-        g_variant_get(parameters, "(a(isvu))", &events);
-      }
-      if (events) {
-        gint item_id = 0;
-        const gchar* event_id = nullptr;
-        GVariant* data = nullptr;
-        guint timestamp = 0;
-        while (g_variant_iter_loop(events, "(i&svu)", &item_id, &event_id, &data, &timestamp)) {
-          if (event_id && (g_strcmp0(event_id, "clicked") == 0 ||
-                           g_strcmp0(event_id, "activated") == 0)) {
-            self->ActivateDbusMenuItem(item_id);
-          }
-        }
-        g_variant_iter_free(events);
-      }
-
-      GVariantBuilder errors;
-      g_variant_builder_init(&errors, G_VARIANT_TYPE("ai"));
-      g_dbus_method_invocation_return_value(invocation,
-                                             g_variant_new("(@ai)",
-                                                           g_variant_builder_end(&errors)));
-      return;
-    }
-
-    if (g_strcmp0(method_name, "AboutToShow") == 0) {
-      g_dbus_method_invocation_return_value(invocation, g_variant_new("(b)", FALSE));
-      return;
-    }
-
-    if (g_strcmp0(method_name, "AboutToShowGroup") == 0) {
-      GVariantBuilder updates;
-      GVariantBuilder errors;
-      g_variant_builder_init(&updates, G_VARIANT_TYPE("ai"));
-      g_variant_builder_init(&errors, G_VARIANT_TYPE("ai"));
-      g_dbus_method_invocation_return_value(
-          invocation, g_variant_new("(@ai@ai)", g_variant_builder_end(&updates),
-                                    g_variant_builder_end(&errors)));
-      return;
-    }
-
-    g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
-                                           "Unknown dbusmenu method: %s", method_name);
-  }
-
-  static GVariant* OnMenuGetProperty(GDBusConnection*, const gchar*, const gchar*, const gchar*,
-                                     const gchar* property_name, GError** error,
-                                     gpointer user_data) {
-    if (g_strcmp0(property_name, "Version") == 0) return g_variant_new_uint32(3);
-    if (g_strcmp0(property_name, "TextDirection") == 0) return g_variant_new_string("ltr");
-    if (g_strcmp0(property_name, "Status") == 0) return g_variant_new_string("normal");
-    if (g_strcmp0(property_name, "IconThemePath") == 0) {
-      GVariantBuilder paths;
-      g_variant_builder_init(&paths, G_VARIANT_TYPE("as"));
-      return g_variant_builder_end(&paths);
-    }
-
-    if (error) {
-      *error = g_error_new(G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_PROPERTY,
-                           "Unknown dbusmenu property: %s", property_name);
-    }
-    return nullptr;
-  }
 };
 
 // ── TrayIcon public interface ─────────────────────────────────────────────────
 
 TrayIcon::TrayIcon() : pimpl_(std::make_unique<Impl>(this)) {
-  if (pimpl_->Init()) {
-    pimpl_->visible_ = true;
-  } else {
-    std::cerr << "[nativeapi] TrayIcon: D-Bus initialisation failed; icon will not appear"
-              << std::endl;
-  }
+  pimpl_->visible_ = true;
+  pimpl_->Init();
 }
 
 TrayIcon::TrayIcon(void* /*tray*/) : pimpl_(std::make_unique<Impl>(this)) {
   // For API compatibility; create a fresh SNI tray icon ignoring the raw pointer.
-  if (pimpl_->Init()) {
-    pimpl_->visible_ = true;
-  } else {
-    std::cerr << "[nativeapi] TrayIcon: D-Bus initialisation failed; icon will not appear"
-              << std::endl;
-  }
+  pimpl_->visible_ = true;
+  pimpl_->Init();
 }
 
 TrayIcon::~TrayIcon() {
@@ -821,17 +718,49 @@ TrayIconId TrayIcon::GetId() {
 }
 
 void TrayIcon::SetIcon(std::shared_ptr<Image> image) {
+  pimpl_->StopAnimation();
   pimpl_->image_ = image;
-  pimpl_->EmitSignal("NewIcon");
+  g_variant_unref(pimpl_->icon_pixmaps_);
+  pimpl_->icon_pixmaps_ = BuildSniIconPixmaps(image);
+  pimpl_->StageUpdate(kPendingIcon);
 }
 
 std::shared_ptr<Image> TrayIcon::GetIcon() const {
   return pimpl_->image_;
 }
 
+bool TrayIcon::SetIconAnimation(const std::vector<std::shared_ptr<Image>>& frames,
+                                std::chrono::milliseconds frame_interval) {
+  pimpl_->StopAnimation();
+  for (const auto& frame : frames) {
+    if (frame) {
+      pimpl_->animation_images_.push_back(frame);
+      pimpl_->animation_pixmaps_.push_back(BuildSniIconPixmaps(frame));
+    }
+  }
+  if (pimpl_->animation_images_.empty()) {
+    return false;
+  }
+
+  pimpl_->animation_interval_ms_ =
+      static_cast<guint>(std::max<std::chrono::milliseconds::rep>(1, frame_interval.count()));
+  pimpl_->ShowAnimationFrame(0);
+  pimpl_->UpdateAnimationTimer();
+  return true;
+}
+
+void TrayIcon::StopIconAnimation() {
+  pimpl_->StopAnimation();
+}
+
+bool TrayIcon::IsIconAnimating() const {
+  return !pimpl_->animation_images_.empty();
+}
+
 void TrayIcon::SetTitle(std::optional<std::string> title) {
   pimpl_->title_ = title;
-  pimpl_->EmitSignal("NewTitle");
+  // The tooltip falls back to the title
+  pimpl_->StageUpdate(kPendingTitle | kPendingToolTip);
 }
 
 std::optional<std::string> TrayIcon::GetTitle() {
@@ -840,7 +769,7 @@ std::optional<std::string> TrayIcon::GetTitle() {
 
 void TrayIcon::SetTooltip(std::optional<std::string> tooltip) {
   pimpl_->tooltip_ = tooltip;
-  pimpl_->EmitSignal("NewToolTip");
+  pimpl_->StageUpdate(kPendingToolTip);
 }
 
 std::optional<std::string> TrayIcon::GetTooltip() {
@@ -849,15 +778,11 @@ std::optional<std::string> TrayIcon::GetTooltip() {
 
 void TrayIcon::SetContextMenu(std::shared_ptr<Menu> menu) {
   pimpl_->context_menu_ = menu;
-  ++pimpl_->menu_revision_;
-  pimpl_->EmitSignal("NewStatus",
-                     g_variant_new("(s)", pimpl_->visible_ ? "Active" : "Passive"));
-  pimpl_->EmitMenuPropertiesChanged();
-  if (pimpl_->connection_ && pimpl_->menu_registration_id_ != 0) {
-    g_dbus_connection_emit_signal(pimpl_->connection_, nullptr, "/StatusNotifierItem/Menu",
-                                  "com.canonical.dbusmenu", "LayoutUpdated",
-                                  g_variant_new("(ui)", pimpl_->menu_revision_, 0), nullptr);
+  if (pimpl_->menu_exporter_) {
+    pimpl_->menu_exporter_->SetMenu(menu);
   }
+  // NewStatus nudges hosts that only re-read the menu on status changes
+  pimpl_->StageUpdate(kPendingMenu | kPendingStatus);
 }
 
 std::shared_ptr<Menu> TrayIcon::GetContextMenu() {
@@ -871,8 +796,8 @@ Rectangle TrayIcon::GetBounds() {
 
 bool TrayIcon::SetVisible(bool visible) {
   pimpl_->visible_ = visible;
-  const char* status = visible ? "Active" : "Passive";
-  pimpl_->EmitSignal("NewStatus", g_variant_new("(s)", status));
+  pimpl_->StageUpdate(kPendingStatus);
+  pimpl_->UpdateAnimationTimer();
   return true;
 }
 
@@ -890,9 +815,7 @@ bool TrayIcon::CloseContextMenu() {
 
 void TrayIcon::SetContextMenuTrigger(ContextMenuTrigger trigger) {
   pimpl_->context_menu_trigger_ = trigger;
-  pimpl_->EmitSignal("NewStatus",
-                     g_variant_new("(s)", pimpl_->visible_ ? "Active" : "Passive"));
-  pimpl_->EmitMenuPropertiesChanged();
+  pimpl_->StageUpdate(kPendingMenu | kPendingStatus);
 }
 
 ContextMenuTrigger TrayIcon::GetContextMenuTrigger() {
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nativeapi {
+
+/**
+ * @brief Process-wide counters of StatusNotifierItem property updates.
+ *
+ * Setters such as TrayIcon::SetIcon only stage a change; staged changes are
+ * flushed once per main-loop iteration as a single PropertiesChanged signal
+ * plus at most one of each legacy New* signal. Comparing the counters shows
+ * how well bursts of updates are coalesced.
+ */
+struct TrayIconUpdateStats {
+  // Setter calls that staged a property change
+  uint64_t staged_changes = 0;
+
+  // Flushes that sent signals
+  uint64_t flushes = 0;
+
+  // D-Bus signals sent by flushes (PropertiesChanged and New*)
+  uint64_t signals_emitted = 0;
+
+  // Staged changes per flush; 1.0 means nothing was coalesced
+  double CoalescingRatio() const {
+    return flushes == 0 ? 0.0 : static_cast<double>(staged_changes) / flushes;
+  }
+};
+
+// Returns a snapshot of the counters; main thread only
+TrayIconUpdateStats GetTrayIconUpdateStats();
+
+// Resets the counters to zero; main thread only
+void ResetTrayIconUpdateStats();
+
+}  // namespace nativeapi
@@ -4,6 +4,7 @@
 
 #include "../../tray_icon.h"
 #include "../../tray_manager.h"
+#include "session_bus_linux.h"
 
 namespace nativeapi {
 
@@ -21,18 +22,9 @@ TrayManager::~TrayManager() {
 }
 
 bool TrayManager::IsSupported() {
-  // Cache the result: session bus availability does not change during runtime.
-  static bool checked = false;
-  static bool supported = false;
-  if (!checked) {
-    GDBusConnection* conn = g_bus_get_sync(G_BUS_TYPE_SESSION, nullptr, nullptr);
-    if (conn) {
-      g_object_unref(conn);
-      supported = true;
-    }
-    checked = true;
-  }
-  return supported;
+  // Only checks that a session bus is configured; connecting happens
+  // asynchronously when the first tray icon is created.
+  return HasSessionBusAddress();
 }
 
 std::shared_ptr<TrayIcon> TrayManager::Get(TrayIconId id) {
@@ -1,45 +1,177 @@
 #import <Cocoa/Cocoa.h>
 #import <Foundation/Foundation.h>
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "../../foundation/base64.h"
 #include "../../foundation/geometry.h"
+#include "../../foundation/image_header.h"
 #include "../../image.h"
 
 namespace nativeapi {
 
-// macOS-specific implementation of Image class
+// Format name for files whose contents were not recognized by the header probe
+static std::string FormatFromExtension(NSString* filePath) {
+  NSString* extension = [[filePath pathExtension] lowercaseString];
+  if ([extension isEqualToString:@"png"]) {
+    return "PNG";
+  } else if ([extension isEqualToString:@"jpg"] || [extension isEqualToString:@"jpeg"]) {
+    return "JPEG";
+  } else if ([extension isEqualToString:@"gif"]) {
+    return "GIF";
+  } else if ([extension isEqualToString:@"tiff"] || [extension isEqualToString:@"tif"]) {
+    return "TIFF";
+  } else if ([extension isEqualToString:@"bmp"]) {
+    return "BMP";
+  } else if ([extension isEqualToString:@"ico"]) {
+    return "ICO";
+  } else if ([extension isEqualToString:@"pdf"]) {
+    return "PDF";
+  }
+  return "Unknown";
+}
+
+// Draws |cgImage| into a premultiplied RGBA context and converts the result
+// to tightly packed, straight-alpha pixels in the requested channel order.
+static bool CopyCGImagePixels(CGImageRef cgImage,
+                              std::vector<uint8_t>& pixels,
+                              int& width,
+                              int& height,
+                              ImagePixelFormat format) {
+  if (!cgImage) {
+    return false;
+  }
+  width = static_cast<int>(CGImageGetWidth(cgImage));
+  height = static_cast<int>(CGImageGetHeight(cgImage));
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  pixels.assign(row_bytes * height, 0);
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef context =
+      CGBitmapContextCreate(pixels.data(), width, height, 8, row_bytes, colorSpace,
+                            kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big);
+  CGColorSpaceRelease(colorSpace);
+  if (!context) {
+    return false;
+  }
+  CGContextSetBlendMode(context, kCGBlendModeCopy);
+  CGContextDrawImage(context, CGRectMake(0, 0, width, height), cgImage);
+  CGContextRelease(context);
+
+  const bool swap = format == ImagePixelFormat::BGRA32;
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    uint8_t* p = &pixels[i];
+    const uint8_t a = p[3];
+    if (a != 0 && a != 255) {
+      p[0] = static_cast<uint8_t>(std::min(255, (p[0] * 255 + a / 2) / a));
+      p[1] = static_cast<uint8_t>(std::min(255, (p[1] * 255 + a / 2) / a));
+      p[2] = static_cast<uint8_t>(std::min(255, (p[2] * 255 + a / 2) / a));
+    }
+    if (swap) {
+      std::swap(p[0], p[2]);
+    }
+  }
+  return true;
+}
+
+// macOS-specific implementation of Image class.
+//
+// When the header probe yields the dimensions, creating the NSImage is
+// deferred until it is first needed; until then the image only keeps its
+// source (file path or encoded bytes).
 class Image::Impl {
  public:
   NSImage* ns_image_;
   std::string source_;
+  NSData* encoded_;
   Size size_;
   std::string format_;
+  mutable std::mutex decode_mutex_;
 
-  Impl() : ns_image_(nil), size_({0, 0}), format_("Unknown") {}
+  Impl() : ns_image_(nil), encoded_(nil), size_({0, 0}), format_("Unknown") {}
 
   ~Impl() {}
 
-  Impl(const Impl& other)
-      : ns_image_(nil), source_(other.source_), size_(other.size_), format_(other.format_) {
-    if (other.ns_image_) {
-      ns_image_ = [other.ns_image_ copy];
-    }
+  // The source is locked because EnsureDecoded() may be swapping its
+  // encoded bytes for an NSImage on a worker thread
+  Impl(const Impl& other) : Impl() {
+    std::lock_guard<std::mutex> lock(other.decode_mutex_);
+    CopyFrom(other);
   }
 
   Impl& operator=(const Impl& other) {
     if (this != &other) {
-      ns_image_ = nil;
-      source_ = other.source_;
-      size_ = other.size_;
-      format_ = other.format_;
-      if (other.ns_image_) {
-        ns_image_ = [other.ns_image_ copy];
-      }
+      std::scoped_lock lock(decode_mutex_, other.decode_mutex_);
+      CopyFrom(other);
     }
     return *this;
   }
+
+  // Copies |other|'s state into this one; both decode locks must be held
+  void CopyFrom(const Impl& other) {
+    ns_image_ = other.ns_image_ ? [other.ns_image_ copy] : nil;
+    source_ = other.source_;
+    encoded_ = other.encoded_;
+    size_ = other.size_;
+    format_ = other.format_;
+  }
+
+  // Returns the NSImage, creating it from the deferred source on first use
+  NSImage* EnsureDecoded() {
+    std::lock_guard<std::mutex> lock(decode_mutex_);
+    if (ns_image_) {
+      return ns_image_;
+    }
+    if (encoded_) {
+      ns_image_ = [[NSImage alloc] initWithData:encoded_];
+      if (ns_image_) {
+        encoded_ = nil;
+      }
+    } else if (!source_.empty()) {
+      NSString* nsFilePath = [NSString stringWithUTF8String:source_.c_str()];
+      ns_image_ = [[NSImage alloc] initWithContentsOfFile:nsFilePath];
+    }
+    // An ICO header only names its largest entry, which the decoder may
+    // not pick; the decoded image decides the size
+    if (ns_image_ && format_ == "ICO") {
+      NSSize nsSize = [ns_image_ size];
+      size_ = {static_cast<double>(nsSize.width), static_cast<double>(nsSize.height)};
+    }
+    return ns_image_;
+  }
+
+  // Creates an image from encoded bytes, deferring the decode when the
+  // header already provides the dimensions. |data| is retained, not copied.
+  static std::shared_ptr<Image> FromEncoded(NSData* data) {
+    ImageHeaderInfo header =
+        ImageHeader::Probe(static_cast<const uint8_t*>([data bytes]), [data length]);
+    auto image = std::shared_ptr<Image>(new Image());
+    Impl* impl = image->pimpl_.get();
+    impl->format_ = header.format.empty() ? "Unknown" : header.format;
+    impl->encoded_ = data;
+
+    if (header.HasSize()) {
+      impl->size_ = {static_cast<double>(header.width), static_cast<double>(header.height)};
+      return image;
+    }
+
+    NSImage* nsImage = impl->EnsureDecoded();
+    if (!nsImage) {
+      return nullptr;
+    }
+    NSSize nsSize = [nsImage size];
+    impl->size_ = {static_cast<double>(nsSize.width), static_cast<double>(nsSize.height)};
+    return image;
+  }
 };
 
 Image::Image() : pimpl_(std::make_unique<Impl>()) {}
@@ -51,83 +183,119 @@ Image::Image(const Image& other) : pimpl_(std::make_unique<Impl>(*other.pimpl_))
 Image::Image(Image&& other) noexcept : pimpl_(std::move(other.pimpl_)) {}
 
 std::shared_ptr<Image> Image::FromFile(const std::string& file_path) {
+  // Only the header is read here; the pixels are decoded on first use.
+  ImageHeaderInfo header = ImageHeader::ProbeFile(file_path);
   auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->source_ = file_path;
+  image->pimpl_->format_ =
+      header.format.empty()
+          ? FormatFromExtension([NSString stringWithUTF8String:file_path.c_str()])
+          : header.format;
+
+  if (header.HasSize()) {
+    image->pimpl_->size_ = {static_cast<double>(header.width),
+                            static_cast<double>(header.height)};
+    return image;
+  }
 
-  NSString* nsFilePath = [NSString stringWithUTF8String:file_path.c_str()];
-  NSImage* nsImage = [[NSImage alloc] initWithContentsOfFile:nsFilePath];
-
-  if (nsImage) {
-    image->pimpl_->ns_image_ = nsImage;
-    image->pimpl_->source_ = file_path;
-
-    // Get actual image size
-    NSSize nsSize = [nsImage size];
-    image->pimpl_->size_ = {static_cast<double>(nsSize.width), static_cast<double>(nsSize.height)};
-
-    // Determine format from file extension
-    NSString* extension = [[nsFilePath pathExtension] lowercaseString];
-    if ([extension isEqualToString:@"png"]) {
-      image->pimpl_->format_ = "PNG";
-    } else if ([extension isEqualToString:@"jpg"] || [extension isEqualToString:@"jpeg"]) {
-      image->pimpl_->format_ = "JPEG";
-    } else if ([extension isEqualToString:@"gif"]) {
-      image->pimpl_->format_ = "GIF";
-    } else if ([extension isEqualToString:@"tiff"] || [extension isEqualToString:@"tif"]) {
-      image->pimpl_->format_ = "TIFF";
-    } else if ([extension isEqualToString:@"bmp"]) {
-      image->pimpl_->format_ = "BMP";
-    } else if ([extension isEqualToString:@"ico"]) {
-      image->pimpl_->format_ = "ICO";
-    } else if ([extension isEqualToString:@"pdf"]) {
-      image->pimpl_->format_ = "PDF";
-    } else {
-      image->pimpl_->format_ = "Unknown";
-    }
-  } else {
+  // Formats without header dimensions (PDF, SVG, ...) are decoded eagerly
+  NSImage* nsImage = image->pimpl_->EnsureDecoded();
+  if (!nsImage) {
     return nullptr;
   }
 
+  // Get actual image size
+  NSSize nsSize = [nsImage size];
+  image->pimpl_->size_ = {static_cast<double>(nsSize.width), static_cast<double>(nsSize.height)};
+
   return image;
 }
 
-std::shared_ptr<Image> Image::FromBase64(const std::string& base64_data) {
-  auto image = std::shared_ptr<Image>(new Image());
-
-  // Remove data URI prefix if present
-  std::string cleanBase64 = base64_data;
-  size_t commaPos = base64_data.find(',');
-  if (commaPos != std::string::npos) {
-    cleanBase64 = base64_data.substr(commaPos + 1);
+std::shared_ptr<Image> Image::FromBytes(const uint8_t* data, size_t size) {
+  if (!data || size == 0) {
+    return nullptr;
   }
+  return Impl::FromEncoded([NSData dataWithBytes:data length:size]);
+}
 
-  // Decode base64
-  NSString* base64String = [NSString stringWithUTF8String:cleanBase64.c_str()];
-  NSData* imageData = [[NSData alloc] initWithBase64EncodedString:base64String options:0];
+std::shared_ptr<Image> Image::FromBase64(std::string_view base64_data) {
+  // Skip the data URI prefix in place and decode straight into the buffer
+  // that backs the NSData, avoiding intermediate NSString/std::string copies.
+  std::string_view payload = Base64::StripDataUriPrefix(base64_data);
+  NSMutableData* imageData = [NSMutableData dataWithLength:Base64::MaxDecodedLength(payload.size())];
+  size_t decodedSize = 0;
+  if (!Base64::Decode(payload, static_cast<uint8_t*>([imageData mutableBytes]), [imageData length],
+                      &decodedSize) ||
+      decodedSize == 0) {
+    return nullptr;
+  }
+  [imageData setLength:decodedSize];
 
-  if (imageData) {
-    NSImage* nsImage = [[NSImage alloc] initWithData:imageData];
-    if (nsImage) {
-      image->pimpl_->ns_image_ = nsImage;
-      image->pimpl_->source_ = base64_data;
+  return Impl::FromEncoded(imageData);
+}
 
-      // Get actual image size
-      NSSize nsSize = [nsImage size];
-      image->pimpl_->size_ = {static_cast<double>(nsSize.width),
-                              static_cast<double>(nsSize.height)};
+std::shared_ptr<Image> Image::FromRawData(const uint8_t* pixels,
+                                          int width,
+                                          int height,
+                                          ImagePixelFormat format) {
+  if (!pixels || width <= 0 || height <= 0) {
+    return nullptr;
+  }
 
-      // Default assumption for base64 images
-      image->pimpl_->format_ = "PNG";
+  NSBitmapImageRep* rep =
+      [[NSBitmapImageRep alloc] initWithBitmapDataPlanes:NULL
+                                              pixelsWide:width
+                                              pixelsHigh:height
+                                           bitsPerSample:8
+                                         samplesPerPixel:4
+                                                hasAlpha:YES
+                                                isPlanar:NO
+                                          colorSpaceName:NSDeviceRGBColorSpace
+                                            bitmapFormat:NSBitmapFormatAlphaNonpremultiplied
+                                             bytesPerRow:width * 4
+                                            bitsPerPixel:32];
+  if (!rep) {
+    return nullptr;
+  }
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = pixels + y * row_bytes;
+    uint8_t* out = [rep bitmapData] + y * row_bytes;
+    if (format == ImagePixelFormat::RGBA32) {
+      memcpy(out, in, row_bytes);
     } else {
-      return nullptr;
+      for (int x = 0; x < width; ++x) {
+        out[x * 4 + 0] = in[x * 4 + 2];
+        out[x * 4 + 1] = in[x * 4 + 1];
+        out[x * 4 + 2] = in[x * 4 + 0];
+        out[x * 4 + 3] = in[x * 4 + 3];
+      }
     }
-  } else {
-    return nullptr;
   }
 
+  NSImage* nsImage = [[NSImage alloc] initWithSize:NSMakeSize(width, height)];
+  [nsImage addRepresentation:rep];
+
+  auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->ns_image_ = nsImage;
+  image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
   return image;
 }
 
+bool Image::ToRawData(std::vector<uint8_t>& pixels,
+                      int& width,
+                      int& height,
+                      ImagePixelFormat format) const {
+  NSImage* nsImage = pimpl_->EnsureDecoded();
+  if (!nsImage) {
+    return false;
+  }
+  CGImageRef cgImage = [nsImage CGImageForProposedRect:NULL context:nil hints:nil];
+  return CopyCGImagePixels(cgImage, pixels, width, height, format);
+}
+
 Size Image::GetSize() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
   return pimpl_->size_;
 }
 
@@ -135,76 +303,72 @@ std::string Image::GetFormat() const {
   return pimpl_->format_;
 }
 
-std::string Image::ToBase64() const {
-  if (!pimpl_->ns_image_) {
-    return "";
-  }
-
-  // Convert NSImage to PNG data
-  NSBitmapImageRep* bitmapRep =
-      [[NSBitmapImageRep alloc] initWithData:[pimpl_->ns_image_ TIFFRepresentation]];
-  if (!bitmapRep) {
-    return "";
-  }
-
-  NSData* pngData = [bitmapRep representationUsingType:NSBitmapImageFileTypePNG properties:@{}];
-
-  if (!pngData) {
-    return "";
+bool Image::EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
+  {
+    // Still-encoded PNG data can be passed through without decoding
+    std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+    if (options.format == ImageEncodeFormat::PNG && !pimpl_->ns_image_ && pimpl_->encoded_ &&
+        pimpl_->format_ == "PNG") {
+      return sink(static_cast<const uint8_t*>([pimpl_->encoded_ bytes]),
+                  [pimpl_->encoded_ length]);
+    }
   }
 
-  // Convert to base64
-  NSString* base64String = [pngData base64EncodedStringWithOptions:0];
-  std::string result = "data:image/png;base64," + std::string([base64String UTF8String]);
-
-  return result;
-}
-
-bool Image::SaveToFile(const std::string& file_path) const {
-  if (!pimpl_->ns_image_) {
+  NSImage* nsImage = pimpl_->EnsureDecoded();
+  if (!nsImage) {
     return false;
   }
 
-  NSString* nsFilePath = [NSString stringWithUTF8String:file_path.c_str()];
-  NSString* extension = [[nsFilePath pathExtension] lowercaseString];
-
   NSBitmapImageFileType fileType;
   NSDictionary* properties = @{};
-
-  if ([extension isEqualToString:@"png"]) {
-    fileType = NSBitmapImageFileTypePNG;
-  } else if ([extension isEqualToString:@"jpg"] || [extension isEqualToString:@"jpeg"]) {
-    fileType = NSBitmapImageFileTypeJPEG;
-    properties = @{NSImageCompressionFactor : @0.9};
-  } else if ([extension isEqualToString:@"gif"]) {
-    fileType = NSBitmapImageFileTypeGIF;
-  } else if ([extension isEqualToString:@"tiff"] || [extension isEqualToString:@"tif"]) {
-    fileType = NSBitmapImageFileTypeTIFF;
-  } else if ([extension isEqualToString:@"bmp"]) {
-    fileType = NSBitmapImageFileTypeBMP;
-  } else {
-    // Default to PNG
-    fileType = NSBitmapImageFileTypePNG;
+  switch (options.format) {
+    case ImageEncodeFormat::PNG:
+      fileType = NSBitmapImageFileTypePNG;
+      break;
+    case ImageEncodeFormat::JPEG:
+      fileType = NSBitmapImageFileTypeJPEG;
+      properties = @{NSImageCompressionFactor : @(std::clamp(options.quality, 1, 100) / 100.0)};
+      break;
+    case ImageEncodeFormat::BMP:
+      fileType = NSBitmapImageFileTypeBMP;
+      break;
+    case ImageEncodeFormat::GIF:
+      fileType = NSBitmapImageFileTypeGIF;
+      break;
+    case ImageEncodeFormat::TIFF:
+      fileType = NSBitmapImageFileTypeTIFF;
+      break;
+    case ImageEncodeFormat::ICO:
+      // AppKit has no icon writer
+      return false;
+    default:
+      return false;
   }
 
   NSBitmapImageRep* bitmapRep =
-      [[NSBitmapImageRep alloc] initWithData:[pimpl_->ns_image_ TIFFRepresentation]];
+      [[NSBitmapImageRep alloc] initWithData:[nsImage TIFFRepresentation]];
   if (!bitmapRep) {
     return false;
   }
 
   NSData* imageData = [bitmapRep representationUsingType:fileType properties:properties];
-
   if (!imageData) {
     return false;
   }
-
-  BOOL success = [imageData writeToFile:nsFilePath atomically:YES];
-  return success == YES;
+  return sink(static_cast<const uint8_t*>([imageData bytes]), [imageData length]);
 }
 
 void* Image::GetNativeObjectInternal() const {
-  return (__bridge void*)pimpl_->ns_image_;
+  return (__bridge void*)pimpl_->EnsureDecoded();
+}
+
+bool Image::IsDecoded() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+  return pimpl_->ns_image_ != nullptr;
+}
+
+bool Image::EnsureDecoded() const {
+  return pimpl_->EnsureDecoded() != nullptr;
 }
 
 }  // namespace nativeapi
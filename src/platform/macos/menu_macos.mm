@@ -1,6 +1,7 @@
 #include <iostream>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include "../../foundation/id_allocator.h"
 #include "../../image.h"
@@ -375,6 +376,7 @@ void MenuItem::SetAccelerator(const std::optional<KeyboardAccelerator>& accelera
     [pimpl_->ns_menu_item_ setKeyEquivalent:@""];
     [pimpl_->ns_menu_item_ setKeyEquivalentModifierMask:0];
   }
+  LinkAccelerator(GetAccelerator());
 }
 
 KeyboardAccelerator MenuItem::GetAccelerator() const {
@@ -416,28 +418,9 @@ void MenuItem::SetState(MenuItemState state) {
     }
     [pimpl_->ns_menu_item_ setState:ns_state];
 
-    // Handle radio button group logic - uncheck siblings in the same NSMenu
-    if (pimpl_->type_ == MenuItemType::Radio && state == MenuItemState::Checked &&
-        pimpl_->radio_group_ >= 0) {
-      NSMenu* parent_menu = [pimpl_->ns_menu_item_ menu];
-      if (parent_menu) {
-        for (NSMenuItem* sibling in [parent_menu itemArray]) {
-          if (sibling == pimpl_->ns_menu_item_)
-            continue;
-          NSObject* target_obj = [sibling target];
-          if ([target_obj isKindOfClass:[NSMenuItemTarget class]]) {
-            // Get the MenuItemId from the associated object
-            NSNumber* sibling_id_obj = objc_getAssociatedObject(sibling, kMenuItemIdKey);
-            if (sibling_id_obj) {
-              // Find the corresponding MenuItem in the parent menu's items
-              // This is a simplified approach - in practice, you might need to store
-              // a reference to the parent menu or use a different strategy
-              [sibling setState:NSControlStateValueOff];
-            }
-          }
-        }
-      }
-    }
+    // Unchecks the group's previously checked item, rather than every
+    // sibling NSMenuItem
+    SyncRadioGroup();
   }
 }
 
@@ -446,7 +429,9 @@ MenuItemState MenuItem::GetState() const {
 }
 
 void MenuItem::SetRadioGroup(int group_id) {
+  ForgetRadioGroup();
   pimpl_->radio_group_ = group_id;
+  SyncRadioGroup();
 }
 
 int MenuItem::GetRadioGroup() const {
@@ -456,6 +441,7 @@ int MenuItem::GetRadioGroup() const {
 void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
   try {
     pimpl_->submenu_ = submenu;
+    LinkSubmenu(submenu);
     if (submenu) {
       NSMenu* ns_submenu = (__bridge NSMenu*)submenu->GetNativeObject();
       if (ns_submenu) {
@@ -476,6 +462,8 @@ void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
         MenuItem* self = this;
         pimpl_->submenu_opened_listener_id_ = submenu->AddListener<MenuOpenedEvent>(
             [self, menu_item_id](const MenuOpenedEvent& event) {
+              // menuWillOpen: runs before the submenu is drawn
+              self->PrepareSubmenu();
               self->Emit<MenuItemSubmenuOpenedEvent>(menu_item_id);
             });
 
@@ -517,6 +505,7 @@ class Menu::Impl {
   NSMenu* ns_menu_;
   NSMenuDelegateImpl* delegate_;
   std::vector<std::shared_ptr<MenuItem>> items_;
+  size_t virtual_window_ = 0;  // Only reported back; NSMenu builds item views itself
 
   Impl(MenuId id, NSMenu* menu)
       : id_(id), ns_menu_(menu), delegate_([[NSMenuDelegateImpl alloc] init]) {
@@ -583,6 +572,7 @@ void Menu::AddItem(std::shared_ptr<MenuItem> item) {
 
   pimpl_->items_.push_back(item);
   [pimpl_->ns_menu_ addItem:(__bridge NSMenuItem*)item->GetNativeObject()];
+  LinkItem(item);
 }
 
 void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
@@ -596,6 +586,7 @@ void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
 
   pimpl_->items_.insert(pimpl_->items_.begin() + index, item);
   [pimpl_->ns_menu_ insertItem:(__bridge NSMenuItem*)item->GetNativeObject() atIndex:index];
+  LinkItem(item);
 }
 
 bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
@@ -605,6 +596,7 @@ bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
   auto it = std::find(pimpl_->items_.begin(), pimpl_->items_.end(), item);
   if (it != pimpl_->items_.end()) {
     [pimpl_->ns_menu_ removeItem:(__bridge NSMenuItem*)item->GetNativeObject()];
+    UnlinkItem(*item);
     pimpl_->items_.erase(it);
     return true;
   }
@@ -615,6 +607,7 @@ bool Menu::RemoveItemById(MenuItemId item_id) {
   for (auto it = pimpl_->items_.begin(); it != pimpl_->items_.end(); ++it) {
     if ((*it)->GetId() == item_id) {
       [pimpl_->ns_menu_ removeItem:(__bridge NSMenuItem*)(*it)->GetNativeObject()];
+      UnlinkItem(**it);
       pimpl_->items_.erase(it);
       return true;
     }
@@ -628,12 +621,16 @@ bool Menu::RemoveItemAt(size_t index) {
 
   auto item = pimpl_->items_[index];
   [pimpl_->ns_menu_ removeItem:(__bridge NSMenuItem*)item->GetNativeObject()];
+  UnlinkItem(*item);
   pimpl_->items_.erase(pimpl_->items_.begin() + index);
   return true;
 }
 
 void Menu::Clear() {
   [pimpl_->ns_menu_ removeAllItems];
+  for (const auto& item : pimpl_->items_) {
+    UnlinkItem(*item);
+  }
   pimpl_->items_.clear();
 }
 
@@ -670,6 +667,14 @@ std::vector<std::shared_ptr<MenuItem>> Menu::GetAllItems() const {
   return pimpl_->items_;
 }
 
+void Menu::SetVirtualWindow(size_t visible_items) {
+  pimpl_->virtual_window_ = visible_items;
+}
+
+size_t Menu::GetVirtualWindow() const {
+  return pimpl_->virtual_window_;
+}
+
 bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
   double x = 0, y = 0;
 
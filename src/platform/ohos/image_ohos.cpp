@@ -39,11 +39,32 @@ std::shared_ptr<Image> Image::FromFile(const std::string& file_path) {
   return nullptr;
 }
 
-std::shared_ptr<Image> Image::FromBase64(const std::string& base64_data) {
+std::shared_ptr<Image> Image::FromBytes(const uint8_t* data, size_t size) {
   // Return nullptr - not implemented on OpenHarmony yet
   return nullptr;
 }
 
+std::shared_ptr<Image> Image::FromBase64(std::string_view base64_data) {
+  // Return nullptr - not implemented on OpenHarmony yet
+  return nullptr;
+}
+
+std::shared_ptr<Image> Image::FromRawData(const uint8_t* pixels,
+                                          int width,
+                                          int height,
+                                          ImagePixelFormat format) {
+  // FromRawData is not implemented on OpenHarmony yet
+  return nullptr;
+}
+
+bool Image::ToRawData(std::vector<uint8_t>& pixels,
+                      int& width,
+                      int& height,
+                      ImagePixelFormat format) const {
+  // ToRawData is not implemented on OpenHarmony yet
+  return false;
+}
+
 Size Image::GetSize() const {
   return pimpl_->size_;
 }
@@ -52,12 +73,7 @@ std::string Image::GetFormat() const {
   return pimpl_->format_;
 }
 
-std::string Image::ToBase64() const {
-  // Return empty string - not implemented on OpenHarmony yet
-  return "";
-}
-
-bool Image::SaveToFile(const std::string& file_path) const {
+bool Image::EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
   // Return false - not implemented on OpenHarmony yet
   return false;
 }
@@ -66,4 +82,13 @@ void* Image::GetNativeObjectInternal() const {
   return pimpl_->native_image_;
 }
 
+// Images are not decoded lazily on OpenHarmony
+bool Image::IsDecoded() const {
+  return pimpl_->native_image_ != nullptr;
+}
+
+bool Image::EnsureDecoded() const {
+  return pimpl_->native_image_ != nullptr;
+}
+
 }  // namespace nativeapi
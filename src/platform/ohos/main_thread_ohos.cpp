@@ -0,0 +1,36 @@
+#ifdef __OHOS__
+#include <hilog/log.h>
+#endif
+#include <iostream>
+#include <utility>
+#include "../../main_thread.h"
+
+#ifdef __OHOS__
+#undef LOG_DOMAIN
+#undef LOG_TAG
+#define LOG_DOMAIN 0xD001700
+#define LOG_TAG "NativeApi"
+#define NATIVEAPI_LOG_ERROR(message) OH_LOG_ERROR(LOG_APP, "%{public}s", message)
+#else
+#define NATIVEAPI_LOG_ERROR(message) std::cerr << "[ERROR] " << message << std::endl
+#endif
+
+namespace nativeapi {
+
+void PostToMainThread(std::function<void()> task) {
+  if (!task) {
+    return;
+  }
+  // The main thread's event loop belongs to the ArkTS runtime, which this
+  // library has no handle to. Running the task on the calling thread would
+  // break the guarantee callers rely on, so it is dropped instead.
+  NATIVEAPI_LOG_ERROR("PostToMainThread is not supported on OpenHarmony, task dropped");
+}
+
+void PrepareMainThreadDispatcher() {}
+
+bool IsMainThreadDispatchSupported() {
+  return false;
+}
+
+}  // namespace nativeapi
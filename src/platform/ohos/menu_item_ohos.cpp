@@ -4,6 +4,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include "../../foundation/id_allocator.h"
 #include "../../menu.h"
 
 #ifdef __OHOS__
@@ -16,28 +17,46 @@
 
 namespace nativeapi {
 
+// There are no native menus on OpenHarmony yet. The item's properties are kept
+// here, so the platform-independent parts of the menu API (Apply, snapshots,
+// radio groups, accelerator dispatch) work as on the desktop platforms.
 class MenuItem::Impl {
  public:
-  Impl() = default;
+  Impl(MenuItemId id, MenuItemType type) : id_(id), type_(type) {}
 
+  MenuItemId id_;
+  MenuItemType type_;
   void* native_item_ = nullptr;
-  std::string label_;
-  MenuItemType type_ = MenuItemType::Normal;
+  std::optional<std::string> label_;
+  std::shared_ptr<Image> image_;
+  std::optional<std::string> tooltip_;
+  KeyboardAccelerator accelerator_{"", ModifierKey::None};
+  bool enabled_ = true;
+  MenuItemState state_ = MenuItemState::Unchecked;
+  int radio_group_ = -1;
+  std::shared_ptr<Menu> submenu_;
 };
 
-MenuItem::MenuItem(const std::string& label, MenuItemType type) : pimpl_(std::make_unique<Impl>()) {
-  pimpl_->label_ = label;
-  pimpl_->type_ = type;
+MenuItem::MenuItem(const std::string& label, MenuItemType type)
+    : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<MenuItem>(), type)) {
+  if (!label.empty()) {
+    pimpl_->label_ = label;
+  }
 }
 
-MenuItem::MenuItem(void* native_item) : pimpl_(std::make_unique<Impl>()) {
+MenuItem::MenuItem(void* native_item)
+    : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<MenuItem>(), MenuItemType::Normal)) {
   pimpl_->native_item_ = native_item;
 }
 
 MenuItem::~MenuItem() = default;
 
+void* MenuItem::GetNativeObjectInternal() const {
+  return pimpl_->native_item_;
+}
+
 MenuItemId MenuItem::GetId() const {
-  return IdAllocator::kInvalidId;
+  return pimpl_->id_;
 }
 
 MenuItemType MenuItem::GetType() const {
@@ -45,71 +64,78 @@ MenuItemType MenuItem::GetType() const {
 }
 
 void MenuItem::SetLabel(const std::optional<std::string>& label) {
-  pimpl_->label_ = label.has_value() ? label.value() : "";
+  pimpl_->label_ = label;
 }
 
 std::optional<std::string> MenuItem::GetLabel() const {
-  return pimpl_->label_.empty() ? std::nullopt : std::make_optional(pimpl_->label_);
+  return pimpl_->label_;
 }
 
 void MenuItem::SetIcon(std::shared_ptr<Image> image) {
-  // Not implemented on OpenHarmony yet
+  pimpl_->image_ = image;
 }
 
 std::shared_ptr<Image> MenuItem::GetIcon() const {
-  return nullptr;
+  return pimpl_->image_;
 }
 
 void MenuItem::SetTooltip(const std::optional<std::string>& tooltip) {
-  // Not implemented on OpenHarmony yet
+  pimpl_->tooltip_ = tooltip;
 }
 
 std::optional<std::string> MenuItem::GetTooltip() const {
-  return std::nullopt;
+  return pimpl_->tooltip_;
 }
 
 void MenuItem::SetAccelerator(const std::optional<KeyboardAccelerator>& accelerator) {
-  // Not implemented on OpenHarmony yet
+  pimpl_->accelerator_ = accelerator.value_or(KeyboardAccelerator("", ModifierKey::None));
+  LinkAccelerator(pimpl_->accelerator_);
 }
 
 KeyboardAccelerator MenuItem::GetAccelerator() const {
-  return KeyboardAccelerator("");
+  return pimpl_->accelerator_;
 }
 
 void MenuItem::SetEnabled(bool enabled) {
-  // Not implemented on OpenHarmony yet
+  pimpl_->enabled_ = enabled;
 }
 
 bool MenuItem::IsEnabled() const {
-  return true;
+  return pimpl_->enabled_;
 }
 
 void MenuItem::SetState(MenuItemState state) {
-  // Not implemented on OpenHarmony yet
+  if (pimpl_->type_ != MenuItemType::Checkbox && pimpl_->type_ != MenuItemType::Radio) {
+    return;
+  }
+  if (pimpl_->type_ == MenuItemType::Radio && state == MenuItemState::Mixed) {
+    return;
+  }
+  pimpl_->state_ = state;
+  SyncRadioGroup();
 }
 
 MenuItemState MenuItem::GetState() const {
-  return MenuItemState::Unchecked;
+  return pimpl_->state_;
 }
 
 void MenuItem::SetRadioGroup(int group_id) {
-  // Not implemented on OpenHarmony yet
+  ForgetRadioGroup();
+  pimpl_->radio_group_ = group_id;
+  SyncRadioGroup();
 }
 
 int MenuItem::GetRadioGroup() const {
-  return -1;
+  return pimpl_->radio_group_;
 }
 
 void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
-  // Not implemented on OpenHarmony yet
+  pimpl_->submenu_ = submenu;
+  LinkSubmenu(submenu);
 }
 
 std::shared_ptr<Menu> MenuItem::GetSubmenu() const {
-  return nullptr;
-}
-
-void* MenuItem::GetNativeObjectInternal() const {
-  return pimpl_->native_item_;
+  return pimpl_->submenu_;
 }
 
 }  // namespace nativeapi
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "../../application.h"
+#include "../../main_thread.h"
 #include "../../menu.h"
 #include "../../window_manager.h"
 
@@ -28,6 +29,9 @@ class Application::Impl {
   }
 
   int Run() {
+    // The thread running the message loop is the main thread
+    PrepareMainThreadDispatcher();
+
     MSG msg = {};
     int exit_code = 0;
 
@@ -66,6 +70,7 @@ class Application::Impl {
     window->Focus();
 
     // Start the message loop
+    PrepareMainThreadDispatcher();
     MSG msg = {};
     int exit_code = 0;
 
@@ -1,10 +1,16 @@
 #include <comdef.h>
 #include <gdiplus.h>
 #include <windows.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "../../foundation/base64.h"
 #include "../../foundation/geometry.h"
+#include "../../foundation/image_header.h"
 #include "../../image.h"
 
 #pragma comment(lib, "gdiplus.lib")
@@ -51,13 +57,86 @@ static int GetEncoderClsid(const WCHAR* format, CLSID* pClsid) {
   return -1;
 }
 
-// Windows-specific implementation of Image class using GDI+
+// Decodes |size| encoded bytes at the start of |hMem| into a bitmap. Takes
+// ownership of |hMem|.
+static Gdiplus::Bitmap* BitmapFromHGlobal(HGLOBAL hMem, size_t size) {
+  IStream* pStream = nullptr;
+  if (CreateStreamOnHGlobal(hMem, TRUE, &pStream) != S_OK) {
+    GlobalFree(hMem);
+    return nullptr;
+  }
+  // The block may be larger than the payload; limit the stream to the data
+  ULARGE_INTEGER stream_size;
+  stream_size.QuadPart = size;
+  pStream->SetSize(stream_size);
+
+  Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromStream(pStream);
+  pStream->Release();
+
+  if (bitmap && bitmap->GetLastStatus() != Gdiplus::Ok) {
+    delete bitmap;
+    return nullptr;
+  }
+  return bitmap;
+}
+
+// Decodes encoded image bytes into a bitmap
+static Gdiplus::Bitmap* DecodeBitmap(const uint8_t* data, size_t size) {
+  HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, size);
+  if (!hMem) {
+    return nullptr;
+  }
+  void* pMem = GlobalLock(hMem);
+  if (!pMem) {
+    GlobalFree(hMem);
+    return nullptr;
+  }
+  memcpy(pMem, data, size);
+  GlobalUnlock(hMem);
+  return BitmapFromHGlobal(hMem, size);
+}
+
+// Format name for files whose contents were not recognized by the header probe
+static std::string FormatFromExtension(const std::string& file_path) {
+  size_t dotPos = file_path.find_last_of('.');
+  if (dotPos == std::string::npos) {
+    return "Unknown";
+  }
+  std::string extension = file_path.substr(dotPos + 1);
+  // Convert to lowercase
+  for (auto& c : extension) {
+    c = std::tolower(c);
+  }
+
+  if (extension == "png") {
+    return "PNG";
+  } else if (extension == "jpg" || extension == "jpeg") {
+    return "JPEG";
+  } else if (extension == "gif") {
+    return "GIF";
+  } else if (extension == "bmp") {
+    return "BMP";
+  } else if (extension == "tiff" || extension == "tif") {
+    return "TIFF";
+  } else if (extension == "ico") {
+    return "ICO";
+  }
+  return "Unknown";
+}
+
+// Windows-specific implementation of Image class using GDI+.
+//
+// When the header probe yields the dimensions, pixel decoding is deferred
+// until the bitmap is first needed; until then the image only keeps its
+// source (file path or encoded bytes).
 class Image::Impl {
  public:
   Gdiplus::Bitmap* bitmap_;
   std::string source_;
+  std::vector<uint8_t> encoded_;
   Size size_;
   std::string format_;
+  mutable std::mutex decode_mutex_;
 
   Impl() : bitmap_(nullptr), size_({0, 0}), format_("Unknown") {}
 
@@ -67,30 +146,89 @@ class Image::Impl {
     }
   }
 
-  Impl(const Impl& other)
-      : bitmap_(nullptr), source_(other.source_), size_(other.size_), format_(other.format_) {
-    if (other.bitmap_) {
-      bitmap_ = other.bitmap_->Clone(0, 0, other.bitmap_->GetWidth(), other.bitmap_->GetHeight(),
-                                     other.bitmap_->GetPixelFormat());
-    }
+  // The source is locked because EnsureDecoded() may be swapping its
+  // encoded bytes for pixels on a worker thread
+  Impl(const Impl& other) : Impl() {
+    std::lock_guard<std::mutex> lock(other.decode_mutex_);
+    CopyFrom(other);
   }
 
   Impl& operator=(const Impl& other) {
     if (this != &other) {
+      std::scoped_lock lock(decode_mutex_, other.decode_mutex_);
       if (bitmap_) {
         delete bitmap_;
       }
       bitmap_ = nullptr;
-      source_ = other.source_;
-      size_ = other.size_;
-      format_ = other.format_;
-      if (other.bitmap_) {
-        bitmap_ = other.bitmap_->Clone(0, 0, other.bitmap_->GetWidth(), other.bitmap_->GetHeight(),
-                                       other.bitmap_->GetPixelFormat());
-      }
+      CopyFrom(other);
     }
     return *this;
   }
+
+  // Copies |other|'s state into this one, which holds no bitmap; both
+  // decode locks must be held
+  void CopyFrom(const Impl& other) {
+    source_ = other.source_;
+    encoded_ = other.encoded_;
+    size_ = other.size_;
+    format_ = other.format_;
+    if (other.bitmap_) {
+      bitmap_ = other.bitmap_->Clone(0, 0, other.bitmap_->GetWidth(), other.bitmap_->GetHeight(),
+                                     other.bitmap_->GetPixelFormat());
+    }
+  }
+
+  // Returns the decoded bitmap, decoding the deferred source on first use
+  Gdiplus::Bitmap* EnsureDecoded() {
+    std::lock_guard<std::mutex> lock(decode_mutex_);
+    if (bitmap_) {
+      return bitmap_;
+    }
+    if (!encoded_.empty()) {
+      bitmap_ = DecodeBitmap(encoded_.data(), encoded_.size());
+      if (bitmap_) {
+        // The pixels are authoritative from now on
+        std::vector<uint8_t>().swap(encoded_);
+      }
+    } else if (!source_.empty()) {
+      std::wstring wFilePath = StringToWString(source_);
+      Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromFile(wFilePath.c_str());
+      if (bitmap && bitmap->GetLastStatus() != Gdiplus::Ok) {
+        delete bitmap;
+        bitmap = nullptr;
+      }
+      bitmap_ = bitmap;
+    }
+    // An ICO header only names its largest entry, which the decoder may
+    // not pick; the decoded image decides the size
+    if (bitmap_ && format_ == "ICO") {
+      size_ = {static_cast<double>(bitmap_->GetWidth()), static_cast<double>(bitmap_->GetHeight())};
+    }
+    return bitmap_;
+  }
+
+  // Creates an image from encoded bytes, deferring the decode when the
+  // header already provides the dimensions.
+  static std::shared_ptr<Image> FromEncoded(std::vector<uint8_t> data) {
+    ImageHeaderInfo header = ImageHeader::Probe(data.data(), data.size());
+    auto image = std::shared_ptr<Image>(new Image());
+    Impl* impl = image->pimpl_.get();
+    impl->format_ = header.format.empty() ? "Unknown" : header.format;
+
+    if (header.HasSize()) {
+      impl->size_ = {static_cast<double>(header.width), static_cast<double>(header.height)};
+      impl->encoded_ = std::move(data);
+      return image;
+    }
+
+    impl->bitmap_ = DecodeBitmap(data.data(), data.size());
+    if (!impl->bitmap_) {
+      return nullptr;
+    }
+    impl->size_ = {static_cast<double>(impl->bitmap_->GetWidth()),
+                   static_cast<double>(impl->bitmap_->GetHeight())};
+    return image;
+  }
 };
 
 // Static GDI+ initialization
@@ -117,276 +255,247 @@ Image::Image(Image&& other) noexcept : pimpl_(std::move(other.pimpl_)) {}
 
 std::shared_ptr<Image> Image::FromFile(const std::string& file_path) {
   EnsureGdiplusInitialized();
-  auto image = std::shared_ptr<Image>(new Image());
 
-  std::wstring wFilePath = StringToWString(file_path);
-  Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromFile(wFilePath.c_str());
-
-  if (bitmap && bitmap->GetLastStatus() == Gdiplus::Ok) {
-    image->pimpl_->bitmap_ = bitmap;
-    image->pimpl_->source_ = file_path;
-
-    // Get actual image size
-    UINT width = bitmap->GetWidth();
-    UINT height = bitmap->GetHeight();
-    image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
-
-    // Determine format from file extension
-    size_t dotPos = file_path.find_last_of('.');
-    if (dotPos != std::string::npos) {
-      std::string extension = file_path.substr(dotPos + 1);
-      // Convert to lowercase
-      for (auto& c : extension) {
-        c = std::tolower(c);
-      }
+  // Only the header is read here; the pixels are decoded on first use.
+  ImageHeaderInfo header = ImageHeader::ProbeFile(file_path);
+  auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->source_ = file_path;
+  image->pimpl_->format_ =
+      header.format.empty() ? FormatFromExtension(file_path) : header.format;
+
+  if (header.HasSize()) {
+    image->pimpl_->size_ = {static_cast<double>(header.width),
+                            static_cast<double>(header.height)};
+    return image;
+  }
 
-      if (extension == "png") {
-        image->pimpl_->format_ = "PNG";
-      } else if (extension == "jpg" || extension == "jpeg") {
-        image->pimpl_->format_ = "JPEG";
-      } else if (extension == "gif") {
-        image->pimpl_->format_ = "GIF";
-      } else if (extension == "bmp") {
-        image->pimpl_->format_ = "BMP";
-      } else if (extension == "tiff" || extension == "tif") {
-        image->pimpl_->format_ = "TIFF";
-      } else if (extension == "ico") {
-        image->pimpl_->format_ = "ICO";
-      } else {
-        image->pimpl_->format_ = "Unknown";
-      }
-    }
-  } else {
-    if (bitmap) {
-      delete bitmap;
-    }
+  // Formats without header dimensions are decoded eagerly
+  Gdiplus::Bitmap* bitmap = image->pimpl_->EnsureDecoded();
+  if (!bitmap) {
     return nullptr;
   }
 
+  // Get actual image size
+  UINT width = bitmap->GetWidth();
+  UINT height = bitmap->GetHeight();
+  image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
+
   return image;
 }
 
-// Helper function to decode base64
-static std::vector<unsigned char> DecodeBase64(const std::string& base64_data) {
-  std::vector<unsigned char> result;
-
-  // Calculate the expected output size
-  DWORD dwOutLen = 0;
-  if (!CryptStringToBinaryA(base64_data.c_str(), 0, CRYPT_STRING_BASE64, NULL, &dwOutLen, NULL,
-                            NULL)) {
-    return result;
-  }
-
-  result.resize(dwOutLen);
-  if (!CryptStringToBinaryA(base64_data.c_str(), 0, CRYPT_STRING_BASE64, result.data(), &dwOutLen,
-                            NULL, NULL)) {
-    result.clear();
+std::shared_ptr<Image> Image::FromBytes(const uint8_t* data, size_t size) {
+  EnsureGdiplusInitialized();
+  if (!data || size == 0) {
+    return nullptr;
   }
-
-  return result;
+  return Impl::FromEncoded(std::vector<uint8_t>(data, data + size));
 }
 
-std::shared_ptr<Image> Image::FromBase64(const std::string& base64_data) {
+std::shared_ptr<Image> Image::FromBase64(std::string_view base64_data) {
   EnsureGdiplusInitialized();
-  auto image = std::shared_ptr<Image>(new Image());
 
-  // Remove data URI prefix if present
-  std::string cleanBase64 = base64_data;
-  size_t commaPos = base64_data.find(',');
-  if (commaPos != std::string::npos) {
-    cleanBase64 = base64_data.substr(commaPos + 1);
-  }
-
-  // Decode base64
-  std::vector<unsigned char> imageData = DecodeBase64(cleanBase64);
-
-  if (!imageData.empty()) {
-    // Create IStream from memory
-    HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, imageData.size());
-    if (hMem) {
-      void* pMem = GlobalLock(hMem);
-      if (pMem) {
-        memcpy(pMem, imageData.data(), imageData.size());
-        GlobalUnlock(hMem);
-
-        IStream* pStream = nullptr;
-        if (CreateStreamOnHGlobal(hMem, TRUE, &pStream) == S_OK) {
-          Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromStream(pStream);
-          pStream->Release();
-
-          if (bitmap && bitmap->GetLastStatus() == Gdiplus::Ok) {
-            image->pimpl_->bitmap_ = bitmap;
-            image->pimpl_->source_ = base64_data;
-
-            // Get actual image size
-            UINT width = bitmap->GetWidth();
-            UINT height = bitmap->GetHeight();
-            image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
-
-            // Default assumption for base64 images
-            image->pimpl_->format_ = "PNG";
-          } else {
-            if (bitmap) {
-              delete bitmap;
-            }
-            return nullptr;
-          }
-        } else {
-          GlobalFree(hMem);
-          return nullptr;
-        }
-      } else {
-        GlobalFree(hMem);
-        return nullptr;
-      }
-    } else {
-      return nullptr;
-    }
-  } else {
+  // Decode straight into the buffer the image keeps; the data URI prefix is
+  // skipped in place rather than copied away.
+  std::string_view payload = Base64::StripDataUriPrefix(base64_data);
+  std::vector<uint8_t> image_data;
+  if (!Base64::Decode(payload, image_data) || image_data.empty()) {
     return nullptr;
   }
-
-  return image;
+  return Impl::FromEncoded(std::move(image_data));
 }
 
-Size Image::GetSize() const {
-  return pimpl_->size_;
-}
-
-std::string Image::GetFormat() const {
-  return pimpl_->format_;
-}
-
-// Helper function to encode to base64
-static std::string EncodeBase64(const unsigned char* data, size_t length) {
-  DWORD dwOutLen = 0;
-  DWORD dwLength = static_cast<DWORD>(length);
-  if (!CryptBinaryToStringA((BYTE*)data, dwLength, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, NULL,
-                            &dwOutLen)) {
-    return "";
+std::shared_ptr<Image> Image::FromRawData(const uint8_t* pixels,
+                                          int width,
+                                          int height,
+                                          ImagePixelFormat format) {
+  EnsureGdiplusInitialized();
+  if (!pixels || width <= 0 || height <= 0) {
+    return nullptr;
   }
 
-  std::string result(dwOutLen, '\0');
-  if (!CryptBinaryToStringA((BYTE*)data, dwLength, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF,
-                            &result[0], &dwOutLen)) {
-    return "";
+  auto* bitmap = new Gdiplus::Bitmap(width, height, PixelFormat32bppARGB);
+  if (bitmap->GetLastStatus() != Gdiplus::Ok) {
+    delete bitmap;
+    return nullptr;
   }
 
-  // Remove trailing null characters
-  result.resize(dwOutLen - 1);
-  return result;
-}
-
-std::string Image::ToBase64() const {
-  if (!pimpl_->bitmap_) {
-    return "";
+  // PixelFormat32bppARGB is stored as non-premultiplied B, G, R, A bytes
+  Gdiplus::Rect rect(0, 0, width, height);
+  Gdiplus::BitmapData data;
+  if (bitmap->LockBits(&rect, Gdiplus::ImageLockModeWrite, PixelFormat32bppARGB, &data) !=
+      Gdiplus::Ok) {
+    delete bitmap;
+    return nullptr;
   }
-
-  // Create IStream to save to memory
-  IStream* pStream = nullptr;
-  if (CreateStreamOnHGlobal(NULL, TRUE, &pStream) != S_OK) {
-    return "";
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = pixels + y * row_bytes;
+    uint8_t* out = static_cast<uint8_t*>(data.Scan0) + static_cast<ptrdiff_t>(y) * data.Stride;
+    if (format == ImagePixelFormat::BGRA32) {
+      memcpy(out, in, row_bytes);
+    } else {
+      for (int x = 0; x < width; ++x) {
+        out[x * 4 + 0] = in[x * 4 + 2];
+        out[x * 4 + 1] = in[x * 4 + 1];
+        out[x * 4 + 2] = in[x * 4 + 0];
+        out[x * 4 + 3] = in[x * 4 + 3];
+      }
+    }
   }
+  bitmap->UnlockBits(&data);
 
-  // Get PNG encoder
-  CLSID pngClsid;
-  if (GetEncoderClsid(L"image/png", &pngClsid) < 0) {
-    pStream->Release();
-    return "";
+  auto image = std::shared_ptr<Image>(new Image());
+  image->pimpl_->bitmap_ = bitmap;
+  image->pimpl_->size_ = {static_cast<double>(width), static_cast<double>(height)};
+  return image;
+}
+
+bool Image::ToRawData(std::vector<uint8_t>& pixels,
+                      int& width,
+                      int& height,
+                      ImagePixelFormat format) const {
+  Gdiplus::Bitmap* bitmap = pimpl_->EnsureDecoded();
+  if (!bitmap) {
+    return false;
   }
 
-  // Save to stream
-  Gdiplus::Status status = pimpl_->bitmap_->Save(pStream, &pngClsid, NULL);
-  if (status != Gdiplus::Ok) {
-    pStream->Release();
-    return "";
+  width = static_cast<int>(bitmap->GetWidth());
+  height = static_cast<int>(bitmap->GetHeight());
+  Gdiplus::Rect rect(0, 0, width, height);
+  Gdiplus::BitmapData data;
+  if (bitmap->LockBits(&rect, Gdiplus::ImageLockModeRead, PixelFormat32bppARGB, &data) !=
+      Gdiplus::Ok) {
+    return false;
   }
 
-  // Get stream size
-  STATSTG statstg;
-  if (pStream->Stat(&statstg, STATFLAG_DEFAULT) != S_OK) {
-    pStream->Release();
-    return "";
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  pixels.resize(row_bytes * height);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in =
+        static_cast<const uint8_t*>(data.Scan0) + static_cast<ptrdiff_t>(y) * data.Stride;
+    uint8_t* out = pixels.data() + y * row_bytes;
+    if (format == ImagePixelFormat::BGRA32) {
+      memcpy(out, in, row_bytes);
+    } else {
+      for (int x = 0; x < width; ++x) {
+        out[x * 4 + 0] = in[x * 4 + 2];
+        out[x * 4 + 1] = in[x * 4 + 1];
+        out[x * 4 + 2] = in[x * 4 + 0];
+        out[x * 4 + 3] = in[x * 4 + 3];
+      }
+    }
   }
+  bitmap->UnlockBits(&data);
+  return true;
+}
 
-  // Read stream data
-  LARGE_INTEGER li = {0};
-  pStream->Seek(li, STREAM_SEEK_SET, NULL);
+Size Image::GetSize() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+  return pimpl_->size_;
+}
 
-  std::vector<unsigned char> buffer(statstg.cbSize.LowPart);
-  ULONG bytesRead = 0;
-  pStream->Read(buffer.data(), statstg.cbSize.LowPart, &bytesRead);
-  pStream->Release();
+std::string Image::GetFormat() const {
+  return pimpl_->format_;
+}
 
-  if (bytesRead == 0) {
-    return "";
+bool Image::EncodeNative(const ImageEncodeSink& sink, const ImageEncodeOptions& options) const {
+  {
+    // Still-encoded PNG data can be passed through without decoding
+    std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+    if (options.format == ImageEncodeFormat::PNG && !pimpl_->bitmap_ &&
+        !pimpl_->encoded_.empty() && pimpl_->format_ == "PNG") {
+      return sink(pimpl_->encoded_.data(), pimpl_->encoded_.size());
+    }
   }
 
-  // Convert to base64
-  std::string base64String = EncodeBase64(buffer.data(), bytesRead);
-  return "data:image/png;base64," + base64String;
-}
-
-bool Image::SaveToFile(const std::string& file_path) const {
-  if (!pimpl_->bitmap_) {
+  Gdiplus::Bitmap* bitmap = pimpl_->EnsureDecoded();
+  if (!bitmap) {
     return false;
   }
 
-  // Determine file type from extension
-  size_t dotPos = file_path.find_last_of('.');
-  std::wstring mimeType = L"image/png";  // default
-
-  if (dotPos != std::string::npos) {
-    std::string extension = file_path.substr(dotPos + 1);
-    // Convert to lowercase
-    for (auto& c : extension) {
-      c = std::tolower(c);
-    }
-
-    if (extension == "jpg" || extension == "jpeg") {
-      mimeType = L"image/jpeg";
-    } else if (extension == "png") {
+  const WCHAR* mimeType = nullptr;
+  switch (options.format) {
+    case ImageEncodeFormat::PNG:
       mimeType = L"image/png";
-    } else if (extension == "bmp") {
+      break;
+    case ImageEncodeFormat::JPEG:
+      mimeType = L"image/jpeg";
+      break;
+    case ImageEncodeFormat::BMP:
       mimeType = L"image/bmp";
-    } else if (extension == "gif") {
+      break;
+    case ImageEncodeFormat::GIF:
       mimeType = L"image/gif";
-    } else if (extension == "tiff" || extension == "tif") {
+      break;
+    case ImageEncodeFormat::TIFF:
       mimeType = L"image/tiff";
-    }
+      break;
+    case ImageEncodeFormat::ICO:
+      // GDI+ has no icon encoder
+      return false;
+    default:
+      return false;
   }
 
-  // Get encoder CLSID
   CLSID encoderClsid;
-  if (GetEncoderClsid(mimeType.c_str(), &encoderClsid) < 0) {
+  if (GetEncoderClsid(mimeType, &encoderClsid) < 0) {
     return false;
   }
 
-  // Convert file path to wide string
-  std::wstring wFilePath = StringToWString(file_path);
-
-  // Set quality for JPEG
+  // GDI+ exposes no PNG compression setting; only JPEG quality applies
   Gdiplus::EncoderParameters encoderParams;
-  ULONG quality = 90;
-
-  if (mimeType == L"image/jpeg") {
+  ULONG quality = static_cast<ULONG>(std::clamp(options.quality, 1, 100));
+  Gdiplus::EncoderParameters* params = nullptr;
+  if (options.format == ImageEncodeFormat::JPEG) {
     encoderParams.Count = 1;
     encoderParams.Parameter[0].Guid = Gdiplus::EncoderQuality;
     encoderParams.Parameter[0].Type = Gdiplus::EncoderParameterValueTypeLong;
     encoderParams.Parameter[0].NumberOfValues = 1;
     encoderParams.Parameter[0].Value = &quality;
+    params = &encoderParams;
+  }
 
-    Gdiplus::Status status =
-        pimpl_->bitmap_->Save(wFilePath.c_str(), &encoderClsid, &encoderParams);
-    return status == Gdiplus::Ok;
-  } else {
-    Gdiplus::Status status = pimpl_->bitmap_->Save(wFilePath.c_str(), &encoderClsid, NULL);
-    return status == Gdiplus::Ok;
+  IStream* pStream = nullptr;
+  if (CreateStreamOnHGlobal(NULL, TRUE, &pStream) != S_OK) {
+    return false;
+  }
+  if (bitmap->Save(pStream, &encoderClsid, params) != Gdiplus::Ok) {
+    pStream->Release();
+    return false;
+  }
+
+  STATSTG statstg;
+  HGLOBAL hMem = nullptr;
+  if (pStream->Stat(&statstg, STATFLAG_NONAME) != S_OK ||
+      GetHGlobalFromStream(pStream, &hMem) != S_OK) {
+    pStream->Release();
+    return false;
+  }
+  const void* data = GlobalLock(hMem);
+  if (!data) {
+    pStream->Release();
+    return false;
   }
+
+  // Hand the stream's memory block to the sink without copying
+  bool success =
+      sink(static_cast<const uint8_t*>(data), static_cast<size_t>(statstg.cbSize.QuadPart));
+  GlobalUnlock(hMem);
+  pStream->Release();
+  return success;
 }
 
 void* Image::GetNativeObjectInternal() const {
-  return pimpl_->bitmap_;
+  return pimpl_->EnsureDecoded();
+}
+
+bool Image::IsDecoded() const {
+  std::lock_guard<std::mutex> lock(pimpl_->decode_mutex_);
+  return pimpl_->bitmap_ != nullptr;
+}
+
+bool Image::EnsureDecoded() const {
+  return pimpl_->EnsureDecoded() != nullptr;
 }
 
 // Windows-specific helper function to convert Image to HICON
@@ -396,33 +505,26 @@ HICON ImageToHICON(const Image* image, int width, int height) {
     return nullptr;
   }
 
+  // Scale with the library's resampler so icons match other platforms
+  std::shared_ptr<Image> scaled;
+  const Size size = image->GetSize();
+  if (static_cast<int>(size.width) != width || static_cast<int>(size.height) != height) {
+    scaled = image->Resize({static_cast<double>(width), static_cast<double>(height)},
+                           ResampleFilter::Lanczos3);
+    if (scaled) {
+      image = scaled.get();
+    }
+  }
+
   // Retrieve native bitmap via public API
-  void* native = image->GetNativeObject();
-  Gdiplus::Bitmap* bitmap = static_cast<Gdiplus::Bitmap*>(native);
+  Gdiplus::Bitmap* bitmap = static_cast<Gdiplus::Bitmap*>(image->GetNativeObject());
   if (!bitmap) {
     return nullptr;
   }
 
-  // Scale bitmap if necessary
-  Gdiplus::Bitmap* scaledBitmap = bitmap;
-  bool needsScaling = (bitmap->GetWidth() != static_cast<UINT>(width) ||
-                       bitmap->GetHeight() != static_cast<UINT>(height));
-
-  if (needsScaling) {
-    scaledBitmap = new Gdiplus::Bitmap(width, height, bitmap->GetPixelFormat());
-    Gdiplus::Graphics graphics(scaledBitmap);
-    graphics.SetInterpolationMode(Gdiplus::InterpolationModeHighQualityBicubic);
-    graphics.DrawImage(bitmap, 0, 0, width, height);
-  }
-
   // Convert to HICON
   HICON hIcon = nullptr;
-  scaledBitmap->GetHICON(&hIcon);
-
-  // Clean up scaled bitmap if we created one
-  if (needsScaling && scaledBitmap) {
-    delete scaledBitmap;
-  }
+  bitmap->GetHICON(&hIcon);
 
   return hIcon;
 }
@@ -0,0 +1,90 @@
+#include <windows.h>
+#include <deque>
+#include <mutex>
+
+#include "../../main_thread.h"
+
+namespace nativeapi {
+
+namespace {
+
+constexpr wchar_t kDispatcherWindowClass[] = L"NativeApiMainThreadDispatcher";
+constexpr UINT kRunTasksMessage = WM_APP + 0x4E41;
+
+std::mutex g_tasks_mutex;
+std::deque<std::function<void()>> g_tasks;
+HWND g_dispatcher_hwnd = nullptr;
+
+void RunPendingTasks() {
+  std::deque<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    tasks.swap(g_tasks);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+LRESULT CALLBACK DispatcherWindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
+  if (msg == kRunTasksMessage) {
+    RunPendingTasks();
+    return 0;
+  }
+  return DefWindowProcW(hwnd, msg, wparam, lparam);
+}
+
+// Creates the message-only window on the calling thread, whose message loop
+// then runs the tasks. Must be called with g_tasks_mutex held.
+HWND CreateDispatcherWindow() {
+  WNDCLASSEXW wc = {};
+  wc.cbSize = sizeof(WNDCLASSEXW);
+  wc.lpfnWndProc = DispatcherWindowProc;
+  wc.hInstance = GetModuleHandleW(nullptr);
+  wc.lpszClassName = kDispatcherWindowClass;
+  RegisterClassExW(&wc);
+  g_dispatcher_hwnd = CreateWindowExW(0, kDispatcherWindowClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE,
+                                      nullptr, wc.hInstance, nullptr);
+  return g_dispatcher_hwnd;
+}
+
+}  // namespace
+
+void PostToMainThread(std::function<void()> task) {
+  if (!task) {
+    return;
+  }
+  HWND hwnd = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    g_tasks.push_back(std::move(task));
+    hwnd = g_dispatcher_hwnd;
+  }
+  // Windows cannot tell which thread runs the UI, so until
+  // PrepareMainThreadDispatcher() has named it, tasks stay queued.
+  if (hwnd) {
+    PostMessageW(hwnd, kRunTasksMessage, 0, 0);
+  }
+}
+
+void PrepareMainThreadDispatcher() {
+  HWND hwnd = nullptr;
+  bool has_tasks = false;
+  {
+    std::lock_guard<std::mutex> lock(g_tasks_mutex);
+    if (g_dispatcher_hwnd) {
+      return;  // The first caller is the main thread
+    }
+    hwnd = CreateDispatcherWindow();
+    has_tasks = !g_tasks.empty();
+  }
+  if (hwnd && has_tasks) {
+    PostMessageW(hwnd, kRunTasksMessage, 0, 0);
+  }
+}
+
+bool IsMainThreadDispatchSupported() {
+  return true;
+}
+
+}  // namespace nativeapi
@@ -5,9 +5,11 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 #include "../../foundation/id_allocator.h"
 #include "../../image.h"
+#include "../../main_thread.h"
 #include "../../menu.h"
 #include "../../menu_event.h"
 #include "../../window.h"
@@ -342,6 +344,7 @@ void MenuItem::SetAccelerator(const std::optional<KeyboardAccelerator>& accelera
     pimpl_->accelerator_ = KeyboardAccelerator("", ModifierKey::None);
     pimpl_->has_accelerator_ = false;
   }
+  LinkAccelerator(GetAccelerator());
   // Windows accelerators would be handled through accelerator tables
   // This is a placeholder implementation
 }
@@ -376,14 +379,8 @@ void MenuItem::SetState(MenuItemState state) {
       CheckMenuItem(pimpl_->parent_menu_, pimpl_->id_, check_state);
     }
 
-    // Handle radio button group logic
-    if (pimpl_->type_ == MenuItemType::Radio && state == MenuItemState::Checked &&
-        pimpl_->radio_group_ >= 0) {
-      // Note: Radio group logic would need to be implemented differently
-      // without global registry. This could be done by maintaining group
-      // information in the parent menu or through other means.
-      // For now, this functionality is disabled.
-    }
+    // Unchecks the group's previously checked item
+    SyncRadioGroup();
   }
 }
 
@@ -392,7 +389,9 @@ MenuItemState MenuItem::GetState() const {
 }
 
 void MenuItem::SetRadioGroup(int group_id) {
+  ForgetRadioGroup();
   pimpl_->radio_group_ = group_id;
+  SyncRadioGroup();
 }
 
 int MenuItem::GetRadioGroup() const {
@@ -411,6 +410,7 @@ void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
   }
 
   pimpl_->submenu_ = submenu;
+  LinkSubmenu(submenu);
 
   // Update platform menu if parent_menu_ is set
   if (pimpl_->parent_menu_ && submenu) {
@@ -427,6 +427,8 @@ void MenuItem::SetSubmenu(std::shared_ptr<Menu> submenu) {
     MenuItem* self = this;
     pimpl_->submenu_opened_listener_id_ =
         submenu->AddListener<MenuOpenedEvent>([self, menu_item_id](const MenuOpenedEvent& event) {
+          // WM_INITMENUPOPUP is the place to fill a popup before it is drawn
+          self->PrepareSubmenu();
           self->Emit<MenuItemSubmenuOpenedEvent>(menu_item_id);
         });
 
@@ -451,6 +453,7 @@ class Menu::Impl {
   MenuId id_;
   HMENU hmenu_;
   std::vector<std::shared_ptr<MenuItem>> items_;
+  size_t virtual_window_ = 0;  // Only reported back; HMENU items are not windows
   int window_proc_handle_id_;
   std::function<void(MenuId)> opened_callback_;
   std::function<void(MenuId)> closed_callback_;
@@ -528,6 +531,8 @@ Menu::Menu(void* native_menu)
   pimpl_->opened_callback_ = [this](MenuId id) { Emit<MenuOpenedEvent>(id); };
   pimpl_->closed_callback_ = [this](MenuId id) { Emit<MenuClosedEvent>(id); };
 
+  PrepareMainThreadDispatcher();
+
   // Register window procedure handler for menu commands and events
   HWND host_window = WindowMessageDispatcher::GetInstance().GetHostWindow();
   if (host_window) {
@@ -543,6 +548,8 @@ Menu::Menu() : pimpl_(std::make_unique<Impl>(IdAllocator::Allocate<Menu>(), Crea
   pimpl_->opened_callback_ = [this](MenuId id) { Emit<MenuOpenedEvent>(id); };
   pimpl_->closed_callback_ = [this](MenuId id) { Emit<MenuClosedEvent>(id); };
 
+  PrepareMainThreadDispatcher();
+
   // Register window procedure handler for menu commands and events
   HWND host_window = WindowMessageDispatcher::GetInstance().GetHostWindow();
   if (host_window) {
@@ -595,6 +602,7 @@ void Menu::AddItem(std::shared_ptr<MenuItem> item) {
 
   // Update the item's impl with menu info
   item->pimpl_->parent_menu_ = pimpl_->hmenu_;
+  LinkItem(item);
 }
 
 void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
@@ -638,6 +646,7 @@ void Menu::InsertItem(size_t index, std::shared_ptr<MenuItem> item) {
               w_label_str.c_str());
 
   item->pimpl_->parent_menu_ = pimpl_->hmenu_;
+  LinkItem(item);
 }
 
 bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
@@ -647,6 +656,7 @@ bool Menu::RemoveItem(std::shared_ptr<MenuItem> item) {
   auto it = std::find(pimpl_->items_.begin(), pimpl_->items_.end(), item);
   if (it != pimpl_->items_.end()) {
     RemoveMenu(pimpl_->hmenu_, item->GetId(), MF_BYCOMMAND);
+    UnlinkItem(*item);
     pimpl_->items_.erase(it);
     return true;
   }
@@ -657,6 +667,7 @@ bool Menu::RemoveItemById(MenuItemId item_id) {
   for (auto it = pimpl_->items_.begin(); it != pimpl_->items_.end(); ++it) {
     if ((*it)->GetId() == item_id) {
       RemoveMenu(pimpl_->hmenu_, item_id, MF_BYCOMMAND);
+      UnlinkItem(**it);
       pimpl_->items_.erase(it);
       return true;
     }
@@ -669,6 +680,7 @@ bool Menu::RemoveItemAt(size_t index) {
     return false;
 
   RemoveMenu(pimpl_->hmenu_, static_cast<UINT>(index), MF_BYPOSITION);
+  UnlinkItem(*pimpl_->items_[index]);
   pimpl_->items_.erase(pimpl_->items_.begin() + index);
   return true;
 }
@@ -677,6 +689,9 @@ void Menu::Clear() {
   while (GetMenuItemCount(pimpl_->hmenu_) > 0) {
     RemoveMenu(pimpl_->hmenu_, 0, MF_BYPOSITION);
   }
+  for (const auto& item : pimpl_->items_) {
+    UnlinkItem(*item);
+  }
   pimpl_->items_.clear();
 }
 
@@ -713,6 +728,14 @@ std::vector<std::shared_ptr<MenuItem>> Menu::GetAllItems() const {
   return pimpl_->items_;
 }
 
+void Menu::SetVirtualWindow(size_t visible_items) {
+  pimpl_->virtual_window_ = visible_items;
+}
+
+size_t Menu::GetVirtualWindow() const {
+  return pimpl_->virtual_window_;
+}
+
 bool Menu::Open(const PositioningStrategy& strategy, Placement placement) {
   POINT pt = {0, 0};
 
@@ -278,6 +278,24 @@ std::shared_ptr<Image> TrayIcon::GetIcon() const {
   return pimpl_->image_;
 }
 
+bool TrayIcon::SetIconAnimation(const std::vector<std::shared_ptr<Image>>& frames,
+                                std::chrono::milliseconds /*frame_interval*/) {
+  // Not animated on this platform; show the first frame
+  for (const auto& frame : frames) {
+    if (frame) {
+      SetIcon(frame);
+      break;
+    }
+  }
+  return false;
+}
+
+void TrayIcon::StopIconAnimation() {}
+
+bool TrayIcon::IsIconAnimating() const {
+  return false;
+}
+
 void TrayIcon::SetTitle(std::optional<std::string> title) {
   (void)title;  // Unused on Windows
   // Windows tray icons don't support title
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 #include "foundation/event_emitter.h"
 #include "foundation/geometry.h"
 #include "foundation/id_allocator.h"
@@ -178,6 +180,44 @@ class TrayIcon : public EventEmitter<TrayIconEvent>, public NativeObjectProvider
    */
   std::shared_ptr<Image> GetIcon() const;
 
+  /**
+   * @brief Animate the tray icon through a sequence of frames.
+   *
+   * All frames are converted to the platform's icon format once, up front,
+   * and a single timer advances them, so each frame costs little more than
+   * the notification to the system tray. The animation loops until
+   * SetIcon() or StopIconAnimation() is called, and pauses while the icon
+   * is hidden or no system tray is available to show it. GetIcon() returns
+   * the frame currently shown.
+   *
+   * @param frames Frames to show in order; null entries are skipped
+   * @param frame_interval Time each frame stays on screen
+   * @return true if the animation started. Platforms without animation
+   *         support show the first frame and return false.
+   *
+   * @example
+   * ```cpp
+   * std::vector<std::shared_ptr<Image>> frames;
+   * for (int i = 0; i < 8; ++i) {
+   *   frames.push_back(Image::FromFile("spinner-" + std::to_string(i) + ".png"));
+   * }
+   * tray_icon->SetIconAnimation(frames, std::chrono::milliseconds(80));
+   * ```
+   */
+  bool SetIconAnimation(const std::vector<std::shared_ptr<Image>>& frames,
+                        std::chrono::milliseconds frame_interval);
+
+  /**
+   * @brief Stop the icon animation, keeping the current frame as the icon.
+   */
+  void StopIconAnimation();
+
+  /**
+   * @brief Check whether an icon animation is set, including one that is
+   * currently paused.
+   */
+  bool IsIconAnimating() const;
+
   /**
    * @brief Set the title text for the tray icon.
    *
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <utility>
 #include "foundation/event.h"
+#include "foundation/geometry.h"
 #include "foundation/id_allocator.h"
 
 namespace nativeapi {
@@ -28,14 +30,22 @@ class TrayIconEvent : public Event {
  */
 class TrayIconClickedEvent : public TrayIconEvent {
  public:
-  TrayIconClickedEvent(TrayIconId tray_icon_id) : tray_icon_id_(tray_icon_id) {}
+  TrayIconClickedEvent(TrayIconId tray_icon_id, Point position = {0, 0})
+      : tray_icon_id_(tray_icon_id), position_(position) {}
 
   TrayIconId GetTrayIconId() const { return tray_icon_id_; }
 
+  /**
+   * @brief Screen position of the click, or (0, 0) where the platform does
+   * not report one.
+   */
+  Point GetPosition() const { return position_; }
+
   std::string GetTypeName() const override { return "TrayIconClickedEvent"; }
 
  private:
   TrayIconId tray_icon_id_;
+  Point position_;
 };
 
 /**
@@ -45,14 +55,22 @@ class TrayIconClickedEvent : public TrayIconEvent {
  */
 class TrayIconRightClickedEvent : public TrayIconEvent {
  public:
-  TrayIconRightClickedEvent(TrayIconId tray_icon_id) : tray_icon_id_(tray_icon_id) {}
+  TrayIconRightClickedEvent(TrayIconId tray_icon_id, Point position = {0, 0})
+      : tray_icon_id_(tray_icon_id), position_(position) {}
 
   TrayIconId GetTrayIconId() const { return tray_icon_id_; }
 
+  /**
+   * @brief Screen position of the click, or (0, 0) where the platform does
+   * not report one.
+   */
+  Point GetPosition() const { return position_; }
+
   std::string GetTypeName() const override { return "TrayIconRightClickedEvent"; }
 
  private:
   TrayIconId tray_icon_id_;
+  Point position_;
 };
 
 /**
@@ -62,14 +80,105 @@ class TrayIconRightClickedEvent : public TrayIconEvent {
  */
 class TrayIconDoubleClickedEvent : public TrayIconEvent {
  public:
-  TrayIconDoubleClickedEvent(TrayIconId tray_icon_id) : tray_icon_id_(tray_icon_id) {}
+  TrayIconDoubleClickedEvent(TrayIconId tray_icon_id, Point position = {0, 0})
+      : tray_icon_id_(tray_icon_id), position_(position) {}
 
   TrayIconId GetTrayIconId() const { return tray_icon_id_; }
 
+  /**
+   * @brief Screen position of the click, or (0, 0) where the platform does
+   * not report one.
+   */
+  Point GetPosition() const { return position_; }
+
   std::string GetTypeName() const override { return "TrayIconDoubleClickedEvent"; }
 
  private:
   TrayIconId tray_icon_id_;
+  Point position_;
+};
+
+/**
+ * @brief Direction of a TrayIconScrolledEvent.
+ */
+enum class TrayIconScrollOrientation {
+  Vertical,
+  Horizontal,
+};
+
+/**
+ * @brief Tray icon scrolled event.
+ *
+ * This event is fired when the mouse wheel is used over a tray icon. Linux
+ * tray hosts forward it through the StatusNotifierItem Scroll method.
+ */
+class TrayIconScrolledEvent : public TrayIconEvent {
+ public:
+  TrayIconScrolledEvent(TrayIconId tray_icon_id,
+                        int delta,
+                        TrayIconScrollOrientation orientation)
+      : tray_icon_id_(tray_icon_id), delta_(delta), orientation_(orientation) {}
+
+  TrayIconId GetTrayIconId() const { return tray_icon_id_; }
+
+  /**
+   * @brief Scroll amount as reported by the tray host; the sign gives the
+   * direction.
+   */
+  int GetDelta() const { return delta_; }
+
+  TrayIconScrollOrientation GetOrientation() const { return orientation_; }
+
+  std::string GetTypeName() const override { return "TrayIconScrolledEvent"; }
+
+ private:
+  TrayIconId tray_icon_id_;
+  int delta_;
+  TrayIconScrollOrientation orientation_;
+};
+
+/**
+ * @brief Tray icon ready event.
+ *
+ * This event is fired when the system tray has accepted the icon. On Linux
+ * registration with the StatusNotifierWatcher is asynchronous, so the event
+ * arrives after construction, and again whenever the tray host restarts and
+ * the icon is registered anew. Platforms that show the icon synchronously do
+ * not fire it.
+ */
+class TrayIconReadyEvent : public TrayIconEvent {
+ public:
+  TrayIconReadyEvent(TrayIconId tray_icon_id) : tray_icon_id_(tray_icon_id) {}
+
+  TrayIconId GetTrayIconId() const { return tray_icon_id_; }
+
+  std::string GetTypeName() const override { return "TrayIconReadyEvent"; }
+
+ private:
+  TrayIconId tray_icon_id_;
+};
+
+/**
+ * @brief Tray icon failed event.
+ *
+ * This event is fired when the icon could not be shown: no session bus, no
+ * StatusNotifierWatcher, or the watcher rejected the registration. On Linux a
+ * later TrayIconReadyEvent may still follow if a tray host starts.
+ */
+class TrayIconFailedEvent : public TrayIconEvent {
+ public:
+  TrayIconFailedEvent(TrayIconId tray_icon_id, std::string error_message)
+      : tray_icon_id_(tray_icon_id), error_message_(std::move(error_message)) {}
+
+  TrayIconId GetTrayIconId() const { return tray_icon_id_; }
+
+  const std::string& GetErrorMessage() const { return error_message_; }
+
+  std::string GetTypeName() const override { return "TrayIconFailedEvent"; }
+
+ private:
+  TrayIconId tray_icon_id_;
+  std::string error_message_;
 };
 
 }  // namespace nativeapi
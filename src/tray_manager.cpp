@@ -7,4 +7,16 @@ TrayManager& TrayManager::GetInstance() {
   return instance;
 }
 
+std::vector<std::shared_ptr<TrayIcon>> TrayManager::CreateMany(size_t count) {
+  // Icons created within one main-loop iteration are set up as a batch by
+  // the platform (see the Linux SNI registrar), so plain construction is
+  // enough here.
+  std::vector<std::shared_ptr<TrayIcon>> icons;
+  icons.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    icons.push_back(std::make_shared<TrayIcon>());
+  }
+  return icons;
+}
+
 }  // namespace nativeapi
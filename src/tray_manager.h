@@ -76,6 +76,30 @@ class TrayManager {
    */
   std::vector<std::shared_ptr<TrayIcon>> GetAll();
 
+  /**
+   * @brief Create several tray icons at once.
+   *
+   * Equivalent to calling std::make_shared<TrayIcon>() @p count times, but
+   * lets the platform set them up together. On Linux all icons share one
+   * D-Bus connection, each under its own object path. Their registrations
+   * with the tray host go out as one batch of pipelined calls, so startup
+   * costs one round trip instead of one handshake per icon. Each icon still
+   * reports TrayIconReadyEvent or TrayIconFailedEvent on its own.
+   *
+   * @param count Number of icons to create
+   * @return The new icons in creation order. Like icons created directly,
+   *         they are owned by the caller and are not tracked by Get().
+   *
+   * @example
+   * ```cpp
+   * auto icons = TrayManager::GetInstance().CreateMany(accounts.size());
+   * for (size_t i = 0; i < icons.size(); ++i) {
+   *   icons[i]->SetTitle(accounts[i].name);
+   * }
+   * ```
+   */
+  std::vector<std::shared_ptr<TrayIcon>> CreateMany(size_t count);
+
   // Prevent copy construction and assignment to maintain singleton property
   TrayManager(const TrayManager&) = delete;
   TrayManager& operator=(const TrayManager&) = delete;
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/foundation/base64.h"
+
+namespace {
+
+std::vector<uint8_t> MakeBytes(size_t length) {
+  std::vector<uint8_t> bytes(length);
+  uint32_t state = 0x12345678u;
+  for (auto& byte : bytes) {
+    state = state * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  return bytes;
+}
+
+int RunTests() {
+  using namespace nativeapi;
+
+  {
+    const std::string text = "Many hands make light work.";
+    std::string encoded;
+    Base64::EncodeAppend(reinterpret_cast<const uint8_t*>(text.data()), text.size(), encoded);
+    if (encoded != "TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsu") {
+      std::cerr << "Expected known-answer encoding, got " << encoded << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    // Lengths around the 12/16-byte vector block sizes exercise both paths
+    for (size_t length = 0; length < 200; ++length) {
+      const std::vector<uint8_t> bytes = MakeBytes(length);
+      std::string encoded;
+      Base64::EncodeAppend(bytes.data(), bytes.size(), encoded);
+      if (encoded.size() != Base64::EncodedLength(length)) {
+        std::cerr << "Unexpected encoded length for " << length << " bytes." << std::endl;
+        return 1;
+      }
+      std::vector<uint8_t> decoded;
+      if (!Base64::Decode(encoded, decoded) || decoded != bytes) {
+        std::cerr << "Round trip failed for " << length << " bytes." << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  {
+    const std::vector<uint8_t> bytes = MakeBytes(300);
+    std::string encoded;
+    Base64::EncodeAppend(bytes.data(), bytes.size(), encoded);
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); ++i) {
+      wrapped += encoded[i];
+      if (i % 76 == 75) {
+        wrapped += "\r\n";
+      }
+    }
+    std::vector<uint8_t> decoded;
+    if (!Base64::Decode(wrapped, decoded) || decoded != bytes) {
+      std::cerr << "Expected line-wrapped input to decode." << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    std::vector<uint8_t> decoded;
+    if (!Base64::Decode("QUI", decoded) || decoded != std::vector<uint8_t>{'A', 'B'}) {
+      std::cerr << "Expected unpadded input to decode." << std::endl;
+      return 1;
+    }
+    if (Base64::Decode("QUJD!EVG", decoded) || Base64::Decode("Q===", decoded) ||
+        Base64::Decode("QQ==QUJD", decoded)) {
+      std::cerr << "Expected malformed input to be rejected." << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    std::string_view mime_type;
+    std::string_view payload =
+        Base64::StripDataUriPrefix("data:image/png;base64,iVBORw0KGgo=", &mime_type);
+    if (payload != "iVBORw0KGgo=" || mime_type != "image/png") {
+      std::cerr << "Expected data URI prefix to be stripped." << std::endl;
+      return 1;
+    }
+    if (Base64::StripDataUriPrefix("iVBORw0KGgo=") != "iVBORw0KGgo=") {
+      std::cerr << "Expected plain base64 to be returned unchanged." << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    uint8_t small[2];
+    size_t written = 0;
+    if (Base64::Decode("QUJD", small, sizeof(small), &written)) {
+      std::cerr << "Expected decode into a too-small buffer to fail." << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
@@ -0,0 +1,99 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../src/capi/callback_registry.h"
+
+namespace {
+
+using nativeapi::CallbackRegistry;
+
+struct ListenerData {
+  int value;
+};
+
+int RunTests() {
+  CallbackRegistry<ListenerData> registry;
+  constexpr int kThreads = 8;
+  constexpr size_t kListeners = 2000;
+
+  // Threads add and remove listeners of their own handle and of a shared
+  // one at the same time; each must get back exactly what it added
+  int shared_handle = 0;
+  std::vector<int> handles(kThreads);
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      const void* own = &handles[t];
+      std::vector<std::shared_ptr<ListenerData>> alive;
+      for (size_t i = 0; i < kListeners; ++i) {
+        const size_t id = static_cast<size_t>(t) * kListeners + i;
+        auto data = std::make_shared<ListenerData>(ListenerData{static_cast<int>(id)});
+        registry.Add(own, id, data);
+        registry.Add(&shared_handle, id, data);
+        alive.push_back(data);
+        // Drop every third listener without unregistering it, as when its
+        // object is destroyed, so the sweeps run alongside the other threads
+        if (i % 3 == 0) {
+          alive.back().reset();
+        }
+      }
+      for (size_t i = 0; i < kListeners; ++i) {
+        const size_t id = static_cast<size_t>(t) * kListeners + i;
+        auto from_own = registry.Remove(own, id);
+        auto from_shared = registry.Remove(&shared_handle, id);
+        const bool expected = i % 3 != 0;
+        if ((from_own != nullptr) != expected || from_shared != from_own ||
+            (from_own && from_own->value != static_cast<int>(id)) ||
+            registry.Remove(own, id)) {
+          failures.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (failures.load() != 0) {
+    std::cerr << failures.load() << " listeners were lost or removed twice" << std::endl;
+    return 1;
+  }
+
+  // Of several threads removing the same listener, exactly one gets it
+  auto contested = std::make_shared<ListenerData>(ListenerData{7});
+  registry.Add(&shared_handle, 7, contested);
+  std::atomic<int> winners{0};
+  threads.clear();
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      if (registry.Remove(&shared_handle, 7)) {
+        winners.fetch_add(1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (winners.load() != 1) {
+    std::cerr << winners.load() << " threads removed the same listener" << std::endl;
+    return 1;
+  }
+
+  // Destroying a handle forgets its listeners
+  registry.Add(&handles[0], 1, contested);
+  registry.RemoveAll(&handles[0]);
+  if (registry.Remove(&handles[0], 1)) {
+    std::cerr << "RemoveAll kept a listener" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
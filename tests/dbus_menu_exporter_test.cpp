@@ -0,0 +1,343 @@
+#include <gio/gio.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/menu.h"
+#include "../src/menu_event.h"
+#include "../src/platform/linux/dbus_menu_exporter_linux.h"
+#include "sni_test_fixture.h"
+
+namespace {
+
+using nativeapi::DbusMenuExporter;
+using nativeapi::KeyboardAccelerator;
+using nativeapi::Menu;
+using nativeapi::MenuItem;
+using nativeapi::MenuItemClickedEvent;
+using nativeapi::MenuItemState;
+using nativeapi::MenuItemType;
+using nativeapi::ModifierKey;
+
+using sni_test::CollectLayoutIds;
+using sni_test::HostClient;
+using sni_test::PrivateBus;
+using sni_test::RunUntil;
+
+constexpr char kObjectPath[] = "/MenuBar";
+
+bool GetLayoutIds(const HostClient& client,
+                  const std::string& service,
+                  unsigned int& revision,
+                  std::vector<int>& ids) {
+  GVariant* layout = client.GetLayout(service, kObjectPath, 0, -1, &revision);
+  if (!layout) {
+    return false;
+  }
+  ids.clear();
+  CollectLayoutIds(layout, ids);
+  g_variant_unref(layout);
+  return true;
+}
+
+// Lets the exporter's idle flush update the properties hosts see
+void Settle() {
+  RunUntil([] { return false; }, 100);
+}
+
+// GetProperty(id, name); returns the value (to be unreffed) or nullptr
+GVariant* GetProperty(const HostClient& client,
+                      const std::string& service,
+                      int id,
+                      const char* name) {
+  GVariant* reply =
+      client.CallMenu(service, kObjectPath, "GetProperty", g_variant_new("(is)", id, name));
+  if (!reply) {
+    return nullptr;
+  }
+  GVariant* value = nullptr;
+  g_variant_get(reply, "(v)", &value);
+  g_variant_unref(reply);
+  return value;
+}
+
+int GetToggleState(const HostClient& client, const std::string& service, int id) {
+  GVariant* value = GetProperty(client, service, id, "toggle-state");
+  if (!value) {
+    return -2;
+  }
+  const int state = g_variant_get_int32(value);
+  g_variant_unref(value);
+  return state;
+}
+
+int RunTests(GDBusConnection* server, const HostClient& client) {
+  const std::string service = g_dbus_connection_get_unique_name(server);
+
+  auto menu = std::make_shared<Menu>();
+  auto open = std::make_shared<MenuItem>("Open", MenuItemType::Normal);
+  auto check = std::make_shared<MenuItem>("Check", MenuItemType::Checkbox);
+  auto more = std::make_shared<MenuItem>("More", MenuItemType::Submenu);
+  auto submenu = std::make_shared<Menu>();
+  auto nested = std::make_shared<MenuItem>("Nested", MenuItemType::Normal);
+  submenu->AddItem(nested);
+  more->SetSubmenu(submenu);
+  menu->AddItem(open);
+  menu->AddItem(check);
+  menu->AddItem(more);
+
+  int check_clicks = 0;
+  int nested_clicks = 0;
+  check->AddListener<MenuItemClickedEvent>(
+      [&check_clicks](const MenuItemClickedEvent&) { ++check_clicks; });
+  nested->AddListener<MenuItemClickedEvent>(
+      [&nested_clicks](const MenuItemClickedEvent&) { ++nested_clicks; });
+
+  DbusMenuExporter exporter(server, kObjectPath);
+  if (!exporter.Register()) {
+    std::cerr << "Exporter registration failed" << std::endl;
+    return 1;
+  }
+  exporter.SetMenu(menu);
+
+  const int open_id = static_cast<int>(open->GetId());
+  const int check_id = static_cast<int>(check->GetId());
+  const int more_id = static_cast<int>(more->GetId());
+  const int nested_id = static_cast<int>(nested->GetId());
+
+  // dbusmenu ids are the MenuItemIds
+  unsigned int revision = 0;
+  std::vector<int> ids;
+  if (!GetLayoutIds(client, service, revision, ids) ||
+      ids != std::vector<int>{0, open_id, check_id, more_id, nested_id}) {
+    std::cerr << "GetLayout did not report MenuItemIds" << std::endl;
+    return 1;
+  }
+
+  // Removing an item leaves the ids of the others untouched
+  menu->RemoveItem(open);
+  unsigned int new_revision = 0;
+  if (!GetLayoutIds(client, service, new_revision, ids) ||
+      ids != std::vector<int>{0, check_id, more_id, nested_id} || new_revision <= revision) {
+    std::cerr << "Ids changed after removing an item" << std::endl;
+    return 1;
+  }
+
+  // A burst of insertions is diffed once and bumps the revision once
+  revision = new_revision;
+  std::vector<std::shared_ptr<MenuItem>> burst;
+  for (int i = 0; i < 50; ++i) {
+    burst.push_back(std::make_shared<MenuItem>("Burst " + std::to_string(i)));
+    menu->AddItem(burst.back());
+  }
+  if (!GetLayoutIds(client, service, new_revision, ids) ||
+      ids.size() != 4 + burst.size() || new_revision != revision + 1) {
+    std::cerr << "Inserting a burst of items was not batched into one layout change"
+              << std::endl;
+    return 1;
+  }
+  for (const auto& item : burst) {
+    menu->RemoveItem(item);
+  }
+  Settle();
+  if (!GetLayoutIds(client, service, revision, ids) ||
+      ids != std::vector<int>{0, check_id, more_id, nested_id} || revision != new_revision + 1) {
+    std::cerr << "Removing a burst of items was not batched into one layout change" << std::endl;
+    return 1;
+  }
+
+  // Event activates the item the id belongs to
+  if (!client.Click(service, kObjectPath, check_id) || check_clicks != 1) {
+    std::cerr << "Event did not activate the item" << std::endl;
+    return 1;
+  }
+
+  // EventGroup reports unknown ids and still activates the known ones
+  GVariantBuilder events;
+  g_variant_builder_init(&events, G_VARIANT_TYPE("a(isvu)"));
+  g_variant_builder_add(&events, "(isvu)", nested_id, "clicked", g_variant_new_int32(0), 0u);
+  g_variant_builder_add(&events, "(isvu)", open_id, "clicked", g_variant_new_int32(0), 0u);
+  GVariant* reply = client.CallMenu(service, kObjectPath, "EventGroup",
+                                    g_variant_new("(@a(isvu))", g_variant_builder_end(&events)));
+  if (!reply) {
+    std::cerr << "EventGroup failed" << std::endl;
+    return 1;
+  }
+  GVariant* errors = g_variant_get_child_value(reply, 0);
+  gsize error_count = 0;
+  const gint32* error_ids =
+      static_cast<const gint32*>(g_variant_get_fixed_array(errors, &error_count, sizeof(gint32)));
+  const bool reported = error_count == 1 && error_ids[0] == open_id;
+  g_variant_unref(errors);
+  g_variant_unref(reply);
+  if (!reported || nested_clicks != 1) {
+    std::cerr << "EventGroup did not resolve ids correctly" << std::endl;
+    return 1;
+  }
+
+  // Properties are served from the model
+  GVariant* value = GetProperty(client, service, check_id, "toggle-type");
+  const bool is_checkmark =
+      value && g_strcmp0(g_variant_get_string(value, nullptr), "checkmark") == 0;
+  if (value) {
+    g_variant_unref(value);
+  }
+  if (!is_checkmark) {
+    std::cerr << "GetProperty returned the wrong toggle-type" << std::endl;
+    return 1;
+  }
+
+  // GetGroupProperties with no ids returns every item
+  GVariantBuilder no_ids;
+  g_variant_builder_init(&no_ids, G_VARIANT_TYPE("ai"));
+  GVariantBuilder no_names;
+  g_variant_builder_init(&no_names, G_VARIANT_TYPE("as"));
+  reply = client.CallMenu(
+      service, kObjectPath, "GetGroupProperties",
+      g_variant_new("(@ai@as)", g_variant_builder_end(&no_ids), g_variant_builder_end(&no_names)));
+  gsize group_count = 0;
+  if (reply) {
+    GVariant* group = g_variant_get_child_value(reply, 0);
+    group_count = g_variant_n_children(group);
+    g_variant_unref(group);
+    g_variant_unref(reply);
+  }
+  if (!GetLayoutIds(client, service, revision, ids) || group_count != ids.size()) {
+    std::cerr << "GetGroupProperties did not return every item for an empty id list"
+              << std::endl;
+    return 1;
+  }
+
+  // The click above toggled the checkbox without a widget
+  Settle();
+  if (check->GetState() != MenuItemState::Checked ||
+      GetToggleState(client, service, check_id) != 1) {
+    std::cerr << "Event did not toggle the checkbox" << std::endl;
+    return 1;
+  }
+
+  // The accelerator is exported as a shortcut
+  check->SetAccelerator(KeyboardAccelerator("S", ModifierKey::Ctrl | ModifierKey::Shift));
+  Settle();
+  value = GetProperty(client, service, check_id, "shortcut");
+  bool has_shortcut = false;
+  if (value) {
+    gchar* text = g_variant_print(value, FALSE);
+    has_shortcut = g_strcmp0(text, "[['Control', 'Shift', 'S']]") == 0;
+    g_free(text);
+    g_variant_unref(value);
+  }
+  if (!has_shortcut) {
+    std::cerr << "Shortcut was not exported" << std::endl;
+    return 1;
+  }
+
+  // Clicking a radio item checks it and unchecks the rest of its group
+  auto first = std::make_shared<MenuItem>("First", MenuItemType::Radio);
+  auto second = std::make_shared<MenuItem>("Second", MenuItemType::Radio);
+  first->SetRadioGroup(1);
+  second->SetRadioGroup(1);
+  first->SetState(MenuItemState::Checked);
+  submenu->AddItem(first);
+  submenu->AddItem(second);
+  int second_clicks = 0;
+  second->AddListener<MenuItemClickedEvent>(
+      [&second_clicks](const MenuItemClickedEvent&) { ++second_clicks; });
+  const int first_id = static_cast<int>(first->GetId());
+  const int second_id = static_cast<int>(second->GetId());
+  Settle();
+  if (!client.Click(service, kObjectPath, second_id)) {
+    std::cerr << "Event on a radio item failed" << std::endl;
+    return 1;
+  }
+  Settle();
+  if (second_clicks != 1 || first->GetState() != MenuItemState::Unchecked ||
+      GetToggleState(client, service, first_id) != 0 ||
+      GetToggleState(client, service, second_id) != 1) {
+    std::cerr << "Radio click did not update the group" << std::endl;
+    return 1;
+  }
+
+  // AboutToShow builds a provided submenu; only then does the host refetch
+  auto recent = std::make_shared<MenuItem>("Recent", MenuItemType::Submenu);
+  recent->SetSubmenuProvider([](Menu& provided) {
+    provided.AddItem(std::make_shared<MenuItem>("File", MenuItemType::Normal));
+  });
+  menu->AddItem(recent);
+  const int recent_id = static_cast<int>(recent->GetId());
+  for (gboolean expected : {TRUE, FALSE}) {
+    reply = client.CallMenu(service, kObjectPath, "AboutToShow", g_variant_new("(i)", recent_id));
+    gboolean need_update = !expected;
+    if (reply) {
+      g_variant_get(reply, "(b)", &need_update);
+      g_variant_unref(reply);
+    }
+    if (need_update != expected) {
+      std::cerr << "AboutToShow reported the wrong needUpdate" << std::endl;
+      return 1;
+    }
+  }
+  const int file_id = static_cast<int>(recent->GetSubmenu()->GetItemAt(0)->GetId());
+  if (!GetLayoutIds(client, service, revision, ids) || ids.back() != file_id) {
+    std::cerr << "GetLayout did not include the provided items" << std::endl;
+    return 1;
+  }
+
+  // A submenu cycle exports each item once instead of recursing
+  auto loop = std::make_shared<Menu>();
+  auto back = std::make_shared<MenuItem>("Back", MenuItemType::Submenu);
+  loop->AddItem(back);
+  auto inner = std::make_shared<Menu>();
+  auto forward = std::make_shared<MenuItem>("Forward", MenuItemType::Submenu);
+  inner->AddItem(forward);
+  back->SetSubmenu(inner);
+  forward->SetSubmenu(loop);
+  exporter.SetMenu(loop);
+  const int back_id = static_cast<int>(back->GetId());
+  const int forward_id = static_cast<int>(forward->GetId());
+  if (!GetLayoutIds(client, service, revision, ids) ||
+      ids != std::vector<int>{0, back_id, forward_id}) {
+    std::cerr << "A submenu cycle was not cut when exporting" << std::endl;
+    return 1;
+  }
+  // Closing the cycle on an exported item is cut the same way
+  forward->SetSubmenu(nullptr);
+  Settle();
+  forward->SetSubmenu(loop);
+  Settle();
+  const bool cut = GetLayoutIds(client, service, revision, ids) &&
+                   ids == std::vector<int>{0, back_id, forward_id};
+  forward->SetSubmenu(nullptr);
+  if (!cut) {
+    std::cerr << "SetSubmenu closing a cycle was not cut" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  PrivateBus bus;
+  // No gtk_init: exporting must not need GTK
+  if (!bus.Start()) {
+    std::cerr << "Skipping: dbus-daemon is not available" << std::endl;
+    return sni_test::kSkipped;
+  }
+
+  GDBusConnection* server = sni_test::Connect(bus.address());
+  HostClient client(bus.address());
+  if (!server || !client.connected()) {
+    std::cerr << "Could not connect to the test bus" << std::endl;
+    if (server) {
+      g_object_unref(server);
+    }
+    return 1;
+  }
+
+  const int result = RunTests(server, client);
+  g_object_unref(server);
+  return result;
+}
@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/foundation/image_header.h"
+
+namespace {
+
+bool Expect(const std::vector<uint8_t>& bytes,
+            const std::string& format,
+            int width,
+            int height,
+            const char* name) {
+  nativeapi::ImageHeaderInfo info = nativeapi::ImageHeader::Probe(bytes.data(), bytes.size());
+  if (info.format != format || info.width != width || info.height != height) {
+    std::cerr << "Unexpected probe result for " << name << ": " << info.format << " "
+              << info.width << "x" << info.height << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int RunTests() {
+  // PNG: signature + IHDR (300x200)
+  if (!Expect({0x89, 'P',  'N',  'G',  0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D,
+               'I',  'H',  'D',  'R',  0x00, 0x00, 0x01, 0x2C, 0x00, 0x00, 0x00, 0xC8},
+              "PNG", 300, 200, "PNG")) {
+    return 1;
+  }
+
+  // JPEG: SOI, APP0 segment, SOF0 (height 48, width 64)
+  if (!Expect({0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x04, 0x00, 0x00, 0xFF, 0xC0, 0x00,
+               0x11, 0x08, 0x00, 0x30, 0x00, 0x40, 0x03},
+              "JPEG", 64, 48, "JPEG")) {
+    return 1;
+  }
+
+  // GIF: logical screen 32x16
+  if (!Expect({'G', 'I', 'F', '8', '9', 'a', 0x20, 0x00, 0x10, 0x00}, "GIF", 32, 16, "GIF")) {
+    return 1;
+  }
+
+  // BMP: BITMAPINFOHEADER, top-down (negative height)
+  {
+    std::vector<uint8_t> bmp(26, 0);
+    bmp[0] = 'B';
+    bmp[1] = 'M';
+    bmp[14] = 40;
+    bmp[18] = 24;
+    bmp[22] = 0xF0;  // -16
+    bmp[23] = 0xFF;
+    bmp[24] = 0xFF;
+    bmp[25] = 0xFF;
+    if (!Expect(bmp, "BMP", 24, 16, "BMP")) {
+      return 1;
+    }
+  }
+
+  // ICO: two entries, 16x16 and 256x256 (stored as 0)
+  {
+    std::vector<uint8_t> ico(6 + 2 * 16, 0);
+    ico[2] = 1;
+    ico[4] = 2;
+    ico[6] = 16;
+    ico[7] = 16;
+    if (!Expect(ico, "ICO", 256, 256, "ICO")) {
+      return 1;
+    }
+  }
+
+  // WebP: extended (VP8X) canvas 640x480
+  {
+    std::vector<uint8_t> webp = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'E', 'B', 'P',
+                                 'V', 'P', '8', 'X', 10, 0, 0, 0, 0, 0, 0, 0};
+    webp.insert(webp.end(), {0x7F, 0x02, 0x00, 0xDF, 0x01, 0x00});
+    if (!Expect(webp, "WEBP", 640, 480, "WebP")) {
+      return 1;
+    }
+  }
+
+  // TIFF (little endian): IFD with ImageWidth (SHORT) and ImageLength (LONG)
+  if (!Expect({'I', 'I', 42,  0, 8, 0, 0, 0, 2,   0, 0x00, 0x01, 3, 0, 1, 0,
+               0,   0,   100, 0, 0, 0, 1, 1, 4,   0, 1,    0,    0, 0, 50, 0,
+               0,   0},
+              "TIFF", 100, 50, "TIFF")) {
+    return 1;
+  }
+
+  // SVG is recognized but has no intrinsic pixel size
+  {
+    const std::string svg = "\n<?xml version=\"1.0\"?>\n<svg width=\"10\" height=\"10\"/>";
+    if (!Expect(std::vector<uint8_t>(svg.begin(), svg.end()), "SVG", 0, 0, "SVG")) {
+      return 1;
+    }
+  }
+
+  // Unrecognized and truncated data
+  if (!Expect({'h', 'e', 'l', 'l', 'o'}, "", 0, 0, "text") ||
+      !Expect({0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A}, "PNG", 0, 0, "truncated PNG")) {
+    return 1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
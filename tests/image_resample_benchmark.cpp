@@ -0,0 +1,83 @@
+// Compares Image::Resize against gdk_pixbuf_scale_simple for typical icon
+// downscales. Not part of the ctest suite; run the binary directly.
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../src/image.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kIterations = 50;
+
+std::vector<uint8_t> Gradient(int width, int height) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint8_t* p = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+      p[0] = static_cast<uint8_t>(x * 255 / width);
+      p[1] = static_cast<uint8_t>(y * 255 / height);
+      p[2] = static_cast<uint8_t>((x ^ y) & 0xFF);
+      p[3] = static_cast<uint8_t>(((x / 8 + y / 8) % 2) ? 255 : 96);
+    }
+  }
+  return pixels;
+}
+
+double Milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count() / kIterations;
+}
+
+void Run(int src_size, int dst_size) {
+  std::vector<uint8_t> pixels = Gradient(src_size, src_size);
+  auto image = nativeapi::Image::FromRawData(pixels.data(), src_size, src_size);
+  GdkPixbuf* pixbuf = static_cast<GdkPixbuf*>(image->GetNativeObject());
+  const nativeapi::Size target{static_cast<double>(dst_size), static_cast<double>(dst_size)};
+
+  struct Case {
+    const char* name;
+    nativeapi::ResampleFilter filter;
+    GdkInterpType interp;
+  };
+  const Case cases[] = {
+      {"box/tiles", nativeapi::ResampleFilter::Box, GDK_INTERP_TILES},
+      {"bilinear", nativeapi::ResampleFilter::Bilinear, GDK_INTERP_BILINEAR},
+      {"lanczos3/hyper", nativeapi::ResampleFilter::Lanczos3, GDK_INTERP_HYPER},
+  };
+
+  for (const Case& c : cases) {
+    auto start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+      auto resized = image->Resize(target, c.filter);
+      if (!resized) {
+        std::cerr << "Image::Resize failed" << std::endl;
+        return;
+      }
+    }
+    const double ours = Milliseconds(Clock::now() - start);
+
+    start = Clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+      g_object_unref(gdk_pixbuf_scale_simple(pixbuf, dst_size, dst_size, c.interp));
+    }
+    const double gdk = Milliseconds(Clock::now() - start);
+
+    std::cout << src_size << " -> " << dst_size << " " << c.name << ": Image::Resize " << ours
+              << " ms, gdk_pixbuf_scale_simple " << gdk << " ms" << std::endl;
+  }
+}
+
+}  // namespace
+
+int main() {
+  Run(256, 16);
+  Run(512, 22);
+  Run(1024, 32);
+  Run(1024, 256);
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "../src/foundation/image_resampler.h"
+
+namespace {
+
+using nativeapi::ImageResampler;
+using nativeapi::ResampleFilter;
+
+const ResampleFilter kFilters[] = {ResampleFilter::Box, ResampleFilter::Bilinear,
+                                   ResampleFilter::Lanczos3};
+
+std::vector<uint8_t> Solid(int width, int height, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    pixels[i] = r;
+    pixels[i + 1] = g;
+    pixels[i + 2] = b;
+    pixels[i + 3] = a;
+  }
+  return pixels;
+}
+
+bool Resize(const std::vector<uint8_t>& src,
+            int src_width,
+            int src_height,
+            std::vector<uint8_t>& dst,
+            int dst_width,
+            int dst_height,
+            ResampleFilter filter) {
+  dst.assign(static_cast<size_t>(dst_width) * dst_height * 4, 0);
+  return ImageResampler::Resize(src.data(), src_width, src_height, src_width * 4, dst.data(),
+                                dst_width, dst_height, dst_width * 4, filter);
+}
+
+int RunTests() {
+  // A solid color stays exactly that color in every direction and filter
+  const int sizes[][2] = {{16, 16}, {1, 1}, {48, 30}, {300, 200}, {7, 129}};
+  for (ResampleFilter filter : kFilters) {
+    for (const auto& size : sizes) {
+      std::vector<uint8_t> src = Solid(64, 64, 200, 100, 50, 255);
+      std::vector<uint8_t> dst;
+      if (!Resize(src, 64, 64, dst, size[0], size[1], filter)) {
+        std::cerr << "Resize failed" << std::endl;
+        return 1;
+      }
+      for (size_t i = 0; i < dst.size(); i += 4) {
+        if (dst[i] != 200 || dst[i + 1] != 100 || dst[i + 2] != 50 || dst[i + 3] != 255) {
+          std::cerr << "Solid color changed at " << size[0] << "x" << size[1] << std::endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  // Fully transparent pixels must not bleed their color into opaque ones
+  for (ResampleFilter filter : kFilters) {
+    std::vector<uint8_t> src = Solid(32, 32, 255, 0, 0, 255);
+    for (int y = 0; y < 32; ++y) {
+      for (int x = 0; x < 32; x += 2) {
+        uint8_t* p = &src[(y * 32 + x) * 4];
+        p[0] = 0;
+        p[1] = 255;
+        p[2] = 0;
+        p[3] = 0;
+      }
+    }
+    std::vector<uint8_t> dst;
+    if (!Resize(src, 32, 32, dst, 8, 8, filter)) {
+      std::cerr << "Resize failed" << std::endl;
+      return 1;
+    }
+    for (size_t i = 0; i < dst.size(); i += 4) {
+      if (dst[i + 3] != 0 && (dst[i + 1] > 2 || dst[i] < 253)) {
+        std::cerr << "Transparent color bled into the result" << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  // Identity resize preserves the pixels
+  {
+    std::vector<uint8_t> src(4 * 4 * 4);
+    for (size_t i = 0; i < src.size(); ++i) {
+      src[i] = static_cast<uint8_t>(i * 13);
+    }
+    for (size_t i = 3; i < src.size(); i += 4) {
+      src[i] = 255;
+    }
+    std::vector<uint8_t> dst;
+    if (!Resize(src, 4, 4, dst, 4, 4, ResampleFilter::Lanczos3)) {
+      std::cerr << "Resize failed" << std::endl;
+      return 1;
+    }
+    for (size_t i = 0; i < src.size(); ++i) {
+      if (std::abs(static_cast<int>(src[i]) - static_cast<int>(dst[i])) > 1) {
+        std::cerr << "Identity resize changed pixel data" << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  // Invalid arguments are rejected
+  {
+    uint8_t pixel[4] = {0, 0, 0, 0};
+    if (ImageResampler::Resize(pixel, 0, 1, 4, pixel, 1, 1, 4, ResampleFilter::Box) ||
+        ImageResampler::Resize(pixel, 1, 1, 4, nullptr, 1, 1, 4, ResampleFilter::Box)) {
+      std::cerr << "Invalid arguments were accepted" << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
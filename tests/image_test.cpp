@@ -0,0 +1,244 @@
+#include <glib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../src/capi/image_c.h"
+#include "../src/capi/main_thread_c.h"
+#include "../src/image.h"
+
+namespace {
+
+using nativeapi::Image;
+using nativeapi::ImageCallbackContext;
+using nativeapi::ImageDecodeTask;
+
+// A 16x8 RGBA PNG with every channel at 0x80
+const uint8_t kPng[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+    0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x08,
+    0x08, 0x06, 0x00, 0x00, 0x00, 0xf0, 0x76, 0x7f, 0x97, 0x00, 0x00, 0x00,
+    0x12, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x68, 0xa0, 0x10, 0x30,
+    0x8c, 0x1a, 0x30, 0x1c, 0x0c, 0x00, 0x00, 0x11, 0x44, 0x00, 0x10, 0xaf,
+    0x53, 0x80, 0x8d, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+    0x42, 0x60, 0x82,
+};
+
+// Runs the main loop until |done| returns true or the timeout expires
+template <typename Predicate>
+bool PumpUntil(Predicate done, int timeout_ms = 10000) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    if (!g_main_context_iteration(nullptr, FALSE)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  return true;
+}
+
+// Drains the main loop for a while, giving late deliveries a chance to run
+void Settle() {
+  PumpUntil([] { return false; }, 200);
+}
+
+struct CDecodeResult {
+  std::atomic<bool> delivered{false};  // set last, publishing the rest
+  double width = 0;
+  std::thread::id thread;
+};
+
+void OnCDecoded(native_image_t image, void* user_data) {
+  auto* result = static_cast<CDecodeResult*>(user_data);
+  result->thread = std::this_thread::get_id();
+  if (image) {
+    result->width = native_image_get_size(image).width;
+    native_image_destroy(image);
+  }
+  result->delivered = true;
+}
+
+int RunTests() {
+  const std::vector<uint8_t> png(std::begin(kPng), std::end(kPng));
+
+  // The synchronous factory only reads the header
+  auto lazy = Image::FromBytes(png.data(), png.size());
+  if (!lazy || lazy->IsDecoded() || lazy->GetSize().width != 16) {
+    std::cerr << "FromBytes did not defer the decode" << std::endl;
+    return 1;
+  }
+
+  // The async factory decodes on the worker, before the callback runs
+  std::mutex mutex;
+  std::condition_variable done;
+  bool delivered = false;
+  bool decoded = false;
+  Image::FromBytesAsync(
+      png,
+      [&](std::shared_ptr<Image> image) {
+        std::lock_guard<std::mutex> lock(mutex);
+        decoded = image && image->IsDecoded();
+        delivered = true;
+        done.notify_one();
+      },
+      ImageCallbackContext::WorkerThread);
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!done.wait_for(lock, std::chrono::seconds(10), [&] { return delivered; }) || !decoded) {
+    std::cerr << "FromBytesAsync delivered an image that was not decoded" << std::endl;
+    return 1;
+  }
+  lock.unlock();
+
+  // MainThread delivery runs from the main loop, never on the worker
+  const std::thread::id main_thread = std::this_thread::get_id();
+  bool main_delivered = false;
+  bool main_decoded = false;
+  std::thread::id delivery_thread;
+  auto main_task = Image::FromBytesAsync(
+      png,
+      [&](std::shared_ptr<Image> image) {
+        main_delivered = true;
+        main_decoded = image && image->IsDecoded() && image->GetSize().width == 16;
+        delivery_thread = std::this_thread::get_id();
+      },
+      ImageCallbackContext::MainThread);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  if (main_delivered) {
+    std::cerr << "MainThread delivery ran outside the main loop" << std::endl;
+    return 1;
+  }
+  if (!PumpUntil([&] { return main_delivered; }) || !main_decoded ||
+      delivery_thread != main_thread || !main_task->IsCompleted()) {
+    std::cerr << "MainThread delivery did not run on the main loop" << std::endl;
+    return 1;
+  }
+
+  // Cancel() before the main loop delivers suppresses the callback, even if
+  // the worker has already decoded the image
+  bool cancelled_delivered = false;
+  auto cancelled = Image::FromBytesAsync(
+      png, [&](std::shared_ptr<Image>) { cancelled_delivered = true; },
+      ImageCallbackContext::MainThread);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  if (!cancelled->Cancel() || !cancelled->IsCancelled()) {
+    std::cerr << "Cancel() failed before delivery" << std::endl;
+    return 1;
+  }
+  Settle();
+  if (cancelled_delivered || cancelled->IsCompleted()) {
+    std::cerr << "A cancelled decode still delivered its result" << std::endl;
+    return 1;
+  }
+  // Once delivered, a task can no longer be cancelled
+  if (main_task->Cancel() || main_task->IsCancelled()) {
+    std::cerr << "Cancel() succeeded after delivery" << std::endl;
+    return 1;
+  }
+
+  // C API: results reach the callback on the requested thread, and a
+  // cancelled decode never calls back
+  native_prepare_main_thread_dispatcher();
+  CDecodeResult c_worker;
+  native_image_decode_task_t c_worker_task = native_image_from_bytes_async(
+      png.data(), png.size(), NATIVE_IMAGE_CALLBACK_CONTEXT_WORKER_THREAD, OnCDecoded, &c_worker);
+  CDecodeResult c_main;
+  native_image_decode_task_t c_main_task = native_image_from_bytes_async(
+      png.data(), png.size(), NATIVE_IMAGE_CALLBACK_CONTEXT_MAIN_THREAD, OnCDecoded, &c_main);
+  CDecodeResult c_cancelled;
+  native_image_decode_task_t c_cancelled_task = native_image_from_bytes_async(
+      png.data(), png.size(), NATIVE_IMAGE_CALLBACK_CONTEXT_MAIN_THREAD, OnCDecoded,
+      &c_cancelled);
+  if (!c_worker_task || !c_main_task || !c_cancelled_task ||
+      !native_image_decode_task_cancel(c_cancelled_task)) {
+    std::cerr << "The C async decode API did not start or cancel a decode" << std::endl;
+    return 1;
+  }
+  const bool c_done = PumpUntil([&] { return c_main.delivered && c_worker.delivered; });
+  Settle();
+  native_image_decode_task_destroy(c_worker_task);
+  native_image_decode_task_destroy(c_main_task);
+  native_image_decode_task_destroy(c_cancelled_task);
+  if (!c_done || c_worker.width != 16 ||
+      c_worker.thread == main_thread || c_main.width != 16 || c_main.thread != main_thread) {
+    std::cerr << "The C async decode API delivered on the wrong thread" << std::endl;
+    return 1;
+  }
+  if (c_cancelled.delivered) {
+    std::cerr << "A cancelled C decode still called back" << std::endl;
+    return 1;
+  }
+
+  // Copies may be taken while another thread decodes the pixels
+  for (int round = 0; round < 20; ++round) {
+    auto shared = Image::FromBytes(png.data(), png.size());
+    std::thread decoder([shared] { shared->GetNativeObject(); });
+    for (int i = 0; i < 50; ++i) {
+      Image copy(*shared);
+      if (copy.GetSize().width != 16) {
+        decoder.join();
+        std::cerr << "A copy taken during a decode lost the image" << std::endl;
+        return 1;
+      }
+    }
+    decoder.join();
+  }
+
+  // An ICO directory that disagrees with its entry is corrected by the decode
+  std::vector<uint8_t> ico(6 + 16, 0);
+  ico[2] = 1;
+  ico[4] = 1;
+  ico[6] = 32;
+  ico[7] = 32;
+  ico[10] = 1;
+  ico[12] = 32;
+  ico[14] = static_cast<uint8_t>(png.size());
+  ico[18] = static_cast<uint8_t>(ico.size());
+  ico.insert(ico.end(), png.begin(), png.end());
+  auto icon = Image::FromBytes(ico.data(), ico.size());
+  if (!icon || icon->GetSize().width != 32) {
+    std::cerr << "FromBytes did not take the ICO directory size" << std::endl;
+    return 1;
+  }
+  if (!icon->GetNativeObject() || icon->GetSize().width != 16 || icon->GetSize().height != 8) {
+    std::cerr << "The ICO size was not taken from the decoded entry" << std::endl;
+    return 1;
+  }
+
+  // GdkPixbuf cannot write GIF, so a ".gif" path is saved as PNG data
+  const std::filesystem::path gif_path =
+      std::filesystem::temp_directory_path() / "nativeapi_image_test.gif";
+  if (!lazy->SaveToFile(gif_path.u8string())) {
+    std::cerr << "SaveToFile failed for a format the backend cannot write" << std::endl;
+    return 1;
+  }
+  std::ifstream saved(gif_path, std::ios::binary);
+  const std::vector<uint8_t> contents((std::istreambuf_iterator<char>(saved)),
+                                      std::istreambuf_iterator<char>());
+  saved.close();
+  std::filesystem::remove(gif_path);
+  const uint8_t kPngSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  if (contents.size() < sizeof(kPngSignature) ||
+      !std::equal(kPngSignature, kPngSignature + sizeof(kPngSignature), contents.begin())) {
+    std::cerr << "SaveToFile did not fall back to PNG" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
@@ -0,0 +1,97 @@
+// Measures id lookups, removals and Clear() on flat menus of 1,000 and
+// 10,000 items, plus FindItemById() through a nested submenu. Menus create
+// no GTK widgets until shown, so this runs without a display. Not part of
+// the ctest suite; run the binary directly.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/menu.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using nativeapi::Menu;
+using nativeapi::MenuItem;
+using nativeapi::MenuItemId;
+using nativeapi::MenuItemType;
+
+constexpr int kNestingDepth = 8;
+
+double Milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::vector<MenuItemId> Fill(Menu& menu, int item_count) {
+  std::vector<MenuItemId> ids;
+  ids.reserve(item_count);
+  for (int i = 0; i < item_count; ++i) {
+    auto item = std::make_shared<MenuItem>("Item " + std::to_string(i), MenuItemType::Normal);
+    menu.AddItem(item);
+    ids.push_back(item->GetId());
+  }
+  return ids;
+}
+
+void Run(int item_count) {
+  Menu menu;
+  auto start = Clock::now();
+  const std::vector<MenuItemId> ids = Fill(menu, item_count);
+  const double build_ms = Milliseconds(Clock::now() - start);
+
+  start = Clock::now();
+  size_t found = 0;
+  for (MenuItemId id : ids) {
+    found += menu.GetItemById(id) ? 1 : 0;
+  }
+  const double lookup_ms = Milliseconds(Clock::now() - start);
+
+  // The items hang off the deepest of a chain of submenus
+  Menu root;
+  std::shared_ptr<Menu> parent;
+  for (int depth = 0; depth < kNestingDepth; ++depth) {
+    auto submenu = std::make_shared<Menu>();
+    auto item = std::make_shared<MenuItem>("Level " + std::to_string(depth), MenuItemType::Submenu);
+    item->SetSubmenu(submenu);
+    (parent ? *parent : root).AddItem(item);
+    parent = submenu;
+  }
+  const std::vector<MenuItemId> nested_ids = Fill(*parent, item_count);
+  start = Clock::now();
+  for (MenuItemId id : nested_ids) {
+    found += root.FindItemById(id) ? 1 : 0;
+  }
+  const double find_ms = Milliseconds(Clock::now() - start);
+
+  // Every other item, so each removal shifts the rest of the menu
+  start = Clock::now();
+  for (size_t i = 0; i < ids.size(); i += 2) {
+    menu.RemoveItemById(ids[i]);
+  }
+  const double remove_ms = Milliseconds(Clock::now() - start);
+
+  start = Clock::now();
+  parent->Clear();
+  const double clear_ms = Milliseconds(Clock::now() - start);
+
+  if (found != ids.size() + nested_ids.size()) {
+    std::cerr << "Lookups missed " << ids.size() + nested_ids.size() - found << " items"
+              << std::endl;
+  }
+  std::cout << item_count << " items: build " << build_ms << " ms, GetItemById " << lookup_ms
+            << " ms, FindItemById (depth " << kNestingDepth << ") " << find_ms
+            << " ms, RemoveItemById x" << (ids.size() + 1) / 2 << " " << remove_ms
+            << " ms, Clear " << clear_ms << " ms" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+  for (int item_count : {1000, 10000}) {
+    Run(item_count);
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include <cstring>
+#include <iostream>
+
+#include "../src/capi/menu_c.h"
+#include "../src/capi/string_utils_c.h"
+
+namespace {
+
+native_menu_item_desc_t Item(int32_t parent, native_menu_item_type_t type, uint32_t label) {
+  native_menu_item_desc_t desc = {};
+  desc.parent = parent;
+  desc.type = type;
+  desc.label = label;
+  desc.tooltip = NATIVE_MENU_NO_STRING;
+  desc.accelerator_key = NATIVE_MENU_NO_STRING;
+  desc.radio_group = -1;
+  desc.enabled = true;
+  return desc;
+}
+
+int RunTests() {
+  // Offsets:             0     5     10 12      19     25
+  const char strings[] = "File\0Open\0O\0Recent\0a.txt\0Quit";
+  native_menu_item_desc_t items[] = {
+      Item(-1, NATIVE_MENU_ITEM_TYPE_SUBMENU, 0),  Item(0, NATIVE_MENU_ITEM_TYPE_NORMAL, 5),
+      Item(0, NATIVE_MENU_ITEM_TYPE_NORMAL, 12),   Item(2, NATIVE_MENU_ITEM_TYPE_CHECKBOX, 19),
+      Item(-1, NATIVE_MENU_ITEM_TYPE_NORMAL, 25),
+  };
+  items[1].accelerator_key = 10;
+  items[1].accelerator_modifiers = NATIVE_ACCELERATOR_MODIFIER_CTRL;
+  items[3].state = NATIVE_MENU_ITEM_STATE_CHECKED;
+  items[4].enabled = false;
+  const size_t count = sizeof(items) / sizeof(items[0]);
+
+  native_menu_item_t handles[count] = {};
+  native_menu_t menu = native_menu_build(items, count, strings, sizeof(strings), handles);
+  if (!menu) {
+    std::cerr << "native_menu_build failed" << std::endl;
+    return 1;
+  }
+
+  // Children went into submenus, created for submenu items and for parents
+  native_menu_t file = native_menu_item_get_submenu(handles[0]);
+  native_menu_t recent = native_menu_item_get_submenu(handles[2]);
+  if (native_menu_get_item_count(menu) != 2 || !file || native_menu_get_item_count(file) != 2 ||
+      !recent || native_menu_get_item_at(recent, 0) != handles[3]) {
+    std::cerr << "The tree was built with the wrong shape" << std::endl;
+    return 1;
+  }
+
+  char* label = native_menu_item_get_label(handles[3]);
+  native_keyboard_accelerator_t accelerator = {};
+  const bool properties_set =
+      label && std::strcmp(label, "a.txt") == 0 &&
+      native_menu_item_get_state(handles[3]) == NATIVE_MENU_ITEM_STATE_CHECKED &&
+      !native_menu_item_is_enabled(handles[4]) &&
+      native_menu_item_get_accelerator(handles[1], &accelerator) &&
+      std::strcmp(accelerator.key, "O") == 0 &&
+      accelerator.modifiers == NATIVE_ACCELERATOR_MODIFIER_CTRL;
+  free_c_str(label);
+  if (!properties_set) {
+    std::cerr << "Descriptor properties were not applied" << std::endl;
+    return 1;
+  }
+
+  // Invalid descriptors are rejected before anything is created
+  native_menu_item_t rejected[count] = {};
+  items[3].parent = 3;
+  if (native_menu_build(items, count, strings, sizeof(strings), rejected)) {
+    std::cerr << "A parent that is not earlier in the array was accepted" << std::endl;
+    return 1;
+  }
+  items[3].parent = 2;
+  items[4].label = sizeof(strings);
+  if (native_menu_build(items, count, strings, sizeof(strings), rejected)) {
+    std::cerr << "A string offset outside the buffer was accepted" << std::endl;
+    return 1;
+  }
+
+  // A snapshot rebuilds the tree in a menu that owns its items
+  uint8_t* snapshot = nullptr;
+  size_t snapshot_size = 0;
+  if (!native_menu_serialize(menu, &snapshot, &snapshot_size)) {
+    std::cerr << "native_menu_serialize failed" << std::endl;
+    return 1;
+  }
+  native_menu_t restored = native_menu_deserialize(snapshot, snapshot_size);
+  const bool truncated_accepted = native_menu_deserialize(snapshot, snapshot_size / 2) != nullptr;
+  native_menu_snapshot_free(snapshot);
+  native_menu_t restored_file =
+      restored ? native_menu_item_get_submenu(native_menu_get_item_at(restored, 0)) : nullptr;
+  if (!restored || native_menu_get_item_count(restored) != 2 || !restored_file ||
+      native_menu_get_item_count(restored_file) != 2 || truncated_accepted) {
+    std::cerr << "A snapshot did not restore the menu" << std::endl;
+    return 1;
+  }
+  native_menu_destroy(restored);
+
+  // A submenu cycle cannot be saved
+  native_menu_t loop = native_menu_create();
+  native_menu_item_t back = native_menu_item_create("Back", NATIVE_MENU_ITEM_TYPE_SUBMENU);
+  native_menu_add_item(loop, back);
+  native_menu_item_set_submenu(back, loop);
+  uint8_t* loop_snapshot = nullptr;
+  size_t loop_snapshot_size = 0;
+  const bool cycle_saved = native_menu_serialize(loop, &loop_snapshot, &loop_snapshot_size);
+  native_menu_item_set_submenu(back, nullptr);
+  native_menu_destroy(loop);
+  native_menu_item_destroy(back);
+  if (cycle_saved || loop_snapshot) {
+    std::cerr << "native_menu_serialize saved a submenu cycle" << std::endl;
+    return 1;
+  }
+
+  // Listeners are removed once, and only from the handle they were added to
+  native_menu_item_event_callback_t on_item_event = [](const void*, void*) {};
+  const int quit_listener = native_menu_item_add_listener(
+      handles[4], NATIVE_MENU_ITEM_EVENT_CLICKED, on_item_event, nullptr);
+  const int open_listener = native_menu_item_add_listener(
+      handles[1], NATIVE_MENU_ITEM_EVENT_CLICKED, on_item_event, nullptr);
+  if (quit_listener < 0 || native_menu_item_remove_listener(handles[1], quit_listener + 100) ||
+      !native_menu_item_remove_listener(handles[4], quit_listener) ||
+      native_menu_item_remove_listener(handles[4], quit_listener) ||
+      !native_menu_item_remove_listener(handles[1], open_listener)) {
+    std::cerr << "Listener removal did not match the registrations" << std::endl;
+    return 1;
+  }
+
+  // Listeners of a submenu go away with the item that owns it, and their ids
+  // are not removed from whatever later lives at the submenu's address
+  native_menu_event_callback_t on_menu_event = [](const void*, void*) {};
+  const int opened_listener =
+      native_menu_add_listener(recent, NATIVE_MENU_EVENT_OPENED, on_menu_event, nullptr);
+  const int closed_listener =
+      native_menu_add_listener(recent, NATIVE_MENU_EVENT_CLOSED, on_menu_event, nullptr);
+  if (opened_listener < 0 || closed_listener < 0 ||
+      !native_menu_remove_listener(recent, opened_listener)) {
+    std::cerr << "Submenu listeners were not registered" << std::endl;
+    return 1;
+  }
+  native_menu_item_set_submenu(handles[2], nullptr);
+  if (native_menu_item_get_submenu(handles[2]) ||
+      native_menu_remove_listener(recent, closed_listener)) {
+    std::cerr << "Listeners of a released submenu outlived it" << std::endl;
+    return 1;
+  }
+
+  // Items may be destroyed before the menus that contain them
+  native_menu_item_destroy_many(handles, count);
+  native_menu_destroy(menu);
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/menu.h"
+#include "../src/menu_model.h"
+
+namespace {
+
+using nativeapi::Menu;
+using nativeapi::MenuApplyStats;
+using nativeapi::MenuItemDescriptor;
+using nativeapi::MenuItemId;
+using nativeapi::MenuItemState;
+using nativeapi::MenuItemType;
+using nativeapi::MenuModel;
+
+MenuItemDescriptor Item(const std::string& key, const std::string& label) {
+  MenuItemDescriptor descriptor;
+  descriptor.key = key;
+  descriptor.label = label;
+  return descriptor;
+}
+
+std::vector<std::string> Labels(const Menu& menu) {
+  std::vector<std::string> labels;
+  for (const auto& item : menu.GetAllItems()) {
+    labels.push_back(item->GetLabel().value_or(""));
+  }
+  return labels;
+}
+
+bool Expect(const MenuApplyStats& stats,
+            size_t inserted,
+            size_t removed,
+            size_t moved,
+            size_t updated,
+            const char* what) {
+  if (stats.inserted != inserted || stats.removed != removed || stats.moved != moved ||
+      stats.updated != updated) {
+    std::cerr << what << ": got " << stats.inserted << " inserted, " << stats.removed
+              << " removed, " << stats.moved << " moved, " << stats.updated << " updated"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int RunTests() {
+  Menu menu;
+  MenuModel model({Item("a", "A"), Item("b", "B"), Item("c", "C")});
+  if (!Expect(menu.Apply(model), 3, 0, 0, 0, "Initial apply") ||
+      Labels(menu) != std::vector<std::string>{"A", "B", "C"}) {
+    return 1;
+  }
+  const MenuItemId a_id = menu.GetItemAt(0)->GetId();
+
+  // Applying an equal model is free
+  if (!Expect(menu.Apply(MenuModel(model.GetItems())), 0, 0, 0, 0, "Unchanged apply")) {
+    return 1;
+  }
+
+  // A changed label is one setter call on the same item
+  if (!Expect(menu.Apply(MenuModel({Item("a", "A2"), Item("b", "B"), Item("c", "C")})), 0, 0, 0,
+              1, "Label change") ||
+      menu.GetItemAt(0)->GetId() != a_id || menu.GetItemAt(0)->GetLabel() != "A2") {
+    return 1;
+  }
+
+  // Rotating the items moves only the one that is out of order
+  if (!Expect(menu.Apply(MenuModel({Item("c", "C"), Item("a", "A2"), Item("b", "B")})), 0, 0, 1,
+              0, "Rotation") ||
+      Labels(menu) != std::vector<std::string>{"C", "A2", "B"} ||
+      menu.GetItemAt(1)->GetId() != a_id) {
+    std::cerr << "Rotation produced the wrong order" << std::endl;
+    return 1;
+  }
+
+  // Removal and insertion in one pass
+  if (!Expect(menu.Apply(MenuModel({Item("c", "C"), Item("d", "D"), Item("a", "A2")})), 1, 1, 0,
+              0, "Replace") ||
+      Labels(menu) != std::vector<std::string>{"C", "D", "A2"}) {
+    std::cerr << "Replace produced the wrong order" << std::endl;
+    return 1;
+  }
+
+  // A changed type needs a new item
+  MenuItemDescriptor check = Item("d", "D");
+  check.type = MenuItemType::Checkbox;
+  check.state = MenuItemState::Checked;
+  if (!Expect(menu.Apply(MenuModel({Item("c", "C"), check, Item("a", "A2")})), 1, 1, 0, 0,
+              "Type change") ||
+      menu.GetItemAt(1)->GetState() != MenuItemState::Checked) {
+    return 1;
+  }
+
+  // State is compared with the item, which clicks may have toggled
+  menu.GetItemAt(1)->SetState(MenuItemState::Unchecked);
+  if (!Expect(menu.Apply(MenuModel({Item("c", "C"), check, Item("a", "A2")})), 0, 0, 0, 1,
+              "State restore")) {
+    return 1;
+  }
+
+  // Submenus are reconciled recursively; the same model instance is skipped
+  auto recent = std::make_shared<const MenuModel>(
+      std::vector<MenuItemDescriptor>{Item("one", "One"), Item("two", "Two")});
+  MenuItemDescriptor more = Item("more", "More");
+  more.type = MenuItemType::Submenu;
+  more.submenu = recent;
+  if (!Expect(menu.Apply(MenuModel({more})), 3, 3, 0, 0, "Submenu apply")) {
+    return 1;
+  }
+  if (!Expect(menu.Apply(MenuModel({more})), 0, 0, 0, 0, "Shared submenu model")) {
+    return 1;
+  }
+  more.submenu = std::make_shared<const MenuModel>(
+      std::vector<MenuItemDescriptor>{Item("two", "Two"), Item("three", "Three")});
+  auto submenu = menu.GetItemAt(0)->GetSubmenu();
+  if (!Expect(menu.Apply(MenuModel({more})), 1, 1, 0, 0, "Submenu change") || !submenu ||
+      menu.GetItemAt(0)->GetSubmenu() != submenu ||
+      Labels(*submenu) != std::vector<std::string>{"Two", "Three"}) {
+    std::cerr << "Submenu was not reconciled in place" << std::endl;
+    return 1;
+  }
+
+  // Items added outside Apply() are removed; unkeyed items match by position
+  menu.AddSeparator();
+  MenuItemDescriptor separator;
+  separator.type = MenuItemType::Separator;
+  if (!Expect(menu.Apply(MenuModel({more, separator})), 1, 1, 0, 0, "Foreign item") ||
+      !Expect(menu.Apply(MenuModel({more, separator})), 0, 0, 0, 0, "Positional key")) {
+    return 1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
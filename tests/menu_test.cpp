@@ -0,0 +1,368 @@
+#include <glib.h>
+#include <gtk/gtk.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/menu.h"
+
+namespace {
+
+using nativeapi::KeyboardAccelerator;
+using nativeapi::Menu;
+using nativeapi::MenuItem;
+using nativeapi::MenuItemClickedEvent;
+using nativeapi::MenuItemState;
+using nativeapi::MenuItemType;
+using nativeapi::MenuOpenStatus;
+using nativeapi::ModifierKey;
+using nativeapi::Placement;
+using nativeapi::PositioningStrategy;
+
+std::shared_ptr<MenuItem> AddItem(Menu& menu, const std::string& label) {
+  auto item = std::make_shared<MenuItem>(label, MenuItemType::Normal);
+  menu.AddItem(item);
+  return item;
+}
+
+int RunTests() {
+  Menu menu;
+  auto first = AddItem(menu, "First");
+  auto second = AddItem(menu, "Second");
+  auto third = AddItem(menu, "Third");
+
+  // The id index follows insertions and removals in the middle
+  auto inserted = std::make_shared<MenuItem>("Inserted", MenuItemType::Normal);
+  menu.InsertItem(1, inserted);
+  if (menu.GetItemById(third->GetId()) != third || menu.GetItemAt(1) != inserted) {
+    std::cerr << "Lookup failed after an insertion" << std::endl;
+    return 1;
+  }
+  if (!menu.RemoveItemById(first->GetId()) || menu.GetItemById(first->GetId()) ||
+      menu.GetItemById(second->GetId()) != second || menu.GetItemAt(0) != inserted) {
+    std::cerr << "Lookup failed after a removal" << std::endl;
+    return 1;
+  }
+  if (menu.RemoveItem(first) || menu.RemoveItemById(first->GetId())) {
+    std::cerr << "Removed an item that is not in the menu" << std::endl;
+    return 1;
+  }
+
+  // FindItemById searches submenus, but only of this menu's tree
+  auto more = AddItem(menu, "More");
+  auto submenu = std::make_shared<Menu>();
+  auto deeper = std::make_shared<Menu>();
+  auto nested = AddItem(*submenu, "Nested");
+  auto deepest = AddItem(*deeper, "Deepest");
+  auto level2 = AddItem(*submenu, "Level 2");
+  level2->SetSubmenu(deeper);
+  more->SetSubmenu(submenu);
+  if (menu.FindItemById(deepest->GetId()) != deepest ||
+      menu.FindItemById(nested->GetId()) != nested ||
+      submenu->FindItemById(deepest->GetId()) != deepest ||
+      deeper->FindItemById(nested->GetId()) || menu.GetItemById(nested->GetId())) {
+    std::cerr << "FindItemById did not respect the menu tree" << std::endl;
+    return 1;
+  }
+  Menu other;
+  if (other.FindItemById(deepest->GetId()) || menu.FindItemById(first->GetId())) {
+    std::cerr << "FindItemById found an item of another tree" << std::endl;
+    return 1;
+  }
+
+  // Detaching a submenu takes its items out of the tree
+  level2->SetSubmenu(nullptr);
+  if (menu.FindItemById(deepest->GetId()) || deeper->FindItemById(deepest->GetId()) != deepest) {
+    std::cerr << "FindItemById found an item of a detached submenu" << std::endl;
+    return 1;
+  }
+  submenu->RemoveItem(nested);
+  if (menu.FindItemById(nested->GetId())) {
+    std::cerr << "FindItemById found a removed item" << std::endl;
+    return 1;
+  }
+
+  // A submenu cycle does not keep the search going
+  auto cycle = std::make_shared<Menu>();
+  auto cycle_back = AddItem(*cycle, "Back");
+  cycle_back->SetSubmenu(cycle);
+  const bool found_in_cycle = cycle->FindItemById(first->GetId()) != nullptr;
+  cycle_back->SetSubmenu(nullptr);
+  if (found_in_cycle) {
+    std::cerr << "FindItemById found an item outside a submenu cycle" << std::endl;
+    return 1;
+  }
+
+  menu.Clear();
+  if (menu.GetItemCount() != 0 || menu.GetItemById(second->GetId()) ||
+      menu.FindItemById(level2->GetId())) {
+    std::cerr << "Clear left items behind" << std::endl;
+    return 1;
+  }
+  menu.AddItem(second);
+  if (menu.GetItemById(second->GetId()) != second) {
+    std::cerr << "Lookup failed after Clear" << std::endl;
+    return 1;
+  }
+
+  // Checking a radio item unchecks the other one of its group, and groups
+  // are scoped to their menu
+  Menu view;
+  Menu sort;
+  std::vector<std::shared_ptr<MenuItem>> radios;
+  for (Menu* owner : {&view, &view, &view, &sort}) {
+    radios.push_back(std::make_shared<MenuItem>("Radio", MenuItemType::Radio));
+    radios.back()->SetRadioGroup(1);
+    owner->AddItem(radios.back());
+  }
+  radios[0]->SetState(MenuItemState::Checked);
+  radios[3]->SetState(MenuItemState::Checked);
+  radios[1]->SetState(MenuItemState::Checked);
+  if (radios[0]->GetState() != MenuItemState::Unchecked ||
+      radios[3]->GetState() != MenuItemState::Checked || view.GetCheckedRadioItem(1) != radios[1] ||
+      sort.GetCheckedRadioItem(1) != radios[3]) {
+    std::cerr << "Checking a radio item did not flip its group" << std::endl;
+    return 1;
+  }
+  radios[2]->SetRadioGroup(2);
+  radios[2]->SetState(MenuItemState::Checked);
+  view.RemoveItem(radios[1]);
+  if (radios[1]->GetState() != MenuItemState::Checked || view.GetCheckedRadioItem(1) ||
+      view.GetCheckedRadioItem(2) != radios[2]) {
+    std::cerr << "The radio groups did not follow the menu's items" << std::endl;
+    return 1;
+  }
+
+  // A snapshot restores the whole tree; a malformed one changes nothing
+  auto save = AddItem(view, "Save");
+  save->SetAccelerator(KeyboardAccelerator("S", ModifierKey::Ctrl));
+  save->SetEnabled(false);
+  auto options = AddItem(view, "Options");
+  options->SetSubmenu(std::make_shared<Menu>());
+  options->GetSubmenu()->AddItem(radios[1]);
+  const std::vector<uint8_t> snapshot = view.Serialize();
+  Menu restored;
+  AddItem(restored, "Stale");
+  if (!restored.Deserialize(snapshot.data(), snapshot.size()) ||
+      restored.GetItemCount() != view.GetItemCount() || restored.Serialize() != snapshot) {
+    std::cerr << "A snapshot did not restore the menu" << std::endl;
+    return 1;
+  }
+  auto restored_save = restored.GetItemAt(2);
+  auto restored_radio = restored.GetItemAt(3)->GetSubmenu()->GetItemAt(0);
+  if (restored_save->GetLabel() != "Save" || restored_save->IsEnabled() ||
+      restored_save->GetAccelerator() != save->GetAccelerator() ||
+      restored_radio->GetState() != MenuItemState::Checked ||
+      restored_radio->GetRadioGroup() != 1 || !restored.GetCheckedRadioItem(2)) {
+    std::cerr << "A snapshot lost item properties" << std::endl;
+    return 1;
+  }
+  if (restored.Deserialize(snapshot.data(), snapshot.size() - 1) ||
+      restored.GetItemCount() != view.GetItemCount()) {
+    std::cerr << "A truncated snapshot was accepted" << std::endl;
+    return 1;
+  }
+
+  // Trees nested deeper than a snapshot can hold, cycles included, are not
+  // saved
+  Menu tower;
+  Menu* level = &tower;
+  for (int depth = 0; depth < 64; ++depth) {
+    auto parent = AddItem(*level, "Level");
+    parent->SetSubmenu(std::make_shared<Menu>());
+    level = parent->GetSubmenu().get();
+  }
+  const std::vector<uint8_t> tower_snapshot = tower.Serialize();
+  AddItem(*level, "Too deep")->SetSubmenu(std::make_shared<Menu>());
+  if (tower_snapshot.empty() ||
+      !restored.Deserialize(tower_snapshot.data(), tower_snapshot.size()) ||
+      !tower.Serialize().empty()) {
+    std::cerr << "The snapshot depth limit was not applied" << std::endl;
+    return 1;
+  }
+  auto loop = std::make_shared<Menu>();
+  auto back = AddItem(*loop, "Back");
+  back->SetSubmenu(loop);
+  const bool cycle_saved = !loop->Serialize().empty();
+  back->SetSubmenu(nullptr);
+  if (cycle_saved) {
+    std::cerr << "A submenu cycle was saved" << std::endl;
+    return 1;
+  }
+
+  // Accelerators reach items anywhere in the tree, and only in that tree
+  Menu app;
+  auto edit = AddItem(app, "Edit");
+  edit->SetSubmenu(std::make_shared<Menu>());
+  auto copy = AddItem(*edit->GetSubmenu(), "Copy");
+  auto wrap = std::make_shared<MenuItem>("Word Wrap", MenuItemType::Checkbox);
+  edit->GetSubmenu()->AddItem(wrap);
+  copy->SetAccelerator(KeyboardAccelerator("c", ModifierKey::Ctrl));
+  wrap->SetAccelerator(KeyboardAccelerator("W", ModifierKey::Alt));
+  int copies = 0;
+  copy->AddListener<MenuItemClickedEvent>([&copies](const MenuItemClickedEvent&) { ++copies; });
+  if (!app.DispatchAccelerator(
+          KeyboardAccelerator("C", ModifierKey::Ctrl | ModifierKey::CapsLock)) ||
+      !app.DispatchAccelerator(KeyboardAccelerator("W", ModifierKey::Alt)) || copies != 1 ||
+      wrap->GetState() != MenuItemState::Checked ||
+      app.DispatchAccelerator(KeyboardAccelerator("C", ModifierKey::Alt)) ||
+      view.DispatchAccelerator(KeyboardAccelerator("C", ModifierKey::Ctrl))) {
+    std::cerr << "An accelerator did not activate its item" << std::endl;
+    return 1;
+  }
+  copy->SetAccelerator(KeyboardAccelerator("Insert", ModifierKey::Ctrl));
+  wrap->SetEnabled(false);
+  if (app.DispatchAccelerator(KeyboardAccelerator("C", ModifierKey::Ctrl)) ||
+      !app.DispatchAccelerator(KeyboardAccelerator("INSERT", ModifierKey::Ctrl)) ||
+      copies != 2 || app.DispatchAccelerator(KeyboardAccelerator("W", ModifierKey::Alt))) {
+    std::cerr << "The accelerator index did not follow the items" << std::endl;
+    return 1;
+  }
+
+  // Accelerators follow subtrees as they are attached, moved and detached
+  auto tools = std::make_shared<Menu>();
+  auto find = AddItem(*tools, "Find");
+  find->SetAccelerator(KeyboardAccelerator("F", ModifierKey::Ctrl));
+  auto search = AddItem(app, "Search");
+  search->SetSubmenu(tools);
+  if (!tools->DispatchAccelerator(KeyboardAccelerator("F", ModifierKey::Ctrl)) ||
+      !app.DispatchAccelerator(KeyboardAccelerator("F", ModifierKey::Ctrl))) {
+    std::cerr << "An attached submenu's accelerator was not found" << std::endl;
+    return 1;
+  }
+  edit->GetSubmenu()->AddItem(search);
+  app.RemoveItem(edit);
+  search->SetSubmenu(nullptr);
+  if (app.DispatchAccelerator(KeyboardAccelerator("F", ModifierKey::Ctrl)) ||
+      app.DispatchAccelerator(KeyboardAccelerator("INSERT", ModifierKey::Ctrl)) ||
+      !tools->DispatchAccelerator(KeyboardAccelerator("F", ModifierKey::Ctrl))) {
+    std::cerr << "A detached subtree's accelerator was still found" << std::endl;
+    return 1;
+  }
+  find.reset();
+  tools->Clear();
+  if (tools->DispatchAccelerator(KeyboardAccelerator("F", ModifierKey::Ctrl))) {
+    std::cerr << "A destroyed item's accelerator was still found" << std::endl;
+    return 1;
+  }
+
+  // A virtualized menu keeps every item record and lookup
+  Menu bookmarks;
+  bookmarks.SetVirtualWindow(20);
+  std::vector<std::shared_ptr<MenuItem>> records;
+  for (int i = 0; i < 1000; ++i) {
+    records.push_back(AddItem(bookmarks, "Bookmark " + std::to_string(i)));
+  }
+  bookmarks.RemoveItemAt(0);
+  if (bookmarks.GetVirtualWindow() != 20 || bookmarks.GetItemCount() != 999 ||
+      bookmarks.GetItemAt(0) != records[1] ||
+      bookmarks.GetItemById(records[999]->GetId()) != records[999]) {
+    std::cerr << "A virtualized menu lost track of its items" << std::endl;
+    return 1;
+  }
+  bookmarks.SetVirtualWindow(0);
+  if (bookmarks.GetVirtualWindow() != 0 || bookmarks.GetItemCount() != 999) {
+    std::cerr << "Turning virtualization off changed the menu" << std::endl;
+    return 1;
+  }
+
+  // A submenu provider runs when the submenu is about to be shown, once per
+  // invalidation
+  auto recent = std::make_shared<MenuItem>("Recent", MenuItemType::Submenu);
+  int builds = 0;
+  recent->SetSubmenuProvider([&builds](Menu& submenu) {
+    ++builds;
+    submenu.Clear();
+    submenu.AddItem(
+        std::make_shared<MenuItem>("File " + std::to_string(builds), MenuItemType::Normal));
+  });
+  auto provided = recent->GetSubmenu();
+  if (!provided || provided->GetItemCount() != 0 || builds != 0) {
+    std::cerr << "SetSubmenuProvider built the submenu up front" << std::endl;
+    return 1;
+  }
+  if (!recent->PrepareSubmenu() || recent->PrepareSubmenu() || builds != 1 ||
+      provided->GetItemCount() != 1) {
+    std::cerr << "The provider result was not cached" << std::endl;
+    return 1;
+  }
+  recent->InvalidateSubmenu();
+  recent->InvalidateSubmenu();
+  if (!recent->PrepareSubmenu() || builds != 2 ||
+      provided->GetItemAt(0)->GetLabel() != "File 2") {
+    std::cerr << "InvalidateSubmenu did not rebuild the submenu" << std::endl;
+    return 1;
+  }
+  recent->SetSubmenuProvider(nullptr);
+  recent->InvalidateSubmenu();
+  if (recent->PrepareSubmenu() || builds != 2 || recent->GetSubmenu() != provided) {
+    std::cerr << "The provider was not removed" << std::endl;
+    return 1;
+  }
+
+  // OpenAsync returns at once; a menu destroyed before the main loop gets
+  // to the request reports Failed without being touched
+  std::vector<MenuOpenStatus> statuses;
+  auto doomed = std::make_unique<Menu>();
+  doomed->OpenAsync(PositioningStrategy::CursorPosition(), Placement::BottomStart,
+                    [&statuses](MenuOpenStatus status) { statuses.push_back(status); });
+  doomed.reset();
+  if (!statuses.empty()) {
+    std::cerr << "OpenAsync reported before the main loop ran" << std::endl;
+    return 1;
+  }
+  while (g_main_context_iteration(nullptr, FALSE)) {
+  }
+  if (statuses != std::vector<MenuOpenStatus>{MenuOpenStatus::Failed}) {
+    std::cerr << "OpenAsync on a destroyed menu did not report Failed" << std::endl;
+    return 1;
+  }
+
+  // Menus and items may be built and destroyed on several threads at once
+  std::vector<std::thread> builders;
+  for (int t = 0; t < 4; ++t) {
+    builders.emplace_back([] {
+      for (int round = 0; round < 200; ++round) {
+        Menu built;
+        AddItem(built, "Built")->SetSubmenu(std::make_shared<Menu>());
+      }
+    });
+  }
+  for (auto& builder : builders) {
+    builder.join();
+  }
+  Menu after_threads;
+  auto survivor = AddItem(after_threads, "Survivor");
+  if (after_threads.GetItemById(survivor->GetId()) != survivor) {
+    std::cerr << "Building menus on other threads broke the item lookup" << std::endl;
+    return 1;
+  }
+
+  // A menu Open() cannot show reports Failed alone. Linux has no Absolute
+  // positioning, so this exercises the refusal path whenever a display is
+  // available to create the popup on.
+  if (gtk_init_check(nullptr, nullptr)) {
+    statuses.clear();
+    Menu refused;
+    AddItem(refused, "Unshown");
+    refused.OpenAsync(PositioningStrategy::Absolute({10, 10}), Placement::BottomStart,
+                      [&statuses](MenuOpenStatus status) { statuses.push_back(status); });
+    while (g_main_context_iteration(nullptr, FALSE)) {
+    }
+    if (statuses != std::vector<MenuOpenStatus>{MenuOpenStatus::Failed}) {
+      std::cerr << "OpenAsync on a menu that could not be shown did not report Failed"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
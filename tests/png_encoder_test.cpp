@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/foundation/png_encoder.h"
+
+namespace {
+
+using nativeapi::PngEncodeMode;
+using nativeapi::PngEncoder;
+
+struct Chunk {
+  std::string type;
+  std::vector<uint8_t> data;
+};
+
+uint32_t ReadBigEndian(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int k = 0; k < 8; ++k) {
+      crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+    }
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+// Splits a PNG file into chunks, checking the signature and every CRC
+bool ParseChunks(const std::vector<uint8_t>& png, std::vector<Chunk>& chunks) {
+  static const uint8_t kSignature[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+  if (png.size() < 8 || memcmp(png.data(), kSignature, 8) != 0) {
+    return false;
+  }
+  size_t offset = 8;
+  while (offset + 12 <= png.size()) {
+    const uint32_t length = ReadBigEndian(&png[offset]);
+    if (offset + 12 + length > png.size()) {
+      return false;
+    }
+    if (Crc32(&png[offset + 4], length + 4) != ReadBigEndian(&png[offset + 8 + length])) {
+      return false;
+    }
+    Chunk chunk;
+    chunk.type.assign(reinterpret_cast<const char*>(&png[offset + 4]), 4);
+    chunk.data.assign(png.begin() + offset + 8, png.begin() + offset + 8 + length);
+    chunks.push_back(std::move(chunk));
+    offset += 12 + length;
+  }
+  return offset == png.size() && !chunks.empty() && chunks.back().type == "IEND";
+}
+
+// A small reference inflater (RFC 1950 and 1951), to check the compressed
+// output of the encoder without a zlib dependency
+class Inflater {
+ public:
+  explicit Inflater(const std::vector<uint8_t>& input) : input_(input) {}
+
+  bool Run(std::vector<uint8_t>& output) {
+    if (input_.size() < 6 || (input_[0] & 0x0F) != 8 || ((input_[0] << 8) | input_[1]) % 31 != 0) {
+      return false;
+    }
+    position_ = 2;
+    bool final_block = false;
+    while (!final_block && !error_) {
+      final_block = Bits(1) != 0;
+      const uint32_t type = Bits(2);
+      if (type == 0) {
+        Stored(output);
+      } else if (type == 1) {
+        Fixed(output);
+      } else if (type == 2) {
+        Dynamic(output);
+      } else {
+        return false;
+      }
+    }
+    if (error_ || position_ + 4 > input_.size()) {
+      return false;
+    }
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (uint8_t byte : output) {
+      a = (a + byte) % 65521;
+      b = (b + a) % 65521;
+    }
+    return ReadBigEndian(&input_[position_]) == ((b << 16) | a);
+  }
+
+ private:
+  struct Huffman {
+    uint16_t count[16] = {};
+    std::vector<uint16_t> symbols;
+  };
+
+  uint32_t Bits(int n) {
+    uint32_t value = bit_buffer_;
+    while (bit_count_ < n) {
+      if (position_ >= input_.size()) {
+        error_ = true;
+        return 0;
+      }
+      value |= static_cast<uint32_t>(input_[position_++]) << bit_count_;
+      bit_count_ += 8;
+    }
+    bit_buffer_ = value >> n;
+    bit_count_ -= n;
+    return value & ((1u << n) - 1);
+  }
+
+  static bool Build(Huffman& huffman, const uint8_t* lengths, int n) {
+    huffman.symbols.assign(n, 0);
+    for (int symbol = 0; symbol < n; ++symbol) {
+      ++huffman.count[lengths[symbol]];
+    }
+    int left = 1;
+    for (int length = 1; length < 16; ++length) {
+      left = (left << 1) - huffman.count[length];
+      if (left < 0) {
+        return false;  // over-subscribed
+      }
+    }
+    uint16_t offsets[16] = {};
+    for (int length = 1; length < 15; ++length) {
+      offsets[length + 1] = offsets[length] + huffman.count[length];
+    }
+    for (int symbol = 0; symbol < n; ++symbol) {
+      if (lengths[symbol] != 0) {
+        huffman.symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+      }
+    }
+    return true;
+  }
+
+  int Decode(const Huffman& huffman) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length < 16 && !error_; ++length) {
+      code |= static_cast<int>(Bits(1));
+      const int count = huffman.count[length];
+      if (code - count < first) {
+        return huffman.symbols[index + (code - first)];
+      }
+      index += count;
+      first = (first + count) << 1;
+      code <<= 1;
+    }
+    error_ = true;
+    return -1;
+  }
+
+  void Stored(std::vector<uint8_t>& output) {
+    bit_buffer_ = 0;
+    bit_count_ = 0;
+    if (position_ + 4 > input_.size()) {
+      error_ = true;
+      return;
+    }
+    const size_t length = input_[position_] | (input_[position_ + 1] << 8);
+    const size_t inverse = input_[position_ + 2] | (input_[position_ + 3] << 8);
+    position_ += 4;
+    if ((length ^ 0xFFFF) != inverse || position_ + length > input_.size()) {
+      error_ = true;
+      return;
+    }
+    output.insert(output.end(), input_.begin() + position_, input_.begin() + position_ + length);
+    position_ += length;
+  }
+
+  void Fixed(std::vector<uint8_t>& output) {
+    uint8_t lengths[288 + 30];
+    std::fill(lengths, lengths + 144, 8);
+    std::fill(lengths + 144, lengths + 256, 9);
+    std::fill(lengths + 256, lengths + 280, 7);
+    std::fill(lengths + 280, lengths + 288, 8);
+    std::fill(lengths + 288, lengths + 318, 5);
+    Huffman literals;
+    Huffman distances;
+    Build(literals, lengths, 288);
+    Build(distances, lengths + 288, 30);
+    Codes(literals, distances, output);
+  }
+
+  void Dynamic(std::vector<uint8_t>& output) {
+    static const uint8_t kOrder[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                       11, 4,  12, 3, 13, 2, 14, 1, 15};
+    const int literal_count = static_cast<int>(Bits(5)) + 257;
+    const int distance_count = static_cast<int>(Bits(5)) + 1;
+    const int code_count = static_cast<int>(Bits(4)) + 4;
+    uint8_t lengths[320] = {};
+    for (int i = 0; i < code_count; ++i) {
+      lengths[kOrder[i]] = static_cast<uint8_t>(Bits(3));
+    }
+    Huffman code_lengths;
+    if (!Build(code_lengths, lengths, 19)) {
+      error_ = true;
+      return;
+    }
+    const int total = literal_count + distance_count;
+    for (int i = 0; i < total && !error_;) {
+      const int symbol = Decode(code_lengths);
+      if (symbol < 16) {
+        lengths[i++] = static_cast<uint8_t>(symbol);
+        continue;
+      }
+      uint8_t value = 0;
+      int repeat = 0;
+      if (symbol == 16) {
+        if (i == 0) {
+          error_ = true;
+          return;
+        }
+        value = lengths[i - 1];
+        repeat = 3 + static_cast<int>(Bits(2));
+      } else if (symbol == 17) {
+        repeat = 3 + static_cast<int>(Bits(3));
+      } else {
+        repeat = 11 + static_cast<int>(Bits(7));
+      }
+      if (i + repeat > total) {
+        error_ = true;
+        return;
+      }
+      std::fill(lengths + i, lengths + i + repeat, value);
+      i += repeat;
+    }
+    Huffman literals;
+    Huffman distances;
+    if (error_ || !Build(literals, lengths, literal_count) ||
+        !Build(distances, lengths + literal_count, distance_count)) {
+      error_ = true;
+      return;
+    }
+    Codes(literals, distances, output);
+  }
+
+  void Codes(const Huffman& literals, const Huffman& distances, std::vector<uint8_t>& output) {
+    static const uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                             15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                             67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                             2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t kDistanceBase[30] = {
+        1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+        193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                               6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    while (!error_) {
+      int symbol = Decode(literals);
+      if (symbol < 256) {
+        if (symbol >= 0) {
+          output.push_back(static_cast<uint8_t>(symbol));
+        }
+        continue;
+      }
+      symbol -= 257;
+      if (symbol < 0) {
+        return;  // end of block
+      }
+      if (symbol >= 29) {
+        error_ = true;
+        return;
+      }
+      const size_t length = kLengthBase[symbol] + Bits(kLengthExtra[symbol]);
+      const int distance_symbol = Decode(distances);
+      if (distance_symbol < 0 || distance_symbol >= 30) {
+        error_ = true;
+        return;
+      }
+      const size_t distance =
+          kDistanceBase[distance_symbol] + Bits(kDistanceExtra[distance_symbol]);
+      if (distance > output.size()) {
+        error_ = true;
+        return;
+      }
+      for (size_t i = 0; i < length; ++i) {
+        output.push_back(output[output.size() - distance]);
+      }
+    }
+  }
+
+  const std::vector<uint8_t>& input_;
+  size_t position_ = 0;
+  uint32_t bit_buffer_ = 0;
+  int bit_count_ = 0;
+  bool error_ = false;
+};
+
+// Inflates the IDAT chunks and undoes the row filters of an 8-bit RGBA image
+bool DecodePixels(const std::vector<Chunk>& chunks,
+                  int width,
+                  int height,
+                  std::vector<uint8_t>& pixels) {
+  std::vector<uint8_t> zlib;
+  for (const Chunk& chunk : chunks) {
+    if (chunk.type == "IDAT") {
+      zlib.insert(zlib.end(), chunk.data.begin(), chunk.data.end());
+    }
+  }
+  std::vector<uint8_t> filtered;
+  const size_t row_bytes = static_cast<size_t>(width) * 4;
+  if (!Inflater(zlib).Run(filtered) || filtered.size() != (row_bytes + 1) * height) {
+    return false;
+  }
+  pixels.assign(row_bytes * height, 0);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* in = &filtered[y * (row_bytes + 1)];
+    uint8_t* row = &pixels[y * row_bytes];
+    const uint8_t* previous = y > 0 ? row - row_bytes : nullptr;
+    for (size_t i = 0; i < row_bytes; ++i) {
+      const int a = i >= 4 ? row[i - 4] : 0;
+      const int b = previous ? previous[i] : 0;
+      const int c = previous && i >= 4 ? previous[i - 4] : 0;
+      int predictor = 0;
+      switch (in[0]) {
+        case 0:
+          break;
+        case 1:
+          predictor = a;
+          break;
+        case 2:
+          predictor = b;
+          break;
+        case 3:
+          predictor = (a + b) / 2;
+          break;
+        case 4: {
+          const int p = a + b - c;
+          const int pa = std::abs(p - a);
+          const int pb = std::abs(p - b);
+          const int pc = std::abs(p - c);
+          predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+          break;
+        }
+        default:
+          return false;
+      }
+      row[i] = static_cast<uint8_t>(in[1 + i] + predictor);
+    }
+  }
+  return true;
+}
+
+bool Encode(const std::vector<uint8_t>& pixels,
+            int width,
+            int height,
+            PngEncodeMode mode,
+            std::vector<uint8_t>& png) {
+  png.clear();
+  return PngEncoder::Encode(pixels.data(), width, height, static_cast<size_t>(width) * 4, mode,
+                            [&png](const uint8_t* data, size_t size) {
+                              png.insert(png.end(), data, data + size);
+                              return true;
+                            });
+}
+
+int RunTests() {
+  const int width = 150;
+  const int height = 120;
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint8_t* p = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+      p[0] = static_cast<uint8_t>(x * 7 + y);
+      p[1] = static_cast<uint8_t>(y * 3);
+      p[2] = static_cast<uint8_t>(x ^ y);
+      p[3] = static_cast<uint8_t>(x < width / 2 ? 255 : 40);
+    }
+  }
+
+  // Store mode: the zlib stream is made of stored blocks that must contain
+  // the unfiltered rows verbatim
+  {
+    std::vector<uint8_t> png;
+    std::vector<Chunk> chunks;
+    if (!Encode(pixels, width, height, PngEncodeMode::Store, png) || !ParseChunks(png, chunks)) {
+      std::cerr << "Store mode produced an invalid file" << std::endl;
+      return 1;
+    }
+    if (chunks[0].type != "IHDR" || ReadBigEndian(chunks[0].data.data()) != width ||
+        ReadBigEndian(chunks[0].data.data() + 4) != height || chunks[0].data[9] != 6) {
+      std::cerr << "Unexpected IHDR" << std::endl;
+      return 1;
+    }
+
+    std::vector<uint8_t> zlib;
+    for (const Chunk& chunk : chunks) {
+      if (chunk.type == "IDAT") {
+        zlib.insert(zlib.end(), chunk.data.begin(), chunk.data.end());
+      }
+    }
+    std::vector<uint8_t> inflated;
+    size_t offset = 2;
+    bool final_block = false;
+    while (!final_block && offset + 5 <= zlib.size()) {
+      final_block = (zlib[offset] & 1) != 0;
+      const size_t length = zlib[offset + 1] | (zlib[offset + 2] << 8);
+      const size_t inverse = zlib[offset + 3] | (zlib[offset + 4] << 8);
+      if ((length ^ 0xFFFF) != inverse) {
+        std::cerr << "Corrupt stored block header" << std::endl;
+        return 1;
+      }
+      inflated.insert(inflated.end(), zlib.begin() + offset + 5,
+                      zlib.begin() + offset + 5 + length);
+      offset += 5 + length;
+    }
+    const size_t row_bytes = static_cast<size_t>(width) * 4;
+    if (!final_block || inflated.size() != (row_bytes + 1) * height) {
+      std::cerr << "Stored stream has the wrong size" << std::endl;
+      return 1;
+    }
+    for (int y = 0; y < height; ++y) {
+      const uint8_t* row = &inflated[y * (row_bytes + 1)];
+      if (row[0] != 0 || memcmp(row + 1, &pixels[y * row_bytes], row_bytes) != 0) {
+        std::cerr << "Stored row " << y << " does not match the source" << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  // Fast mode: valid framing, the compressed rows inflate back to the
+  // source pixels, and flat images compress well
+  {
+    std::vector<uint8_t> png;
+    std::vector<Chunk> chunks;
+    if (!Encode(pixels, width, height, PngEncodeMode::Fast, png) || !ParseChunks(png, chunks)) {
+      std::cerr << "Fast mode produced an invalid file" << std::endl;
+      return 1;
+    }
+    std::vector<uint8_t> decoded;
+    if (!DecodePixels(chunks, width, height, decoded) || decoded != pixels) {
+      std::cerr << "Fast mode output does not inflate to the source pixels" << std::endl;
+      return 1;
+    }
+
+    std::vector<uint8_t> flat(static_cast<size_t>(64) * 64 * 4, 0x80);
+    chunks.clear();
+    if (!Encode(flat, 64, 64, PngEncodeMode::Fast, png) || !ParseChunks(png, chunks) ||
+        png.size() > flat.size() / 20) {
+      std::cerr << "Fast mode did not compress a flat image: " << png.size() << " bytes"
+                << std::endl;
+      return 1;
+    }
+    if (!DecodePixels(chunks, 64, 64, decoded) || decoded != flat) {
+      std::cerr << "Fast mode output of a flat image does not inflate back" << std::endl;
+      return 1;
+    }
+  }
+
+  // A sink returning false aborts encoding
+  {
+    int calls = 0;
+    bool result = PngEncoder::Encode(pixels.data(), width, height, width * 4,
+                                     PngEncodeMode::Store, [&calls](const uint8_t*, size_t) {
+                                       ++calls;
+                                       return false;
+                                     });
+    if (result || calls != 1) {
+      std::cerr << "Aborting sink was not honored" << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  return RunTests();
+}
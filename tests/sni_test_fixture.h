@@ -0,0 +1,346 @@
+// Shared fixture for the Linux tray and dbusmenu tests and benchmarks: a
+// private dbus-daemon, an in-process StatusNotifierWatcher and a host-side
+// client that reads properties, fetches layouts and sends events the way a
+// panel does. Everything runs on the default GLib main context, so the code
+// under test answers calls while the fixture waits for replies.
+
+#pragma once
+
+#include <gio/gio.h>
+#include <signal.h>
+#include <unistd.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sni_test {
+
+// ctest treats this exit code as "skipped" (see tests/CMakeLists.txt)
+constexpr int kSkipped = 77;
+
+// Iterates the default main context until |done| returns true or the
+// timeout expires
+inline bool RunUntil(const std::function<bool()>& done, guint timeout_ms = 5000) {
+  bool timed_out = false;
+  const guint timer = g_timeout_add(
+      timeout_ms,
+      [](gpointer user_data) -> gboolean {
+        *static_cast<bool*>(user_data) = true;
+        return G_SOURCE_REMOVE;
+      },
+      &timed_out);
+  while (!done() && !timed_out) {
+    g_main_context_iteration(nullptr, TRUE);
+  }
+  if (!timed_out) {
+    g_source_remove(timer);
+  }
+  return done();
+}
+
+inline GDBusConnection* Connect(const std::string& address) {
+  return g_dbus_connection_new_for_address_sync(
+      address.c_str(),
+      static_cast<GDBusConnectionFlags>(G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                        G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+      nullptr, nullptr, nullptr);
+}
+
+// Where a registered item lives. RegisterStatusNotifierItem takes either a
+// bus name, with the item at /StatusNotifierItem, or an object path on the
+// caller's connection; this resolves it the way KDE's watcher does.
+struct ItemAddress {
+  std::string bus_name;
+  std::string object_path;
+};
+
+// A `dbus-daemon --session` private to this process. Start() exports its
+// address as DBUS_SESSION_BUS_ADDRESS, so it must run before anything
+// connects to the session bus.
+class PrivateBus {
+ public:
+  ~PrivateBus() {
+    if (pid_ > 0) {
+      kill(pid_, SIGTERM);
+      g_spawn_close_pid(pid_);
+    }
+  }
+
+  bool Start() {
+    const gchar* argv[] = {"dbus-daemon", "--session", "--nofork", "--print-address=1",
+                           nullptr};
+    gint stdout_fd = -1;
+    if (!g_spawn_async_with_pipes(nullptr, const_cast<gchar**>(argv), nullptr,
+                                  G_SPAWN_SEARCH_PATH, nullptr, nullptr, &pid_, nullptr,
+                                  &stdout_fd, nullptr, nullptr)) {
+      return false;
+    }
+    std::string address;
+    char c = 0;
+    while (read(stdout_fd, &c, 1) == 1 && c != '\n') {
+      address += c;
+    }
+    close(stdout_fd);
+    if (address.empty()) {
+      return false;
+    }
+    g_setenv("DBUS_SESSION_BUS_ADDRESS", address.c_str(), TRUE);
+    address_ = address;
+    return true;
+  }
+
+  const std::string& address() const { return address_; }
+
+ private:
+  GPid pid_ = 0;
+  std::string address_;
+};
+
+// Minimal org.kde.StatusNotifierWatcher on its own connection. Destroying it
+// releases the name, which looks like a panel exiting.
+class MockWatcher {
+ public:
+  explicit MockWatcher(const std::string& address) : connection_(Connect(address)) {
+    if (!connection_) {
+      return;
+    }
+
+    static const char kXml[] =
+        "<node>"
+        "  <interface name='org.kde.StatusNotifierWatcher'>"
+        "    <method name='RegisterStatusNotifierItem'>"
+        "      <arg type='s' direction='in' name='service'/>"
+        "    </method>"
+        "  </interface>"
+        "</node>";
+    static const GDBusInterfaceVTable vtable = {&MockWatcher::OnMethodCall, nullptr, nullptr};
+    GDBusNodeInfo* info = g_dbus_node_info_new_for_xml(kXml, nullptr);
+    registration_id_ = g_dbus_connection_register_object(
+        connection_, "/StatusNotifierWatcher", info->interfaces[0], &vtable, this, nullptr,
+        nullptr);
+    g_dbus_node_info_unref(info);
+
+    owner_id_ = g_bus_own_name_on_connection(
+        connection_, "org.kde.StatusNotifierWatcher", G_BUS_NAME_OWNER_FLAGS_NONE,
+        [](GDBusConnection*, const gchar*, gpointer user_data) {
+          static_cast<MockWatcher*>(user_data)->owned_ = true;
+        },
+        nullptr, this, nullptr);
+    RunUntil([this] { return owned_; });
+  }
+
+  ~MockWatcher() {
+    if (owner_id_ != 0) {
+      g_bus_unown_name(owner_id_);
+    }
+    if (connection_) {
+      g_dbus_connection_unregister_object(connection_, registration_id_);
+      g_dbus_connection_close_sync(connection_, nullptr, nullptr);
+      g_object_unref(connection_);
+    }
+  }
+
+  MockWatcher(const MockWatcher&) = delete;
+  MockWatcher& operator=(const MockWatcher&) = delete;
+
+  bool owned() const { return owned_; }
+  int registrations() const { return static_cast<int>(items_.size()); }
+  const std::vector<ItemAddress>& items() const { return items_; }
+
+  // The most recently registered item
+  ItemAddress last_item() const { return items_.empty() ? ItemAddress{} : items_.back(); }
+
+ private:
+  static void OnMethodCall(GDBusConnection*, const gchar* sender, const gchar*, const gchar*,
+                           const gchar*, GVariant* parameters,
+                           GDBusMethodInvocation* invocation, gpointer user_data) {
+    MockWatcher* self = static_cast<MockWatcher*>(user_data);
+    const gchar* service = nullptr;
+    g_variant_get(parameters, "(&s)", &service);
+    if (service[0] == '/') {
+      self->items_.push_back({sender, service});
+    } else {
+      self->items_.push_back({service, "/StatusNotifierItem"});
+    }
+    g_dbus_method_invocation_return_value(invocation, nullptr);
+  }
+
+  GDBusConnection* connection_;
+  guint registration_id_ = 0;
+  guint owner_id_ = 0;
+  bool owned_ = false;
+  std::vector<ItemAddress> items_;
+};
+
+// Host-side stand-in: calls into a StatusNotifierItem and its dbusmenu object
+// and counts the signals the watched item emits.
+class HostClient {
+ public:
+  explicit HostClient(const std::string& address) : connection_(Connect(address)) {}
+
+  ~HostClient() {
+    if (connection_) {
+      if (subscription_id_) {
+        g_dbus_connection_signal_unsubscribe(connection_, subscription_id_);
+      }
+      g_dbus_connection_close_sync(connection_, nullptr, nullptr);
+      g_object_unref(connection_);
+    }
+  }
+
+  HostClient(const HostClient&) = delete;
+  HostClient& operator=(const HostClient&) = delete;
+
+  bool connected() const { return connection_ != nullptr; }
+
+  // Counts the signals |item| emits on its own object path, as a host
+  // does; signals on any other path are not counted
+  void WatchItem(const ItemAddress& item) {
+    if (!connection_) {
+      return;
+    }
+    if (subscription_id_) {
+      g_dbus_connection_signal_unsubscribe(connection_, subscription_id_);
+    }
+    subscription_id_ = g_dbus_connection_signal_subscribe(
+        connection_, item.bus_name.c_str(), nullptr, nullptr, item.object_path.c_str(), nullptr,
+        G_DBUS_SIGNAL_FLAGS_NONE, &HostClient::OnSignal, this, nullptr);
+  }
+
+  // Calls a method and iterates the main loop until the reply arrives.
+  // Returns the reply (to be unreffed) or nullptr on error.
+  GVariant* Call(const std::string& destination,
+                 const char* path,
+                 const char* interface_name,
+                 const char* method,
+                 GVariant* params) const {
+    struct State {
+      bool done;
+      GVariant* reply;
+    } state{false, nullptr};
+
+    g_dbus_connection_call(
+        connection_, destination.c_str(), path, interface_name, method, params, nullptr,
+        G_DBUS_CALL_FLAGS_NONE, 5000, nullptr,
+        [](GObject* source, GAsyncResult* result, gpointer user_data) {
+          State* state = static_cast<State*>(user_data);
+          state->reply =
+              g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, nullptr);
+          state->done = true;
+        },
+        &state);
+    RunUntil([&state] { return state.done; }, 10000);
+    return state.reply;
+  }
+
+  // org.freedesktop.DBus.Properties.Get on the StatusNotifierItem; returns
+  // the unboxed value (to be unreffed) or nullptr
+  GVariant* GetItemProperty(const ItemAddress& item, const char* name) const {
+    GVariant* reply = Call(item.bus_name, item.object_path.c_str(),
+                           "org.freedesktop.DBus.Properties", "Get",
+                           g_variant_new("(ss)", "org.kde.StatusNotifierItem", name));
+    if (!reply) {
+      return nullptr;
+    }
+    GVariant* value = nullptr;
+    g_variant_get(reply, "(v)", &value);
+    g_variant_unref(reply);
+    return value;
+  }
+
+  // org.kde.StatusNotifierItem method call, e.g. Activate
+  GVariant* CallItem(const ItemAddress& item, const char* method, GVariant* params) const {
+    return Call(item.bus_name, item.object_path.c_str(), "org.kde.StatusNotifierItem", method,
+                params);
+  }
+
+  // Object path from the item's Menu property, or "" if it has none
+  std::string GetMenuPath(const ItemAddress& item) const {
+    GVariant* value = GetItemProperty(item, "Menu");
+    if (!value) {
+      return "";
+    }
+    std::string path = g_variant_get_string(value, nullptr);
+    g_variant_unref(value);
+    return path == "/" ? "" : path;
+  }
+
+  // com.canonical.dbusmenu call on the object at |path|
+  GVariant* CallMenu(const std::string& service,
+                     const char* path,
+                     const char* method,
+                     GVariant* params) const {
+    return Call(service, path, "com.canonical.dbusmenu", method, params);
+  }
+
+  // GetLayout(parent_id, depth, []) returning the (ia{sv}av) layout
+  GVariant* GetLayout(const std::string& service,
+                      const char* path,
+                      int parent_id = 0,
+                      int depth = -1,
+                      unsigned int* revision = nullptr) const {
+    GVariant* reply =
+        CallMenu(service, path, "GetLayout",
+                 g_variant_new("(ii@as)", parent_id, depth, g_variant_new_strv(nullptr, 0)));
+    if (!reply) {
+      return nullptr;
+    }
+    guint reply_revision = 0;
+    GVariant* layout = nullptr;
+    g_variant_get(reply, "(u@(ia{sv}av))", &reply_revision, &layout);
+    g_variant_unref(reply);
+    if (revision) {
+      *revision = reply_revision;
+    }
+    return layout;
+  }
+
+  // Sends Event(id, "clicked") and waits for the reply
+  bool Click(const std::string& service, const char* path, int id) const {
+    GVariant* reply = CallMenu(
+        service, path, "Event",
+        g_variant_new("(isvu)", id, "clicked", g_variant_new_int32(0), 0u));
+    if (!reply) {
+      return false;
+    }
+    g_variant_unref(reply);
+    return true;
+  }
+
+  // Number of signals with this member name received so far
+  int SignalCount(const std::string& member) const {
+    auto it = signal_counts_.find(member);
+    return it == signal_counts_.end() ? 0 : it->second;
+  }
+
+ private:
+  static void OnSignal(GDBusConnection*, const gchar*, const gchar*, const gchar*,
+                       const gchar* signal_name, GVariant*, gpointer user_data) {
+    ++static_cast<HostClient*>(user_data)->signal_counts_[signal_name];
+  }
+
+  GDBusConnection* connection_;
+  guint subscription_id_ = 0;
+  std::map<std::string, int> signal_counts_;
+};
+
+// Collects the ids of every node of a (ia{sv}av) layout in document order
+inline void CollectLayoutIds(GVariant* layout, std::vector<int>& ids) {
+  gint id = 0;
+  GVariant* properties = nullptr;
+  GVariant* children = nullptr;
+  g_variant_get(layout, "(i@a{sv}@av)", &id, &properties, &children);
+  ids.push_back(id);
+  for (gsize i = 0; i < g_variant_n_children(children); ++i) {
+    GVariant* boxed = g_variant_get_child_value(children, i);
+    GVariant* child = g_variant_get_variant(boxed);
+    CollectLayoutIds(child, ids);
+    g_variant_unref(child);
+    g_variant_unref(boxed);
+  }
+  g_variant_unref(properties);
+  g_variant_unref(children);
+}
+
+}  // namespace sni_test
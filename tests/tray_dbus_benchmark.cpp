@@ -0,0 +1,119 @@
+// Measures the tray/dbusmenu stack as a panel sees it: GetLayout round-trip
+// latency and icon-update throughput (SetIcon to NewIcon at the host) for
+// context menus of 10, 100 and 1,000 items. Runs against a private
+// dbus-daemon. Not part of the ctest suite; run the binary directly.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/image.h"
+#include "../src/menu.h"
+#include "../src/platform/linux/tray_icon_linux.h"
+#include "../src/tray_icon.h"
+#include "../src/tray_icon_event.h"
+#include "sni_test_fixture.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using nativeapi::ContextMenuTrigger;
+using nativeapi::GetTrayIconUpdateStats;
+using nativeapi::Image;
+using nativeapi::Menu;
+using nativeapi::MenuItem;
+using nativeapi::MenuItemType;
+using nativeapi::ResetTrayIconUpdateStats;
+using nativeapi::TrayIcon;
+using nativeapi::TrayIconReadyEvent;
+using sni_test::HostClient;
+using sni_test::ItemAddress;
+using sni_test::MockWatcher;
+using sni_test::PrivateBus;
+using sni_test::RunUntil;
+
+constexpr int kLayoutIterations = 50;
+constexpr int kIconUpdates = 200;
+
+double Milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::shared_ptr<Menu> BuildMenu(int item_count) {
+  auto menu = std::make_shared<Menu>();
+  for (int i = 0; i < item_count; ++i) {
+    menu->AddItem(std::make_shared<MenuItem>("Item " + std::to_string(i), MenuItemType::Normal));
+  }
+  return menu;
+}
+
+std::shared_ptr<Image> SolidIcon(uint8_t value) {
+  std::vector<uint8_t> pixels(32 * 32 * 4, value);
+  return Image::FromRawData(pixels.data(), 32, 32);
+}
+
+void Run(TrayIcon& tray, const HostClient& host, const ItemAddress& item, int item_count) {
+  tray.SetContextMenu(BuildMenu(item_count));
+  ResetTrayIconUpdateStats();
+  RunUntil([] { return GetTrayIconUpdateStats().flushes > 0; });
+  const std::string menu_path = host.GetMenuPath(item);
+
+  auto start = Clock::now();
+  for (int i = 0; i < kLayoutIterations; ++i) {
+    GVariant* layout = host.GetLayout(item.bus_name, menu_path.c_str());
+    if (!layout) {
+      std::cerr << "GetLayout failed" << std::endl;
+      return;
+    }
+    g_variant_unref(layout);
+  }
+  const double layout_ms = Milliseconds(Clock::now() - start) / kLayoutIterations;
+
+  // Each update is waited for at the host, so this is end-to-end throughput
+  const auto icons = std::vector<std::shared_ptr<Image>>{SolidIcon(0x20), SolidIcon(0xE0)};
+  const int first_signal = host.SignalCount("NewIcon");
+  start = Clock::now();
+  for (int i = 0; i < kIconUpdates; ++i) {
+    tray.SetIcon(icons[i % 2]);
+    const int expected = first_signal + i + 1;
+    if (!RunUntil([&host, expected] { return host.SignalCount("NewIcon") >= expected; })) {
+      std::cerr << "NewIcon was not received" << std::endl;
+      return;
+    }
+  }
+  const double seconds = Milliseconds(Clock::now() - start) / 1000.0;
+
+  std::cout << item_count << " items: GetLayout " << layout_ms << " ms, "
+            << kIconUpdates / seconds << " icon updates/s" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+  PrivateBus bus;
+  // No gtk_init: the exported menu is served without GTK
+  if (!bus.Start()) {
+    std::cerr << "Skipping: dbus-daemon is not available" << std::endl;
+    return sni_test::kSkipped;
+  }
+
+  HostClient host(bus.address());
+  MockWatcher watcher(bus.address());
+  bool ready = false;
+  TrayIcon tray;
+  tray.SetContextMenuTrigger(ContextMenuTrigger::Clicked);
+  tray.AddListener<TrayIconReadyEvent>([&ready](const TrayIconReadyEvent&) { ready = true; });
+  if (!host.connected() || !RunUntil([&ready] { return ready; })) {
+    std::cerr << "Tray icon did not register" << std::endl;
+    return 1;
+  }
+
+  host.WatchItem(watcher.last_item());
+  for (int item_count : {10, 100, 1000}) {
+    Run(tray, host, watcher.last_item(), item_count);
+  }
+  return 0;
+}
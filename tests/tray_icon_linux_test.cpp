@@ -0,0 +1,380 @@
+#include <gio/gio.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../src/image.h"
+#include "../src/menu.h"
+#include "../src/platform/linux/tray_icon_linux.h"
+#include "../src/tray_icon.h"
+#include "../src/tray_icon_event.h"
+#include "../src/tray_manager.h"
+#include "sni_test_fixture.h"
+
+namespace {
+
+using nativeapi::ContextMenuTrigger;
+using nativeapi::GetTrayIconUpdateStats;
+using nativeapi::Image;
+using nativeapi::Menu;
+using nativeapi::MenuItem;
+using nativeapi::MenuItemClickedEvent;
+using nativeapi::MenuItemType;
+using nativeapi::Point;
+using nativeapi::ResetTrayIconUpdateStats;
+using nativeapi::TrayIcon;
+using nativeapi::TrayIconClickedEvent;
+using nativeapi::TrayIconDoubleClickedEvent;
+using nativeapi::TrayIconRightClickedEvent;
+using nativeapi::TrayIconScrolledEvent;
+using nativeapi::TrayIconScrollOrientation;
+using nativeapi::TrayManager;
+using nativeapi::TrayIconFailedEvent;
+using nativeapi::TrayIconReadyEvent;
+using sni_test::CollectLayoutIds;
+using sni_test::HostClient;
+using sni_test::ItemAddress;
+using sni_test::MockWatcher;
+using sni_test::PrivateBus;
+using sni_test::RunUntil;
+
+std::string GetStringProperty(const HostClient& host, const ItemAddress& item,
+                              const char* name) {
+  GVariant* value = host.GetItemProperty(item, name);
+  if (!value) {
+    return "";
+  }
+  std::string result = g_variant_get_string(value, nullptr);
+  g_variant_unref(value);
+  return result;
+}
+
+// Property reads as a panel performs them
+int TestProperties(TrayIcon& tray, const HostClient& host, const ItemAddress& item) {
+  tray.SetTitle("Downloads");
+  std::vector<uint8_t> pixels(128 * 128 * 4, 0xFF);
+  tray.SetIcon(Image::FromRawData(pixels.data(), 128, 128));
+  RunUntil([] { return GetTrayIconUpdateStats().flushes > 0; });
+
+  if (GetStringProperty(host, item, "Title") != "Downloads" ||
+      GetStringProperty(host, item, "Status") != "Active") {
+    std::cerr << "Title or Status property is wrong" << std::endl;
+    return 1;
+  }
+
+  // Icons are exported at every standard size the source covers
+  GVariant* pixmaps = host.GetItemProperty(item, "IconPixmap");
+  std::vector<int> edges;
+  for (gsize i = 0; pixmaps && i < g_variant_n_children(pixmaps); ++i) {
+    gint width = 0;
+    gint height = 0;
+    GVariant* entry = g_variant_get_child_value(pixmaps, i);
+    g_variant_get_child(entry, 0, "i", &width);
+    g_variant_get_child(entry, 1, "i", &height);
+    g_variant_unref(entry);
+    edges.push_back(width == height ? width : -1);
+  }
+  if (pixmaps) {
+    g_variant_unref(pixmaps);
+  }
+  const std::vector<int> standard{16, 22, 24, 32, 48};
+  if (!std::is_sorted(edges.begin(), edges.end()) ||
+      !std::includes(edges.begin(), edges.end(), standard.begin(), standard.end()) ||
+      edges.back() > 128) {
+    std::cerr << "IconPixmap has " << edges.size() << " entries, expected the standard sizes"
+              << std::endl;
+    return 1;
+  }
+
+  // A 64x64 PNG header with no image data probes fine but fails to decode;
+  // it exports no pixmaps rather than bogus entries
+  const uint8_t kTruncatedPng[] = {0x89, 'P',  'N',  'G',  '\r', '\n', 0x1A, '\n',
+                                   0x00, 0x00, 0x00, 0x0D, 'I',  'H',  'D',  'R',
+                                   0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x40,
+                                   0x08, 0x06, 0x00, 0x00, 0x00};
+  const uint64_t flushes = GetTrayIconUpdateStats().flushes;
+  tray.SetIcon(Image::FromBytes(kTruncatedPng, sizeof(kTruncatedPng)));
+  RunUntil([flushes] { return GetTrayIconUpdateStats().flushes > flushes; });
+  pixmaps = host.GetItemProperty(item, "IconPixmap");
+  const gsize broken_entries = pixmaps ? g_variant_n_children(pixmaps) : 1;
+  if (pixmaps) {
+    g_variant_unref(pixmaps);
+  }
+  if (broken_entries != 0) {
+    std::cerr << "An icon that failed to decode exported " << broken_entries << " pixmaps"
+              << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Frames advance from the timer and pause while the icon is hidden
+int TestAnimation(TrayIcon& tray, const HostClient& host) {
+  std::vector<std::shared_ptr<Image>> frames;
+  for (uint8_t value : {0x20, 0x80, 0xE0}) {
+    std::vector<uint8_t> pixels(16 * 16 * 4, value);
+    frames.push_back(Image::FromRawData(pixels.data(), 16, 16));
+  }
+  if (!tray.SetIconAnimation(frames, std::chrono::milliseconds(20)) || !tray.IsIconAnimating()) {
+    std::cerr << "Icon animation did not start" << std::endl;
+    return 1;
+  }
+
+  const int start = host.SignalCount("NewIcon");
+  const int properties_changed = host.SignalCount("PropertiesChanged");
+  if (!RunUntil([&host, start] { return host.SignalCount("NewIcon") >= start + 3; })) {
+    std::cerr << "Animation frames were not sent" << std::endl;
+    return 1;
+  }
+  // Frames are announced with NewIcon alone; hosts fetch the pixmaps
+  if (host.SignalCount("PropertiesChanged") != properties_changed) {
+    std::cerr << "Animation frames sent IconPixmap in PropertiesChanged" << std::endl;
+    return 1;
+  }
+
+  tray.SetVisible(false);
+  RunUntil([] { return false; }, 100);
+  const int paused = host.SignalCount("NewIcon");
+  RunUntil([] { return false; }, 100);
+  if (host.SignalCount("NewIcon") != paused) {
+    std::cerr << "Animation kept running while hidden" << std::endl;
+    return 1;
+  }
+
+  tray.SetVisible(true);
+  tray.SetIcon(frames[0]);
+  if (tray.IsIconAnimating()) {
+    std::cerr << "SetIcon did not stop the animation" << std::endl;
+    return 1;
+  }
+  // Let the static icon reach the host before the next test
+  RunUntil([&host, paused] { return host.SignalCount("NewIcon") > paused; });
+  return 0;
+}
+
+// Host calls become click, double-click, right-click and scroll events
+int TestPointerEvents(TrayIcon& tray, const HostClient& host, const ItemAddress& item) {
+  std::vector<Point> clicks;
+  int double_clicks = 0;
+  Point right_click{0, 0};
+  int scroll_delta = 0;
+  bool horizontal = false;
+  const auto clicked_id = tray.AddListener<TrayIconClickedEvent>(
+      [&clicks](const TrayIconClickedEvent& event) { clicks.push_back(event.GetPosition()); });
+  const auto double_clicked_id = tray.AddListener<TrayIconDoubleClickedEvent>(
+      [&double_clicks](const TrayIconDoubleClickedEvent&) { ++double_clicks; });
+  const auto right_clicked_id = tray.AddListener<TrayIconRightClickedEvent>(
+      [&right_click](const TrayIconRightClickedEvent& event) {
+        right_click = event.GetPosition();
+      });
+  const auto scrolled_id = tray.AddListener<TrayIconScrolledEvent>(
+      [&scroll_delta, &horizontal](const TrayIconScrolledEvent& event) {
+        scroll_delta = event.GetDelta();
+        horizontal = event.GetOrientation() == TrayIconScrollOrientation::Horizontal;
+      });
+
+  // Replies arrive after the handler emitted its events
+  auto call = [&host, &item](const char* method, GVariant* params) {
+    GVariant* reply = host.CallItem(item, method, params);
+    if (reply) {
+      g_variant_unref(reply);
+    }
+    return reply != nullptr;
+  };
+  const bool delivered = call("Activate", g_variant_new("(ii)", 10, 20)) &&
+                         call("Activate", g_variant_new("(ii)", 11, 20)) &&
+                         call("ContextMenu", g_variant_new("(ii)", 30, 40)) &&
+                         call("Scroll", g_variant_new("(is)", -3, "horizontal"));
+
+  tray.RemoveListener(clicked_id);
+  tray.RemoveListener(double_clicked_id);
+  tray.RemoveListener(right_clicked_id);
+  tray.RemoveListener(scrolled_id);
+
+  if (!delivered || clicks.size() != 2 || clicks[0].x != 10 || clicks[0].y != 20 ||
+      double_clicks != 1) {
+    std::cerr << "Activate was not turned into click and double-click events" << std::endl;
+    return 1;
+  }
+  if (right_click.x != 30 || right_click.y != 40) {
+    std::cerr << "ContextMenu was not turned into a right-click event" << std::endl;
+    return 1;
+  }
+  if (scroll_delta != -3 || !horizontal) {
+    std::cerr << "Scroll was not turned into a scrolled event" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Layout fetch and click activation through the exported context menu
+int TestContextMenu(TrayIcon& tray, const HostClient& host, const ItemAddress& item) {
+  auto menu = std::make_shared<Menu>();
+  auto open = std::make_shared<MenuItem>("Open", MenuItemType::Normal);
+  auto pause = std::make_shared<MenuItem>("Pause", MenuItemType::Checkbox);
+  auto quit = std::make_shared<MenuItem>("Quit", MenuItemType::Normal);
+  menu->AddItem(open);
+  menu->AddItem(pause);
+  menu->AddSeparator();
+  menu->AddItem(quit);
+
+  int clicks = 0;
+  quit->AddListener<MenuItemClickedEvent>([&clicks](const MenuItemClickedEvent&) { ++clicks; });
+
+  tray.SetContextMenu(menu);
+  tray.SetContextMenuTrigger(ContextMenuTrigger::Clicked);
+  ResetTrayIconUpdateStats();
+  RunUntil([] { return GetTrayIconUpdateStats().flushes > 0; });
+
+  const std::string menu_path = host.GetMenuPath(item);
+  if (menu_path != item.object_path + "/Menu") {
+    std::cerr << "Menu property does not point at the dbusmenu object" << std::endl;
+    return 1;
+  }
+
+  GVariant* layout = host.GetLayout(item.bus_name, menu_path.c_str());
+  std::vector<int> ids;
+  if (layout) {
+    CollectLayoutIds(layout, ids);
+    g_variant_unref(layout);
+  }
+  if (ids.size() != 5 || ids[0] != 0 || ids[1] != static_cast<int>(open->GetId()) ||
+      ids[4] != static_cast<int>(quit->GetId())) {
+    std::cerr << "GetLayout returned " << ids.size() << " nodes" << std::endl;
+    return 1;
+  }
+
+  if (!host.Click(item.bus_name, menu_path.c_str(), static_cast<int>(quit->GetId())) || clicks != 1) {
+    std::cerr << "Clicking a menu item did not activate it" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Icons created together get their own object paths on one connection and
+// reach the watcher in one batch
+int TestCreateMany(const PrivateBus& bus, const ItemAddress& existing) {
+  MockWatcher watcher(bus.address());
+  int ready = 0;
+  auto icons = TrayManager::GetInstance().CreateMany(4);
+  for (const auto& icon : icons) {
+    icon->AddListener<TrayIconReadyEvent>([&ready](const TrayIconReadyEvent&) { ++ready; });
+  }
+  if (!watcher.owned() || !RunUntil([&ready] { return ready == 4; })) {
+    std::cerr << "Icons from CreateMany did not all register" << std::endl;
+    return 1;
+  }
+
+  std::set<std::string> paths;
+  std::set<std::string> bus_names;
+  // The existing icon registers with this watcher too
+  for (const ItemAddress& item : watcher.items()) {
+    if (item.object_path != existing.object_path) {
+      paths.insert(item.object_path);
+      bus_names.insert(item.bus_name);
+    }
+  }
+  if (paths.size() != 4 || bus_names.size() != 1) {
+    std::cerr << "Icons do not share one connection with distinct paths" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int RunTests(const PrivateBus& bus) {
+  HostClient host(bus.address());
+  if (!host.connected()) {
+    std::cerr << "Could not connect to the private bus" << std::endl;
+    return 1;
+  }
+
+  int ready = 0;
+  int failed = 0;
+  auto tray = std::make_shared<TrayIcon>();
+  tray->AddListener<TrayIconReadyEvent>([&ready](const TrayIconReadyEvent&) { ++ready; });
+  tray->AddListener<TrayIconFailedEvent>([&failed](const TrayIconFailedEvent&) { ++failed; });
+
+  // Without a watcher the icon reports failure instead of blocking
+  if (!RunUntil([&failed] { return failed > 0; }) || ready != 0) {
+    std::cerr << "Missing watcher was not reported" << std::endl;
+    return 1;
+  }
+
+  // A watcher appearing later receives the registration
+  {
+    MockWatcher watcher(bus.address());
+    if (!watcher.owned() || !RunUntil([&ready] { return ready == 1; }) ||
+        watcher.registrations() != 1 ||
+        watcher.last_item().object_path.rfind("/StatusNotifierItem/", 0) != 0) {
+      std::cerr << "Tray icon did not register with the watcher" << std::endl;
+      return 1;
+    }
+  }
+
+  // A restarted watcher (new name owner) receives it again
+  ItemAddress item;
+  {
+    MockWatcher watcher(bus.address());
+    if (!watcher.owned() || !RunUntil([&ready] { return ready == 2; }) ||
+        watcher.registrations() != 1) {
+      std::cerr << "Tray icon did not re-register after the watcher restarted" << std::endl;
+      return 1;
+    }
+    item = watcher.last_item();
+  }
+  host.WatchItem(item);
+
+  if (TestProperties(*tray, host, item) != 0 || TestAnimation(*tray, host) != 0 ||
+      TestPointerEvents(*tray, host, item) != 0 || TestContextMenu(*tray, host, item) != 0) {
+    return 1;
+  }
+
+  if (TestCreateMany(bus, item) != 0) {
+    return 1;
+  }
+
+  // A burst of setter calls is flushed once, with one signal per property
+  ResetTrayIconUpdateStats();
+  const int new_titles = host.SignalCount("NewTitle");
+  for (int i = 0; i < 10; ++i) {
+    tray->SetTitle("Title " + std::to_string(i));
+    tray->SetTooltip("Tooltip " + std::to_string(i));
+  }
+  if (!RunUntil([] { return GetTrayIconUpdateStats().flushes == 1; })) {
+    std::cerr << "Staged property changes were not flushed" << std::endl;
+    return 1;
+  }
+  const auto stats = GetTrayIconUpdateStats();
+  // PropertiesChanged, NewTitle and NewToolTip
+  if (stats.staged_changes != 20 || stats.signals_emitted != 3) {
+    std::cerr << "Property changes were not coalesced: " << stats.staged_changes
+              << " changes, " << stats.signals_emitted << " signals" << std::endl;
+    return 1;
+  }
+  // ...and the host sees exactly one NewTitle
+  RunUntil([&host, new_titles] { return host.SignalCount("NewTitle") > new_titles; });
+  RunUntil([] { return false; }, 100);
+  if (host.SignalCount("NewTitle") != new_titles + 1) {
+    std::cerr << "Host received " << host.SignalCount("NewTitle") - new_titles
+              << " NewTitle signals" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main() {
+  PrivateBus bus;
+  if (!bus.Start()) {
+    std::cerr << "Skipping: dbus-daemon is not available" << std::endl;
+    return sni_test::kSkipped;
+  }
+  // No gtk_init: the tray icon and its exported menu must not need GTK
+  return RunTests(bus);
+}